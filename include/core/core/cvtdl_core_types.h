@@ -185,6 +185,29 @@ typedef struct {
   uint32_t full_length;
 } cvtdl_image_t;
 
+/** @struct cvtdl_image_batch_t
+ * @ingroup core_cvitdlcore
+ * @brief Images cropped from one frame that share one pixel buffer.
+ *
+ * @var cvtdl_image_batch_t::size
+ * The number of images.
+ * @var cvtdl_image_batch_t::images
+ * The cropped images. Their pixels live in buffer, do not free them one by one.
+ * @var cvtdl_image_batch_t::crop_boxes
+ * The frame region covered by each image, x2 and y2 inclusive. Parts outside the frame are zero.
+ * @var cvtdl_image_batch_t::buffer
+ * The shared pixel buffer, reused by later crops into the same batch while it is large enough.
+ * @var cvtdl_image_batch_t::capacity
+ * The size of buffer in bytes.
+ */
+typedef struct {
+  uint32_t size;
+  cvtdl_image_t* images;
+  cvtdl_bbox_t* crop_boxes;
+  uint8_t* buffer;
+  uint32_t capacity;
+} cvtdl_image_batch_t;
+
 /** @struct InputPreParam
  *  @ingroup core_cvitdlcore
  *  @brief Config the detection model preprocess.
@@ -211,6 +234,32 @@ typedef struct {
   VPSS_SCALE_COEF_E resize_method;
 } InputPreParam;
 
+/** @struct cvtdl_latency_stats_t
+ * @ingroup core_cvitdlcore
+ * @brief Latency distribution of one inference stage, see CVI_TDL_GetLatencyStats.
+ *
+ * @var cvtdl_latency_stats_t::count
+ * Number of recorded spans.
+ * @var cvtdl_latency_stats_t::mean_us
+ * Mean span in microseconds.
+ * @var cvtdl_latency_stats_t::p50_us
+ * Median span in microseconds, percentiles are accurate to 1/16 of their value.
+ * @var cvtdl_latency_stats_t::p95_us
+ * 95th percentile in microseconds.
+ * @var cvtdl_latency_stats_t::p99_us
+ * 99th percentile in microseconds.
+ * @var cvtdl_latency_stats_t::max_us
+ * Longest span in microseconds.
+ */
+typedef struct {
+  uint64_t count;
+  float mean_us;
+  float p50_us;
+  float p95_us;
+  float p99_us;
+  float max_us;
+} cvtdl_latency_stats_t;
+
 /**
  * @brief A helper function to get the unit size of feature_type_e.
  * @ingroup core_cvitdlcore
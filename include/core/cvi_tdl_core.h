@@ -33,7 +33,9 @@
            cvtdl_handpose21_meta_ts*: CVI_TDL_FreeHandPoses, \
            cvtdl_class_meta_t*: CVI_TDL_FreeClassMeta, \
            cvtdl_image_t*: CVI_TDL_FreeImage,          \
+           cvtdl_image_batch_t*: CVI_TDL_FreeImageBatch, \
            cvtdl_clip_feature*: CVI_TDL_FreeClip,      \
+           cvtdl_seg_label_t*: CVI_TDL_FreeSegLabel,   \
            cvtdl_lane_t* : CVI_TDL_FreeLane)(X)
 
 // clang-format on
@@ -276,6 +278,127 @@ DLL_EXPORT CVI_S32 CVI_TDL_OpenModel_FromBuffer(cvitdl_handle_t handle,
                                                 CVI_TDL_SUPPORTED_MODEL_E model, int8_t *buf,
                                                 uint32_t size);
 
+/** @typedef cvtdl_model_file_t
+ *  @ingroup core_cvitdlcore
+ *  @brief A model and the cvimodel file to open it from.
+ */
+typedef struct {
+  CVI_TDL_SUPPORTED_MODEL_E model_id;
+  const char *filepath;
+} cvtdl_model_file_t;
+
+/** @typedef cvtdl_model_ready_cb
+ *  @ingroup core_cvitdlcore
+ *  @brief Called once a model is ready, with the result of opening it. Warmed up models are
+ *  reported after all loader threads are done.
+ */
+typedef void (*cvtdl_model_ready_cb)(CVI_TDL_SUPPORTED_MODEL_E model_id, CVI_S32 result,
+                                     void *user_data);
+
+/**
+ * @brief Open several models concurrently, one loader thread per model, and wait for all of them.
+ *
+ * @param handle An TDL SDK handle.
+ * @param models Models and their file paths, each model at most once.
+ * @param num_models Number of models.
+ * @param warm_up Warm up each opened model, see CVI_TDL_WarmUpModel. Vpss engines are
+ * initialized after all loader threads are done.
+ * @return int Return CVI_TDL_SUCCESS if all models are opened, else the first error.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_OpenModels(cvitdl_handle_t handle, const cvtdl_model_file_t *models,
+                                      uint32_t num_models, bool warm_up);
+
+/**
+ * @brief Open several models concurrently in the background and return immediately. Arguments
+ * are checked before returning. The models must not be used or closed until they are reported
+ * ready by callback or CVI_TDL_WaitModelsReady.
+ *
+ * @param handle An TDL SDK handle.
+ * @param models Models and their file paths, each model at most once.
+ * @param num_models Number of models.
+ * @param warm_up Warm up each opened model, see CVI_TDL_OpenModels.
+ * @param callback Called once per model when it is ready or failed, can be NULL.
+ * @param user_data Passed to callback.
+ * @return int Return CVI_TDL_SUCCESS if loading has started.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_OpenModelsAsync(cvitdl_handle_t handle,
+                                           const cvtdl_model_file_t *models, uint32_t num_models,
+                                           bool warm_up, cvtdl_model_ready_cb callback,
+                                           void *user_data);
+
+/**
+ * @brief Wait for the models opened by CVI_TDL_OpenModelsAsync.
+ *
+ * @param handle An TDL SDK handle.
+ * @return int Return CVI_TDL_SUCCESS if all models are opened or none are loading, else the first
+ * error.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_WaitModelsReady(cvitdl_handle_t handle);
+
+/**
+ * @brief Initialize the vpss engine and run one forward pass on the current input tensors for
+ * every instance of an opened model, so one-time costs are paid before the first frame. Outputs
+ * are discarded.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_WarmUpModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model);
+
+/**
+ * @brief Set how many instances of an opened model serve inference calls concurrently.
+ *
+ * Concurrency model of a handle: opening, closing and configuring models must not overlap with
+ * other calls on the handle. Once models are opened, inference functions may be called from any
+ * number of threads. Each call checks one instance of its model out of a pool, calls on the same
+ * model beyond the number of instances wait for a free one. Calls on different models run in
+ * parallel if the models use different vpss threads (see CVI_TDL_SetVpssThread) or skip vpss
+ * preprocessing.
+ *
+ * The extra instances share the weights of the opened model and each gets its own vpss group.
+ * They copy the settings of the opened model, and later model settings apply to all instances.
+ * Latency stats are reported for all instances together. The vpss image helpers, such as
+ * CVI_TDL_Change_Img and CVI_TDL_Delete_Img, wait for the opened instance, since frames must be
+ * released through the vpss group they came from. Replicas of a replayed model each replay the
+ * record from its first frame, and a model can't have replicas while it records tensors.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @param num_instances Number of instances, 1 to 32. 1 releases the extra instances.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_SetModelInstances(cvitdl_handle_t handle,
+                                             CVI_TDL_SUPPORTED_MODEL_E model,
+                                             uint32_t num_instances);
+
+/**
+ * @brief Open a model on tensors recorded by CVI_TDL_SetTensorRecord instead of a cvimodel.
+ * Inference skips preprocessing and the TPU and feeds the recorded outputs to post-processing,
+ * frame by frame in a loop, so post-processing runs without the device.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @param record_path File path to the tensor record.
+ * @return int Return CVI_TDL_SUCCESS if the record is loaded.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_OpenModelReplay(cvitdl_handle_t handle,
+                                           CVI_TDL_SUPPORTED_MODEL_E model,
+                                           const char *record_path);
+
+/**
+ * @brief Append the input layout and output tensors of every following inference of the model to
+ * a tensor record for CVI_TDL_OpenModelReplay.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @param record_path File path to the tensor record, NULL stops recording.
+ * @return int Return CVI_TDL_SUCCESS on success, CVI_TDL_ERR_INVALID_ARGS if the model has
+ * several instances, see CVI_TDL_SetModelInstances.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_SetTensorRecord(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model,
+                                           const char *record_path);
+
 /**
  * @brief Get set model path from supported models.
  *
@@ -308,6 +431,88 @@ DLL_EXPORT CVI_S32 CVI_TDL_SetSkipVpssPreprocess(cvitdl_handle_t handle,
 DLL_EXPORT CVI_S32 CVI_TDL_SetPerfEvalInterval(cvitdl_handle_t handle,
                                                CVI_TDL_SUPPORTED_MODEL_E config, int interval);
 
+/**
+ * @brief Start or stop recording per-stage latency histograms of a model. Recording is off by
+ * default unless the SDK is built with PERF_EVAL or TDL_LATENCY_STATS=1 is set in the
+ * environment, and costs a clock read and a few atomic increments per stage when on.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @param enable Record latencies or not.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_EnableLatencyStats(cvitdl_handle_t handle,
+                                              CVI_TDL_SUPPORTED_MODEL_E model, bool enable);
+
+/**
+ * @brief Get the latency distribution of one stage of a model since the last reset. Stages end
+ * where they are named: "vpss" is preprocessing, "tpu" the forward pass and "post" the
+ * post-processing of most models, and "total" covers a whole inference. The stages of all
+ * instances of the model are merged, see CVI_TDL_SetModelInstances.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @param stage Stage name.
+ * @param stats Output latency statistics.
+ * @return int Return CVI_TDL_ERR_INVALID_ARGS if the stage has never been recorded.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_GetLatencyStats(cvitdl_handle_t handle,
+                                           CVI_TDL_SUPPORTED_MODEL_E model, const char *stage,
+                                           cvtdl_latency_stats_t *stats);
+
+/**
+ * @brief Clear the latency histograms of a model.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model Supported model id.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResetLatencyStats(cvitdl_handle_t handle,
+                                             CVI_TDL_SUPPORTED_MODEL_E model);
+
+/**
+ * @brief Mark the end of an app stage on the handle. The capture apps mark "start" when a frame
+ * comes in, then the end of their "detect", "recognize", "quality", "track" and "update" stages,
+ * each one they run. Marks must come from one thread, the one running the app. Stats are recorded
+ * under the same conditions as CVI_TDL_EnableLatencyStats.
+ *
+ * @param handle An TDL SDK handle.
+ * @param stage Stage name of at most 31 characters, the first stage ever marked opens every round.
+ * The name is copied, the buffer can be reused.
+ * @return int Return CVI_TDL_SUCCESS on success, CVI_TDL_ERR_INVALID_ARGS if the name is NULL or
+ * too long.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_MarkAppStage(cvitdl_handle_t handle, const char *stage);
+
+/**
+ * @brief Start or stop recording the app stages marked on the handle.
+ *
+ * @param handle An TDL SDK handle.
+ * @param enable Record latencies or not.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_EnableAppLatencyStats(cvitdl_handle_t handle, bool enable);
+
+/**
+ * @brief Get the latency distribution of an app stage since the last reset, "total" covers a
+ * whole round. Can be called from any thread.
+ *
+ * @param handle An TDL SDK handle.
+ * @param stage Stage name.
+ * @param stats Output latency statistics.
+ * @return int Return CVI_TDL_ERR_INVALID_ARGS if the stage has never been marked.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_GetAppLatencyStats(cvitdl_handle_t handle, const char *stage,
+                                              cvtdl_latency_stats_t *stats);
+
+/**
+ * @brief Clear the latency histograms of the app stages.
+ *
+ * @param handle An TDL SDK handle.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResetAppLatencyStats(cvitdl_handle_t handle);
+
 /**
  * @brief Set list depth for VPSS.
  *
@@ -483,6 +688,16 @@ DLL_EXPORT CVI_S32 CVI_TDL_GetVpssGrpIds(cvitdl_handle_t handle, VPSS_GRP **grou
  */
 DLL_EXPORT CVI_S32 CVI_TDL_SetVpssTimeout(cvitdl_handle_t handle, uint32_t timeout);
 
+/**
+ * @brief Set the most verbose log level written, a syslog level from LOG_EMERG to LOG_DEBUG.
+ * Messages above it are skipped before their arguments are evaluated. Defaults to LOG_INFO, the
+ * messages are written to syslog by a background thread. Applies to the whole process.
+ *
+ * @param level The log level.
+ * @return int Return CVI_TDL_SUCCESS, CVI_TDL_ERR_INVALID_ARGS if level is out of range.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_SetLogLevel(int level);
+
 /**
  * @brief Close all opened models and delete the model instances.
  *
@@ -679,6 +894,39 @@ DLL_EXPORT CVI_S32 CVI_TDL_CropImage_Exten(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_i
 DLL_EXPORT CVI_S32 CVI_TDL_CropImage_Face(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *dst,
                                           cvtdl_face_info_t *face_info, bool align, bool cvtRGB888);
 
+/**
+ * @brief Crop many boxes of a frame in one call. All crops share one buffer in dst, which is reused
+ * when dst is passed again, so cropping every target of every frame allocates only while the
+ * crops grow. Free dst with CVI_TDL_Free.
+ *
+ * @param srcFrame Input frame. (RGB packed, RGB planar, NV21 or YUV420 planar)
+ * @param bboxes The bounding boxes.
+ * @param num Number of bounding boxes.
+ * @param dst Output image batch, zero-initialized or from a previous call.
+ * @param cvtRGB888 convert to RGB888 format.
+ * @param exten_ratio Crop the square extension of CVI_TDL_CropImage_Exten if greater than 0.
+ * @param num_threads Number of threads sharing the work, 0 or 1 runs on the calling thread.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_CropImages(VIDEO_FRAME_INFO_S *srcFrame, const cvtdl_bbox_t *bboxes,
+                                      uint32_t num, cvtdl_image_batch_t *dst, bool cvtRGB888,
+                                      float exten_ratio, uint32_t num_threads);
+
+/**
+ * @brief Crop the boxes of all objects in obj_meta. See CVI_TDL_CropImages.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_CropImages_Object(VIDEO_FRAME_INFO_S *srcFrame,
+                                             const cvtdl_object_t *obj_meta,
+                                             cvtdl_image_batch_t *dst, bool cvtRGB888,
+                                             float exten_ratio, uint32_t num_threads);
+
+/**
+ * @brief Crop the boxes of all faces in face_meta without alignment. See CVI_TDL_CropImages.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_CropImages_Face(VIDEO_FRAME_INFO_S *srcFrame,
+                                           const cvtdl_face_t *face_meta, cvtdl_image_batch_t *dst,
+                                           bool cvtRGB888, float exten_ratio, uint32_t num_threads);
+
 /**
  * @brief Mask classification. Tells if a face is wearing a mask.
  *
@@ -990,6 +1238,53 @@ DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_DebugInfo_1(const cvitdl_handle_t handle, ch
 DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_GetTracker_Inactive(const cvitdl_handle_t handle,
                                                         cvtdl_tracker_t *tracker);
 
+/**
+ * @brief Set detection skipping for object tracking, disabled by default.
+ *
+ * @param handle An TDL SDK handle.
+ * @param skip_conf Skip config, see cvtdl_deepsort_skip_config_t.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_SetSkipConfig(const cvitdl_handle_t handle,
+                                                  const cvtdl_deepsort_skip_config_t *skip_conf);
+
+/**
+ * @brief Get detection skipping config.
+ *
+ * @param handle An TDL SDK handle.
+ * @param skip_conf Output skip config.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_GetSkipConfig(const cvitdl_handle_t handle,
+                                                  cvtdl_deepsort_skip_config_t *skip_conf);
+
+/**
+ * @brief Decide per frame whether the detector runs. If it does, track its result with
+ * CVI_TDL_DeepSORT_Obj as usual, otherwise serve the frame with CVI_TDL_DeepSORT_Predict. Always
+ * true while skipping is disabled.
+ *
+ * @param handle An TDL SDK handle.
+ * @param scene_changed Force detection, e.g. when motion detection finds activity away from the
+ * tracked objects.
+ * @param need_detection Output, true if the detector should run on this frame.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_NeedDetection(const cvitdl_handle_t handle, bool scene_changed,
+                                                  bool *need_detection);
+
+/**
+ * @brief Advance the object tracks by one frame without detection and output their Kalman
+ * predicted boxes. Skipped frames don't count as misses of the tracks.
+ *
+ * @param handle An TDL SDK handle.
+ * @param obj Output objects of the tracks matched at the last detection, with their track ids.
+ * The boxes are in the coordinates of the tracked detections, no crops around them are detected.
+ * @param tracker Output tracker results, one per object.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_Predict(const cvitdl_handle_t handle, cvtdl_object_t *obj,
+                                            cvtdl_tracker_t *tracker);
+
 /**
  * @brief Calculate iou score between faces and heads.
  *
@@ -1020,6 +1315,20 @@ DLL_EXPORT CVI_S32 CVI_TDL_FaceHeadIouScore(const cvitdl_handle_t handle, cvtdl_
  */
 DLL_EXPORT CVI_S32 CVI_TDL_DeeplabV3(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                      VIDEO_FRAME_INFO_S *out_frame, cvtdl_class_filter_t *filter);
+
+/**
+ * @brief Deeplabv3 segmentation into a label map at model output resolution, optionally
+ * downscaled or run-length encoded. No VPSS resize is involved.
+ *
+ * @param handle An TDL SDK handle.
+ * @param frame Input video frame.
+ * @param seg_label Output label map. Set downscale and use_rle before calling.
+ * @param filter Class id filter. Set NULL to ignore.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeeplabV3_Label(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
+                                           cvtdl_seg_label_t *seg_label,
+                                           cvtdl_class_filter_t *filter);
 /**@}*/
 
 /**
@@ -1139,6 +1448,19 @@ DLL_EXPORT CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle,
                                                    CVI_TDL_SUPPORTED_MODEL_E model_id,
                                                    cvtdl_object_t *vehicle);
 
+/**
+ * @brief Set the CTC beam width of a license plate recognition model. A width above 1 decodes with
+ * a prefix beam search restricted to valid plate formats, 1 (the default) decodes greedily.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_id One of the license plate recognition models.
+ * @param beam_width Number of prefixes kept per time step.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_SetLicensePlateBeamWidth(const cvitdl_handle_t handle,
+                                                    CVI_TDL_SUPPORTED_MODEL_E model_id,
+                                                    uint32_t beam_width);
+
 DLL_EXPORT CVI_S32 CVI_TDL_OCR_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                          cvtdl_object_t *obj_meta);
 /**
@@ -1583,13 +1905,121 @@ DLL_EXPORT CVI_S32 CVI_TDL_Set_TextPreprocess(const char *encoderFile, const cha
                                               const char *textFile, int32_t **tokens,
                                               int numSentences);
 
+/**
+ * @brief Tokenize prompts for the CLIP text model without going through a text file.
+ *
+ * The tokenizer is loaded on first use and shared by later calls with the same files.
+ *
+ * @param encoderFile Vocabulary file, or a binary file from CVI_TDL_Export_TextTokenizer.
+ * @param bpeFile BPE merges file. Pass NULL or "" when encoderFile is a binary tokenizer file.
+ * @param texts Prompts to tokenize.
+ * @param numSentences Number of prompts.
+ * @param tokens Output, numSentences buffers of 77 int32 each, allocated by caller.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_TextTokenize(const char *encoderFile, const char *bpeFile,
+                                        const char **texts, int numSentences, int32_t **tokens);
+
+/**
+ * @brief Export the CLIP tokenizer vocabulary and merge ranks to a compact binary file.
+ *
+ * @param encoderFile Vocabulary file.
+ * @param bpeFile BPE merges file.
+ * @param outFile Output binary file path.
+ * @return int Return CVI_TDL_SUCCESS on success, CVI_TDL_ERR_INVALID_ARGS if a path is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Export_TextTokenizer(const char *encoderFile, const char *bpeFile,
+                                                const char *outFile);
+
 DLL_EXPORT CVI_S32 CVI_TDL_Set_ClipPostprocess(float **text_features, int text_features_num,
                                                float **image_features, int image_features_num,
                                                float **probs);
 
+/**
+ * @brief Keep normalized CLIP text features resident in the handle for later scoring.
+ *
+ * @param handle An TDL SDK handle.
+ * @param text_features Text features, text_features_num rows of feature_dim floats.
+ * @param text_features_num Number of text features.
+ * @param feature_dim Feature dimension, must match the image features scored later.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Clip_SetTextFeatures(const cvitdl_handle_t handle,
+                                                float **text_features, int text_features_num,
+                                                int feature_dim);
+
+/**
+ * @brief Score image features against the text features set by CVI_TDL_Clip_SetTextFeatures.
+ *
+ * @param handle An TDL SDK handle.
+ * @param image_features Image features, image_features_num rows of feature_dim floats.
+ * @param image_features_num Number of image features.
+ * @param topk Number of best labels returned per image.
+ * @param labels Output text indices, image_features_num * topk, row-major, allocated by caller.
+ * @param scores Output softmax probabilities matching labels, allocated by caller.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Clip_ScoreTopK(const cvitdl_handle_t handle, float **image_features,
+                                          int image_features_num, int topk, int *labels,
+                                          float *scores);
+
+/**
+ * @brief Extract the outer contour of each instance mask into mask_point, in frame coordinates.
+ * The contour of the largest connected component is traced on the run-length encoded mask, so
+ * OpenCV is not required.
+ *
+ * @param frame The frame the masks were inferred on.
+ * @param obj_meta Output of instance segmentation.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
 DLL_EXPORT CVI_S32 CVI_TDL_Set_MaskOutlinePoint(VIDEO_FRAME_INFO_S *frame,
                                                 cvtdl_object_t *obj_meta);
 
+/**
+ * @brief Get the number of foreground pixels of an instance mask.
+ *
+ * @param obj_meta Output of instance segmentation.
+ * @param index Object index.
+ * @param area Output foreground pixel count.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Mask_Area(const cvtdl_object_t *obj_meta, uint32_t index,
+                                     uint32_t *area);
+
+/**
+ * @brief Get the tight bounding box of an instance mask in mask coordinates.
+ *
+ * @param obj_meta Output of instance segmentation.
+ * @param index Object index.
+ * @param bbox Output box, x2 and y2 exclusive. All zero when the mask is empty.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Mask_BBox(const cvtdl_object_t *obj_meta, uint32_t index,
+                                     cvtdl_bbox_t *bbox);
+
+/**
+ * @brief Compute the IoU of two instance masks of the same object meta.
+ *
+ * @param obj_meta Output of instance segmentation.
+ * @param index_a Index of the first object.
+ * @param index_b Index of the second object.
+ * @param iou Output intersection over union.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Mask_IoU(const cvtdl_object_t *obj_meta, uint32_t index_a,
+                                    uint32_t index_b, float *iou);
+
+/**
+ * @brief Decode an instance mask into a dense mask_height x mask_width buffer, 255 for foreground.
+ *
+ * @param obj_meta Output of instance segmentation.
+ * @param index Object index.
+ * @param mask Output buffer of mask_height * mask_width bytes, allocated by caller.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Mask_Decode(const cvtdl_object_t *obj_meta, uint32_t index,
+                                       uint8_t *mask);
+
 DLL_EXPORT CVI_S32 CVI_TDL_Depth_Stereo(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame1,
                                         VIDEO_FRAME_INFO_S *frame2,
                                         cvtdl_depth_logits_t *depth_logist);
@@ -13,11 +13,13 @@ DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_face_t *face);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_object_info_t *obj_info);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_object_t *obj);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_image_t *image);
+DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_image_batch_t *batch);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_dms_od_t *dms_od);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_dms_t *dms);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_handpose21_meta_ts *handposes);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_class_meta_t *cls_meta);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_seg_logits_t *seg_logits);
+DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_seg_label_t *seg_label);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_lane_t *lane_meta);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_clip_feature *clip_meta);
 DLL_EXPORT void CVI_TDL_CopyInfoCpp(const cvtdl_face_info_t *info, cvtdl_face_info_t *infoNew);
@@ -37,10 +39,12 @@ DLL_EXPORT void CVI_TDL_FreeFace(cvtdl_face_t *face);
 DLL_EXPORT void CVI_TDL_FreeObjectInfo(cvtdl_object_info_t *obj_info);
 DLL_EXPORT void CVI_TDL_FreeObject(cvtdl_object_t *obj);
 DLL_EXPORT void CVI_TDL_FreeImage(cvtdl_image_t *image);
+DLL_EXPORT void CVI_TDL_FreeImageBatch(cvtdl_image_batch_t *batch);
 DLL_EXPORT void CVI_TDL_FreeDMS(cvtdl_dms_t *dms);
 DLL_EXPORT void CVI_TDL_FreeHandPoses(cvtdl_handpose21_meta_ts *handposes);
 DLL_EXPORT void CVI_TDL_FreeClassMeta(cvtdl_class_meta_t *cls_meta);
 DLL_EXPORT void CVI_TDL_FreeSegLogits(cvtdl_seg_logits_t *seg_logits);
+DLL_EXPORT void CVI_TDL_FreeSegLabel(cvtdl_seg_label_t *seg_label);
 DLL_EXPORT void CVI_TDL_FreeLane(cvtdl_lane_t *lane_meta);
 DLL_EXPORT void CVI_TDL_FreeClip(cvtdl_clip_feature *clip_meta);
 
@@ -57,6 +61,17 @@ DLL_EXPORT void CVI_TDL_CopyImage(const cvtdl_image_t *src_image, cvtdl_image_t
 DLL_EXPORT void CVI_TDL_MapImage(VIDEO_FRAME_INFO_S *src_image, bool *p_is_mapped);
 DLL_EXPORT void CVI_TDL_UnMapImage(VIDEO_FRAME_INFO_S *src_image);
 
+/**
+ * @brief Keep src_image mapped until CVI_TDL_EndFrameMapping. Crop and quality helpers called on
+ * the frame in between share one mapping instead of mapping it per call. Scopes may nest, and
+ * must end before the frame is released.
+ *
+ * @param src_image The frame.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_BeginFrameMapping(VIDEO_FRAME_INFO_S *src_image);
+DLL_EXPORT CVI_S32 CVI_TDL_EndFrameMapping(VIDEO_FRAME_INFO_S *src_image);
+
 DLL_EXPORT CVI_S32 CVI_TDL_CopyVpssImage(VIDEO_FRAME_INFO_S *src_image, cvtdl_image_t *dst_image);
 #ifdef __cplusplus
 }
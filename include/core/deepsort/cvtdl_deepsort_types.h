@@ -60,4 +60,17 @@ typedef struct {
   cvtdl_kalman_tracker_config_t ktracker_conf;
 } cvtdl_deepsort_config_t;
 
+/**
+ *  Detection skipping, see CVI_TDL_DeepSORT_NeedDetection:
+ *    The detector runs every K frames, min_interval <= K <= max_interval. K is the number of frames
+ *    the fastest confirmed track takes to move by max_drift of its height. New tracks, no tracks
+ *    or a scene change reported by the caller bring K down to min_interval.
+ */
+typedef struct {
+  bool enable;
+  uint32_t min_interval;
+  uint32_t max_interval;
+  float max_drift;
+} cvtdl_deepsort_skip_config_t;
+
 #endif /* _CVI_DEEPSORT_TYPES_H_ */
@@ -292,10 +292,29 @@ typedef struct {
   adas_state_e state;
 } cvtdl_adas_meta;
 
+/** @struct cvtdl_mask_meta
+ * @ingroup core_cvitdlcore
+ * @brief A structure to describe an instance mask of mask_height x mask_width.
+ * @var cvtdl_mask_meta::mask
+ * Dense mask, 255 for foreground. NULL when the mask is run-length encoded.
+ * @var cvtdl_mask_meta::mask_point
+ * Outer contour of the mask in image coordinates, (x, y) pairs.
+ * @var cvtdl_mask_meta::mask_point_size
+ * Number of contour points.
+ * @var cvtdl_mask_meta::mask_rle
+ * Row-major run-length encoded mask. Run lengths alternate between background and foreground,
+ * starting with background, so the first run may be 0.
+ * @var cvtdl_mask_meta::mask_rle_size
+ * Number of runs.
+ * @see cvtdl_object_info_t
+ * @see cvtdl_object_t
+ */
 typedef struct {
   uint8_t *mask;
   float *mask_point;
   uint32_t mask_point_size;
+  uint32_t *mask_rle;
+  uint32_t mask_rle_size;
 } cvtdl_mask_meta;
 
 /** @struct cvtdl_object_info_t
@@ -444,6 +463,36 @@ typedef struct {
   uint32_t num_preserved_classes;
 } cvtdl_class_filter_t;
 
+/** @struct cvtdl_seg_label_t
+ *  @ingroup core_cvitdlcore
+ *  @brief Class label map of semantic segmentation.
+ *
+ *  @var cvtdl_seg_label_t::downscale
+ *  Set by caller. Only every downscale-th row and column of the model output is labeled. 0 or 1
+ *  gives the full output resolution.
+ *  @var cvtdl_seg_label_t::use_rle
+ *  Set by caller. Output rle instead of labels.
+ *  @var cvtdl_seg_label_t::width
+ *  Width of the label map.
+ *  @var cvtdl_seg_label_t::height
+ *  Height of the label map.
+ *  @var cvtdl_seg_label_t::labels
+ *  Row-major labels of width x height, NULL when use_rle is set.
+ *  @var cvtdl_seg_label_t::rle
+ *  Row-major (label, run length) pairs, NULL when use_rle is not set.
+ *  @var cvtdl_seg_label_t::rle_size
+ *  Number of (label, run length) pairs.
+ */
+typedef struct {
+  uint32_t downscale;
+  bool use_rle;
+  uint32_t width;
+  uint32_t height;
+  uint8_t *labels;
+  uint32_t *rle;
+  uint32_t rle_size;
+} cvtdl_seg_label_t;
+
 typedef struct {
   float *out_feature;
   int feature_dim;
@@ -544,6 +593,11 @@ typedef struct {
  *  Configure number of detection model stride
  *  @var cvtdl_det_algo_param_t::cls
  *  Configure the number of detection model predict classes
+ *  @var cvtdl_det_algo_param_t::max_det
+ *  Configure the maximum number of detections kept after NMS, 0 for no limit
+ *  @var cvtdl_det_algo_param_t::max_candidates
+ *  Configure the maximum number of highest scoring candidates per class passed to NMS, 0 for no
+ *  limit
  */
 typedef struct {
   uint32_t *anchors;
@@ -553,6 +607,7 @@ typedef struct {
   uint32_t cls;
   uint32_t max_det;
   int *mapping_class;
+  uint32_t max_candidates;
 } cvtdl_det_algo_param_t;
 
 typedef struct {
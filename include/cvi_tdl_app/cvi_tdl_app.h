@@ -4,6 +4,7 @@
 #include "capture/face_capture_type.h"
 #include "capture/person_capture_type.h"
 #include "capture/personvehicle_capture_type.h"
+#include "pipeline/pipeline_type.h"
 #include "core/core/cvtdl_core_types.h"
 #include "core/cvi_tdl_core.h"
 #include "cvi_comm.h"
@@ -143,6 +144,78 @@ DLL_EXPORT CVI_S32 CVI_TDL_APP_ADAS_Init(const cvitdl_app_handle_t handle, uint3
 DLL_EXPORT CVI_S32 CVI_TDL_APP_ADAS_Run(const cvitdl_app_handle_t handle,
                                         VIDEO_FRAME_INFO_S *frame);
 
+/* Pipeline */
+
+/**
+ * @brief Get the default pipeline config: 2 workers, 2 frames in flight, no callback.
+ * @ingroup core_cvitdlapp
+ *
+ * @param cfg Output config.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_GetDefaultConfig(pipeline_config_t *cfg);
+
+/**
+ * @brief Create a pipeline graph whose stages run on the tdl handle of the app handle. Stages are
+ * added with CVI_TDL_APP_Pipeline_AddStage, then frames are fed with CVI_TDL_APP_Pipeline_Submit.
+ * Stages run on the worker threads of the pipeline, so stages must list their models to keep
+ * those sharing a vpss thread apart, and must not call CVI_TDL_MarkAppStage.
+ * @ingroup core_cvitdlapp
+ *
+ * @param handle A app handle.
+ * @param cfg Pipeline config.
+ * @param pipeline Output pipeline.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_Create(const cvitdl_app_handle_t handle,
+                                               const pipeline_config_t *cfg,
+                                               cvitdl_pipeline_t **pipeline);
+
+/**
+ * @brief Add a stage to the graph. A stage depends only on stages added before it, so the graph
+ * has no cycles. Stages can't be added once a frame has been submitted. The vpss threads of the
+ * stage models are read when the first frame is submitted.
+ * @ingroup core_cvitdlapp
+ *
+ * @param pipeline A pipeline.
+ * @param stage Stage description, copied.
+ * @param stage_id Output id of the stage, used in deps of later stages.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_AddStage(cvitdl_pipeline_t *pipeline,
+                                                 const pipeline_stage_t *stage, int *stage_id);
+
+/**
+ * @brief Run the graph on a frame in the background. Blocks while max_frames_in_flight frames
+ * are not done. The frame and frame_data must stay valid until the frame_done callback.
+ * @ingroup core_cvitdlapp
+ *
+ * @param pipeline A pipeline.
+ * @param frame Input frame, passed to every stage.
+ * @param frame_data Per frame data shared by the stages, can be NULL.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if the frame is scheduled.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_Submit(cvitdl_pipeline_t *pipeline,
+                                               VIDEO_FRAME_INFO_S *frame, void *frame_data);
+
+/**
+ * @brief Wait until all submitted frames are done.
+ * @ingroup core_cvitdlapp
+ *
+ * @param pipeline A pipeline.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_Flush(cvitdl_pipeline_t *pipeline);
+
+/**
+ * @brief Wait for the submitted frames, then stop the workers and free the pipeline.
+ * @ingroup core_cvitdlapp
+ *
+ * @param pipeline A pipeline.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_APP_Pipeline_Destroy(cvitdl_pipeline_t *pipeline);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,67 @@
+#ifndef _CVI_TDL_APP_PIPELINE_TYPE_H_
+#define _CVI_TDL_APP_PIPELINE_TYPE_H_
+
+#include "core/cvi_tdl_core.h"
+
+#define PIPELINE_MAX_STAGE_DEPS 8
+#define PIPELINE_MAX_STAGE_MODELS 4
+
+/**
+ * Runs one stage on one frame. frame_data is the pointer given to CVI_TDL_APP_Pipeline_Submit,
+ * shared by all stages of the frame, so a stage reads the results of the stages it depends on
+ * from it and writes its own there. Runs on a worker thread, so it must not call
+ * CVI_TDL_MarkAppStage, whose stages belong to the thread feeding the frames.
+ */
+typedef CVI_S32 (*pipeline_stage_func)(cvitdl_handle_t tdl_handle, VIDEO_FRAME_INFO_S *frame,
+                                       void *frame_data, void *user_data);
+
+/** Returns true to skip the stage on this frame, its dependents still run. */
+typedef bool (*pipeline_skip_func)(uint64_t frame_id, void *frame_data, void *user_data);
+
+/**
+ * Called once all stages of a frame are done, in submission order. result is CVI_TDL_SUCCESS or
+ * the error of the first failed stage, stages depending on a failed stage don't run. Runs on a
+ * worker thread and must not submit or flush frames.
+ */
+typedef void (*pipeline_frame_done_cb)(uint64_t frame_id, VIDEO_FRAME_INFO_S *frame,
+                                       void *frame_data, CVI_S32 result, void *user_data);
+
+typedef enum {
+  // Frames pass the stage one at a time in submission order, for stateful stages like trackers.
+  PIPELINE_STAGE_ORDERED = 0,
+  // Several frames may be in the stage at once, for models with several instances, see
+  // CVI_TDL_SetModelInstances.
+  PIPELINE_STAGE_CONCURRENT,
+} pipeline_stage_mode_e;
+
+typedef struct {
+  const char *name;
+  pipeline_stage_func func;
+  void *user_data;
+  // ids of the stages this stage waits for, returned by CVI_TDL_APP_Pipeline_AddStage
+  int deps[PIPELINE_MAX_STAGE_DEPS];
+  uint32_t num_deps;
+  // run on every interval-th frame only, 0 or 1 runs on every frame
+  uint32_t interval;
+  // optional, checked on the frames the interval lets through
+  pipeline_skip_func skip;
+  pipeline_stage_mode_e mode;
+  // models the stage runs. Stages whose models share a vpss thread (see CVI_TDL_SetVpssThread)
+  // never run at the same time, stages listing no model are not held back.
+  CVI_TDL_SUPPORTED_MODEL_E models[PIPELINE_MAX_STAGE_MODELS];
+  uint32_t num_models;
+} pipeline_stage_t;
+
+typedef struct {
+  // threads running stages, independent stages of a frame and stages of different frames run
+  // in parallel unless their models share a vpss thread
+  uint32_t num_workers;
+  // frames submitted but not done, Submit blocks beyond that
+  uint32_t max_frames_in_flight;
+  pipeline_frame_done_cb frame_done;
+  void *user_data;
+} pipeline_config_t;
+
+typedef struct cvitdl_pipeline cvitdl_pipeline_t;
+
+#endif  // End of _CVI_TDL_APP_PIPELINE_TYPE_H_
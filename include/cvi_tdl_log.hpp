@@ -5,45 +5,60 @@
 #ifdef LOGD
 #undef LOGD
 #endif
-#define LOGD(fmt, ...) ulog(LOG_DEBUG, "TDLSDK", ULOG_TAG, "[TDLSDK] [D] " fmt, ##__VA_ARGS__)
 #ifdef LOGI
 #undef LOGI
 #endif
-#define LOGI(fmt, ...) ulog(LOG_INFO, "TDLSDK", ULOG_TAG, "[TDLSDK] [I] " fmt, ##__VA_ARGS__)
 #ifdef LOGN
 #undef LOGN
 #endif
-#define LOGN(fmt, ...) ulog(LOG_NOTICE, "TDLSDK", ULOG_TAG, "[TDLSDK] [N] " fmt, ##__VA_ARGS__)
 #ifdef LOGW
 #undef LOGW
 #endif
-#define LOGW(fmt, ...) ulog(LOG_WARNING, "TDLSDK", ULOG_TAG, "[TDLSDK] [W] " fmt, ##__VA_ARGS__)
 #ifdef LOGE
 #undef LOGE
 #endif
-#define LOGE(fmt, ...) ulog(LOG_ERR, "TDLSDK", ULOG_TAG, "[TDLSDK] [E] " fmt, ##__VA_ARGS__)
 #ifdef LOGC
 #undef LOGC
 #endif
-#define LOGC(fmt, ...) ulog(LOG_CRIT, "TDLSDK", ULOG_TAG, "[TDLSDK] [C] " fmt, ##__VA_ARGS__)
 #ifndef syslog
 #define syslog(level, fmt, ...) printf(fmt, ##__VA_ARGS__)
 #endif
 #else
 #include <syslog.h>
+#endif
 
 #define MODULE_NAME "TDLSDK"
 #define CVI_TDL_LOG_CHN LOG_LOCAL7
-#define LOGD(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_DEBUG, "[%s] [D] " fmt, MODULE_NAME, ##__VA_ARGS__)
-#define LOGI(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_INFO, "[%s] [I] " fmt, MODULE_NAME, ##__VA_ARGS__)
-#define LOGN(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_NOTICE, "[%s] [N] " fmt, MODULE_NAME, ##__VA_ARGS__)
-#define LOGW(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_WARNING, "[%s] [W] " fmt, MODULE_NAME, ##__VA_ARGS__)
-#define LOGE(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_ERR, "[%s] [E] " fmt, MODULE_NAME, ##__VA_ARGS__)
-#define LOGC(fmt, ...) \
-  syslog(CVI_TDL_LOG_CHN | LOG_CRIT, "[%s] [C] " fmt, MODULE_NAME, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+extern "C" {
 #endif
+
+// Most verbose syslog level written, set with CVI_TDL_SetLogLevel.
+extern int cvi_tdl_log_level;
+
+// Formats the message into the calling thread's ring buffer, a background thread writes it out.
+// Errors and messages too long for a ring slot are written out directly.
+void cvi_tdl_log_write(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#ifdef __cplusplus
+}
+#endif
+
+// The level is checked before the arguments are evaluated, disabled messages cost one load.
+#define CVI_TDL_LOG_ENABLED(level) \
+  ((level) <= __atomic_load_n(&cvi_tdl_log_level, __ATOMIC_RELAXED))
+
+#define CVI_TDL_LOG(level, fmt, ...)                \
+  do {                                              \
+    if (CVI_TDL_LOG_ENABLED(level)) {               \
+      cvi_tdl_log_write(level, fmt, ##__VA_ARGS__); \
+    }                                               \
+  } while (0)
+
+#define LOGD(fmt, ...) CVI_TDL_LOG(LOG_DEBUG, "[" MODULE_NAME "] [D] " fmt, ##__VA_ARGS__)
+#define LOGI(fmt, ...) CVI_TDL_LOG(LOG_INFO, "[" MODULE_NAME "] [I] " fmt, ##__VA_ARGS__)
+#define LOGN(fmt, ...) CVI_TDL_LOG(LOG_NOTICE, "[" MODULE_NAME "] [N] " fmt, ##__VA_ARGS__)
+#define LOGW(fmt, ...) CVI_TDL_LOG(LOG_WARNING, "[" MODULE_NAME "] [W] " fmt, ##__VA_ARGS__)
+#define LOGE(fmt, ...) CVI_TDL_LOG(LOG_ERR, "[" MODULE_NAME "] [E] " fmt, ##__VA_ARGS__)
+#define LOGC(fmt, ...) CVI_TDL_LOG(LOG_CRIT, "[" MODULE_NAME "] [C] " fmt, ##__VA_ARGS__)
@@ -5,6 +5,7 @@
 #include "face_pet_capture/face_pet_capture.h"
 #include "person_capture/person_capture.h"
 #include "personvehicle_capture/personvehicle_capture.h"
+#include "pipeline/pipeline.h"
 #include "vehicle_adas/vehicle_adas.h"
 
 CVI_S32 CVI_TDL_APP_CreateHandle(cvitdl_app_handle_t *handle, cvitdl_handle_t tdl_handle) {
@@ -225,6 +226,36 @@ CVI_S32 CVI_TDL_APP_ADAS_Run(const cvitdl_app_handle_t handle, VIDEO_FRAME_INFO_
   return _ADAS_Run(ctx->adas_info, ctx->tdl_handle, frame);
 }
 
+/* Pipeline */
+
+CVI_S32 CVI_TDL_APP_Pipeline_GetDefaultConfig(pipeline_config_t *cfg) {
+  return _Pipeline_GetDefaultConfig(cfg);
+}
+
+CVI_S32 CVI_TDL_APP_Pipeline_Create(const cvitdl_app_handle_t handle,
+                                    const pipeline_config_t *cfg, cvitdl_pipeline_t **pipeline) {
+  cvitdl_app_context_t *ctx = handle;
+  return _Pipeline_Create(ctx->tdl_handle, cfg, pipeline);
+}
+
+CVI_S32 CVI_TDL_APP_Pipeline_AddStage(cvitdl_pipeline_t *pipeline, const pipeline_stage_t *stage,
+                                      int *stage_id) {
+  return _Pipeline_AddStage(pipeline, stage, stage_id);
+}
+
+CVI_S32 CVI_TDL_APP_Pipeline_Submit(cvitdl_pipeline_t *pipeline, VIDEO_FRAME_INFO_S *frame,
+                                    void *frame_data) {
+  return _Pipeline_Submit(pipeline, frame, frame_data);
+}
+
+CVI_S32 CVI_TDL_APP_Pipeline_Flush(cvitdl_pipeline_t *pipeline) {
+  return _Pipeline_Flush(pipeline);
+}
+
+CVI_S32 CVI_TDL_APP_Pipeline_Destroy(cvitdl_pipeline_t *pipeline) {
+  return _Pipeline_Destroy(pipeline);
+}
+
 // Irregular
 CVI_S32 CVI_TDL_APP_PersonVehicleCaptureIrregular_Run(const cvitdl_app_handle_t handle,
                                                       VIDEO_FRAME_INFO_S *frame) {
@@ -157,6 +157,10 @@ float get_score(cvtdl_face_info_t *face_info, uint32_t img_w, uint32_t img_h, bo
 void face_quality_assessment(VIDEO_FRAME_INFO_S *frame, cvtdl_face_t *face, bool *skip,
                              quality_assessment_e qa_method, float thr_laplacian) {
   /* NOTE: Make sure the coordinate is recovered by RetinaFace */
+  bool map_frame = (qa_method == LAPLACIAN || qa_method == MIX) && face->size > 0;
+  if (map_frame) {
+    CVI_TDL_BeginFrameMapping(frame);
+  }
   for (uint32_t i = 0; i < face->size; i++) {
     if (skip != NULL && skip[i]) {
       face->info[i].pose_score = 0;
@@ -200,6 +204,9 @@ void face_quality_assessment(VIDEO_FRAME_INFO_S *frame, cvtdl_face_t *face, bool
       }
     }
   }
+  if (map_frame) {
+    CVI_TDL_EndFrameMapping(frame);
+  }
   return;
 }
 
@@ -33,39 +33,36 @@ CVI_S32 _FaceCapture_QuickSetUp(cvitdl_handle_t tdl_handle, face_capture_t *face
     LOGE("invalid face recognition model id %d", fr_model_id);
     return CVI_FAILURE;
   }
-  CVI_S32 ret = CVI_SUCCESS;
-  ret |= CVI_TDL_OpenModel(tdl_handle, fd_model_id, fd_model_path);
-  if (ret != CVI_SUCCESS) {
-    printf("fd model %s open failed\n", fd_model_path);
-    return CVI_FAILURE;
-  }
+  CVI_TDL_SUPPORTED_MODEL_E flmodel =
+      CVI_TDL_SUPPORTED_MODEL_FACELANDMARKERDET2;  // CVI_TDL_SUPPORTED_MODEL_LANDMARK_DET3;
+  // open all models concurrently
+  cvtdl_model_file_t models[5];
+  uint32_t num_models = 0;
+  models[num_models].model_id = (CVI_TDL_SUPPORTED_MODEL_E)fd_model_id;
+  models[num_models++].filepath = fd_model_path;
   if (fr_model_path != NULL && strlen(fr_model_path) > 1) {
-    ret |= CVI_TDL_OpenModel(tdl_handle, fr_model_id, fr_model_path);
-    if (ret == CVI_SUCCESS) {
-      printf("fr model %s open sucessfull\n", fr_model_path);
-    }
+    models[num_models].model_id = (CVI_TDL_SUPPORTED_MODEL_E)fr_model_id;
+    models[num_models++].filepath = fr_model_path;
   }
-
   if (fa_model_path != NULL) {
-    ret |= CVI_TDL_OpenModel(tdl_handle, CVI_TDL_SUPPORTED_MODEL_FACEATTRIBUTE_CLS, fa_model_path);
-    if (ret == CVI_SUCCESS) {
-      printf("fa model %s open sucessfull\n", fa_model_path);
-    }
+    models[num_models].model_id = CVI_TDL_SUPPORTED_MODEL_FACEATTRIBUTE_CLS;
+    models[num_models++].filepath = fa_model_path;
   }
-
   if (fq_model_path != NULL) {
-    ret |= CVI_TDL_OpenModel(tdl_handle, CVI_TDL_SUPPORTED_MODEL_FACEQUALITY, fq_model_path);
+    models[num_models].model_id = CVI_TDL_SUPPORTED_MODEL_FACEQUALITY;
+    models[num_models++].filepath = fq_model_path;
   }
   if (fl_model_path != NULL) {
-    CVI_TDL_SUPPORTED_MODEL_E flmodel =
-        CVI_TDL_SUPPORTED_MODEL_FACELANDMARKERDET2;  // CVI_TDL_SUPPORTED_MODEL_LANDMARK_DET3;
-    ret |= CVI_TDL_OpenModel(tdl_handle, flmodel, fl_model_path);
-    if (ret == CVI_SUCCESS) {
-      face_cpt_info->fl_model = flmodel;
-    } else {
-      printf("open landmark failed,ret:%d\n", ret);
-      return ret;
-    }
+    models[num_models].model_id = flmodel;
+    models[num_models++].filepath = fl_model_path;
+  }
+  CVI_S32 ret = CVI_TDL_OpenModels(tdl_handle, models, num_models, false);
+  if (ret != CVI_SUCCESS) {
+    printf("open models failed,ret:%d\n", ret);
+    return ret;
+  }
+  if (fl_model_path != NULL) {
+    face_cpt_info->fl_model = flmodel;
   }
 
   if (fd_model_id == CVI_TDL_SUPPORTED_MODEL_RETINAFACE) {
@@ -144,6 +141,7 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
   }
   LOGI("[APP::FaceCapture] RUN (MODE: %d, FR: %d, FQ: %d)\n", face_cpt_info->mode,
        face_cpt_info->fr_flag, face_cpt_info->use_FQNet);
+  CVI_TDL_MarkAppStage(tdl_handle, "start");
   CVI_S32 ret;
   ret = clean_data(face_cpt_info);
   if (ret != CVI_TDL_SUCCESS) {
@@ -204,11 +202,13 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
       return CVI_TDL_FAILURE;
     }
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "detect");
 
   if (face_cpt_info->fr_flag == 1) {
     if (CVI_SUCCESS != face_cpt_info->fr_inference(tdl_handle, frame, &face_cpt_info->last_faces)) {
       return CVI_TDL_FAILURE;
     }
+    CVI_TDL_MarkAppStage(tdl_handle, "recognize");
   }
 
   CVI_TDL_Service_FaceAngleForAll(&face_cpt_info->last_faces);
@@ -230,6 +230,7 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
     }
   }
   free(skip);
+  CVI_TDL_MarkAppStage(tdl_handle, "quality");
 
 #ifdef DEBUG_TRACK
   for (uint32_t j = 0; j < face_cpt_info->last_faces.size; j++) {
@@ -248,6 +249,7 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
   } else {
     CVI_TDL_DeepSORT_Face(tdl_handle, &face_cpt_info->last_faces, &face_cpt_info->last_trackers);
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "track");
   if (frame->stVFrame.u32Length[0] == 0) {
     LOGE("input frame turn into empty\n");
     return CVI_TDL_FAILURE;
@@ -305,6 +307,7 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
     LOGE("[APP::FaceCapture] capture face failed.\n");
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "update");
 
   /* update timestamp*/
   face_cpt_info->_time =
@@ -205,6 +205,7 @@ CVI_S32 _FacePetCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t
   }
   LOGI("[APP::FacePetCapture] RUN (MODE: %d, FR: %d, FQ: %d)\n", face_cpt_info->mode,
        face_cpt_info->fr_flag, face_cpt_info->use_FQNet);
+  CVI_TDL_MarkAppStage(tdl_handle, "start");
   CVI_S32 ret;
   ret = clean_data(face_cpt_info);
   if (ret != CVI_TDL_SUCCESS) {
@@ -236,11 +237,13 @@ CVI_S32 _FacePetCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t
   }
 
   assign_object(tdl_handle, face_cpt_info, &obj_meta);
+  CVI_TDL_MarkAppStage(tdl_handle, "detect");
 
   if (face_cpt_info->fr_flag == 1) {
     if (CVI_SUCCESS != face_cpt_info->fr_inference(tdl_handle, frame, &face_cpt_info->last_faces)) {
       return CVI_TDL_FAILURE;
     }
+    CVI_TDL_MarkAppStage(tdl_handle, "recognize");
   }
 
   for (uint32_t i = 0; i < face_cpt_info->last_faces.size; i++) {
@@ -269,6 +272,7 @@ CVI_S32 _FacePetCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t
   } else {
     CVI_TDL_DeepSORT_Face(tdl_handle, &face_cpt_info->last_faces, &face_cpt_info->last_trackers);
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "track");
 
   if (frame->stVFrame.u32Length[0] == 0) {
     LOGE("input frame turn into empty\n");
@@ -327,6 +331,7 @@ CVI_S32 _FacePetCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t
     LOGE("[APP::FacePetCapture] capture face failed.\n");
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "update");
 
   /* update timestamp*/
   face_cpt_info->_time =
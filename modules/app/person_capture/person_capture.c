@@ -207,10 +207,18 @@ CVI_S32 _PersonCapture_QuickSetUp(cvitdl_handle_t tdl_handle, person_capture_t *
     return CVI_TDL_FAILURE;
   }
 
-  ret |= CVI_TDL_OpenModel(tdl_handle, person_cpt_info->od_model_index, od_model_path);
+  // open the detector and the re-id model concurrently
+  cvtdl_model_file_t models[2];
+  uint32_t num_models = 0;
+  models[num_models].model_id = person_cpt_info->od_model_index;
+  models[num_models++].filepath = od_model_path;
+  if (reid_model_path != NULL) {
+    models[num_models].model_id = CVI_TDL_SUPPORTED_MODEL_OSNET;
+    models[num_models++].filepath = reid_model_path;
+  }
+  ret = CVI_TDL_OpenModels(tdl_handle, models, num_models, false);
   CVI_TDL_SetSkipVpssPreprocess(tdl_handle, person_cpt_info->od_model_index, false);
   if (reid_model_path != NULL) {
-    ret |= CVI_TDL_OpenModel(tdl_handle, CVI_TDL_SUPPORTED_MODEL_OSNET, reid_model_path);
     CVI_TDL_SetSkipVpssPreprocess(tdl_handle, CVI_TDL_SUPPORTED_MODEL_OSNET, false);
   }
   if (ret != CVI_TDL_SUCCESS) {
@@ -268,6 +276,7 @@ CVI_S32 _PersonCapture_Run(person_capture_t *person_cpt_info, const cvitdl_handl
   }
   printf("[APP::PersonCapture] RUN (MODE: %d, ReID: %d)\n", person_cpt_info->mode,
          person_cpt_info->enable_DeepSORT);
+  CVI_TDL_MarkAppStage(tdl_handle, "start");
   CVI_S32 ret;
   ret = clean_data(person_cpt_info);
   if (ret != CVI_TDL_SUCCESS) {
@@ -283,16 +292,19 @@ CVI_S32 _PersonCapture_Run(person_capture_t *person_cpt_info, const cvitdl_handl
                                            &person_cpt_info->last_objects)) {
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "detect");
   if (person_cpt_info->enable_DeepSORT) {
     if (CVI_TDL_SUCCESS != CVI_TDL_OSNet(tdl_handle, frame, &person_cpt_info->last_objects)) {
       return CVI_TDL_FAILURE;
     }
+    CVI_TDL_MarkAppStage(tdl_handle, "recognize");
   }
   if (CVI_TDL_SUCCESS != CVI_TDL_DeepSORT_Obj(tdl_handle, &person_cpt_info->last_objects,
                                               &person_cpt_info->last_trackers,
                                               person_cpt_info->enable_DeepSORT)) {
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "track");
 
   if (person_cpt_info->last_quality != NULL) {
     free(person_cpt_info->last_quality);
@@ -303,6 +315,7 @@ CVI_S32 _PersonCapture_Run(person_capture_t *person_cpt_info, const cvitdl_handl
   memset(person_cpt_info->last_quality, 0, sizeof(float) * person_cpt_info->last_objects.size);
 
   quality_assessment(person_cpt_info, person_cpt_info->last_quality);
+  CVI_TDL_MarkAppStage(tdl_handle, "quality");
 #if 0
   for (uint32_t i = 0; i < person_cpt_info->last_objects.size; i++) {
     cvtdl_bbox_t *bbox = &person_cpt_info->last_objects.info[i].bbox;
@@ -323,6 +336,7 @@ CVI_S32 _PersonCapture_Run(person_capture_t *person_cpt_info, const cvitdl_handl
     printf("[APP::PersonCapture] capture target failed.\n");
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "update");
 
 #if 0
   uint64_t mem_used;
@@ -666,16 +680,7 @@ static CVI_S32 capture_target(person_capture_t *person_cpt_info, VIDEO_FRAME_INF
   uint64_t mem_used;
   SUMMARY(person_cpt_info, &mem_used, false);
 
-  bool do_unmap = false;
-  size_t image_size =
-      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
-  if (frame->stVFrame.pu8VirAddr[0] == NULL) {
-    frame->stVFrame.pu8VirAddr[0] =
-        (CVI_U8 *)CVI_SYS_Mmap(frame->stVFrame.u64PhyAddr[0], image_size);
-    frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
-    frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
-    do_unmap = true;
-  }
+  CVI_TDL_BeginFrameMapping(frame);
 
   for (uint32_t j = 0; j < person_cpt_info->size; j++) {
     if (!(person_cpt_info->data[j]._capture)) {
@@ -705,12 +710,7 @@ static CVI_S32 capture_target(person_capture_t *person_cpt_info, VIDEO_FRAME_INF
 
     person_cpt_info->data[j]._capture = false;
   }
-  if (do_unmap) {
-    CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], image_size);
-    frame->stVFrame.pu8VirAddr[0] = NULL;
-    frame->stVFrame.pu8VirAddr[1] = NULL;
-    frame->stVFrame.pu8VirAddr[2] = NULL;
-  }
+  CVI_TDL_EndFrameMapping(frame);
   return CVI_TDL_SUCCESS;
 }
 
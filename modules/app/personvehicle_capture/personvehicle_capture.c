@@ -325,6 +325,7 @@ CVI_S32 _PersonVehicleCapture_Run(personvehicle_capture_t *personvehicle_cpt_inf
   }
   printf("[APP::PersonVehicleCapture] RUN (MODE: %d, ReID: %d)\n", personvehicle_cpt_info->mode,
          personvehicle_cpt_info->enable_DeepSORT);
+  CVI_TDL_MarkAppStage(tdl_handle, "start");
   CVI_S32 ret;
   ret = clean_data(personvehicle_cpt_info);
   if (ret != CVI_TDL_SUCCESS) {
@@ -343,12 +344,14 @@ CVI_S32 _PersonVehicleCapture_Run(personvehicle_capture_t *personvehicle_cpt_inf
   for (int i = 0; i < personvehicle_cpt_info->last_objects.size; i++) {
     personvehicle_cpt_info->last_objects.info[i].is_cross = false;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "detect");
 #ifndef NO_OPENCV
   if (personvehicle_cpt_info->enable_DeepSORT) {
     if (CVI_TDL_SUCCESS !=
         CVI_TDL_OSNet(tdl_handle, frame, &personvehicle_cpt_info->last_objects)) {
       return CVI_TDL_FAILURE;
     }
+    CVI_TDL_MarkAppStage(tdl_handle, "recognize");
   }
 #endif
   if (CVI_TDL_SUCCESS !=
@@ -358,6 +361,7 @@ CVI_S32 _PersonVehicleCapture_Run(personvehicle_capture_t *personvehicle_cpt_inf
           &personvehicle_cpt_info->rect)) {
     return CVI_TDL_FAILURE;
   }
+  CVI_TDL_MarkAppStage(tdl_handle, "track");
 #if 0
   uint64_t mem_used;
   SUMMARY(person_cpt_info, &mem_used, true);
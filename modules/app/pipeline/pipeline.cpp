@@ -0,0 +1,344 @@
+#include "pipeline.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cvi_tdl_log.hpp"
+
+namespace {
+
+struct Stage {
+  pipeline_stage_t desc;
+  std::string name;
+  std::vector<int> dependents;
+  // next frame an ordered stage may take
+  uint64_t next_frame = 0;
+  // vpss threads of the stage models, read when the workers start
+  std::vector<uint32_t> vpss_threads;
+};
+
+struct Frame {
+  uint64_t id;
+  VIDEO_FRAME_INFO_S *frame;
+  void *data;
+  // per stage, dependencies not done yet
+  std::vector<uint32_t> pending_deps;
+  std::vector<bool> failed;
+  uint32_t remaining;
+  CVI_S32 result = CVI_TDL_SUCCESS;
+};
+
+struct Task {
+  Frame *frame;
+  int stage;
+};
+
+// Stage running on a vpss thread and how many of its frames are in it.
+struct VpssOwner {
+  int stage;
+  uint32_t count;
+};
+
+}  // namespace
+
+/**
+ * Frames flow through a DAG of stages. A stage of a frame is ready once the stages it depends on
+ * are done for that frame, and for ordered stages once the previous frame has left the stage.
+ * Ready stages go to a queue drained by the workers, so independent branches of a frame and
+ * stages of consecutive frames overlap. A vpss thread of the handle is not thread safe, so a
+ * worker skips the tasks of stages whose vpss threads are held by another stage.
+ */
+struct cvitdl_pipeline {
+  cvitdl_handle_t tdl_handle;
+  pipeline_config_t cfg;
+  std::vector<Stage> stages;
+
+  std::mutex mutex;
+  std::condition_variable task_ready;
+  std::condition_variable frame_done;
+  std::deque<Task> tasks;
+  std::map<uint32_t, VpssOwner> busy_vpss;
+  // in submission order, freed once delivered
+  std::deque<std::unique_ptr<Frame>> frames;
+  uint64_t next_frame_id = 0;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+  // held while delivering frame_done callbacks so they keep submission order
+  std::mutex deliver_mutex;
+};
+
+static bool stageReady(cvitdl_pipeline_t *p, const Frame &frame, int stage) {
+  const Stage &s = p->stages[stage];
+  return frame.pending_deps[stage] == 0 &&
+         (s.desc.mode == PIPELINE_STAGE_CONCURRENT || s.next_frame == frame.id);
+}
+
+static Frame *findFrame(cvitdl_pipeline_t *p, uint64_t id) {
+  if (p->frames.empty() || id < p->frames.front()->id) {
+    return nullptr;
+  }
+  size_t index = id - p->frames.front()->id;
+  return index < p->frames.size() ? p->frames[index].get() : nullptr;
+}
+
+// Called with the lock held once a stage is done for a frame, run, skipped or failed.
+static void finishStage(cvitdl_pipeline_t *p, Frame *frame, int stage, CVI_S32 ret) {
+  if (ret != CVI_TDL_SUCCESS) {
+    frame->failed[stage] = true;
+    if (frame->result == CVI_TDL_SUCCESS) {
+      frame->result = ret;
+    }
+  }
+  Stage &s = p->stages[stage];
+  for (int dependent : s.dependents) {
+    if (frame->failed[stage]) {
+      frame->failed[dependent] = true;
+    }
+    if (--frame->pending_deps[dependent] == 0 && stageReady(p, *frame, dependent)) {
+      p->tasks.push_back({frame, dependent});
+    }
+  }
+  if (s.desc.mode == PIPELINE_STAGE_ORDERED) {
+    s.next_frame = frame->id + 1;
+    Frame *next = findFrame(p, s.next_frame);
+    if (next != nullptr && stageReady(p, *next, stage)) {
+      p->tasks.push_back({next, stage});
+    }
+  }
+  frame->remaining--;
+  p->task_ready.notify_all();
+}
+
+static bool shouldRun(const Stage &s, const Frame &frame) {
+  if (s.desc.interval > 1 && frame.id % s.desc.interval != 0) {
+    return false;
+  }
+  return s.desc.skip == nullptr || !s.desc.skip(frame.id, frame.data, s.desc.user_data);
+}
+
+static void deliverFrames(cvitdl_pipeline_t *p) {
+  std::lock_guard<std::mutex> deliver_lock(p->deliver_mutex);
+  while (true) {
+    Frame *frame;
+    {
+      std::lock_guard<std::mutex> lock(p->mutex);
+      if (p->frames.empty() || p->frames.front()->remaining != 0) {
+        return;
+      }
+      frame = p->frames.front().get();
+    }
+    if (p->cfg.frame_done != nullptr) {
+      p->cfg.frame_done(frame->id, frame->frame, frame->data, frame->result, p->cfg.user_data);
+    }
+    // Popped after the callback, so Flush returns only once every callback has run.
+    std::lock_guard<std::mutex> lock(p->mutex);
+    p->frames.pop_front();
+    p->frame_done.notify_all();
+  }
+}
+
+// Frames of a concurrent stage may share its vpss threads, they rely on the instances of the
+// model, see CVI_TDL_SetModelInstances.
+static bool vpssFree(cvitdl_pipeline_t *p, int stage) {
+  for (uint32_t thread : p->stages[stage].vpss_threads) {
+    auto it = p->busy_vpss.find(thread);
+    if (it != p->busy_vpss.end() && it->second.stage != stage) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::deque<Task>::iterator nextTask(cvitdl_pipeline_t *p) {
+  return std::find_if(p->tasks.begin(), p->tasks.end(),
+                      [p](const Task &task) { return vpssFree(p, task.stage); });
+}
+
+static void holdVpss(cvitdl_pipeline_t *p, int stage) {
+  for (uint32_t thread : p->stages[stage].vpss_threads) {
+    VpssOwner &owner = p->busy_vpss.emplace(thread, VpssOwner{stage, 0}).first->second;
+    owner.count++;
+  }
+}
+
+static void releaseVpss(cvitdl_pipeline_t *p, int stage) {
+  for (uint32_t thread : p->stages[stage].vpss_threads) {
+    auto it = p->busy_vpss.find(thread);
+    if (--it->second.count == 0) {
+      p->busy_vpss.erase(it);
+    }
+  }
+}
+
+static void workerLoop(cvitdl_pipeline_t *p) {
+  std::unique_lock<std::mutex> lock(p->mutex);
+  while (true) {
+    std::deque<Task>::iterator it;
+    p->task_ready.wait(lock, [p, &it] {
+      it = nextTask(p);
+      return it != p->tasks.end() || (p->stopping && p->tasks.empty());
+    });
+    if (it == p->tasks.end()) {
+      return;
+    }
+    Task task = *it;
+    p->tasks.erase(it);
+    holdVpss(p, task.stage);
+    Frame *frame = task.frame;
+    const Stage &stage = p->stages[task.stage];
+    bool failed = frame->failed[task.stage];
+    lock.unlock();
+
+    CVI_S32 ret = CVI_TDL_SUCCESS;
+    if (!failed && shouldRun(stage, *frame)) {
+      ret = stage.desc.func(p->tdl_handle, frame->frame, frame->data, stage.desc.user_data);
+      if (ret != CVI_TDL_SUCCESS) {
+        LOGW("pipeline stage %s failed on frame %lu, ret: %d\n", stage.name.c_str(),
+             (unsigned long)frame->id, ret);
+      }
+    }
+
+    lock.lock();
+    releaseVpss(p, task.stage);
+    finishStage(p, frame, task.stage, ret);
+    bool frame_finished = frame->remaining == 0;
+    if (frame_finished) {
+      lock.unlock();
+      deliverFrames(p);
+      lock.lock();
+    }
+  }
+}
+
+CVI_S32 _Pipeline_GetDefaultConfig(pipeline_config_t *cfg) {
+  cfg->num_workers = 2;
+  cfg->max_frames_in_flight = 2;
+  cfg->frame_done = NULL;
+  cfg->user_data = NULL;
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 _Pipeline_Create(cvitdl_handle_t tdl_handle, const pipeline_config_t *cfg,
+                         cvitdl_pipeline_t **pipeline) {
+  if (cfg == NULL || pipeline == NULL || cfg->num_workers == 0 ||
+      cfg->max_frames_in_flight == 0) {
+    LOGE("invalid pipeline config\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_pipeline_t *p = new cvitdl_pipeline_t;
+  p->tdl_handle = tdl_handle;
+  p->cfg = *cfg;
+  *pipeline = p;
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 _Pipeline_AddStage(cvitdl_pipeline_t *pipeline, const pipeline_stage_t *stage,
+                           int *stage_id) {
+  if (pipeline == NULL || stage == NULL || stage->func == NULL ||
+      stage->num_deps > PIPELINE_MAX_STAGE_DEPS || stage->num_models > PIPELINE_MAX_STAGE_MODELS) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::lock_guard<std::mutex> lock(pipeline->mutex);
+  if (pipeline->next_frame_id != 0) {
+    LOGE("pipeline stages can't be added after frames are submitted\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  int id = (int)pipeline->stages.size();
+  for (uint32_t i = 0; i < stage->num_deps; i++) {
+    if (stage->deps[i] < 0 || stage->deps[i] >= id) {
+      LOGE("stage %s depends on unknown stage %d\n", stage->name ? stage->name : "",
+           stage->deps[i]);
+      return CVI_TDL_ERR_INVALID_ARGS;
+    }
+  }
+  Stage s;
+  s.desc = *stage;
+  s.name = stage->name != NULL ? stage->name : std::to_string(id);
+  pipeline->stages.push_back(s);
+  for (uint32_t i = 0; i < stage->num_deps; i++) {
+    pipeline->stages[stage->deps[i]].dependents.push_back(id);
+  }
+  if (stage_id != NULL) {
+    *stage_id = id;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 _Pipeline_Submit(cvitdl_pipeline_t *pipeline, VIDEO_FRAME_INFO_S *frame,
+                         void *frame_data) {
+  if (pipeline == NULL || pipeline->stages.empty()) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::unique_lock<std::mutex> lock(pipeline->mutex);
+  if (pipeline->workers.empty()) {
+    for (Stage &s : pipeline->stages) {
+      for (uint32_t i = 0; i < s.desc.num_models; i++) {
+        uint32_t thread = 0;
+        CVI_TDL_GetVpssThread(pipeline->tdl_handle, s.desc.models[i], &thread);
+        if (std::find(s.vpss_threads.begin(), s.vpss_threads.end(), thread) ==
+            s.vpss_threads.end()) {
+          s.vpss_threads.push_back(thread);
+        }
+      }
+    }
+    for (uint32_t i = 0; i < pipeline->cfg.num_workers; i++) {
+      pipeline->workers.emplace_back(workerLoop, pipeline);
+    }
+  }
+  pipeline->frame_done.wait(lock, [pipeline] {
+    return pipeline->frames.size() < pipeline->cfg.max_frames_in_flight;
+  });
+
+  size_t num_stages = pipeline->stages.size();
+  std::unique_ptr<Frame> f(new Frame);
+  f->id = pipeline->next_frame_id++;
+  f->frame = frame;
+  f->data = frame_data;
+  f->pending_deps.resize(num_stages);
+  f->failed.assign(num_stages, false);
+  f->remaining = num_stages;
+  for (size_t i = 0; i < num_stages; i++) {
+    f->pending_deps[i] = pipeline->stages[i].desc.num_deps;
+  }
+  for (size_t i = 0; i < num_stages; i++) {
+    if (stageReady(pipeline, *f, i)) {
+      pipeline->tasks.push_back({f.get(), (int)i});
+    }
+  }
+  pipeline->frames.push_back(std::move(f));
+  pipeline->task_ready.notify_all();
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 _Pipeline_Flush(cvitdl_pipeline_t *pipeline) {
+  if (pipeline == NULL) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::unique_lock<std::mutex> lock(pipeline->mutex);
+  pipeline->frame_done.wait(lock, [pipeline] { return pipeline->frames.empty(); });
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 _Pipeline_Destroy(cvitdl_pipeline_t *pipeline) {
+  if (pipeline == NULL) {
+    return CVI_TDL_SUCCESS;
+  }
+  _Pipeline_Flush(pipeline);
+  {
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    pipeline->stopping = true;
+  }
+  pipeline->task_ready.notify_all();
+  for (auto &worker : pipeline->workers) {
+    worker.join();
+  }
+  delete pipeline;
+  return CVI_TDL_SUCCESS;
+}
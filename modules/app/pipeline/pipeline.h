@@ -0,0 +1,30 @@
+#ifndef _CVI_TDL_APP_PIPELINE_H_
+#define _CVI_TDL_APP_PIPELINE_H_
+
+#include "core/cvi_tdl_core.h"
+#include "cvi_tdl_app/pipeline/pipeline_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+CVI_S32 _Pipeline_GetDefaultConfig(pipeline_config_t *cfg);
+
+CVI_S32 _Pipeline_Create(cvitdl_handle_t tdl_handle, const pipeline_config_t *cfg,
+                         cvitdl_pipeline_t **pipeline);
+
+CVI_S32 _Pipeline_AddStage(cvitdl_pipeline_t *pipeline, const pipeline_stage_t *stage,
+                           int *stage_id);
+
+CVI_S32 _Pipeline_Submit(cvitdl_pipeline_t *pipeline, VIDEO_FRAME_INFO_S *frame,
+                         void *frame_data);
+
+CVI_S32 _Pipeline_Flush(cvitdl_pipeline_t *pipeline);
+
+CVI_S32 _Pipeline_Destroy(cvitdl_pipeline_t *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // End of _CVI_TDL_APP_PIPELINE_H_
@@ -1,4 +1,6 @@
 #include "core.hpp"
+#include <string.h>
+#include <algorithm>
 #include <stdexcept>
 #include "core/utils/vpss_helper.h"
 #include "demangle.hpp"
@@ -54,126 +56,97 @@ void Core::setraw(bool raw) { this->raw = raw; }
 #endif
 
 int Core::modelOpen(const char *filepath) {
-  if (!mp_mi) {
-    LOGE("config not set\n");
-    return CVI_TDL_ERR_OPEN_MODEL;
-  }
-
-  if (mp_mi->handle != nullptr) {
-    LOGE("failed to open model: \"%s\" has already opened.\n", filepath);
-    return CVI_TDL_FAILURE;
-  }
-  m_model_file = filepath;
-  CLOSE_MODEL_IF_TPU_FAILED(CVI_NN_RegisterModel(filepath, &mp_mi->handle),
-                            "CVI_NN_RegisterModel failed");
-
-  CVI_NN_SetConfig(mp_mi->handle, OPTION_OUTPUT_ALL_TENSORS,
-                   static_cast<int>(mp_mi->conf.debug_mode));
-
-  CLOSE_MODEL_IF_TPU_FAILED(
-      CVI_NN_GetInputOutputTensors(mp_mi->handle, &mp_mi->in.tensors, &mp_mi->in.num,
-                                   &mp_mi->out.tensors, &mp_mi->out.num),
-      "CVI_NN_GetINputsOutputs failed");
+  return openBackend(std::unique_ptr<InferenceBackend>(
+                         new CviruntimeBackend(filepath, mp_mi->conf.debug_mode)),
+                     filepath);
+}
 
-  setupTensorInfo(mp_mi->in.tensors, mp_mi->in.num, &m_input_tensor_info);
-  setupTensorInfo(mp_mi->out.tensors, mp_mi->out.num, &m_output_tensor_info);
+int Core::modelOpen(const int8_t *buf, uint32_t size) {
+  return openBackend(std::unique_ptr<InferenceBackend>(
+                         new CviruntimeBackend(buf, size, mp_mi->conf.debug_mode)),
+                     nullptr);
+}
 
-  CVI_TENSOR *input =
-      CVI_NN_GetTensorByName(CVI_NN_DEFAULT_TENSOR, mp_mi->in.tensors, mp_mi->in.num);
-  // Assigning default values.
-  bool use_quantize_scale;
-  for (uint32_t i = 0; i < (uint32_t)mp_mi->in.num; i++) {
-    CVI_TENSOR *tensor = mp_mi->in.tensors + i;
-    float quant_scale = CVI_NN_TensorQuantScale(tensor);
-    use_quantize_scale = quant_scale != 0 || quant_scale != 1.0;
+int Core::modelOpenReplay(const char *record_path) {
+  return openBackend(std::unique_ptr<InferenceBackend>(new ReplayBackend(record_path)),
+                     record_path);
+}
 
-    if (((mp_mi->in.tensors[i].shape.dim[3] % 64) != 0)) {
-      aligned_input = false;
-    }
+int Core::openBackend(std::unique_ptr<InferenceBackend> backend, const char *model_file) {
+  if (m_backend != nullptr) {
+    LOGE("failed to open model: \"%s\", \"%s\" has already opened.\n",
+         model_file != nullptr ? model_file : "buffer", m_model_file.c_str());
+    return CVI_TDL_FAILURE;
   }
-
-  if (CVI_MEM_SYSTEM == getInputMemType()) {
-    aligned_input = false;
+  if (model_file != nullptr) {
+    m_model_file = model_file;
   }
-
-  if (true == aligned_input) {
-    for (int32_t i = 0; i < mp_mi->in.num; i++)
-      CLOSE_MODEL_IF_TPU_FAILED(CVI_NN_SetTensorPhysicalAddr(&mp_mi->in.tensors[i], (uint64_t)0),
-                                "CVI_NN_SetTensorPhysicalAddr failed");
-    LOGI("parse model with aligned input tensor\n");
+  int ret = backend->open(&mp_mi->in, &mp_mi->out);
+  if (ret != CVI_TDL_SUCCESS) {
+    return ret;
   }
+  m_backend = std::move(backend);
+  return setupModel();
+}
 
-  CLOSE_MODEL_IF_FAILED(onModelOpened(), "return failed in onModelOpened");
-
-  m_vpss_config.clear();
-  for (uint32_t i = 0; i < (uint32_t)mp_mi->in.num; i++) {
-    if (use_quantize_scale) {
-      CVI_TENSOR *tensor = mp_mi->in.tensors + i;
-      float quant_scale = CVI_NN_TensorQuantScale(tensor);
-      for (uint32_t j = 0; j < 3; j++) {
-        m_preprocess_param[i].factor[j] *= quant_scale;
-        m_preprocess_param[i].mean[j] *= quant_scale;
-      }
-      // FIXME: Behavior will changed in 1822.
-      float factor_limit = 8191.f / 8192;
-      for (uint32_t j = 0; j < 3; j++) {
-        if (m_preprocess_param[i].factor[j] > factor_limit) {
-          LOGW("factor[%d] is bigger than limit: %f\n", i, m_preprocess_param[i].factor[j]);
-          m_preprocess_param[i].factor[j] = factor_limit;
-        }
-      }
-    }
-    VPSSConfig vcfg;
-    int32_t width, height;
-    // FIXME: Future support for nhwc input. Currently disabled.
-    if (false) {
-      width = input->shape.dim[2];
-      height = input->shape.dim[1];
-      vcfg.frame_type = CVI_FRAME_PACKAGE;
-    } else {
-      CVI_TENSOR *input = &(mp_mi->in.tensors[i]);
-      width = input->shape.dim[3];
-      height = input->shape.dim[2];
-      vcfg.frame_type = CVI_FRAME_PLANAR;
-    }
-    vcfg.rescale_type = m_preprocess_param[i].rescale_type;
-    vcfg.crop_attr.bEnable = m_preprocess_param[i].use_crop;
-    bool pad_reverse = false;
-    VPSS_CHN_SQ_HELPER(&vcfg.chn_attr, width, height, m_preprocess_param[i].format,
-                       m_preprocess_param[i].factor, m_preprocess_param[i].mean, pad_reverse);
-    if (!m_preprocess_param[i].keep_aspect_ratio) {
-      vcfg.chn_attr.stAspectRatio.enMode = ASPECT_RATIO_NONE;
-    }
-    vcfg.chn_coeff = m_preprocess_param[i].resize_method;
-    m_vpss_config.emplace_back(vcfg);
+int Core::setTensorRecord(const char *record_path) {
+  m_record_fp.reset();
+  if (record_path == nullptr) {
+    return CVI_TDL_SUCCESS;
+  }
+  m_record_fp.reset(fopen(record_path, "ab"));
+  if (!m_record_fp) {
+    LOGE("cannot open tensor record: %s\n", record_path);
+    return CVI_TDL_ERR_INVALID_ARGS;
   }
   return CVI_TDL_SUCCESS;
 }
 
-int Core::modelOpen(const int8_t *buf, uint32_t size) {
-  if (!mp_mi) {
-    LOGE("config not set\n");
-    return CVI_TDL_ERR_OPEN_MODEL;
+static void record_tensors(CVI_TENSOR *tensors, int32_t num, bool with_data,
+                           std::vector<TensorRecord> *records) {
+  records->resize(num);
+  for (int32_t i = 0; i < num; i++) {
+    CVI_TENSOR *tensor = tensors + i;
+    TensorRecord &record = (*records)[i];
+    CVI_SHAPE shape = CVI_NN_TensorShape(tensor);
+    record.name = CVI_NN_TensorName(tensor);
+    record.fmt = tensor->fmt;
+    record.dims.assign(shape.dim, shape.dim + shape.dim_size);
+    record.qscale = CVI_NN_TensorQuantScale(tensor);
+    record.count = CVI_NN_TensorCount(tensor);
+    record.mem_size = CVI_NN_TensorSize(tensor);
+    if (with_data) {
+      const uint8_t *data = static_cast<const uint8_t *>(CVI_NN_TensorPtr(tensor));
+      record.data.assign(data, data + record.mem_size);
+    } else {
+      record.data.clear();
+    }
   }
+}
 
-  if (mp_mi->handle != nullptr) {
-    LOGE("failed to open model from buffer: %d \n", (int)*buf);
-    return CVI_TDL_FAILURE;
+void Core::recordFrame() {
+  TensorRecordFrame frame;
+  record_tensors(mp_mi->in.tensors, mp_mi->in.num, false, &frame.inputs);
+  record_tensors(mp_mi->out.tensors, mp_mi->out.num, true, &frame.outputs);
+  if (write_tensor_record(m_record_fp.get(), frame) != CVI_TDL_SUCCESS) {
+    m_record_fp.reset();
   }
+}
 
-  CLOSE_MODEL_IF_TPU_FAILED(CVI_NN_RegisterModelFromBuffer(buf, size, &mp_mi->handle),
-                            "CVI_NN_RegisterModelFromBuffer failed");
-
-  CVI_NN_SetConfig(mp_mi->handle, OPTION_OUTPUT_ALL_TENSORS,
-                   static_cast<int>(mp_mi->conf.debug_mode));
-
-  CLOSE_MODEL_IF_TPU_FAILED(
-      CVI_NN_GetInputOutputTensors(mp_mi->handle, &mp_mi->in.tensors, &mp_mi->in.num,
-                                   &mp_mi->out.tensors, &mp_mi->out.num),
-      "CVI_NN_GetINputsOutputs failed");
-
+// Tensor info, input alignment and preprocessing of the tensors of an opened model.
+int Core::setupModel() {
+  m_input_tensor_info.clear();
+  m_output_tensor_info.clear();
   setupTensorInfo(mp_mi->in.tensors, mp_mi->in.num, &m_input_tensor_info);
   setupTensorInfo(mp_mi->out.tensors, mp_mi->out.num, &m_output_tensor_info);
+  m_input_tensor_list.clear();
+  m_output_tensor_list.clear();
+  for (const auto &kv : m_input_tensor_info) {
+    m_input_tensor_list.push_back(&kv.second);
+  }
+  for (const auto &kv : m_output_tensor_info) {
+    m_output_tensor_list.push_back(&kv.second);
+  }
 
   CVI_TENSOR *input =
       CVI_NN_GetTensorByName(CVI_NN_DEFAULT_TENSOR, mp_mi->in.tensors, mp_mi->in.num);
@@ -189,7 +162,7 @@ int Core::modelOpen(const int8_t *buf, uint32_t size) {
     }
   }
 
-  if (CVI_MEM_SYSTEM == getInputMemType()) {
+  if (CVI_MEM_SYSTEM == getInputMemType() || m_backend->modelHandle() == nullptr) {
     aligned_input = false;
   }
 
@@ -267,20 +240,24 @@ void Core::setupTensorInfo(CVI_TENSOR *tensor, int32_t num_tensors,
 int Core::modelClose() {
   int ret = CVI_TDL_SUCCESS;
 
-  if (mp_mi->handle != nullptr) {
-    ret = CVI_NN_CleanupModel(mp_mi->handle);
-    if (ret != CVI_RC_SUCCESS) {  // NOLINT
-      LOGE("CVI_NN_CleanupModel failed: %s\n", get_tpu_error_msg(ret));
-      mp_mi->handle = nullptr;
-      onModelClosed();
-      return CVI_TDL_ERR_CLOSE_MODEL;
-    }
-    mp_mi->handle = nullptr;
+  if (m_backend != nullptr) {
+    ret = m_backend->close();
+    m_backend.reset();
+    mp_mi->in = CvimodelPair();
+    mp_mi->out = CvimodelPair();
   }
   onModelClosed();
   return ret;
 }
 
+int Core::warmUp() {
+  if (m_backend == nullptr) {
+    LOGE("model is not opened\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  return m_backend->warmUp();
+}
+
 CVI_TENSOR *Core::getInputTensor(int idx) {
   if (idx >= mp_mi->in.num) {
     return NULL;
@@ -310,25 +287,37 @@ const TensorInfo &Core::getInputTensorInfo(const std::string &name) {
 }
 
 const TensorInfo &Core::getOutputTensorInfo(size_t index) {
-  size_t cur = 0;
-  for (auto iter = m_output_tensor_info.begin(); iter != m_output_tensor_info.end(); iter++) {
-    if (cur == index) {
-      return iter->second;
-    }
-    cur++;
+  if (index >= m_output_tensor_list.size()) {
+    throw std::out_of_range("out of range");
   }
-  throw std::out_of_range("out of range");
+  return *m_output_tensor_list[index];
 }
 
 const TensorInfo &Core::getInputTensorInfo(size_t index) {
-  size_t cur = 0;
-  for (auto iter = m_input_tensor_info.begin(); iter != m_input_tensor_info.end(); iter++) {
-    if (cur == index) {
-      return iter->second;
-    }
-    cur++;
+  if (index >= m_input_tensor_list.size()) {
+    throw std::out_of_range("out of range");
   }
-  throw std::out_of_range("out of range");
+  return *m_input_tensor_list[index];
+}
+
+static TensorView make_tensor_view(const TensorInfo &info) {
+  TensorView view;
+  view.data = info.raw_pointer;
+  view.is_int8 = info.tensor_size == info.tensor_elem;
+  view.qscale = view.is_int8 ? info.qscale : 1.f;
+  for (size_t i = 0; i < 4 && i < info.shape.dim_size; i++) {
+    view.dims[i] = info.shape.dim[i];
+  }
+  view.batch_stride = info.shape.dim[0] > 0 ? info.tensor_elem / info.shape.dim[0] : 0;
+  return view;
+}
+
+TensorView Core::getOutputTensorView(const std::string &name) {
+  return make_tensor_view(getOutputTensorInfo(name));
+}
+
+TensorView Core::getOutputTensorView(size_t index) {
+  return make_tensor_view(getOutputTensorInfo(index));
 }
 
 size_t Core::getNumInputTensor() const { return static_cast<size_t>(mp_mi->in.num); }
@@ -422,7 +411,7 @@ int Core::getChnConfig(const uint32_t width, const uint32_t height, const uint32
   return CVI_TDL_SUCCESS;
 }
 
-bool Core::isInitialized() { return mp_mi->handle == nullptr ? false : true; }
+bool Core::isInitialized() { return m_backend != nullptr; }
 
 CVI_SHAPE Core::getInputShape(size_t index) { return getInputTensorInfo(index).shape; }
 
@@ -467,7 +456,7 @@ size_t Core::getInputTensorSize(const std::string &name) {
 int Core::vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame,
                          VPSSConfig &vpss_config) {
   int ret;
-  LOGI("to vpss preprocess,crop_enable:%d\n", (int)vpss_config.crop_attr.bEnable);
+  LOGD("to vpss preprocess,crop_enable:%d\n", (int)vpss_config.crop_attr.bEnable);
   if (!vpss_config.crop_attr.bEnable) {
     ret = mp_vpss_inst->sendFrame(srcFrame, &vpss_config.chn_attr, &vpss_config.chn_coeff, 1);
   } else {
@@ -504,7 +493,8 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
     LOGE("can only process one frame for aligninput,got frame_num:%d\n", int(frames.size()));
   }
 
-  if (mp_mi->conf.input_mem_type == CVI_MEM_DEVICE) {
+  // backends without a runtime handle don't read their inputs
+  if (mp_mi->conf.input_mem_type == CVI_MEM_DEVICE && m_backend->modelHandle() != nullptr) {
     if (m_skip_vpss_preprocess) {
       // skip vpss preprocess is true, just register frame directly.
       ret = registerFrame2Tensor(frames);
@@ -540,19 +530,9 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
   }
   model_timer_.TicToc("vpss");
   if (ret == CVI_TDL_SUCCESS) {
-    int rcret = CVI_NN_Forward(mp_mi->handle, mp_mi->in.tensors, mp_mi->in.num, mp_mi->out.tensors,
-                               mp_mi->out.num);
-
-    if (rcret == CVI_RC_SUCCESS) {
-      // save debuginfo
-      for (int32_t i = 0; i < mp_mi->in.num; i++) {
-        // save normalizer only if model needs vpss precprcossing
-        if (!m_skip_vpss_preprocess && mp_mi->conf.input_mem_type == CVI_MEM_DEVICE) {
-        }
-      }
-    } else {
-      LOGE("NN forward failed: %s\n", get_tpu_error_msg(rcret));
-      ret = CVI_TDL_ERR_INFERENCE;
+    ret = m_backend->forward();
+    if (ret == CVI_TDL_SUCCESS && m_record_fp) {
+      recordFrame();
     }
   }
   model_timer_.TicToc("tpu");
@@ -595,7 +575,7 @@ int Core::registerFrame2Tensor(std::vector<T> &frames) {
     if (aligned_input == true) {
       ret = CVI_NN_SetTensorPhysicalAddr(mp_mi->in.tensors + i, frame->stVFrame.u64PhyAddr[0]);
     } else {
-      ret = CVI_NN_FeedTensorWithFrames(mp_mi->handle, mp_mi->in.tensors,
+      ret = CVI_NN_FeedTensorWithFrames(m_backend->modelHandle(), mp_mi->in.tensors,
                                         m_vpss_config[0].frame_type, CVI_FMT_INT8, paddrs.size(),
                                         paddrs.data(), frame->stVFrame.u32Height,
                                         frame->stVFrame.u32Width, frame->stVFrame.u32Stride[0]);
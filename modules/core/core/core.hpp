@@ -10,6 +10,7 @@
 #include <vector>
 #include "cvi_comm.h"
 #include "cvi_tdl_log.hpp"
+#include "inference_backend.hpp"
 #include "profiler.hpp"
 #include "vpss_engine.hpp"
 #define DEFAULT_MODEL_THRESHOLD 0.5
@@ -22,14 +23,8 @@ struct CvimodelConfig {
   int input_mem_type = CVI_MEM_SYSTEM;
 };
 
-struct CvimodelPair {
-  CVI_TENSOR *tensors = nullptr;
-  int32_t num = 0;
-};
-
 struct CvimodelInfo {
   CvimodelConfig conf;
-  CVI_MODEL_HANDLE handle = nullptr;
   CvimodelPair in;
   CvimodelPair out;
 };
@@ -53,6 +48,20 @@ struct TensorInfo {
   }
   float qscale;
 };
+// Typed view of a tensor, resolved once in onModelOpened so decode loops index plain pointers.
+struct TensorView {
+  const void *data = nullptr;
+  bool is_int8 = false;
+  float qscale = 1.f;  // dequantization scale, 1 for float tensors
+  int32_t dims[4] = {0, 0, 0, 0};
+  size_t batch_stride = 0;  // elements between batch items
+
+  template <typename DataType>
+  const DataType *get(uint32_t batch = 0) const {
+    return static_cast<const DataType *>(data) + batch * batch_stride;
+  }
+};
+
 struct VPSSConfig {
   meta_rescale_type_e rescale_type = RESCALE_CENTER;
   CVI_FRAME_TYPE frame_type = CVI_FRAME_PLANAR;
@@ -71,9 +80,17 @@ class Core {
   virtual ~Core() = default;
   int modelOpen(const char *filepath);
   int modelOpen(const int8_t *buf, uint32_t size);
+  // Open outputs recorded by setTensorRecord() in place of a cvimodel, see ReplayBackend.
+  int modelOpenReplay(const char *record_path);
+  // Append the tensors of every following inference to record_path, nullptr stops recording.
+  int setTensorRecord(const char *record_path);
+  bool isRecording() const { return m_record_fp != nullptr; }
   int getInputMemType();
   const char *getModelFilePath() const { return m_model_file.c_str(); }
   int modelClose();
+  // Run one forward pass on the current input tensors, so one-time runtime costs are paid before
+  // the first frame. Outputs are discarded.
+  int warmUp();
   int setVpssTimeout(uint32_t timeout);
   const uint32_t getVpssTimeout() const { return m_vpss_timeout; }
   int setVpssEngine(VpssEngine *engine);
@@ -82,6 +99,7 @@ class Core {
   bool hasSkippedVpssPreprocess() const { return m_skip_vpss_preprocess; }
   int setVpssDepth(uint32_t in_index, uint32_t depth);
   int getVpssDepth(uint32_t in_index, uint32_t *depth);
+  size_t getNumVpssInputs() const { return m_vpss_config.size(); }
   virtual int getChnConfig(const uint32_t width, const uint32_t height, const uint32_t idx,
                            cvtdl_vpssconfig_t *chn_config);
   const float &getModelThreshold() { return m_model_threshold; }
@@ -100,6 +118,13 @@ class Core {
   virtual bool allowExportChannelAttribute() const { return false; }
 
   void set_perf_eval_interval(int interval) { model_timer_.Config("", interval); }
+  int get_perf_eval_interval() const { return model_timer_.SummaryInterval(); }
+  void enable_latency_stats(bool enable) { model_timer_.EnableStats(enable); }
+  bool latency_stats_enabled() const { return model_timer_.StatsEnabled(); }
+  bool merge_latency_stats(const char *stage, LatencyHistogram *hist) const {
+    return model_timer_.MergeStats(stage, hist);
+  }
+  void reset_latency_stats() { model_timer_.ResetStats(); }
   int vpssCropImage(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame, cvtdl_bbox_t bbox,
                     uint32_t rw, uint32_t rh, PIXEL_FORMAT_E enDstFormat,
                     VPSS_SCALE_COEF_E reize_mode = VPSS_SCALE_COEF_BICUBIC);
@@ -127,6 +152,9 @@ class Core {
   const TensorInfo &getOutputTensorInfo(size_t index);
   const TensorInfo &getInputTensorInfo(size_t index);
 
+  TensorView getOutputTensorView(const std::string &name);
+  TensorView getOutputTensorView(size_t index);
+
   size_t getNumInputTensor() const;
   size_t getNumOutputTensor() const;
 
@@ -193,11 +221,18 @@ class Core {
   template <typename T>
   inline int __attribute__((always_inline)) registerFrame2Tensor(std::vector<T> &frames);
 
+  // Open backend in place of the current one, model_file is nullptr for models from a buffer.
+  int openBackend(std::unique_ptr<InferenceBackend> backend, const char *model_file);
+  int setupModel();
   void setupTensorInfo(CVI_TENSOR *tensor, int32_t num_tensors,
                        std::map<std::string, TensorInfo> *tensor_info);
+  void recordFrame();
 
   std::map<std::string, TensorInfo> m_input_tensor_info;
   std::map<std::string, TensorInfo> m_output_tensor_info;
+  // Map entries in map order, the order of the index getters.
+  std::vector<const TensorInfo *> m_input_tensor_list;
+  std::vector<const TensorInfo *> m_output_tensor_list;
 
   // Preprocessing related control
   bool m_skip_vpss_preprocess = false;
@@ -205,8 +240,12 @@ class Core {
 
   // Cvimodel related
   std::unique_ptr<CvimodelInfo> mp_mi;
+  std::unique_ptr<InferenceBackend> m_backend;
 #ifndef CONFIG_ALIOS
   bool raw = false;
 #endif
+
+  // Tensors of every inference are appended here while set, whatever the backend.
+  std::unique_ptr<FILE, decltype(&fclose)> m_record_fp{nullptr, &fclose};
 };
 }  // namespace cvitdl
@@ -141,6 +141,14 @@ int Core::modelOpen(const char *filepath) {
   setupInputTensorInfo(net_info, mp_mi.get(), m_input_tensor_info);
   m_output_tensor_info.clear();
   setupOutputTensorInfo(net_info, mp_mi.get(), m_output_tensor_info);  // to update raw_pointer
+  m_input_tensor_list.clear();
+  m_output_tensor_list.clear();
+  for (const auto &kv : m_input_tensor_info) {
+    m_input_tensor_list.push_back(&kv.second);
+  }
+  for (const auto &kv : m_output_tensor_info) {
+    m_output_tensor_list.push_back(&kv.second);
+  }
 
   /* input preprocess param */
   m_vpss_config.clear();
@@ -321,25 +329,37 @@ const TensorInfo &Core::getInputTensorInfo(const std::string &name) {
 }
 
 const TensorInfo &Core::getOutputTensorInfo(size_t index) {
-  size_t cur = 0;
-  for (auto iter = m_output_tensor_info.begin(); iter != m_output_tensor_info.end(); iter++) {
-    if (cur == index) {
-      return iter->second;
-    }
-    cur++;
+  if (index >= m_output_tensor_list.size()) {
+    throw std::out_of_range("out of range");
   }
-  throw std::out_of_range("out of range");
+  return *m_output_tensor_list[index];
 }
 
 const TensorInfo &Core::getInputTensorInfo(size_t index) {
-  size_t cur = 0;
-  for (auto iter = m_input_tensor_info.begin(); iter != m_input_tensor_info.end(); iter++) {
-    if (cur == index) {
-      return iter->second;
-    }
-    cur++;
+  if (index >= m_input_tensor_list.size()) {
+    throw std::out_of_range("out of range");
+  }
+  return *m_input_tensor_list[index];
+}
+
+static TensorView make_tensor_view(const TensorInfo &info) {
+  TensorView view;
+  view.data = info.raw_pointer;
+  view.is_int8 = info.tensor_size == info.tensor_elem;
+  view.qscale = view.is_int8 ? info.qscale : 1.f;
+  for (size_t i = 0; i < 4 && i < info.shape.dim_size; i++) {
+    view.dims[i] = info.shape.dim[i];
   }
-  throw std::out_of_range("out of range");
+  view.batch_stride = info.shape.dim[0] > 0 ? info.tensor_elem / info.shape.dim[0] : 0;
+  return view;
+}
+
+TensorView Core::getOutputTensorView(const std::string &name) {
+  return make_tensor_view(getOutputTensorInfo(name));
+}
+
+TensorView Core::getOutputTensorView(size_t index) {
+  return make_tensor_view(getOutputTensorInfo(index));
 }
 
 size_t Core::getNumInputTensor() const { return static_cast<size_t>(mp_mi->in.num); }
@@ -434,6 +454,22 @@ int Core::getChnConfig(const uint32_t width, const uint32_t height, const uint32
   return 0;
 }
 
+int Core::warmUp() {
+  if (mp_mi->handle == nullptr) {
+    LOGE("model is not opened\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  bool ok =
+      bmrt_launch_tensor_ex(mp_mi->handle, mp_mi->net_names[0], mp_mi->in.tensors.data(),
+                            mp_mi->in.num, mp_mi->out.tensors.data(), mp_mi->out.num, true, false);
+  if (!ok) {
+    LOGE("bmrt_launch_tensor_ex failed\n");
+    return CVI_TDL_ERR_INFERENCE;
+  }
+  bm_thread_sync(bm_handle);
+  return CVI_TDL_SUCCESS;
+}
+
 bool Core::isInitialized() { return mp_mi->handle == nullptr ? false : true; }
 
 CVI_SHAPE Core::getInputShape(size_t index) { return getInputTensorInfo(index).shape; }
@@ -475,7 +511,7 @@ size_t Core::getInputTensorSize(const std::string &name) {
 int Core::vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame,
                          VPSSConfig &vpss_config) {
   int ret;
-  LOGI("to vpss preprocess,crop_enable:%d\n", (int)vpss_config.crop_attr.bEnable);
+  LOGD("to vpss preprocess,crop_enable:%d\n", (int)vpss_config.crop_attr.bEnable);
   if (!vpss_config.crop_attr.bEnable) {
     ret = mp_vpss_inst->sendFrame(srcFrame, &vpss_config.chn_attr, &vpss_config.chn_coeff, 1);
   } else {
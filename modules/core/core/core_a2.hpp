@@ -63,6 +63,19 @@ struct TensorInfo {
   }
   float qscale;
 };
+// Typed view of a tensor, resolved once in onModelOpened so decode loops index plain pointers.
+struct TensorView {
+  const void *data = nullptr;
+  bool is_int8 = false;
+  float qscale = 1.f;  // dequantization scale, 1 for float tensors
+  int32_t dims[4] = {0, 0, 0, 0};
+  size_t batch_stride = 0;  // elements between batch items
+
+  template <typename DataType>
+  const DataType *get(uint32_t batch = 0) const {
+    return static_cast<const DataType *>(data) + batch * batch_stride;
+  }
+};
 
 typedef enum {
   CVI_NN_PIXEL_RGB_PACKED = 0,
@@ -106,6 +119,9 @@ class Core {
 
   const char *getModelFilePath() const { return m_model_file.c_str(); }
   int modelClose();
+  // Run one forward pass on the current input tensors, so one-time runtime costs are paid before
+  // the first frame. Outputs are discarded.
+  int warmUp();
   int setVpssTimeout(uint32_t timeout);
   const uint32_t getVpssTimeout() const { return m_vpss_timeout; }
   int setVpssEngine(VpssEngine *engine);
@@ -114,6 +130,7 @@ class Core {
   bool hasSkippedVpssPreprocess() const { return m_skip_vpss_preprocess; }
   int setVpssDepth(uint32_t in_index, uint32_t depth);
   int getVpssDepth(uint32_t in_index, uint32_t *depth);
+  size_t getNumVpssInputs() const { return m_vpss_config.size(); }
   virtual int getChnConfig(const uint32_t width, const uint32_t height, const uint32_t idx,
                            cvtdl_vpssconfig_t *chn_config);
   const float &getModelThreshold() { return m_model_threshold; }
@@ -130,6 +147,13 @@ class Core {
   void setraw(bool raw);
   virtual int after_inference();
   void set_perf_eval_interval(int interval) { model_timer_.Config("", interval); }
+  int get_perf_eval_interval() const { return model_timer_.SummaryInterval(); }
+  void enable_latency_stats(bool enable) { model_timer_.EnableStats(enable); }
+  bool latency_stats_enabled() const { return model_timer_.StatsEnabled(); }
+  bool merge_latency_stats(const char *stage, LatencyHistogram *hist) const {
+    return model_timer_.MergeStats(stage, hist);
+  }
+  void reset_latency_stats() { model_timer_.ResetStats(); }
   int vpssCropImage(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame, cvtdl_bbox_t bbox,
                     uint32_t rw, uint32_t rh, PIXEL_FORMAT_E enDstFormat,
                     VPSS_SCALE_COEF_E reize_mode = VPSS_SCALE_COEF_BICUBIC);
@@ -157,6 +181,9 @@ class Core {
   const TensorInfo &getOutputTensorInfo(size_t index);
   const TensorInfo &getInputTensorInfo(size_t index);
 
+  TensorView getOutputTensorView(const std::string &name);
+  TensorView getOutputTensorView(size_t index);
+
   size_t getNumInputTensor() const;
   size_t getNumOutputTensor() const;
 
@@ -227,6 +254,9 @@ class Core {
 
   std::map<std::string, TensorInfo> m_input_tensor_info;
   std::map<std::string, TensorInfo> m_output_tensor_info;
+  // Map entries in map order, the order of the index getters.
+  std::vector<const TensorInfo *> m_input_tensor_list;
+  std::vector<const TensorInfo *> m_output_tensor_list;
 
   // Preprocessing related control
   bool m_skip_vpss_preprocess = false;
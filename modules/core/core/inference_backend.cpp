@@ -0,0 +1,127 @@
+#include "inference_backend.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+#include "error_msg.hpp"
+#include "model_cache.hpp"
+
+namespace cvitdl {
+
+CviruntimeBackend::CviruntimeBackend(const char *filepath, bool output_all_tensors)
+    : m_filepath(filepath), m_output_all_tensors(output_all_tensors) {}
+
+CviruntimeBackend::CviruntimeBackend(const int8_t *buf, uint32_t size, bool output_all_tensors)
+    : m_buf(buf), m_size(size), m_output_all_tensors(output_all_tensors) {}
+
+int CviruntimeBackend::open(CvimodelPair *in, CvimodelPair *out) {
+  CVI_RC ret = m_buf != nullptr
+                   ? ModelCache::instance().registerModel(m_buf, m_size, &m_handle)
+                   : ModelCache::instance().registerModel(m_filepath.c_str(), &m_handle);
+  m_buf = nullptr;
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("CVI_NN_RegisterModel failed: %s\n", get_tpu_error_msg(ret));
+    m_handle = nullptr;
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+
+  CVI_NN_SetConfig(m_handle, OPTION_OUTPUT_ALL_TENSORS, static_cast<int>(m_output_all_tensors));
+
+  ret = CVI_NN_GetInputOutputTensors(m_handle, &m_in.tensors, &m_in.num, &m_out.tensors,
+                                     &m_out.num);
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("CVI_NN_GetINputsOutputs failed: %s\n", get_tpu_error_msg(ret));
+    close();
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  *in = m_in;
+  *out = m_out;
+  return CVI_TDL_SUCCESS;
+}
+
+int CviruntimeBackend::close() {
+  if (m_handle == nullptr) {
+    return CVI_TDL_SUCCESS;
+  }
+  CVI_RC ret = ModelCache::instance().cleanupModel(m_handle);
+  m_handle = nullptr;
+  m_in = CvimodelPair();
+  m_out = CvimodelPair();
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("CVI_NN_CleanupModel failed: %s\n", get_tpu_error_msg(ret));
+    return CVI_TDL_ERR_CLOSE_MODEL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int CviruntimeBackend::forward() {
+  CVI_RC ret = CVI_NN_Forward(m_handle, m_in.tensors, m_in.num, m_out.tensors, m_out.num);
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("NN forward failed: %s\n", get_tpu_error_msg(ret));
+    return CVI_TDL_ERR_INFERENCE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int ReplayBackend::open(CvimodelPair *in, CvimodelPair *out) {
+  if (read_tensor_records(m_record_path.c_str(), &m_frames) != CVI_TDL_SUCCESS) {
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+
+  const TensorRecordFrame &first = m_frames.front();
+  m_num_inputs = first.inputs.size();
+  size_t num_tensors = m_num_inputs + first.outputs.size();
+  m_tensors.resize(num_tensors);
+  m_buffers.resize(num_tensors);
+  for (size_t i = 0; i < num_tensors; i++) {
+    const TensorRecord &record =
+        i < m_num_inputs ? first.inputs[i] : first.outputs[i - m_num_inputs];
+    if (record.dims.size() > CVI_DIM_MAX) {
+      LOGE("tensor record %s has %zu dims\n", record.name.c_str(), record.dims.size());
+      close();
+      return CVI_TDL_ERR_OPEN_MODEL;
+    }
+    CVI_TENSOR &tensor = m_tensors[i];
+    memset(&tensor, 0, sizeof(CVI_TENSOR));
+    tensor.name = const_cast<char *>(record.name.c_str());
+    tensor.shape.dim_size = record.dims.size();
+    std::copy(record.dims.begin(), record.dims.end(), tensor.shape.dim);
+    tensor.fmt = static_cast<CVI_FMT>(record.fmt);
+    tensor.count = record.count;
+    tensor.mem_size = record.mem_size;
+    tensor.qscale = record.qscale;
+    m_buffers[i].assign(record.mem_size, 0);
+    tensor.sys_mem = m_buffers[i].data();
+  }
+  in->tensors = m_tensors.data();
+  in->num = m_num_inputs;
+  out->tensors = m_tensors.data() + m_num_inputs;
+  out->num = num_tensors - m_num_inputs;
+  m_next_frame = 0;
+  LOGI("replay %zu frames from %s\n", m_frames.size(), m_record_path.c_str());
+  return CVI_TDL_SUCCESS;
+}
+
+int ReplayBackend::close() {
+  m_tensors.clear();
+  m_buffers.clear();
+  m_frames.clear();
+  return CVI_TDL_SUCCESS;
+}
+
+int ReplayBackend::forward() {
+  const TensorRecordFrame &frame = m_frames[m_next_frame];
+  m_next_frame = (m_next_frame + 1) % m_frames.size();
+  for (size_t i = 0; i < frame.outputs.size(); i++) {
+    const TensorRecord &record = frame.outputs[i];
+    if (record.data.size() != record.mem_size) {
+      LOGE("tensor record has no data for output: %s\n", record.name.c_str());
+      return CVI_TDL_ERR_INFERENCE;
+    }
+    memcpy(m_tensors[m_num_inputs + i].sys_mem, record.data.data(), record.mem_size);
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <cviruntime.h>
+#include <string>
+#include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "tensor_record.hpp"
+
+namespace cvitdl {
+
+struct CvimodelPair {
+  CVI_TENSOR *tensors = nullptr;
+  int32_t num = 0;
+};
+
+/**
+ * @brief Runs the network behind a Core.
+ *
+ * A backend owns the input and output tensors of the model. Core feeds the inputs and
+ * post-processing reads the outputs through the CVI_TENSOR accessors, so the backend decides
+ * where outputs come from without the models noticing.
+ */
+class InferenceBackend {
+ public:
+  virtual ~InferenceBackend() = default;
+
+  // Load the network and expose its tensors, they stay valid until close().
+  virtual int open(CvimodelPair *in, CvimodelPair *out) = 0;
+  virtual int close() = 0;
+  virtual int forward() = 0;
+  // Pay one-time costs before the first frame.
+  virtual int warmUp() { return forward(); }
+  // Runtime handle to feed frames into the inputs with, nullptr if the backend doesn't read its
+  // inputs. Core skips preprocessing then.
+  virtual CVI_MODEL_HANDLE modelHandle() const { return nullptr; }
+};
+
+// Runs a cvimodel through cviruntime. Weights are shared with other handles through ModelCache.
+class CviruntimeBackend : public InferenceBackend {
+ public:
+  CviruntimeBackend(const char *filepath, bool output_all_tensors);
+  // buf only has to live until open() returns.
+  CviruntimeBackend(const int8_t *buf, uint32_t size, bool output_all_tensors);
+
+  int open(CvimodelPair *in, CvimodelPair *out) override;
+  int close() override;
+  int forward() override;
+  CVI_MODEL_HANDLE modelHandle() const override { return m_handle; }
+
+ private:
+  std::string m_filepath;
+  const int8_t *m_buf = nullptr;
+  uint32_t m_size = 0;
+  bool m_output_all_tensors;
+  CVI_MODEL_HANDLE m_handle = nullptr;
+  CvimodelPair m_in;
+  CvimodelPair m_out;
+};
+
+// Serves the outputs of a tensor record frame by frame in a loop, without VPSS or the TPU.
+class ReplayBackend : public InferenceBackend {
+ public:
+  explicit ReplayBackend(const char *record_path) : m_record_path(record_path) {}
+
+  int open(CvimodelPair *in, CvimodelPair *out) override;
+  int close() override;
+  int forward() override;
+  // Doesn't advance the record, so the first frame still gets the first recorded outputs.
+  int warmUp() override { return CVI_TDL_SUCCESS; }
+
+ private:
+  std::string m_record_path;
+  std::vector<TensorRecordFrame> m_frames;
+  size_t m_next_frame = 0;
+  // recorded layouts standing in for the runtime's tensors
+  std::vector<CVI_TENSOR> m_tensors;
+  std::vector<std::vector<uint8_t>> m_buffers;
+  size_t m_num_inputs = 0;
+};
+
+}  // namespace cvitdl
@@ -0,0 +1,69 @@
+#include "instance_pool.hpp"
+
+namespace cvitdl {
+
+bool InstancePool::add(Core *instance) {
+  if (m_size == kMaxInstances) {
+    return false;
+  }
+  m_instances[m_size] = instance;
+  m_free.fetch_or(1u << m_size);
+  m_size++;
+  return true;
+}
+
+Core *InstancePool::acquire() {
+  while (true) {
+    uint32_t free = m_free.load(std::memory_order_relaxed);
+    while (free != 0) {
+      uint32_t bit = free & (~free + 1);
+      if (m_free.compare_exchange_weak(free, free & ~bit, std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return m_instances[__builtin_ctz(bit)];
+      }
+    }
+    // All instances are busy. Checking m_free under the lock pairs with release(), which notifies
+    // under the lock whenever someone waits, so a release can't slip in unnoticed.
+    m_waiters.fetch_add(1);
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_released.wait(lock, [this] { return m_free.load() != 0; });
+    }
+    m_waiters.fetch_sub(1);
+  }
+}
+
+Core *InstancePool::acquire(uint32_t index) {
+  const uint32_t bit = 1u << index;
+  while (true) {
+    uint32_t free = m_free.load(std::memory_order_relaxed);
+    while ((free & bit) != 0) {
+      if (m_free.compare_exchange_weak(free, free & ~bit, std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return m_instances[index];
+      }
+    }
+    m_waiters.fetch_add(1);
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_released.wait(lock, [this, bit] { return (m_free.load() & bit) != 0; });
+    }
+    m_waiters.fetch_sub(1);
+  }
+}
+
+void InstancePool::release(Core *instance) {
+  for (uint32_t i = 0; i < m_size; i++) {
+    if (m_instances[i] == instance) {
+      m_free.fetch_or(1u << i);
+      break;
+    }
+  }
+  // Waiters for a particular instance may not take this one, so wake them all.
+  if (m_waiters.load() != 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_released.notify_all();
+  }
+}
+
+}  // namespace cvitdl
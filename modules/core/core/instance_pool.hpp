@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace cvitdl {
+
+class Core;
+
+/**
+ * @brief Instances of one model that inference calls check out exclusively.
+ *
+ * acquire() claims a free slot with a compare-and-swap on a bitmask, so checkout never takes a
+ * lock while an instance is free. Only when every instance is busy does the caller sleep until
+ * one is released. Instances are added while no inference is running, the pool doesn't own them.
+ */
+class InstancePool {
+ public:
+  static constexpr uint32_t kMaxInstances = 32;
+
+  InstancePool() = default;
+  InstancePool(const InstancePool &) = delete;
+  InstancePool &operator=(const InstancePool &) = delete;
+
+  bool add(Core *instance);
+  uint32_t size() const { return m_size; }
+  Core *at(uint32_t index) const { return m_instances[index]; }
+
+  Core *acquire();
+  // Wait for the instance at index in particular.
+  Core *acquire(uint32_t index);
+  void release(Core *instance);
+
+ private:
+  Core *m_instances[kMaxInstances] = {nullptr};
+  uint32_t m_size = 0;
+  // Bit i is set while m_instances[i] is free.
+  std::atomic<uint32_t> m_free{0};
+  std::atomic<uint32_t> m_waiters{0};
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+};
+
+}  // namespace cvitdl
@@ -0,0 +1,111 @@
+#include "model_cache.hpp"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "cvi_tdl_log.hpp"
+#include "error_msg.hpp"
+
+namespace cvitdl {
+
+// Keys include size and modification time, so a model file replaced on disk is loaded anew.
+static std::string file_key(const char *filepath) {
+  char resolved[PATH_MAX];
+  std::string key = realpath(filepath, resolved) != nullptr ? resolved : filepath;
+  struct stat st;
+  if (stat(key.c_str(), &st) == 0) {
+    key += ":" + std::to_string((long long)st.st_size) + ":" +
+           std::to_string((long long)st.st_mtime);
+  }
+  return "file:" + key;
+}
+
+// FNV-1a of the model content.
+static std::string buffer_key(const int8_t *buf, uint32_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (uint32_t i = 0; i < size; i++) {
+    hash = (hash ^ (uint8_t)buf[i]) * 1099511628211ull;
+  }
+  return "buf:" + std::to_string(size) + ":" + std::to_string(hash);
+}
+
+ModelCache &ModelCache::instance() {
+  static ModelCache cache;
+  return cache;
+}
+
+CVI_RC ModelCache::registerModel(const char *filepath, CVI_MODEL_HANDLE *handle) {
+  return acquire(
+      file_key(filepath),
+      [filepath](CVI_MODEL_HANDLE *h) { return CVI_NN_RegisterModel(filepath, h); }, handle);
+}
+
+CVI_RC ModelCache::registerModel(const int8_t *buf, uint32_t size, CVI_MODEL_HANDLE *handle) {
+  return acquire(
+      buffer_key(buf, size),
+      [buf, size](CVI_MODEL_HANDLE *h) { return CVI_NN_RegisterModelFromBuffer(buf, size, h); },
+      handle);
+}
+
+CVI_RC ModelCache::acquire(const std::string &key,
+                           const std::function<CVI_RC(CVI_MODEL_HANDLE *)> &open,
+                           CVI_MODEL_HANDLE *handle) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto iter = m_entries.find(key);
+  while (iter != m_entries.end() && iter->second.loading) {
+    m_loaded.wait(lock);
+    iter = m_entries.find(key);
+  }
+
+  if (iter != m_entries.end()) {
+    CVI_RC ret = CVI_NN_CloneModel(iter->second.instances.front(), handle);
+    if (ret != CVI_RC_SUCCESS) {
+      LOGE("CVI_NN_CloneModel failed: %s\n", get_tpu_error_msg(ret));
+      return ret;
+    }
+    iter->second.instances.push_back(*handle);
+    m_keys[*handle] = key;
+    LOGI("share model weights: %s, instances: %zu\n", key.c_str(),
+         iter->second.instances.size());
+    return CVI_RC_SUCCESS;
+  }
+
+  // Register without the lock so different models load concurrently.
+  m_entries[key].loading = true;
+  lock.unlock();
+  CVI_RC ret = open(handle);
+  lock.lock();
+  iter = m_entries.find(key);
+  if (ret != CVI_RC_SUCCESS) {
+    m_entries.erase(iter);
+  } else {
+    iter->second.loading = false;
+    iter->second.instances.push_back(*handle);
+    m_keys[*handle] = key;
+  }
+  m_loaded.notify_all();
+  return ret;
+}
+
+CVI_RC ModelCache::cleanupModel(CVI_MODEL_HANDLE handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto key_iter = m_keys.find(handle);
+  if (key_iter != m_keys.end()) {
+    auto iter = m_entries.find(key_iter->second);
+    std::vector<CVI_MODEL_HANDLE> &instances = iter->second.instances;
+    for (size_t i = 0; i < instances.size(); i++) {
+      if (instances[i] == handle) {
+        instances.erase(instances.begin() + i);
+        break;
+      }
+    }
+    if (instances.empty()) {
+      m_entries.erase(iter);
+    }
+    m_keys.erase(key_iter);
+  }
+  // Cleaned up under the lock, so a concurrent open never clones an instance being released.
+  return CVI_NN_CleanupModel(handle);
+}
+
+}  // namespace cvitdl
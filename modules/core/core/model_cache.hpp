@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <cviruntime.h>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cvitdl {
+
+/**
+ * @brief Process-wide registry of opened cvimodels, so handles opening the same model share its
+ * weights and command buffers.
+ *
+ * The first open of a model registers it with the runtime. Later opens of the same file or buffer
+ * content clone a live instance, which shares the weights and only allocates its own activation
+ * buffers. The runtime reference counts the shared part, so instances can be closed in any order.
+ */
+class ModelCache {
+ public:
+  static ModelCache &instance();
+
+  CVI_RC registerModel(const char *filepath, CVI_MODEL_HANDLE *handle);
+  CVI_RC registerModel(const int8_t *buf, uint32_t size, CVI_MODEL_HANDLE *handle);
+  CVI_RC cleanupModel(CVI_MODEL_HANDLE handle);
+
+ private:
+  struct Entry {
+    std::vector<CVI_MODEL_HANDLE> instances;
+    // Set while the first instance is being registered, later opens wait for it.
+    bool loading = false;
+  };
+
+  CVI_RC acquire(const std::string &key, const std::function<CVI_RC(CVI_MODEL_HANDLE *)> &open,
+                 CVI_MODEL_HANDLE *handle);
+
+  std::mutex m_mutex;
+  std::condition_variable m_loaded;
+  std::map<std::string, Entry> m_entries;
+  std::map<CVI_MODEL_HANDLE, std::string> m_keys;
+};
+
+}  // namespace cvitdl
@@ -9,10 +9,14 @@
 namespace cvitdl {
 
 DetectionBase::DetectionBase() : Core(CVI_MEM_DEVICE) {
+  alg_param_.anchors = nullptr;
   alg_param_.anchor_len = 0;
+  alg_param_.strides = nullptr;
   alg_param_.stride_len = 0;
   alg_param_.cls = 80;
-  alg_param_.max_det = 100;
+  alg_param_.max_det = 0;
+  alg_param_.mapping_class = nullptr;
+  alg_param_.max_candidates = 0;
   setting_out_names_.clear();
 }
 int DetectionBase::vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame,
@@ -39,21 +43,19 @@ int DetectionBase::vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO
 }
 
 void DetectionBase::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  // copy first, alg_param may point at our own storage
+  std::vector<uint32_t> anchors(alg_param.anchors, alg_param.anchors + alg_param.anchor_len);
+  std::vector<uint32_t> strides(alg_param.strides, alg_param.strides + alg_param.stride_len);
+  anchor_storage_.swap(anchors);
+  stride_storage_.swap(strides);
+
+  alg_param_.anchors = anchor_storage_.data();
   alg_param_.anchor_len = alg_param.anchor_len;
+  alg_param_.strides = stride_storage_.data();
   alg_param_.stride_len = alg_param.stride_len;
   alg_param_.cls = alg_param.cls;
-
-  uint32_t *anchors = new uint32_t[alg_param.anchor_len];
-  for (int i = 0; i < alg_param.anchor_len; i++) {
-    anchors[i] = alg_param.anchors[i];
-  }
-  alg_param_.anchors = anchors;
-
-  uint32_t *strides = new uint32_t[alg_param.stride_len];
-  for (int i = 0; i < alg_param.stride_len; i++) {
-    strides[i] = alg_param.strides[i];
-  }
-  alg_param_.strides = strides;
+  alg_param_.max_det = alg_param.max_det;
+  alg_param_.max_candidates = alg_param.max_candidates;
 }
 
 void DetectionBase::set_out_names(const std::vector<std::string> &names) {
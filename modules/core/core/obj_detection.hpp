@@ -1,5 +1,6 @@
 #pragma once
 #include <bitset>
+#include <vector>
 #include "core/object/cvtdl_object_types.h"
 #include "core_internel.hpp"
 #define DEFAULT_MODEL_THRESHOLD 0.5
@@ -19,6 +20,7 @@ class DetectionBase : public Core {
   virtual const cvtdl_det_algo_param_t &get_algparam() { return alg_param_; }
   virtual void set_algparam(const cvtdl_det_algo_param_t &alg_param);
   virtual void set_out_names(const std::vector<std::string> &);
+  const std::vector<std::string> &get_out_names() const { return setting_out_names_; }
 
  private:
   virtual int onModelOpened() override {
@@ -33,6 +35,9 @@ class DetectionBase : public Core {
 
  protected:
   cvtdl_det_algo_param_t alg_param_;
+  // backing arrays of alg_param_.anchors and alg_param_.strides
+  std::vector<uint32_t> anchor_storage_;
+  std::vector<uint32_t> stride_storage_;
   std::vector<std::string> setting_out_names_;
 };
 }  // namespace cvitdl
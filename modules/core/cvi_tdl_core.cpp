@@ -52,6 +52,7 @@
 #include "face_detection/retina_face/scrfd_face.hpp"
 #include "face_detection/thermal_face_detection/thermal_face.hpp"
 #include "mask_classification/mask_classification.hpp"
+#include "ocr/ocr_detection/ocr_detection.hpp"
 #include "ocr/ocr_recognition/ocr_recognition.hpp"
 #include "osnet/osnet.hpp"
 #include "raw_image_classification/raw_image_classification.hpp"
@@ -70,7 +71,6 @@
 #include "license_plate_recognition/license_plate_recognition.hpp"
 #include "liveness/liveness.hpp"
 #include "mask_face_recognition/mask_face_recognition.hpp"
-#include "ocr/ocr_detection/ocr_detection.hpp"
 #include "opencv2/opencv.hpp"
 #include "smoke_classification/smoke_classification.hpp"
 #include "utils/image_utils.hpp"
@@ -84,10 +84,13 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include "utils/clip_postprocess.hpp"
 #include "utils/core_utils.hpp"
+#include "utils/crop_batch.hpp"
+#include "utils/mask_rle.hpp"
 #include "utils/token.hpp"
 #include "version.hpp"
 
@@ -129,30 +132,13 @@ static int createIVEHandleIfNeeded(cvitdl_context_t *ctx) {
   return CVI_SUCCESS;
 }
 
-static CVI_S32 initVPSSIfNeeded(cvitdl_context_t *ctx, CVI_TDL_SUPPORTED_MODEL_E model_id) {
-  bool skipped;
-  CVI_S32 ret = CVI_TDL_GetSkipVpssPreprocess(ctx, model_id, &skipped);
-  if (ret != CVI_TDL_SUCCESS) {
-    return ret;
-  }
-
-  // Don't create vpss if preprocessing is skipped.
-  if (skipped) {
-    return CVI_TDL_SUCCESS;
-  }
-
-  if (ctx->vec_vpss_engine.size() == 0) {
+// Initialize the vpss engine of the instance on first use, unless preprocessing is skipped.
+static CVI_S32 initVPSSIfNeeded(Core *instance) {
+  VpssEngine *engine = instance->get_vpss_instance();
+  if (instance->hasSkippedVpssPreprocess() || engine == nullptr || engine->isInitialized()) {
     return CVI_TDL_SUCCESS;
   }
-
-  uint32_t thread;
-  ret = CVI_TDL_GetVpssThread(ctx, model_id, &thread);
-  if (ret == CVI_TDL_SUCCESS) {
-    if (!ctx->vec_vpss_engine[thread]->isInitialized()) {
-      ret = ctx->vec_vpss_engine[thread]->init();
-    }
-  }
-  return ret;
+  return engine->init();
 }
 
 // Convenience macros for creator
@@ -184,7 +170,6 @@ unordered_map<int, CreatorFunc> MODEL_CREATORS = {
     {CVI_TDL_SUPPORTED_MODEL_SMOKECLASSIFICATION, CREATOR(SmokeClassification)},
     {CVI_TDL_SUPPORTED_MODEL_LPRNET_TW, CREATOR_P1(LicensePlateRecognition, LP_FORMAT, TAIWAN)},
     {CVI_TDL_SUPPORTED_MODEL_LPRNET_CN, CREATOR_P1(LicensePlateRecognition, LP_FORMAT, CHINA)},
-    {CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION, CREATOR(OCRDetection)},
     {CVI_TDL_SUPPORTED_MODEL_MASKFACERECOGNITION, CREATOR(MaskFaceRecognition)},
     {CVI_TDL_SUPPORTED_MODEL_YOLOV8_SEG, CREATOR(YoloV8Seg)},
 #endif
@@ -275,6 +260,7 @@ unordered_map<int, CreatorFunc> MODEL_CREATORS = {
     {CVI_TDL_SUPPORTED_MODEL_POLYLANE, CREATOR(Polylanenet)},
     {CVI_TDL_SUPPORTED_MODEL_SUPER_RESOLUTION, CREATOR(SuperResolution)},
 
+    {CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION, CREATOR(OCRDetection)},
     {CVI_TDL_SUPPORTED_MODEL_OCR_RECOGNITION, CREATOR(OCRRecognition)},
     {CVI_TDL_SUPPORTED_MODEL_STEREO, CREATOR(Stereo)},
 #endif
@@ -294,6 +280,7 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
   delete ctx->ds_tracker;
   delete ctx->td_model;
   delete ctx->md_model;
+  delete ctx->clip_scorer;
 
   if (ctx->ive_handle) {
     ctx->ive_handle->destroy();
@@ -317,6 +304,11 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
     ctx->md_model = nullptr;
   }
 
+  if (ctx->clip_scorer) {
+    delete ctx->clip_scorer;
+    ctx->clip_scorer = nullptr;
+  }
+
   if (ctx->ive_handle) {
     ctx->ive_handle->destroy();
     ctx->ive_handle = nullptr;
@@ -329,38 +321,79 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
 }
 #endif
 
+static Core *createInstance(const CVI_TDL_SUPPORTED_MODEL_E index, VpssEngine *engine,
+                            uint32_t vpss_timeout) {
+  // create custom instance here
+  if (index == CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION) {
+    if (MODEL_CREATORS_AUD.find(index) == MODEL_CREATORS_AUD.end()) {
+      LOGE("Cannot find creator for %s, Please register a creator for this model!\n",
+           CVI_TDL_GetModelName(index));
+      return nullptr;
+    }
+    auto creator = MODEL_CREATORS_AUD[index];
+    return creator();
+  }
+  if (MODEL_CREATORS.find(index) == MODEL_CREATORS.end()) {
+    LOGE("Cannot find creator for %s, Please register a creator for this model!\n",
+         CVI_TDL_GetModelName(index));
+    return nullptr;
+  }
+
+  auto creator = MODEL_CREATORS[index];
+  ModelParams params = {.vpss_engine = engine, .vpss_timeout_value = vpss_timeout};
+
+  Core *instance = creator(params);
+  instance->setVpssEngine(engine);
+  instance->setVpssTimeout(vpss_timeout);
+  return instance;
+}
+
 inline Core *__attribute__((always_inline))
 getInferenceInstance(const CVI_TDL_SUPPORTED_MODEL_E index, cvitdl_context_t *ctx) {
   cvitdl_model_t &m_t = ctx->model_cont[index];
   if (m_t.instance == nullptr) {
-    // create custom instance here
-    if (index == CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION) {
-      if (MODEL_CREATORS_AUD.find(index) == MODEL_CREATORS_AUD.end()) {
-        LOGE("Cannot find creator for %s, Please register a creator for this model!\n",
-             CVI_TDL_GetModelName(index));
-        return nullptr;
-      }
-      auto creator = MODEL_CREATORS_AUD[index];
-      m_t.instance = creator();
-    } else {
-      if (MODEL_CREATORS.find(index) == MODEL_CREATORS.end()) {
-        LOGE("Cannot find creator for %s, Please register a creator for this model!\n",
-             CVI_TDL_GetModelName(index));
-        return nullptr;
-      }
-
-      auto creator = MODEL_CREATORS[index];
-      ModelParams params = {.vpss_engine = ctx->vec_vpss_engine[m_t.vpss_thread],
-                            .vpss_timeout_value = ctx->vpss_timeout_value};
-
-      m_t.instance = creator(params);
-      m_t.instance->setVpssEngine(ctx->vec_vpss_engine[m_t.vpss_thread]);
-      m_t.instance->setVpssTimeout(ctx->vpss_timeout_value);
+    m_t.instance =
+        createInstance(index, ctx->vec_vpss_engine[m_t.vpss_thread], ctx->vpss_timeout_value);
+    if (m_t.instance != nullptr) {
+      m_t.pool = std::make_shared<InstancePool>();
+      m_t.pool->add(m_t.instance);
     }
   }
   return m_t.instance;
 }
 
+// Apply a setting to every instance of the model, replicas included.
+template <typename Func>
+static void forEachInstance(cvitdl_model_t &m_t, Func func) {
+  func(m_t.instance);
+  for (Core *replica : m_t.replicas) {
+    func(replica);
+  }
+}
+
+static void releaseReplicas(cvitdl_model_t &m_t) {
+  for (size_t i = 0; i < m_t.replicas.size(); i++) {
+    m_t.replicas[i]->modelClose();
+    delete m_t.replicas[i];
+    delete m_t.replica_engines[i];
+  }
+  m_t.replicas.clear();
+  m_t.replica_engines.clear();
+  m_t.pool = std::make_shared<InstancePool>();
+  m_t.pool->add(m_t.instance);
+}
+
+static void closeInstance(cvitdl_model_t &m_t) {
+  releaseReplicas(m_t);
+  m_t.pool.reset();
+  m_t.instance->modelClose();
+  delete m_t.instance;
+  m_t.instance = nullptr;
+  m_t.buf = nullptr;
+  m_t.buf_size = 0;
+  m_t.replay = false;
+}
+
 CVI_S32 CVI_TDL_CreateHandle(cvitdl_handle_t *handle) {
   return CVI_TDL_CreateHandle2(handle, -1, 0);
 }
@@ -444,6 +477,269 @@ CVI_S32 CVI_TDL_OpenModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E conf
   return CVI_TDL_SUCCESS;
 }
 
+struct ModelLoad {
+  CVI_TDL_SUPPORTED_MODEL_E model_id;
+  Core *instance;
+  std::string filepath;
+};
+
+// Check the models and create their instances on the calling thread, so loader threads only
+// touch their own instance.
+static CVI_S32 prepareModelLoads(cvitdl_context_t *ctx, const cvtdl_model_file_t *models,
+                                 uint32_t num_models, std::vector<ModelLoad> *loads) {
+  if (models == nullptr || num_models == 0) {
+    LOGE("no model to open\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::set<CVI_TDL_SUPPORTED_MODEL_E> model_ids;
+  for (uint32_t i = 0; i < num_models; i++) {
+    CVI_TDL_SUPPORTED_MODEL_E config = models[i].model_id;
+    if (!model_ids.insert(config).second || models[i].filepath == nullptr) {
+      LOGE("%s: duplicated model or no file path\n", CVI_TDL_GetModelName(config));
+      return CVI_TDL_ERR_INVALID_ARGS;
+    }
+    Core *instance = getInferenceInstance(config, ctx);
+    if (instance == nullptr) {
+      LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+      return CVI_TDL_ERR_OPEN_MODEL;
+    }
+    if (instance->isInitialized()) {
+      LOGW("%s: Inference has already initialized. Please call CVI_TDL_CloseModel to reset.\n",
+           CVI_TDL_GetModelName(config));
+      return CVI_TDL_ERR_MODEL_INITIALIZED;
+    }
+    if (!checkModelFile(models[i].filepath)) {
+      return CVI_TDL_ERR_INVALID_MODEL_PATH;
+    }
+    ctx->model_cont[config].model_path = models[i].filepath;
+    loads->push_back({config, instance, models[i].filepath});
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+static CVI_S32 loadModel(const ModelLoad &load, bool warm_up) {
+  CVI_S32 ret = load.instance->modelOpen(load.filepath.c_str());
+  if (ret != CVI_TDL_SUCCESS) {
+    LOGE("Failed to open model: %s (%s)\n", CVI_TDL_GetModelName(load.model_id),
+         load.filepath.c_str());
+    return ret;
+  }
+  if (warm_up) {
+    ret = load.instance->warmUp();
+    if (ret != CVI_TDL_SUCCESS) {
+      LOGE("Failed to warm up model: %s\n", CVI_TDL_GetModelName(load.model_id));
+      return ret;
+    }
+  }
+  LOGI("Model is opened successfully: %s \n", CVI_TDL_GetModelName(load.model_id));
+  return CVI_TDL_SUCCESS;
+}
+
+static CVI_S32 loadModels(const std::vector<ModelLoad> &loads, bool warm_up,
+                          cvtdl_model_ready_cb callback, void *user_data) {
+  std::vector<CVI_S32> results(loads.size(), CVI_TDL_SUCCESS);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < loads.size(); i++) {
+    threads.emplace_back([&, i]() {
+      results[i] = loadModel(loads[i], warm_up);
+      // a warmed up model is ready once its vpss engine is initialized below
+      if (callback != nullptr && (!warm_up || results[i] != CVI_TDL_SUCCESS)) {
+        callback(loads[i].model_id, results[i], user_data);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // Models on the same vpss thread share an engine, so engines are initialized one at a time here.
+  if (warm_up) {
+    for (size_t i = 0; i < loads.size(); i++) {
+      if (results[i] != CVI_TDL_SUCCESS) {
+        continue;
+      }
+      results[i] = initVPSSIfNeeded(loads[i].instance);
+      if (results[i] != CVI_TDL_SUCCESS) {
+        LOGE("Failed to init vpss for model: %s\n", CVI_TDL_GetModelName(loads[i].model_id));
+      }
+      if (callback != nullptr) {
+        callback(loads[i].model_id, results[i], user_data);
+      }
+    }
+  }
+  for (CVI_S32 ret : results) {
+    if (ret != CVI_TDL_SUCCESS) {
+      return ret;
+    }
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_OpenModels(cvitdl_handle_t handle, const cvtdl_model_file_t *models,
+                           uint32_t num_models, bool warm_up) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  CVI_TDL_WaitModelsReady(handle);
+  std::vector<ModelLoad> loads;
+  CVI_S32 ret = prepareModelLoads(ctx, models, num_models, &loads);
+  if (ret != CVI_TDL_SUCCESS) {
+    return ret;
+  }
+  return loadModels(loads, warm_up, nullptr, nullptr);
+}
+
+CVI_S32 CVI_TDL_OpenModelsAsync(cvitdl_handle_t handle, const cvtdl_model_file_t *models,
+                                uint32_t num_models, bool warm_up, cvtdl_model_ready_cb callback,
+                                void *user_data) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  CVI_TDL_WaitModelsReady(handle);
+  std::vector<ModelLoad> loads;
+  CVI_S32 ret = prepareModelLoads(ctx, models, num_models, &loads);
+  if (ret != CVI_TDL_SUCCESS) {
+    return ret;
+  }
+  ctx->model_loading = std::async(std::launch::async, [loads, warm_up, callback, user_data]() {
+    return loadModels(loads, warm_up, callback, user_data);
+  });
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_WaitModelsReady(cvitdl_handle_t handle) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (!ctx->model_loading.valid()) {
+    return CVI_TDL_SUCCESS;
+  }
+  return ctx->model_loading.get();
+}
+
+CVI_S32 CVI_TDL_WarmUpModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(config, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  CVI_S32 ret = CVI_TDL_SUCCESS;
+  forEachInstance(ctx->model_cont[config], [&ret](Core *inst) {
+    if (ret == CVI_TDL_SUCCESS) {
+      ret = initVPSSIfNeeded(inst);
+    }
+    if (ret == CVI_TDL_SUCCESS) {
+      ret = inst->warmUp();
+    }
+  });
+  if (ret != CVI_TDL_SUCCESS) {
+    LOGE("Failed to warm up model: %s\n", CVI_TDL_GetModelName(config));
+  }
+  return ret;
+}
+
+static CVI_S32 addReplica(cvitdl_context_t *ctx, CVI_TDL_SUPPORTED_MODEL_E config,
+                          cvitdl_model_t &m_t) {
+  VpssEngine *engine = nullptr;
+  if (m_t.instance->get_vpss_instance() != nullptr) {
+    engine = new VpssEngine(-1, m_t.instance->get_vpss_instance()->get_device_id());
+  }
+  Core *replica = createInstance(config, engine, ctx->vpss_timeout_value);
+  if (replica == nullptr) {
+    delete engine;
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  // Detection and audio parameters take effect when the model is opened.
+  if (DetectionBase *det = dynamic_cast<DetectionBase *>(m_t.instance)) {
+    dynamic_cast<DetectionBase *>(replica)->set_algparam(det->get_algparam());
+    dynamic_cast<DetectionBase *>(replica)->set_out_names(det->get_out_names());
+  }
+  if (SoundClassification *sc = dynamic_cast<SoundClassification *>(m_t.instance)) {
+    dynamic_cast<SoundClassification *>(replica)->set_algparam(sc->get_algparam());
+  }
+
+  CVI_S32 ret;
+#ifndef CV186X
+  if (m_t.replay) {
+    ret = replica->modelOpenReplay(m_t.model_path.c_str());
+  } else if (m_t.buf != nullptr) {
+    ret = replica->modelOpen(m_t.buf, m_t.buf_size);
+  } else {
+    ret = replica->modelOpen(m_t.model_path.c_str());
+  }
+#else
+  ret = replica->modelOpen(m_t.model_path.c_str());
+#endif
+  if (ret != CVI_TDL_SUCCESS) {
+    LOGE("Failed to open replica of model: %s\n", CVI_TDL_GetModelName(config));
+    delete replica;
+    delete engine;
+    return ret;
+  }
+  replica->setModelThreshold(m_t.instance->getModelThreshold());
+  replica->setModelNmsThreshold(m_t.instance->getModelNmsThreshold());
+  replica->set_preparam(m_t.instance->get_preparam());
+  replica->skipVpssPreprocess(m_t.instance->hasSkippedVpssPreprocess());
+  replica->set_perf_eval_interval(m_t.instance->get_perf_eval_interval());
+  replica->enable_latency_stats(m_t.instance->latency_stats_enabled());
+  for (uint32_t i = 0; i < m_t.instance->getNumVpssInputs(); i++) {
+    uint32_t depth;
+    m_t.instance->getVpssDepth(i, &depth);
+    replica->setVpssDepth(i, depth);
+  }
+  if (LicensePlateRecognitionBase *lpr =
+          dynamic_cast<LicensePlateRecognitionBase *>(m_t.instance)) {
+    dynamic_cast<LicensePlateRecognitionBase *>(replica)->setBeamWidth(lpr->getBeamWidth());
+  }
+  if (Yolov5 *yolov5 = dynamic_cast<Yolov5 *>(m_t.instance)) {
+    Point_t roi;
+    if (yolov5->get_roi(&roi)) {
+      dynamic_cast<Yolov5 *>(replica)->set_roi(roi);
+    }
+  }
+  if (Polylanenet *polylane = dynamic_cast<Polylanenet *>(m_t.instance)) {
+    dynamic_cast<Polylanenet *>(replica)->set_lower(polylane->get_lower());
+  }
+  if (SoundClassification *sc = dynamic_cast<SoundClassification *>(m_t.instance)) {
+    dynamic_cast<SoundClassification *>(replica)->setThreshold(sc->getThreshold());
+  }
+
+  m_t.replicas.push_back(replica);
+  m_t.replica_engines.push_back(engine);
+  m_t.pool->add(replica);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_SetModelInstances(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
+                                  uint32_t num_instances) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  CVI_TDL_WaitModelsReady(handle);
+  if (num_instances == 0 || num_instances > InstancePool::kMaxInstances) {
+    LOGE("Invalid number of instances: %u, should be 1 to %u\n", num_instances,
+         InstancePool::kMaxInstances);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  auto iter = ctx->model_cont.find(config);
+  if (iter == ctx->model_cont.end() || iter->second.instance == nullptr ||
+      !iter->second.instance->isInitialized()) {
+    LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n",
+         CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+
+  cvitdl_model_t &m_t = iter->second;
+#ifndef CV186X
+  if (num_instances > 1 && m_t.instance->isRecording()) {
+    LOGE("%s: cannot add instances while recording tensors\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+#endif
+  releaseReplicas(m_t);
+  for (uint32_t i = 1; i < num_instances; i++) {
+    CVI_S32 ret = addReplica(ctx, config, m_t);
+    if (ret != CVI_TDL_SUCCESS) {
+      releaseReplicas(m_t);
+      return ret;
+    }
+  }
+  LOGI("Model %s has %u instances\n", CVI_TDL_GetModelName(config), num_instances);
+  return CVI_TDL_SUCCESS;
+}
+
 #ifndef CV186X
 CVI_S32 CVI_TDL_OpenModel_FromBuffer(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
                                      int8_t *buf, uint32_t size) {
@@ -463,6 +759,7 @@ CVI_S32 CVI_TDL_OpenModel_FromBuffer(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_M
   }
 
   m_t.buf = buf;
+  m_t.buf_size = size;
   CVI_S32 ret = m_t.instance->modelOpen(m_t.buf, size);
   if (ret != CVI_TDL_SUCCESS) {
     LOGE("Failed to open model: %s (%d)", CVI_TDL_GetModelName(config), (int)*m_t.buf);
@@ -471,6 +768,53 @@ CVI_S32 CVI_TDL_OpenModel_FromBuffer(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_M
   LOGI("Model is opened successfully: %s \n", CVI_TDL_GetModelName(config));
   return CVI_TDL_SUCCESS;
 }
+
+CVI_S32 CVI_TDL_OpenModelReplay(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
+                                const char *record_path) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  cvitdl_model_t &m_t = ctx->model_cont[config];
+  Core *instance = getInferenceInstance(config, ctx);
+
+  if (instance != nullptr) {
+    if (instance->isInitialized()) {
+      LOGW("%s: Inference has already initialized. Please call CVI_TDL_CloseModel to reset.\n",
+           CVI_TDL_GetModelName(config));
+      return CVI_TDL_ERR_MODEL_INITIALIZED;
+    }
+  } else {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+
+  if (record_path == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  m_t.model_path = record_path;
+  CVI_S32 ret = m_t.instance->modelOpenReplay(m_t.model_path.c_str());
+  m_t.replay = ret == CVI_TDL_SUCCESS;
+  if (ret != CVI_TDL_SUCCESS) {
+    LOGE("Failed to replay model: %s (%s)\n", CVI_TDL_GetModelName(config),
+         m_t.model_path.c_str());
+    return ret;
+  }
+  LOGI("Model is replayed successfully: %s \n", CVI_TDL_GetModelName(config));
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_SetTensorRecord(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
+                                const char *record_path) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(config, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  if (record_path != nullptr && !ctx->model_cont[config].replicas.empty()) {
+    LOGE("%s: cannot record a model with several instances\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return instance->setTensorRecord(record_path);
+}
 #else
 CVI_S32 CVI_TDL_GetModelInputTpye(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
                                   int *inputDTpye) {
@@ -497,7 +841,8 @@ CVI_S32 CVI_TDL_SetSkipVpssPreprocess(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   Core *instance = getInferenceInstance(config, ctx);
   if (instance != nullptr) {
-    instance->skipVpssPreprocess(skip);
+    forEachInstance(ctx->model_cont[config],
+                    [skip](Core *inst) { inst->skipVpssPreprocess(skip); });
   } else {
     LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -510,7 +855,69 @@ CVI_S32 CVI_TDL_SetPerfEvalInterval(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MO
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   Core *instance = getInferenceInstance(config, ctx);
   if (instance != nullptr) {
-    instance->set_perf_eval_interval(interval);
+    forEachInstance(ctx->model_cont[config],
+                    [interval](Core *inst) { inst->set_perf_eval_interval(interval); });
+  } else {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_EnableLatencyStats(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
+                                   bool enable) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(config, ctx);
+  if (instance != nullptr) {
+    forEachInstance(ctx->model_cont[config],
+                    [enable](Core *inst) { inst->enable_latency_stats(enable); });
+  } else {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+static void toLatencyStats(const LatencyHistogram &hist, cvtdl_latency_stats_t *stats) {
+  LatencyStats latency;
+  hist.stats(&latency);
+  stats->count = latency.count;
+  stats->mean_us = latency.mean_us;
+  stats->p50_us = latency.p50_us;
+  stats->p95_us = latency.p95_us;
+  stats->p99_us = latency.p99_us;
+  stats->max_us = latency.max_us;
+}
+
+CVI_S32 CVI_TDL_GetLatencyStats(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
+                                const char *stage, cvtdl_latency_stats_t *stats) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(config, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  if (stage == nullptr || stats == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  // Replicas record into their own histograms, the model reports them as one.
+  LatencyHistogram hist;
+  bool found = false;
+  forEachInstance(ctx->model_cont[config], [stage, &hist, &found](Core *inst) {
+    found |= inst->merge_latency_stats(stage, &hist);
+  });
+  if (!found) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  toLatencyStats(hist, stats);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_ResetLatencyStats(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(config, ctx);
+  if (instance != nullptr) {
+    forEachInstance(ctx->model_cont[config], [](Core *inst) { inst->reset_latency_stats(); });
   } else {
     LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -518,6 +925,40 @@ CVI_S32 CVI_TDL_SetPerfEvalInterval(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MO
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_MarkAppStage(cvitdl_handle_t handle, const char *stage) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (stage == nullptr || strlen(stage) > Timer::kMaxStageName) {
+    LOGE("app stage name should have at most %zu characters\n", Timer::kMaxStageName);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  // the name may live in a reused buffer, so stages are looked up by name only
+  ctx->app_timer.TicToc(stage, false);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_EnableAppLatencyStats(cvitdl_handle_t handle, bool enable) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  ctx->app_timer.EnableStats(enable);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_GetAppLatencyStats(cvitdl_handle_t handle, const char *stage,
+                                   cvtdl_latency_stats_t *stats) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  LatencyHistogram hist;
+  if (stage == nullptr || stats == nullptr || !ctx->app_timer.MergeStats(stage, &hist)) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  toLatencyStats(hist, stats);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_ResetAppLatencyStats(cvitdl_handle_t handle) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  ctx->app_timer.ResetStats();
+  return CVI_TDL_SUCCESS;
+}
+
 CVI_S32 CVI_TDL_GetSkipVpssPreprocess(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
                                       bool *skip) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
@@ -536,7 +977,8 @@ CVI_S32 CVI_TDL_SetModelThreshold(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODE
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   Core *instance = getInferenceInstance(config, ctx);
   if (instance != nullptr) {
-    instance->setModelThreshold(threshold);
+    forEachInstance(ctx->model_cont[config],
+                    [threshold](Core *inst) { inst->setModelThreshold(threshold); });
   } else {
     LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -562,7 +1004,8 @@ CVI_S32 CVI_TDL_SetModelNmsThreshold(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_M
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   Core *instance = getInferenceInstance(config, ctx);
   if (instance != nullptr) {
-    instance->setModelNmsThreshold(threshold);
+    forEachInstance(ctx->model_cont[config],
+                    [threshold](Core *inst) { inst->setModelNmsThreshold(threshold); });
   } else {
     LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(config));
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -645,7 +1088,13 @@ CVI_S32 CVI_TDL_SetVpssDepth(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E m
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   Core *instance = getInferenceInstance(model, ctx);
   if (instance != nullptr) {
-    return instance->setVpssDepth(input_id, depth);
+    CVI_S32 ret = CVI_TDL_SUCCESS;
+    forEachInstance(ctx->model_cont[model], [input_id, depth, &ret](Core *inst) {
+      if (ret == CVI_TDL_SUCCESS) {
+        ret = inst->setVpssDepth(input_id, depth);
+      }
+    });
+    return ret;
   } else {
     LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(model));
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -681,20 +1130,28 @@ CVI_S32 CVI_TDL_SetVpssTimeout(cvitdl_handle_t handle, uint32_t timeout) {
 
   for (auto &m_inst : ctx->model_cont) {
     if (m_inst.second.instance != nullptr) {
-      m_inst.second.instance->setVpssTimeout(timeout);
+      forEachInstance(m_inst.second, [timeout](Core *inst) { inst->setVpssTimeout(timeout); });
     }
   }
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_SetLogLevel(int level) {
+  if (level < LOG_EMERG || level > LOG_DEBUG) {
+    LOGE("invalid log level %d\n", level);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  __atomic_store_n(&cvi_tdl_log_level, level, __ATOMIC_RELAXED);
+  return CVI_TDL_SUCCESS;
+}
+
 CVI_S32 CVI_TDL_CloseAllModel(cvitdl_handle_t handle) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  CVI_TDL_WaitModelsReady(handle);
   for (auto &m_inst : ctx->model_cont) {
     if (m_inst.second.instance != nullptr) {
-      m_inst.second.instance->modelClose();
+      closeInstance(m_inst.second);
       LOGI("Model is closed: %s\n", CVI_TDL_GetModelName(m_inst.first));
-      delete m_inst.second.instance;
-      m_inst.second.instance = nullptr;
     }
   }
   for (auto &m_inst : ctx->custom_cont) {
@@ -711,15 +1168,14 @@ CVI_S32 CVI_TDL_CloseAllModel(cvitdl_handle_t handle) {
 
 CVI_S32 CVI_TDL_CloseModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  CVI_TDL_WaitModelsReady(handle);
   cvitdl_model_t &m_t = ctx->model_cont[config];
   if (m_t.instance == nullptr) {
     return CVI_TDL_ERR_CLOSE_MODEL;
   }
 
-  m_t.instance->modelClose();
+  closeInstance(m_t);
   LOGI("Model is closed: %s\n", CVI_TDL_GetModelName(config));
-  delete m_t.instance;
-  m_t.instance = nullptr;
   return CVI_TDL_SUCCESS;
 }
 
@@ -786,13 +1242,14 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
 #define DEFINE_INF_FUNC_F1_P1(func_name, class_name, model_index, arg_type)                    \
   CVI_S32 func_name(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame, arg_type arg1) {  \
     cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);                           \
-    class_name *obj = dynamic_cast<class_name *>(getInferenceInstance(model_index, ctx));      \
+    ModelLease lease(ctx, model_index);                                                        \
+    class_name *obj = dynamic_cast<class_name *>(lease.get());                                 \
     if (obj == nullptr) {                                                                      \
       LOGE("No instance found for %s.\n", #class_name);                                        \
       return CVI_TDL_ERR_OPEN_MODEL;                                                           \
     }                                                                                          \
     if (obj->isInitialized()) {                                                                \
-      if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
+      if (initVPSSIfNeeded(obj) != CVI_SUCCESS) {                                              \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame, arg1);                                             \
@@ -812,13 +1269,14 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
   CVI_S32 func_name(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame, arg1_type arg1,   \
                     arg2_type arg2) {                                                          \
     cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);                           \
-    class_name *obj = dynamic_cast<class_name *>(getInferenceInstance(model_index, ctx));      \
+    ModelLease lease(ctx, model_index);                                                        \
+    class_name *obj = dynamic_cast<class_name *>(lease.get());                                 \
     if (obj == nullptr) {                                                                      \
       LOGE("No instance found for %s.\n", #class_name);                                        \
       return CVI_TDL_ERR_OPEN_MODEL;                                                           \
     }                                                                                          \
     if (obj->isInitialized()) {                                                                \
-      if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
+      if (initVPSSIfNeeded(obj) != CVI_SUCCESS) {                                              \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame, arg1, arg2);                                       \
@@ -838,13 +1296,14 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
   CVI_S32 func_name(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame1,                  \
                     VIDEO_FRAME_INFO_S *frame2, arg_type arg1) {                               \
     cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);                           \
-    class_name *obj = dynamic_cast<class_name *>(getInferenceInstance(model_index, ctx));      \
+    ModelLease lease(ctx, model_index);                                                        \
+    class_name *obj = dynamic_cast<class_name *>(lease.get());                                 \
     if (obj == nullptr) {                                                                      \
       LOGE("No instance found for %s.\n", #class_name);                                        \
       return CVI_TDL_ERR_OPEN_MODEL;                                                           \
     }                                                                                          \
     if (obj->isInitialized()) {                                                                \
-      if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
+      if (initVPSSIfNeeded(obj) != CVI_SUCCESS) {                                              \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame1, frame2, arg1);                                    \
@@ -864,13 +1323,14 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
   CVI_S32 func_name(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame1,                  \
                     VIDEO_FRAME_INFO_S *frame2, arg1_type arg1, arg2_type arg2) {              \
     cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);                           \
-    class_name *obj = dynamic_cast<class_name *>(getInferenceInstance(model_index, ctx));      \
+    ModelLease lease(ctx, model_index);                                                        \
+    class_name *obj = dynamic_cast<class_name *>(lease.get());                                 \
     if (obj == nullptr) {                                                                      \
       LOGE("No instance found for %s.\n", #class_name);                                        \
       return CVI_TDL_ERR_OPEN_MODEL;                                                           \
     }                                                                                          \
     if (obj->isInitialized()) {                                                                \
-      if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
+      if (initVPSSIfNeeded(obj) != CVI_SUCCESS) {                                              \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame1, frame2, arg1, arg2);                              \
@@ -897,8 +1357,6 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
 #ifndef NO_OPENCV
 DEFINE_INF_FUNC_F2_P2(CVI_TDL_Liveness, Liveness, CVI_TDL_SUPPORTED_MODEL_LIVENESS, cvtdl_face_t *,
                       cvtdl_face_t *)
-DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Detection, OCRDetection, CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION,
-                      cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_EyeClassification, EyeClassification,
                       CVI_TDL_SUPPORTED_MODEL_EYECLASSIFICATION, cvtdl_face_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_YawnClassification, YawnClassification,
@@ -958,61 +1416,6 @@ CVI_S32 CVI_TDL_Fall_Monitor(const cvitdl_handle_t handle, cvtdl_object_t *objec
   return ctx->fall_monitor_model->monitor(objects);
 }
 
-CVI_S32 CVI_TDL_Set_MaskOutlinePoint(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *obj_meta) {
-  int proto_h = obj_meta->mask_height;
-  int proto_w = obj_meta->mask_width;
-  for (uint32_t i = 0; i < obj_meta->size; i++) {
-    cv::Mat src(proto_h, proto_w, CV_8UC1, obj_meta->info[i].mask_properity->mask,
-                proto_w * sizeof(uint8_t));
-
-    std::vector<std::vector<cv::Point>> contours;
-    std::vector<cv::Vec4i> hierarchy;
-    // search for contours
-    cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-    // find the longest contour
-    int longest_index = -1;
-    size_t max_length = 0;
-    for (size_t i = 0; i < contours.size(); i++) {
-      if (contours[i].size() > max_length) {
-        max_length = contours[i].size();
-        longest_index = i;
-      }
-    }
-    if (longest_index >= 0 && max_length >= 1) {
-      float ratio_height = (proto_h / static_cast<float>(frame->stVFrame.u32Height));
-      float ratio_width = (proto_w / static_cast<float>(frame->stVFrame.u32Width));
-      int source_y_offset, source_x_offset;
-      if (ratio_height > ratio_width) {
-        source_x_offset = 0;
-        source_y_offset = (proto_h - frame->stVFrame.u32Height * ratio_width) / 2;
-      } else {
-        source_x_offset = (proto_w - frame->stVFrame.u32Width * ratio_height) / 2;
-        source_y_offset = 0;
-      }
-      int source_region_height = proto_h - 2 * source_y_offset;
-      int source_region_width = proto_w - 2 * source_x_offset;
-      // calculate scaling factor
-      float height_scale =
-          static_cast<float>(frame->stVFrame.u32Height) / static_cast<float>(source_region_height);
-      float width_scale =
-          static_cast<float>(frame->stVFrame.u32Width) / static_cast<float>(source_region_width);
-      obj_meta->info[i].mask_properity->mask_point_size = max_length;
-      obj_meta->info[i].mask_properity->mask_point =
-          (float *)malloc(2 * max_length * sizeof(float));
-
-      size_t j = 0;
-      for (const auto &point : contours[longest_index]) {
-        obj_meta->info[i].mask_properity->mask_point[2 * j] =
-            (point.x - source_x_offset) * width_scale;
-        obj_meta->info[i].mask_properity->mask_point[2 * j + 1] =
-            (point.y - source_y_offset) * height_scale;
-        j++;
-      }
-    }
-  }
-  return CVI_SUCCESS;
-}
-
 CVI_S32 CVI_TDL_Set_Fall_FPS(const cvitdl_handle_t handle, float fps) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   FallDetMonitor *fall_monitor_model = ctx->fall_monitor_model;
@@ -1042,6 +1445,158 @@ CVI_S32 CVI_TDL_CropImage_Face(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *p_ds
 }
 #endif
 
+CVI_S32 CVI_TDL_CropImages(VIDEO_FRAME_INFO_S *srcFrame, const cvtdl_bbox_t *bboxes, uint32_t num,
+                           cvtdl_image_batch_t *dst, bool cvtRGB888, float exten_ratio,
+                           uint32_t num_threads) {
+  return crop_images(srcFrame, bboxes, num, dst, cvtRGB888, exten_ratio, num_threads);
+}
+
+CVI_S32 CVI_TDL_CropImages_Object(VIDEO_FRAME_INFO_S *srcFrame, const cvtdl_object_t *obj_meta,
+                                  cvtdl_image_batch_t *dst, bool cvtRGB888, float exten_ratio,
+                                  uint32_t num_threads) {
+  std::vector<cvtdl_bbox_t> bboxes(obj_meta->size);
+  for (uint32_t i = 0; i < obj_meta->size; i++) {
+    bboxes[i] = obj_meta->info[i].bbox;
+  }
+  return crop_images(srcFrame, bboxes.data(), obj_meta->size, dst, cvtRGB888, exten_ratio,
+                     num_threads);
+}
+
+CVI_S32 CVI_TDL_CropImages_Face(VIDEO_FRAME_INFO_S *srcFrame, const cvtdl_face_t *face_meta,
+                                cvtdl_image_batch_t *dst, bool cvtRGB888, float exten_ratio,
+                                uint32_t num_threads) {
+  std::vector<cvtdl_bbox_t> bboxes(face_meta->size);
+  for (uint32_t i = 0; i < face_meta->size; i++) {
+    bboxes[i] = face_meta->info[i].bbox;
+  }
+  return crop_images(srcFrame, bboxes.data(), face_meta->size, dst, cvtRGB888, exten_ratio,
+                     num_threads);
+}
+
+// Run-length encoded mask of object index. Dense masks are encoded into tmp.
+static const uint32_t *get_mask_rle(const cvtdl_object_t *obj_meta, uint32_t index,
+                                    std::vector<uint32_t> *tmp, uint32_t *size) {
+  if (index >= obj_meta->size || obj_meta->info[index].mask_properity == NULL) {
+    return NULL;
+  }
+  const cvtdl_mask_meta *mask_meta = obj_meta->info[index].mask_properity;
+  if (mask_meta->mask_rle != NULL) {
+    *size = mask_meta->mask_rle_size;
+    return mask_meta->mask_rle;
+  }
+  if (mask_meta->mask == NULL) {
+    return NULL;
+  }
+  rle_encode(mask_meta->mask, obj_meta->mask_width, obj_meta->mask_height, tmp);
+  *size = tmp->size();
+  return tmp->data();
+}
+
+CVI_S32 CVI_TDL_Mask_Area(const cvtdl_object_t *obj_meta, uint32_t index, uint32_t *area) {
+  std::vector<uint32_t> tmp;
+  uint32_t size = 0;
+  const uint32_t *rle = get_mask_rle(obj_meta, index, &tmp, &size);
+  if (rle == NULL) {
+    LOGE("object %u has no mask\n", index);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  *area = rle_area(rle, size);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Mask_BBox(const cvtdl_object_t *obj_meta, uint32_t index, cvtdl_bbox_t *bbox) {
+  std::vector<uint32_t> tmp;
+  uint32_t size = 0;
+  const uint32_t *rle = get_mask_rle(obj_meta, index, &tmp, &size);
+  if (rle == NULL) {
+    LOGE("object %u has no mask\n", index);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  int x1 = 0, y1 = 0, x2 = -1, y2 = -1;
+  rle_bbox(rle, size, obj_meta->mask_width, &x1, &y1, &x2, &y2);
+  bbox->x1 = x1;
+  bbox->y1 = y1;
+  bbox->x2 = x2 + 1;
+  bbox->y2 = y2 + 1;
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Mask_IoU(const cvtdl_object_t *obj_meta, uint32_t index_a, uint32_t index_b,
+                         float *iou) {
+  std::vector<uint32_t> tmp_a, tmp_b;
+  uint32_t size_a = 0, size_b = 0;
+  const uint32_t *rle_a = get_mask_rle(obj_meta, index_a, &tmp_a, &size_a);
+  const uint32_t *rle_b = get_mask_rle(obj_meta, index_b, &tmp_b, &size_b);
+  if (rle_a == NULL || rle_b == NULL) {
+    LOGE("object %u or %u has no mask\n", index_a, index_b);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  *iou = rle_iou(rle_a, size_a, rle_b, size_b);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Mask_Decode(const cvtdl_object_t *obj_meta, uint32_t index, uint8_t *mask) {
+  std::vector<uint32_t> tmp;
+  uint32_t size = 0;
+  const uint32_t *rle = get_mask_rle(obj_meta, index, &tmp, &size);
+  if (rle == NULL) {
+    LOGE("object %u has no mask\n", index);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  rle_decode(rle, size, obj_meta->mask_width, obj_meta->mask_height, mask);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Set_MaskOutlinePoint(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *obj_meta) {
+  int proto_h = obj_meta->mask_height;
+  int proto_w = obj_meta->mask_width;
+  std::vector<uint32_t> tmp;
+  std::vector<int> contour;
+  for (uint32_t i = 0; i < obj_meta->size; i++) {
+    uint32_t rle_size = 0;
+    const uint32_t *rle = get_mask_rle(obj_meta, i, &tmp, &rle_size);
+    if (rle == NULL) {
+      continue;
+    }
+    // the outer contour of the largest component
+    rle_outer_contour(rle, rle_size, proto_w, proto_h, &contour);
+    size_t max_length = contour.size() / 2;
+    if (max_length >= 1) {
+      float ratio_height = (proto_h / static_cast<float>(frame->stVFrame.u32Height));
+      float ratio_width = (proto_w / static_cast<float>(frame->stVFrame.u32Width));
+      int source_y_offset, source_x_offset;
+      if (ratio_height > ratio_width) {
+        source_x_offset = 0;
+        source_y_offset = (proto_h - frame->stVFrame.u32Height * ratio_width) / 2;
+      } else {
+        source_x_offset = (proto_w - frame->stVFrame.u32Width * ratio_height) / 2;
+        source_y_offset = 0;
+      }
+      int source_region_height = proto_h - 2 * source_y_offset;
+      int source_region_width = proto_w - 2 * source_x_offset;
+      // calculate scaling factor
+      float height_scale =
+          static_cast<float>(frame->stVFrame.u32Height) / static_cast<float>(source_region_height);
+      float width_scale =
+          static_cast<float>(frame->stVFrame.u32Width) / static_cast<float>(source_region_width);
+      cvtdl_mask_meta *mask_meta = obj_meta->info[i].mask_properity;
+      free(mask_meta->mask_point);
+      mask_meta->mask_point_size = 0;
+      mask_meta->mask_point = (float *)malloc(2 * max_length * sizeof(float));
+      if (mask_meta->mask_point == NULL) {
+        LOGE("Failed to allocate memory for mask_point\n");
+        return CVI_TDL_FAILURE;
+      }
+      mask_meta->mask_point_size = max_length;
+      for (size_t j = 0; j < max_length; j++) {
+        mask_meta->mask_point[2 * j] = (contour[2 * j] - source_x_offset) * width_scale;
+        mask_meta->mask_point[2 * j + 1] = (contour[2 * j + 1] - source_y_offset) * height_scale;
+      }
+    }
+  }
+  return CVI_SUCCESS;
+}
+
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_DMSLDet, DMSLandmarkerDet, CVI_TDL_SUPPORTED_MODEL_DMSLANDMARKERDET,
                       cvtdl_face_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_FLDet3, FaceLandmarkDet3, CVI_TDL_SUPPORTED_MODEL_LANDMARK_DET3,
@@ -1072,6 +1627,8 @@ DEFINE_INF_FUNC_F1_P1(CVI_TDL_SoundClassification, SoundClassification,
                       CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION, int *)
 DEFINE_INF_FUNC_F2_P1(CVI_TDL_DeeplabV3, Deeplabv3, CVI_TDL_SUPPORTED_MODEL_DEEPLABV3,
                       cvtdl_class_filter_t *)
+DEFINE_INF_FUNC_F1_P2(CVI_TDL_DeeplabV3_Label, Deeplabv3, CVI_TDL_SUPPORTED_MODEL_DEEPLABV3,
+                      cvtdl_seg_label_t *, cvtdl_class_filter_t *)
 DEFINE_INF_FUNC_F2_P1(CVI_TDL_MotionSegmentation, MotionSegmentation,
                       CVI_TDL_SUPPORTED_MODEL_MOTIONSEGMENTATION, cvtdl_seg_logits_t *)
 
@@ -1102,6 +1659,8 @@ DEFINE_INF_FUNC_F1_P1(CVI_TDL_PolyLane_Det, Polylanenet, CVI_TDL_SUPPORTED_MODEL
                       cvtdl_lane_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_Super_Resolution, SuperResolution,
                       CVI_TDL_SUPPORTED_MODEL_SUPER_RESOLUTION, cvtdl_sr_feature *)
+DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Detection, OCRDetection, CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION,
+                      cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Recognition, OCRRecognition,
                       CVI_TDL_SUPPORTED_MODEL_OCR_RECOGNITION, cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_LSTR_Det, LSTR, CVI_TDL_SUPPORTED_MODEL_LSTR, cvtdl_lane_t *)
@@ -1144,13 +1703,14 @@ CVI_S32 CVI_TDL_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *fram
     return CVI_TDL_ERR_OPEN_MODEL;
   }
 
-  DetectionBase *model = dynamic_cast<DetectionBase *>(getInferenceInstance(model_index, ctx));
+  ModelLease lease(ctx, model_index);
+  DetectionBase *model = dynamic_cast<DetectionBase *>(lease.get());
   if (model == nullptr) {
     LOGE("No instance found\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
   if (model->isInitialized()) {
-    if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {
+    if (initVPSSIfNeeded(model) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
       CVI_S32 ret = model->inference(frame, obj);
@@ -1177,7 +1737,9 @@ CVI_S32 CVI_TDL_Set_Outputlayer_Names(const cvitdl_handle_t handle,
     for (size_t i = 0; i < size; ++i) {
       names.emplace_back(std::string(output_names[i]));
     }
-    model->set_out_names(names);
+    forEachInstance(ctx->model_cont[model_index], [&names](Core *inst) {
+      dynamic_cast<DetectionBase *>(inst)->set_out_names(names);
+    });
   } else {
     LOGE("No instance found\n");
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -1196,14 +1758,14 @@ CVI_S32 CVI_TDL_FaceDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *
     LOGE("unknown face detection model index.\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
-  FaceDetectionBase *model =
-      dynamic_cast<FaceDetectionBase *>(getInferenceInstance(model_index, ctx));
+  ModelLease lease(ctx, model_index);
+  FaceDetectionBase *model = dynamic_cast<FaceDetectionBase *>(lease.get());
   if (model == nullptr) {
     LOGE("No instance found\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
   if (model->isInitialized()) {
-    if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {
+    if (initVPSSIfNeeded(model) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
       CVI_S32 ret = model->inference(frame, face_meta);
@@ -1229,14 +1791,14 @@ CVI_S32 CVI_TDL_PoseDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *
     LOGE("unknown pose detection model index.\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
-  PoseDetectionBase *model =
-      dynamic_cast<PoseDetectionBase *>(getInferenceInstance(model_index, ctx));
+  ModelLease lease(ctx, model_index);
+  PoseDetectionBase *model = dynamic_cast<PoseDetectionBase *>(lease.get());
   if (model == nullptr) {
     LOGE("No instance found\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
   if (model->isInitialized()) {
-    if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {
+    if (initVPSSIfNeeded(model) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
       CVI_S32 ret = model->inference(frame, obj_meta);
@@ -1262,8 +1824,8 @@ CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle, VIDEO_FRAM
     LOGE("unknown license plate recognition model index.\n");
     return CVI_TDL_ERR_OPEN_MODEL;
   }
-  LicensePlateRecognitionBase *sc_model =
-      dynamic_cast<LicensePlateRecognitionBase *>(getInferenceInstance(model_id, ctx));
+  ModelLease lease(ctx, model_id);
+  LicensePlateRecognitionBase *sc_model = dynamic_cast<LicensePlateRecognitionBase *>(lease.get());
   if (sc_model == nullptr) {
     LOGE("No instance found for LicensePlateRecognition.\n");
     return CVI_TDL_ERR_OPEN_MODEL;
@@ -1277,6 +1839,21 @@ CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle, VIDEO_FRAM
   }
 }
 
+CVI_S32 CVI_TDL_SetLicensePlateBeamWidth(const cvitdl_handle_t handle,
+                                         CVI_TDL_SUPPORTED_MODEL_E model_id, uint32_t beam_width) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  LicensePlateRecognitionBase *sc_model =
+      dynamic_cast<LicensePlateRecognitionBase *>(getInferenceInstance(model_id, ctx));
+  if (sc_model == nullptr) {
+    LOGE("No instance found for LicensePlateRecognition.\n");
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  forEachInstance(ctx->model_cont[model_id], [beam_width](Core *inst) {
+    dynamic_cast<LicensePlateRecognitionBase *>(inst)->setBeamWidth(beam_width);
+  });
+  return CVI_TDL_SUCCESS;
+}
+
 // Tracker
 
 CVI_S32 CVI_TDL_DeepSORT_Init(const cvitdl_handle_t handle, bool use_specific_counter) {
@@ -1454,6 +2031,58 @@ CVI_S32 CVI_TDL_DeepSORT_GetTracker_Inactive(const cvitdl_handle_t handle,
   return ctx->ds_tracker->get_trackers_inactive(tracker);
 }
 
+CVI_S32 CVI_TDL_DeepSORT_SetSkipConfig(const cvitdl_handle_t handle,
+                                       const cvtdl_deepsort_skip_config_t *skip_conf) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  DeepSORT *ds_tracker = ctx->ds_tracker;
+  if (ds_tracker == nullptr) {
+    LOGE("Please initialize DeepSORT first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  if (skip_conf == nullptr || skip_conf->min_interval == 0 ||
+      skip_conf->min_interval > skip_conf->max_interval) {
+    LOGE("Invalid skip config, expect 0 < min_interval <= max_interval\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  ds_tracker->set_skip_config(*skip_conf);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_DeepSORT_GetSkipConfig(const cvitdl_handle_t handle,
+                                       cvtdl_deepsort_skip_config_t *skip_conf) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  DeepSORT *ds_tracker = ctx->ds_tracker;
+  if (ds_tracker == nullptr) {
+    LOGE("Please initialize DeepSORT first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  *skip_conf = ds_tracker->get_skip_config();
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_DeepSORT_NeedDetection(const cvitdl_handle_t handle, bool scene_changed,
+                                       bool *need_detection) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  DeepSORT *ds_tracker = ctx->ds_tracker;
+  if (ds_tracker == nullptr) {
+    LOGE("Please initialize DeepSORT first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  *need_detection = ds_tracker->need_detection(scene_changed);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_DeepSORT_Predict(const cvitdl_handle_t handle, cvtdl_object_t *obj,
+                                 cvtdl_tracker_t *tracker) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  DeepSORT *ds_tracker = ctx->ds_tracker;
+  if (ds_tracker == nullptr) {
+    LOGE("Please initialize DeepSORT first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  return ds_tracker->predict(obj, tracker);
+}
+
 CVI_S32 CVI_TDL_FaceHeadIouScore(const cvitdl_handle_t handle, cvtdl_face_t *faces,
                                  cvtdl_face_t *heads) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
@@ -1544,14 +2173,14 @@ CVI_S32 CVI_TDL_FaceFeatureExtract(const cvitdl_handle_t handle, const uint8_t *
                                    int width, int height, int stride,
                                    cvtdl_face_info_t *p_face_info) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  FaceAttribute *inst = dynamic_cast<FaceAttribute *>(
-      getInferenceInstance(CVI_TDL_SUPPORTED_MODEL_FACERECOGNITION, ctx));
+  ModelLease lease(ctx, CVI_TDL_SUPPORTED_MODEL_FACERECOGNITION);
+  FaceAttribute *inst = dynamic_cast<FaceAttribute *>(lease.get());
   if (inst == nullptr) {
     LOGE("No instance found for FaceAttribute\n");
     return CVI_FAILURE;
   }
   if (inst->isInitialized()) {
-    if (initVPSSIfNeeded(ctx, CVI_TDL_SUPPORTED_MODEL_FACERECOGNITION) != CVI_SUCCESS) {
+    if (initVPSSIfNeeded(inst) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     }
   } else {
@@ -1588,7 +2217,10 @@ CVI_S32 CVI_TDL_SetSoundClassificationThreshold(const cvitdl_handle_t handle, co
     return CVI_TDL_ERR_OPEN_MODEL;
   }
   if (sc_model->isInitialized()) {
-    return sc_model->setThreshold(th);
+    forEachInstance(ctx->model_cont[CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION], [th](Core *inst) {
+      dynamic_cast<SoundClassification *>(inst)->setThreshold(th);
+    });
+    return CVI_SUCCESS;
   } else {
     LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n",
          CVI_TDL_GetModelName(CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION));
@@ -1600,13 +2232,14 @@ CVI_S32 CVI_TDL_Change_Img(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
                            VIDEO_FRAME_INFO_S *frame, VIDEO_FRAME_INFO_S **dst_frame,
                            PIXEL_FORMAT_E enDstFormat) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type, true);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
 
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
@@ -1614,8 +2247,8 @@ CVI_S32 CVI_TDL_Change_Img(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
 
   VIDEO_FRAME_INFO_S *f = new VIDEO_FRAME_INFO_S;
   memset(f, 0, sizeof(VIDEO_FRAME_INFO_S));
-  modelt.instance->vpssChangeImage(frame, f, frame->stVFrame.u32Width, frame->stVFrame.u32Height,
-                                   enDstFormat);
+  instance->vpssChangeImage(frame, f, frame->stVFrame.u32Width, frame->stVFrame.u32Height,
+                            enDstFormat);
   *dst_frame = f;
   return CVI_SUCCESS;
 }
@@ -1623,12 +2256,13 @@ CVI_S32 CVI_TDL_Change_Img(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
 CVI_S32 CVI_TDL_Delete_Img(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model_type,
                            VIDEO_FRAME_INFO_S *p_f) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type, true);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
 
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
@@ -1643,12 +2277,13 @@ CVI_S32 CVI_TDL_CropImage_With_VPSS(const cvitdl_handle_t handle,
                                     CVI_TDL_SUPPORTED_MODEL_E model_type, VIDEO_FRAME_INFO_S *frame,
                                     const cvtdl_bbox_t *p_crop_box, cvtdl_image_t *p_dst) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
 
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
@@ -1661,8 +2296,7 @@ CVI_S32 CVI_TDL_CropImage_With_VPSS(const cvitdl_handle_t handle,
 
   VIDEO_FRAME_INFO_S *f = new VIDEO_FRAME_INFO_S;
   memset(f, 0, sizeof(VIDEO_FRAME_INFO_S));
-  modelt.instance->vpssCropImage(frame, f, *p_crop_box, p_dst->width, p_dst->height,
-                                 p_dst->pix_format);
+  instance->vpssCropImage(frame, f, *p_crop_box, p_dst->width, p_dst->height, p_dst->pix_format);
   mmap_video_frame(f);
 
   int ret = CVI_SUCCESS;
@@ -1694,12 +2328,13 @@ CVI_S32 CVI_TDL_CropResizeImage(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_
                                 int dst_width, int dst_height, PIXEL_FORMAT_E enDstFormat,
                                 VIDEO_FRAME_INFO_S **p_dst_img) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type, true);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
 
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
@@ -1708,8 +2343,7 @@ CVI_S32 CVI_TDL_CropResizeImage(const cvitdl_handle_t handle, CVI_TDL_SUPPORTED_
 
   VIDEO_FRAME_INFO_S *f = new VIDEO_FRAME_INFO_S;
   memset(f, 0, sizeof(VIDEO_FRAME_INFO_S));
-  int ret =
-      modelt.instance->vpssCropImage(frame, f, *p_crop_box, dst_width, dst_height, enDstFormat);
+  int ret = instance->vpssCropImage(frame, f, *p_crop_box, dst_width, dst_height, enDstFormat);
   *p_dst_img = f;
   return ret;
 }
@@ -1741,12 +2375,13 @@ CVI_S32 CVI_TDL_Resize_VideoFrame(const cvitdl_handle_t handle,
                                   const int dst_w, const int dst_h, PIXEL_FORMAT_E dst_format,
                                   VIDEO_FRAME_INFO_S **dst_frame) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type, true);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
 
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
@@ -1761,7 +2396,7 @@ CVI_S32 CVI_TDL_Resize_VideoFrame(const cvitdl_handle_t handle,
   bbox.x2 = frame->stVFrame.u32Width;
   bbox.y2 = frame->stVFrame.u32Height;
   VPSS_SCALE_COEF_E scale = VPSS_SCALE_COEF_NEAREST;
-  CVI_S32 ret = modelt.instance->vpssCropImage(frame, f, bbox, dst_w, dst_h, dst_format, scale);
+  CVI_S32 ret = instance->vpssCropImage(frame, f, bbox, dst_w, dst_h, dst_format, scale);
   *dst_frame = f;
   return ret;
 }
@@ -1769,12 +2404,13 @@ DLL_EXPORT CVI_S32 CVI_TDL_Release_VideoFrame(const cvitdl_handle_t handle,
                                               CVI_TDL_SUPPORTED_MODEL_E model_type,
                                               VIDEO_FRAME_INFO_S *frame, bool del_frame) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl_model_t modelt = ctx->model_cont[model_type];
-  if (modelt.instance == nullptr) {
+  ModelLease lease(ctx, model_type, true);
+  Core *instance = lease.get();
+  if (instance == nullptr) {
     LOGE("model not initialized:%d\n", (int)model_type);
     return CVI_FAILURE;
   }
-  VpssEngine *p_vpss_inst = modelt.instance->get_vpss_instance();
+  VpssEngine *p_vpss_inst = instance->get_vpss_instance();
 
   if (p_vpss_inst == nullptr) {
     LOGE("vpssmodel not initialized:%d\n", (int)model_type);
@@ -1793,15 +2429,15 @@ DLL_EXPORT CVI_S32 CVI_TDL_Release_VideoFrame(const cvitdl_handle_t handle,
 CVI_S32 CVI_TDL_PersonVehicle_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                         cvtdl_object_t *obj_meta) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  YoloV8Detection *yolo_model = dynamic_cast<YoloV8Detection *>(
-      getInferenceInstance(CVI_TDL_SUPPORTED_MODEL_PERSON_VEHICLE_DETECTION, ctx));
+  ModelLease lease(ctx, CVI_TDL_SUPPORTED_MODEL_PERSON_VEHICLE_DETECTION);
+  YoloV8Detection *yolo_model = dynamic_cast<YoloV8Detection *>(lease.get());
   if (yolo_model == nullptr) {
     LOGE("No instance found for CVI_TDL_PersonVehicle_Detection.\n");
     return CVI_FAILURE;
   }
   LOGI("got yolov8 instance\n");
   if (yolo_model->isInitialized()) {
-    if (initVPSSIfNeeded(ctx, CVI_TDL_SUPPORTED_MODEL_PERSON_VEHICLE_DETECTION) != CVI_SUCCESS) {
+    if (initVPSSIfNeeded(yolo_model) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
       int ret = yolo_model->inference(frame, obj_meta);
@@ -1837,7 +2473,9 @@ CVI_S32 CVI_TDL_Set_Yolov5_ROI(const cvitdl_handle_t handle, Point_t roi_s) {
     LOGE("yolov5_model has not been inited\n");
     return CVI_TDL_FAILURE;
   }
-  return yolov5_model->set_roi(roi_s);
+  forEachInstance(ctx->model_cont[CVI_TDL_SUPPORTED_MODEL_YOLOV5],
+                  [&roi_s](Core *inst) { dynamic_cast<Yolov5 *>(inst)->set_roi(roi_s); });
+  return CVI_TDL_SUCCESS;
 }
 
 InputPreParam CVI_TDL_GetPreParam(const cvitdl_handle_t handle,
@@ -1850,8 +2488,9 @@ InputPreParam CVI_TDL_GetPreParam(const cvitdl_handle_t handle,
 CVI_S32 CVI_TDL_SetPreParam(const cvitdl_handle_t handle,
                             const CVI_TDL_SUPPORTED_MODEL_E model_index, InputPreParam pre_param) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  cvitdl::Core *instance = getInferenceInstance(model_index, ctx);
-  instance->set_preparam(pre_param);
+  getInferenceInstance(model_index, ctx);
+  forEachInstance(ctx->model_cont[model_index],
+                  [&pre_param](Core *inst) { inst->set_preparam(pre_param); });
   return CVI_SUCCESS;
 }
 
@@ -1866,8 +2505,10 @@ CVI_S32 CVI_TDL_SetDetectionAlgoParam(const cvitdl_handle_t handle,
                                       const CVI_TDL_SUPPORTED_MODEL_E model_index,
                                       cvtdl_det_algo_param_t alg_param) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  DetectionBase *model = dynamic_cast<DetectionBase *>(getInferenceInstance(model_index, ctx));
-  model->set_algparam(alg_param);
+  getInferenceInstance(model_index, ctx);
+  forEachInstance(ctx->model_cont[model_index], [&alg_param](Core *inst) {
+    dynamic_cast<DetectionBase *>(inst)->set_algparam(alg_param);
+  });
   return CVI_SUCCESS;
 }
 
@@ -1889,9 +2530,10 @@ CVI_S32 CVI_TDL_SetSoundClassificationParam(const cvitdl_handle_t handle,
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
 
   if (model_index == CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION) {
-    SoundClassification *sc_v2_model =
-        dynamic_cast<SoundClassification *>(getInferenceInstance(model_index, ctx));
-    sc_v2_model->set_algparam(audio_param);
+    getInferenceInstance(model_index, ctx);
+    forEachInstance(ctx->model_cont[model_index], [&audio_param](Core *inst) {
+      dynamic_cast<SoundClassification *>(inst)->set_algparam(audio_param);
+    });
     return CVI_SUCCESS;
   }
   LOGE("not supported model index\n");
@@ -1901,8 +2543,8 @@ CVI_S32 CVI_TDL_SetSoundClassificationParam(const cvitdl_handle_t handle,
 CVI_S32 CVI_TDL_SoundClassificationPack(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                         int pack_idx, int pack_len, int *index) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
-  SoundClassification *sc_model = dynamic_cast<SoundClassification *>(
-      getInferenceInstance(CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION, ctx));
+  ModelLease lease(ctx, CVI_TDL_SUPPORTED_MODEL_SOUNDCLASSIFICATION);
+  SoundClassification *sc_model = dynamic_cast<SoundClassification *>(lease.get());
   if (sc_model == nullptr) {
     LOGE("No instance found for SoundClassification.\n");
     return CVI_FAILURE;
@@ -1920,9 +2562,9 @@ CVI_S32 CVI_TDL_Set_Polylanenet_Lower(const cvitdl_handle_t handle,
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
 
   if (model_index == CVI_TDL_SUPPORTED_MODEL_POLYLANE) {
-    Polylanenet *polylane_model =
-        dynamic_cast<Polylanenet *>(getInferenceInstance(model_index, ctx));
-    polylane_model->set_lower(th);
+    getInferenceInstance(model_index, ctx);
+    forEachInstance(ctx->model_cont[model_index],
+                    [th](Core *inst) { dynamic_cast<Polylanenet *>(inst)->set_lower(th); });
     return CVI_SUCCESS;
   }
   LOGE("not supported model index\n");
@@ -1949,6 +2591,52 @@ CVI_S32 CVI_TDL_Set_TextPreprocess(const char *encoderFile, const char *bpeFile,
   return CVI_FAILURE;
 }
 
+CVI_S32 CVI_TDL_TextTokenize(const char *encoderFile, const char *bpeFile, const char **texts,
+                             int numSentences, int32_t **tokens) {
+  if (encoderFile == NULL || texts == NULL || tokens == NULL || numSentences < 0) {
+    LOGE("invalid tokenizer arguments\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  for (int i = 0; i < numSentences; i++) {
+    if (texts[i] == NULL || tokens[i] == NULL) {
+      LOGE("text or token buffer %d is NULL\n", i);
+      return CVI_TDL_ERR_INVALID_ARGS;
+    }
+  }
+  std::shared_ptr<BpeTokenizer> tokenizer =
+      get_bpe_tokenizer(std::string(encoderFile), std::string(bpeFile == NULL ? "" : bpeFile));
+  if (tokenizer == nullptr) {
+    LOGE("load tokenizer failed\n");
+    return CVI_TDL_FAILURE;
+  }
+  std::vector<std::string> text_list(texts, texts + numSentences);
+  std::vector<std::vector<int32_t>> tokens_cpp;
+  int ret = tokenizer->encodeBatch(text_list, &tokens_cpp);
+  if (ret != CVI_TDL_SUCCESS) {
+    LOGE("Tokenization error\n");
+    return ret;
+  }
+  for (int i = 0; i < numSentences; i++) {
+    memcpy(tokens[i], tokens_cpp[i].data(), tokens_cpp[i].size() * sizeof(int32_t));
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Export_TextTokenizer(const char *encoderFile, const char *bpeFile,
+                                     const char *outFile) {
+  if (encoderFile == NULL || bpeFile == NULL || outFile == NULL) {
+    LOGE("invalid tokenizer export arguments\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::shared_ptr<BpeTokenizer> tokenizer =
+      get_bpe_tokenizer(std::string(encoderFile), std::string(bpeFile));
+  if (tokenizer == nullptr) {
+    LOGE("load tokenizer failed\n");
+    return CVI_TDL_FAILURE;
+  }
+  return tokenizer->saveBinary(std::string(outFile));
+}
+
 CVI_S32 CVI_TDL_Set_ClipPostprocess(float **text_features, int text_features_num,
                                     float **image_features, int image_features_num, float **probs) {
   Eigen::MatrixXf text_features_eigen(text_features_num, 512);
@@ -1991,4 +2679,23 @@ CVI_S32 CVI_TDL_Set_ClipPostprocess(float **text_features, int text_features_num
 
   LOGE("Tokenization error\n");
   return CVI_FAILURE;
+}
+
+CVI_S32 CVI_TDL_Clip_SetTextFeatures(const cvitdl_handle_t handle, float **text_features,
+                                     int text_features_num, int feature_dim) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (ctx->clip_scorer == nullptr) {
+    ctx->clip_scorer = new ClipScorer();
+  }
+  return ctx->clip_scorer->setTextFeatures(text_features, text_features_num, feature_dim);
+}
+
+CVI_S32 CVI_TDL_Clip_ScoreTopK(const cvitdl_handle_t handle, float **image_features,
+                               int image_features_num, int topk, int *labels, float *scores) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (ctx->clip_scorer == nullptr) {
+    LOGE("Text features are not set, please invoke CVI_TDL_Clip_SetTextFeatures first.\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  return ctx->clip_scorer->topk(image_features, image_features_num, topk, labels, scores);
 }
\ No newline at end of file
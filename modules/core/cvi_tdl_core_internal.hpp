@@ -1,8 +1,11 @@
 #pragma once
+#include <future>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "core/cvi_tdl_core.h"
+#include "core/instance_pool.hpp"
 #include "core/vpss_engine.hpp"
 #include "core_internel.hpp"
 
@@ -12,11 +15,24 @@
 #include "ive/ive.hpp"
 #include "motion_detection/md.hpp"
 #include "tamper_detection/tamper_detection.hpp"
+
+namespace cvitdl {
+class ClipScorer;
+}
+
 typedef struct {
   cvitdl::Core *instance = nullptr;
   std::string model_path = "";
   uint32_t vpss_thread = 0;
   int8_t *buf = nullptr;
+  uint32_t buf_size = 0;
+  // model_path is a tensor record opened by CVI_TDL_OpenModelReplay
+  bool replay = false;
+  // instance and its replicas, inference calls check one of them out
+  std::shared_ptr<cvitdl::InstancePool> pool;
+  // extra instances added by CVI_TDL_SetModelInstances, each with its own vpss engine
+  std::vector<cvitdl::Core *> replicas;
+  std::vector<cvitdl::VpssEngine *> replica_engines;
 } cvitdl_model_t;
 
 // specialize std::hash for enum CVI_TDL_SUPPORTED_MODEL_E
@@ -38,9 +54,42 @@ typedef struct {
   TamperDetectorMD *td_model = nullptr;
   FallMD *fall_model = nullptr;
   FallDetMonitor *fall_monitor_model = nullptr;
+  cvitdl::ClipScorer *clip_scorer = nullptr;
   bool use_gdc_wrap = false;
+  // result of the models opening in the background, see CVI_TDL_OpenModelsAsync
+  std::future<CVI_S32> model_loading;
+  // stages marked by the app running on the handle, see CVI_TDL_MarkAppStage
+  Timer app_timer{"app"};
 } cvitdl_context_t;
 
+// Exclusive use of one instance of a model for the duration of an inference call. The model is
+// looked up without inserting into model_cont, so leases can be taken from any thread. A primary
+// lease waits for the opened instance itself, for frames handed out and released through its vpss
+// engine by separate calls.
+class ModelLease {
+ public:
+  ModelLease(cvitdl_context_t *ctx, CVI_TDL_SUPPORTED_MODEL_E index, bool primary = false) {
+    auto iter = ctx->model_cont.find(index);
+    if (iter != ctx->model_cont.end() && iter->second.pool != nullptr) {
+      m_pool = iter->second.pool.get();
+      m_instance = primary ? m_pool->acquire(0) : m_pool->acquire();
+    }
+  }
+  ~ModelLease() {
+    if (m_instance != nullptr) {
+      m_pool->release(m_instance);
+    }
+  }
+  ModelLease(const ModelLease &) = delete;
+  ModelLease &operator=(const ModelLease &) = delete;
+
+  cvitdl::Core *get() const { return m_instance; }
+
+ private:
+  cvitdl::InstancePool *m_pool = nullptr;
+  cvitdl::Core *m_instance = nullptr;
+};
+
 inline const char *__attribute__((always_inline)) GetModelName(cvitdl_model_t &model) {
   return model.model_path.c_str();
 }
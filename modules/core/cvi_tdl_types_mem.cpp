@@ -2,6 +2,7 @@
 #include <string.h>
 #include <cvi_tdl_log.hpp>
 #include "core/cvi_tdl_types_mem_internal.h"
+#include "utils/frame_map_cache.hpp"
 // Free
 
 void CVI_TDL_FreeCpp(cvtdl_feature_t *feature) {
@@ -93,6 +94,10 @@ void CVI_TDL_FreeCpp(cvtdl_object_info_t *obj_info) {
       free(obj_info->mask_properity->mask_point);
       obj_info->mask_properity->mask_point = NULL;
     }
+    if (obj_info->mask_properity->mask_rle) {
+      free(obj_info->mask_properity->mask_rle);
+      obj_info->mask_properity->mask_rle = NULL;
+    }
     free(obj_info->mask_properity);
     obj_info->mask_properity = NULL;
   }
@@ -124,6 +129,17 @@ void CVI_TDL_FreeCpp(cvtdl_image_t *image) {
   image->width = 0;
 }
 
+void CVI_TDL_FreeCpp(cvtdl_image_batch_t *batch) {
+  free(batch->images);
+  free(batch->crop_boxes);
+  free(batch->buffer);
+  batch->images = NULL;
+  batch->crop_boxes = NULL;
+  batch->buffer = NULL;
+  batch->size = 0;
+  batch->capacity = 0;
+}
+
 void CVI_TDL_FreeCpp(cvtdl_handpose21_meta_ts *handposes) {
   if (handposes->info != NULL) {
     free(handposes->info);
@@ -157,6 +173,20 @@ void CVI_TDL_FreeCpp(cvtdl_seg_logits_t *seg_logits) {
   seg_logits->qscale = 0;
 }
 
+void CVI_TDL_FreeCpp(cvtdl_seg_label_t *seg_label) {
+  if (seg_label->labels != NULL) {
+    free(seg_label->labels);
+    seg_label->labels = NULL;
+  }
+  if (seg_label->rle != NULL) {
+    free(seg_label->rle);
+    seg_label->rle = NULL;
+  }
+  seg_label->width = 0;
+  seg_label->height = 0;
+  seg_label->rle_size = 0;
+}
+
 void CVI_TDL_FreeCpp(cvtdl_lane_t *lane_meta) {
   if (lane_meta->lane != NULL) {
     // for (uint32_t i = 0; i < lane_meta->size; i++) {
@@ -190,12 +220,16 @@ void CVI_TDL_FreeObject(cvtdl_object_t *obj) { CVI_TDL_FreeCpp(obj); }
 
 void CVI_TDL_FreeImage(cvtdl_image_t *image) { CVI_TDL_FreeCpp(image); }
 
+void CVI_TDL_FreeImageBatch(cvtdl_image_batch_t *batch) { CVI_TDL_FreeCpp(batch); }
+
 void CVI_TDL_FreeDMS(cvtdl_dms_t *dms) { CVI_TDL_FreeCpp(dms); }
 
 void CVI_TDL_FreeHandPoses(cvtdl_handpose21_meta_ts *handposes) { CVI_TDL_FreeCpp(handposes); }
 
 void CVI_TDL_FreeClassMeta(cvtdl_class_meta_t *cls_meta) { CVI_TDL_FreeCpp(cls_meta); }
 
+void CVI_TDL_FreeSegLabel(cvtdl_seg_label_t *seg_label) { CVI_TDL_FreeCpp(seg_label); }
+
 void CVI_TDL_FreeLane(cvtdl_lane_t *lane_meta) { CVI_TDL_FreeCpp(lane_meta); }
 
 void CVI_TDL_FreeClip(cvtdl_clip_feature *clip_meta) { CVI_TDL_FreeCpp(clip_meta); }
@@ -417,27 +451,19 @@ void CVI_TDL_CopyImage(const cvtdl_image_t *src_image, cvtdl_image_t *dst_image)
 }
 
 void CVI_TDL_MapImage(VIDEO_FRAME_INFO_S *frame, bool *p_is_mapped) {
-  *p_is_mapped = false;
-  CVI_U32 frame_size =
-      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
-  if (frame->stVFrame.pu8VirAddr[0] == NULL) {
-    frame->stVFrame.pu8VirAddr[0] =
-        (CVI_U8 *)CVI_SYS_Mmap(frame->stVFrame.u64PhyAddr[0], frame_size);
-    frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
-    frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
-    *p_is_mapped = true;
-  }
+  *p_is_mapped = cvitdl::FrameMapCache::instance().map(frame);
 }
 void CVI_TDL_UnMapImage(VIDEO_FRAME_INFO_S *frame, bool do_unmap) {
-  CVI_U32 frame_size =
-      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
   if (do_unmap) {
-    CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], frame_size);
-    frame->stVFrame.pu8VirAddr[0] = NULL;
-    frame->stVFrame.pu8VirAddr[1] = NULL;
-    frame->stVFrame.pu8VirAddr[2] = NULL;
+    cvitdl::FrameMapCache::instance().unmap(frame);
   }
 }
+CVI_S32 CVI_TDL_BeginFrameMapping(VIDEO_FRAME_INFO_S *frame) {
+  return cvitdl::FrameMapCache::instance().beginFrame(frame);
+}
+CVI_S32 CVI_TDL_EndFrameMapping(VIDEO_FRAME_INFO_S *frame) {
+  return cvitdl::FrameMapCache::instance().endFrame(frame);
+}
 CVI_S32 CVI_TDL_CopyVpssImage(VIDEO_FRAME_INFO_S *src_frame, cvtdl_image_t *dst_image) {
   if (src_frame->stVFrame.enPixelFormat != dst_image->pix_format) {
     printf("pixel format type not match,src:%d,dst:%d\n", (int)src_frame->stVFrame.enPixelFormat,
@@ -6,6 +6,7 @@
 #include "core/error_msg.hpp"
 #include "core/utils/vpss_helper.h"
 #include "utils/core_utils.hpp"
+#include "utils/crop_batch.hpp"
 
 #ifndef NO_OPENCV
 #include "utils/face_utils.hpp"
@@ -13,15 +14,6 @@
 #endif
 #include <string>
 
-/** NOTE: If turn on DO_ALIGN_STRIDE, we can not copy the data from cv::Mat directly. */
-/** TODO: If ALIGN is not necessary in TDL SDK, remove it in the future. */
-#define DO_ALIGN_STRIDE
-#ifdef DO_ALIGN_STRIDE
-#define GET_TDL_IMAGE_STRIDE(x) (ALIGN((x), DEFAULT_ALIGN))
-#else
-#define GET_TDL_IMAGE_STRIDE(x) (x)
-#endif
-
 CVI_S32 CVI_TDL_Dequantize(const int8_t *quantizedData, float *data, const uint32_t bufferSize,
                            const float dequantizeThreshold) {
   cvitdl::Dequantize(quantizedData, data, dequantizeThreshold, bufferSize);
@@ -143,73 +135,14 @@ CVI_S32 CVI_TDL_CreateImage(cvtdl_image_t *image, uint32_t height, uint32_t widt
     LOGE("destination image is not empty.");
     return CVI_TDL_ERR_INVALID_ARGS;
   }
-  image->pix_format = fmt;
-  image->height = height;
-  image->width = width;
-
-  /* NOTE: Refer to vpss_helper.h*/
-  switch (fmt) {
-    case PIXEL_FORMAT_RGB_888: {
-      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width * 3);
-      image->stride[1] = 0;
-      image->stride[2] = 0;
-      image->length[0] = image->stride[0] * image->height;
-      image->length[1] = 0;
-      image->length[2] = 0;
-    } break;
-    case PIXEL_FORMAT_RGB_888_PLANAR: {
-      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->stride[2] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->length[0] = image->stride[0] * image->height;
-      image->length[1] = image->stride[1] * image->height;
-      image->length[2] = image->stride[2] * image->height;
-    } break;
-    case PIXEL_FORMAT_NV21: {
-      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->stride[2] = 0;
-      image->length[0] = image->stride[0] * image->height;
-      image->length[1] = image->stride[0] * (image->height >> 1);
-      image->length[2] = 0;
-    } break;
-    case PIXEL_FORMAT_YUV_PLANAR_420: {
-      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
-      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width >> 1);
-      image->stride[2] = GET_TDL_IMAGE_STRIDE(image->width >> 1);
-      image->length[0] = image->stride[0] * image->height;
-      image->length[1] = image->stride[1] * (image->height >> 1);
-      image->length[2] = image->stride[2] * (image->height >> 1);
-    } break;
-    default:
-      LOGE("Currently unsupported format %u\n", fmt);
-      return CVI_TDL_ERR_INVALID_ARGS;
-  }
-
-  uint32_t image_size = image->length[0] + image->length[1] + image->length[2];
-  image->pix[0] = (uint8_t *)malloc(image_size);
-  memset(image->pix[0], 0, image_size);
-  switch (fmt) {
-    case PIXEL_FORMAT_RGB_888: {
-      image->pix[1] = NULL;
-      image->pix[2] = NULL;
-    } break;
-    case PIXEL_FORMAT_RGB_888_PLANAR: {
-      image->pix[1] = image->pix[0] + image->length[0];
-      image->pix[2] = image->pix[1] + image->length[1];
-    } break;
-    case PIXEL_FORMAT_NV21: {
-      image->pix[1] = image->pix[0] + image->length[0];
-      image->pix[2] = NULL;
-    } break;
-    case PIXEL_FORMAT_YUV_PLANAR_420: {
-      image->pix[1] = image->pix[0] + image->length[0];
-      image->pix[2] = image->pix[1] + image->length[1];
-    } break;
-    default:
-      LOGE("Currently unsupported format %u\n", fmt);
-      return CVI_TDL_ERR_INVALID_ARGS;
+  uint32_t image_size = cvitdl::image_layout(image, height, width, fmt);
+  uint8_t *data = (uint8_t *)malloc(image_size);
+  if (data == NULL && image_size > 0) {
+    LOGE("alloc image failed, size: %u\n", image_size);
+    return CVI_TDL_FAILURE;
   }
+  memset(data, 0, image_size);
+  cvitdl::image_attach(image, data);
 
 #if 0
   LOGI("[create image] format[%d], height[%u], width[%u], stride[%u][%u][%u], length[%u][%u][%u]\n",
@@ -5,6 +5,7 @@
 #include "cvi_tdl_log.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
@@ -1845,6 +1846,89 @@ CVI_S32 DeepSORT::get_trackers_inactive(cvtdl_tracker_t *tracker) const {
   return CVI_TDL_SUCCESS;
 }
 
+cvtdl_deepsort_config_t *DeepSORT::get_conf(int class_id) {
+  auto it_conf = specific_conf.find(class_id);
+  return it_conf != specific_conf.end() ? &it_conf->second : &default_conf;
+}
+
+uint32_t DeepSORT::detection_interval() const {
+  float max_speed = 0.f;
+  bool confirmed = false;
+  for (const KalmanTracker &tracker_ : k_trackers) {
+    if (tracker_.tracker_state == k_tracker_state_e::PROBATION) {
+      return skip_conf_.min_interval;
+    }
+    if (tracker_.tracker_state != k_tracker_state_e::ACCREDITATION ||
+        tracker_.unmatched_times != 0) {
+      continue;
+    }
+    confirmed = true;
+    /* state: center x, center y, aspect ratio, height and their velocities */
+    float h = std::max(tracker_.x(3), 1.f);
+    float speed = std::max(std::sqrt(tracker_.x(4) * tracker_.x(4) + tracker_.x(5) * tracker_.x(5)),
+                           std::fabs(tracker_.x(7))) /
+                  h;
+    max_speed = std::max(max_speed, speed);
+  }
+  if (!confirmed) {
+    return skip_conf_.min_interval;
+  }
+  float interval = max_speed > 0.f ? skip_conf_.max_drift / max_speed : skip_conf_.max_interval;
+  if (interval <= skip_conf_.min_interval) {
+    return skip_conf_.min_interval;
+  }
+  return interval >= skip_conf_.max_interval ? skip_conf_.max_interval : (uint32_t)interval;
+}
+
+bool DeepSORT::need_detection(bool scene_changed) {
+  if (!skip_conf_.enable || scene_changed || skipped_frames_ + 1 >= detection_interval()) {
+    skipped_frames_ = 0;
+    return true;
+  }
+  skipped_frames_++;
+  return false;
+}
+
+CVI_S32 DeepSORT::predict(cvtdl_object_t *obj, cvtdl_tracker_t *tracker) {
+  std::vector<const KalmanTracker *> tracked;
+  for (KalmanTracker &tracker_ : k_trackers) {
+    if (tracker_.tracker_state == k_tracker_state_e::MISS ||
+        tracker_.kalman_state != kalman_state_e::UPDATED) {
+      continue;
+    }
+    tracker_.coast(kf_, get_conf(tracker_.class_id));
+    if (tracker_.unmatched_times == 0) {
+      tracked.push_back(&tracker_);
+    }
+  }
+
+  uint32_t num = static_cast<uint32_t>(tracked.size());
+  CVI_TDL_MemAllocInit(num, obj);
+  CVI_TDL_MemAlloc(num, tracker);
+  for (uint32_t i = 0; i < num; i++) {
+    const KalmanTracker &tracker_ = *tracked[i];
+    BBOX t_bbox = tracker_.getBBox_TLWH();
+    cvtdl_trk_state_type_t state = tracker_.tracker_state == k_tracker_state_e::ACCREDITATION
+                                       ? cvtdl_trk_state_type_t::CVI_TRACKER_STABLE
+                                       : cvtdl_trk_state_type_t::CVI_TRACKER_UNSTABLE;
+    cvtdl_bbox_t bbox;
+    bbox.x1 = t_bbox(0);
+    bbox.y1 = t_bbox(1);
+    bbox.x2 = t_bbox(0) + t_bbox(2);
+    bbox.y2 = t_bbox(1) + t_bbox(3);
+    bbox.score = 0.f;
+    obj->info[i].bbox = bbox;
+    obj->info[i].classes = tracker_.class_id;
+    obj->info[i].unique_id = tracker_.id;
+    obj->info[i].track_state = state;
+    tracker->info[i].bbox = bbox;
+    tracker->info[i].id = tracker_.id;
+    tracker->info[i].state = state;
+    tracker->info[i].out_num = tracker_.out_nums;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
 // static void FACE_QUALITY_ASSESSMENT(cvtdl_face_t *face) {
 //   for (uint32_t i = 0; i < face->size; i++) {
 //     cvtdl_bbox_t &bbox = face->info[i].bbox;
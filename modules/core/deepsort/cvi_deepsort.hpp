@@ -71,6 +71,13 @@ class DeepSORT {
   void cleanCounter();
 
   CVI_S32 get_trackers_inactive(cvtdl_tracker_t *tracker) const;
+
+  // Detection skipping: need_detection() tells whether the detector should run on this frame, if
+  // not predict() serves the frame from the Kalman state of the tracks.
+  void set_skip_config(const cvtdl_deepsort_skip_config_t &skip_conf) { skip_conf_ = skip_conf; }
+  cvtdl_deepsort_skip_config_t get_skip_config() const { return skip_conf_; }
+  bool need_detection(bool scene_changed);
+  CVI_S32 predict(cvtdl_object_t *obj, cvtdl_tracker_t *tracker);
   void set_timestamp(uint32_t ts) { current_timestamp_ = ts; }
 
   /* DEBUG CODE */
@@ -105,7 +112,12 @@ class DeepSORT {
   std::map<uint64_t, int> track_indices_;
   std::map<uint64_t, std::vector<float>> old_coordinate;
 
+  cvtdl_deepsort_skip_config_t skip_conf_ = {false, 1, 1, 0.f};
+  uint32_t skipped_frames_ = 0;
+
   uint64_t get_nextID(int class_id);
+  cvtdl_deepsort_config_t *get_conf(int class_id);
+  uint32_t detection_interval() const;
   MatchResult get_match_result(MatchResult &prev_match, const std::vector<BBOX> &BBoxes,
                                const std::vector<FEATURE> &Features, bool use_reid,
                                float crowd_iou_thresh, cvtdl_deepsort_config_t *conf);
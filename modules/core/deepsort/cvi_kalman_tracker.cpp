@@ -291,6 +291,11 @@ void KalmanTracker::predict(KalmanFilter &kf, cvtdl_deepsort_config_t *conf) {
   unmatched_times += 1;
   ages_ += 1;
 }
+
+void KalmanTracker::coast(KalmanFilter &kf, cvtdl_deepsort_config_t *conf) {
+  kf.predict(kalman_state, x, P, conf->kfilter_conf);
+  kalman_state = kalman_state_e::UPDATED;
+}
 //
 void KalmanTracker::update(KalmanFilter &kf, const stRect *p_tlwh_bbox,
                            cvtdl_deepsort_config_t *conf) {
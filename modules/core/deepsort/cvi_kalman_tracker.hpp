@@ -58,6 +58,8 @@ class KalmanTracker : public Tracker {
                               cvtdl_deepsort_config_t *conf);
   void update_pair_info(KalmanTracker *p_other);
   void predict(KalmanFilter &kf, cvtdl_deepsort_config_t *conf);
+  // Advance one frame the detector skipped. Unlike predict(), the frame is not counted as a miss.
+  void coast(KalmanFilter &kf, cvtdl_deepsort_config_t *conf);
   void update(KalmanFilter &kf, const stRect *p_bbox, cvtdl_deepsort_config_t *conf);
   BBOX getBBox_TLWH() const;
 
@@ -91,22 +91,20 @@ int RetinaFace::onModelOpened() {
 
   std::vector<std::vector<anchor_box>> anchors_fpn =
       generate_anchors_fpn(false, cfg, this->process_);
-  std::map<std::string, std::vector<anchor_box>> anchors_fpn_map;
-  for (size_t i = 0; i < anchors_fpn.size(); i++) {
-    std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-    anchors_fpn_map[key] = anchors_fpn[i];
-    m_num_anchors[key] = anchors_fpn[i].size();
-  }
-
+  bool add_landmark_process = getNumOutputTensor() == 9;
+  m_fpn_levels.clear();
+  m_fpn_levels.resize(m_feat_stride_fpn.size());
   for (size_t i = 0; i < m_feat_stride_fpn.size(); i++) {
     int stride = m_feat_stride_fpn[i];
-
-    std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-    std::string bbox_str = NAME_BBOX + key;
-    CVI_SHAPE bbox_shape = getOutputShape(bbox_str.c_str());
-
-    m_anchors[bbox_str] =
-        anchors_plane(bbox_shape.dim[2], bbox_shape.dim[3], stride, anchors_fpn_map[key]);
+    std::string key = "stride" + std::to_string(stride) + suffix_info;
+    FpnLevel &level = m_fpn_levels[i];
+    level.score = getOutputTensorView(NAME_SCORE + key);
+    level.bbox = getOutputTensorView(NAME_BBOX + key);
+    if (add_landmark_process) {
+      level.landmark = getOutputTensorView(NAME_LANDMARK + key);
+    }
+    level.num_anchors = anchors_fpn[i].size();
+    level.anchors = anchors_plane(level.bbox.dims[2], level.bbox.dims[3], stride, anchors_fpn[i]);
   }
   return CVI_TDL_SUCCESS;
 }
@@ -136,17 +134,14 @@ void RetinaFace::outputParser(int image_width, int image_height, int frame_width
   for (uint32_t b = 0; b < (uint32_t)input_shape.dim[0]; b++) {
     std::vector<cvtdl_face_info_t> vec_bbox;
     std::vector<cvtdl_face_info_t> vec_bbox_nms;
-    for (size_t i = 0; i < m_feat_stride_fpn.size(); i++) {
-      std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-
-      std::string score_str = NAME_SCORE + key;
-      CVI_SHAPE score_shape = getOutputShape(score_str.c_str());
-      size_t score_size = score_shape.dim[1] * score_shape.dim[2] * score_shape.dim[3];
-      float *score_blob = getOutputRawPtr<float>(score_str.c_str()) + (b * score_size);
+    for (size_t i = 0; i < m_fpn_levels.size(); i++) {
+      const FpnLevel &level = m_fpn_levels[i];
+      size_t score_size = level.score.batch_stride;
+      const float *score_blob = level.score.get<float>(b);
 
-      bool add_hardhat_score = (score_shape.dim[1] == 6);
-      float *hardhat_score_blob = 0;
-      float *nohardhat_score_blob = 0;
+      bool add_hardhat_score = (level.score.dims[1] == 6);
+      const float *hardhat_score_blob = 0;
+      const float *nohardhat_score_blob = 0;
 
       if (add_hardhat_score) {
         // let score as non face, face conf would be 1 - score
@@ -157,28 +152,19 @@ void RetinaFace::outputParser(int image_width, int image_height, int frame_width
         score_blob += score_size / 2;
       }
 
-      std::string bbox_str = NAME_BBOX + key;
-      CVI_SHAPE blob_shape = getOutputShape(bbox_str.c_str());
-      size_t blob_size = blob_shape.dim[1] * blob_shape.dim[2] * blob_shape.dim[3];
-      float *bbox_blob = getOutputRawPtr<float>(bbox_str.c_str()) + (b * blob_size);
+      const float *bbox_blob = level.bbox.get<float>(b);
 
-      size_t output_number = getNumOutputTensor();
-      bool add_landmark_process = (output_number == 9);
-
-      float *landmark_blob = 0;
+      bool add_landmark_process = level.landmark.data != nullptr;
+      const float *landmark_blob = 0;
       if (add_landmark_process) {
-        std::string landmark_str = NAME_LANDMARK + key;
-        CVI_SHAPE landmark_shape = getOutputShape(landmark_str.c_str());
-        size_t landmark_size =
-            landmark_shape.dim[1] * landmark_shape.dim[2] * landmark_shape.dim[3];
-        landmark_blob = getOutputRawPtr<float>(landmark_str.c_str()) + (b * landmark_size);
-      };
-      int width = blob_shape.dim[3];
-      int height = blob_shape.dim[2];
+        landmark_blob = level.landmark.get<float>(b);
+      }
+      int width = level.bbox.dims[3];
+      int height = level.bbox.dims[2];
       size_t count = width * height;
-      size_t num_anchor = m_num_anchors[key];
+      size_t num_anchor = level.num_anchors;
 
-      std::vector<anchor_box> anchors = m_anchors[bbox_str];
+      const std::vector<anchor_box> &anchors = level.anchors;
       for (size_t num = 0; num < num_anchor; num++) {
         for (size_t j = 0; j < count; j++) {
           float conf = -1;
@@ -18,8 +18,15 @@ class RetinaFace final : public FaceDetectionBase {
   void outputParser(int image_width, int image_height, int frame_width, int frame_height,
                     cvtdl_face_t *meta);
   std::vector<int> m_feat_stride_fpn;
-  std::map<std::string, std::vector<anchor_box>> m_anchors;
-  std::map<std::string, int> m_num_anchors;
+  // output branches and anchors of each stride in m_feat_stride_fpn, resolved at model open
+  struct FpnLevel {
+    TensorView score;
+    TensorView bbox;
+    TensorView landmark;  // no data without a landmark branch
+    size_t num_anchors = 0;
+    std::vector<anchor_box> anchors;
+  };
+  std::vector<FpnLevel> m_fpn_levels;
   PROCESS process_;
 };
 }  // namespace cvitdl
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include "retina_face_utils.hpp"
 
 #include <math.h>
-#include <iostream>
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/cvi_tdl_types_mem_internal.h"
@@ -51,6 +50,7 @@ int ScrFDFace::onModelOpened() {
   // std::cout << "start to parse node\n";
   std::map<std::string, std::vector<anchor_box>> anchors_fpn_map;
   CVI_SHAPE input_shape = getInputShape(0);
+  fpn_branches_.clear();
   for (size_t i = 0; i < cfg.size(); i++) {
     std::vector<std::vector<float>> base_anchors =
         generate_mmdet_base_anchors(cfg[i].BASE_SIZE, 0, cfg[i].RATIOS, cfg[i].SCALES);
@@ -86,13 +86,18 @@ int ScrFDFace::onModelOpened() {
       }
     }
     // std::cout << "numfeat:" << num_feat_branch << std::endl;
-    for (auto &kv : fpn_out_nodes_[stride]) {
-      std::cout << kv.first << ":" << kv.second << std::endl;
-    }
-    if (num_feat_branch != int(cfg.size())) {
-      LOGE("output nodenum error,got:%d,expected:%d at branch:%d", num_feat_branch, int(cfg.size()),
-           int(i));
+    std::map<std::string, std::string> &nodes = fpn_out_nodes_[stride];
+    if (num_feat_branch != int(cfg.size()) || nodes.count("score") == 0 ||
+        nodes.count("bbox") == 0 || nodes.count("landmark") == 0) {
+      LOGE("output nodenum error,got:%d,expected:%d at branch:%d\n", num_feat_branch,
+           int(cfg.size()), int(i));
+      return CVI_TDL_FAILURE;
     }
+    FpnBranches branches;
+    branches.score = getOutputTensorView(nodes["score"]);
+    branches.bbox = getOutputTensorView(nodes["bbox"]);
+    branches.landmark = getOutputTensorView(nodes["landmark"]);
+    fpn_branches_.push_back(branches);
   }
   return CVI_TDL_SUCCESS;
 }
@@ -131,26 +136,12 @@ void ScrFDFace::outputParser(int image_width, int image_height, int frame_width,
     std::vector<cvtdl_face_info_t> vec_bbox_nms;
     for (size_t i = 0; i < m_feat_stride_fpn.size(); i++) {
       int stride = m_feat_stride_fpn[i];
-      std::string score_str = fpn_out_nodes_[stride]["score"];
-      CVI_SHAPE score_shape = getOutputShape(score_str.c_str());
-      // std::cout << "stride:" << m_feat_stride_fpn[i] << "\n";
-      // print_dim(score_shape, "score");
-      size_t score_size = score_shape.dim[1] * score_shape.dim[2] * score_shape.dim[3];
-      float *score_blob = getOutputRawPtr<float>(score_str.c_str()) + (b * score_size);
-
-      std::string bbox_str = fpn_out_nodes_[stride]["bbox"];
-      CVI_SHAPE blob_shape = getOutputShape(bbox_str.c_str());
-      // print_dim(blob_shape, "bbox");
-      size_t blob_size = blob_shape.dim[1] * blob_shape.dim[2] * blob_shape.dim[3];
-      float *bbox_blob = getOutputRawPtr<float>(bbox_str.c_str()) + (b * blob_size);
-
-      std::string landmark_str = fpn_out_nodes_[stride]["landmark"];
-      CVI_SHAPE landmark_shape = getOutputShape(landmark_str.c_str());
-      // print_dim(blob_shape, "bbox");
-      size_t landmark_size = landmark_shape.dim[1] * landmark_shape.dim[2] * landmark_shape.dim[3];
-      float *landmark_blob = getOutputRawPtr<float>(landmark_str.c_str()) + (b * landmark_size);
-      int width = blob_shape.dim[3];
-      int height = blob_shape.dim[2];
+      const FpnBranches &branches = fpn_branches_[i];
+      const float *score_blob = branches.score.get<float>(b);
+      const float *bbox_blob = branches.bbox.get<float>(b);
+      const float *landmark_blob = branches.landmark.get<float>(b);
+      int width = branches.bbox.dims[3];
+      int height = branches.bbox.dims[2];
       size_t count = width * height;
       size_t num_anchor = fpn_grid_anchor_num_[stride];
       // std::cout << "numanchor:" << num_anchor << ",count:" << count << "\n";
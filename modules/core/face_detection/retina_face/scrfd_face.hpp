@@ -24,6 +24,13 @@ class ScrFDFace : public FaceDetectionBase {
   std::map<int, std::map<std::string, std::string>>
       fpn_out_nodes_;  //{stride:{"box":"xxxx","score":"xxx","landmark":"xxxx"}}
   std::map<int, int> fpn_grid_anchor_num_;
+  struct FpnBranches {
+    TensorView score;
+    TensorView bbox;
+    TensorView landmark;
+  };
+  // output branches of each stride in m_feat_stride_fpn, resolved at model open
+  std::vector<FpnBranches> fpn_branches_;
 
   PROCESS process_;
 };
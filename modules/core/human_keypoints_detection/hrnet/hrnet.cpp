@@ -3,7 +3,6 @@
 #include <cmath>
 #include <iterator>
 
-#include <iostream>
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
@@ -11,6 +10,7 @@
 #include "core_utils.hpp"
 #include "cvi_sys.h"
 #include "hrnet.hpp"
+#include "keypoint_decode.hpp"
 #include "object_utils.hpp"
 
 // #define R_SCALE (float)(1.0 / 58.395)
@@ -39,16 +39,6 @@ Hrnet::Hrnet() {
   m_model_threshold = 0.3f;
 }
 
-float getSignedValue(float value) {
-  if (value < 0) {
-    return -1.0;
-  } else if (value == 0.0) {
-    return 0.0;
-  } else {
-    return 1.0;
-  }
-}
-
 int Hrnet::inference(VIDEO_FRAME_INFO_S *stOutFrame, cvtdl_object_t *obj_meta) {
   int infer_num = std::min((int)obj_meta->size, MAX_NUM);
   for (int i = 0; i < infer_num; i++) {
@@ -104,66 +94,29 @@ void Hrnet::outputParser(const float nn_width, const float nn_height, const int
                          int index) {
   TensorInfo oinfo = getOutputTensorInfo(0);
   CVI_SHAPE output_shape = oinfo.shape;
-
-  int num_per_pixel = oinfo.tensor_size / oinfo.tensor_elem;
-  float qscale = num_per_pixel == 1 ? oinfo.qscale : 1;
-
-  obj->info[index].pedestrian_properity =
-      (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
-  int batch_size = output_shape.dim[0];
   int num_joints = output_shape.dim[1];
   int height = output_shape.dim[2];
   int width = output_shape.dim[3];
 
-  if (qscale == 1) {
-    float *ptr_float = static_cast<float *>(oinfo.raw_pointer);
-    getMaxPreds(batch_size, num_joints, height, width, ptr_float, preds, maxvals, qscale);
-    for (int i = 0; i < num_joints; i++) {
-      int row = static_cast<int>(std::floor(preds[2 * i] + 0.5));
-      int col = static_cast<int>(std::floor(preds[2 * i + 1] + 0.5));
-      if (1 < col && col < width - 1 && 1 < row && row < height - 1) {
-        float diff_x = ptr_float[i * height * width + row * width + col + 1] * qscale -
-                       ptr_float[i * height * width + row * width + col - 1] * qscale;
-        float diff_y = ptr_float[i * height * width + (row + 1) * width + col] * qscale -
-                       ptr_float[i * height * width + (row - 1) * width + col] * qscale;
-        std::cout << "before" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-
-        diff_x = getSignedValue(diff_x);
-        diff_y = getSignedValue(diff_y);
-        preds[2 * i] += diff_x * 0.25;
-        preds[2 * i + 1] += diff_y * 0.25;
-
-        std::cout << "after" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << "float ptr: diff_x=" << diff_x * 0.25 << ", diff_y=" << diff_y << std::endl;
-      }
-      obj->info[index].pedestrian_properity->pose_17.x[i] = preds[2 * i + 1] * 4;
-      obj->info[index].pedestrian_properity->pose_17.y[i] = preds[2 * i] * 4;
-      obj->info[index].pedestrian_properity->pose_17.score[i] = maxvals[i];
-    }
+  keypoints_.resize(num_joints);
+  if (oinfo.tensor_size == oinfo.tensor_elem) {
+    decode_heatmaps(static_cast<int8_t *>(oinfo.raw_pointer), oinfo.qscale, num_joints, height,
+                    width, KeypointRefine::DARK, keypoints_.data());
   } else {
-    int8_t *ptr_int8 = static_cast<int8_t *>(oinfo.raw_pointer);
-    getMaxPreds(batch_size, num_joints, height, width, ptr_int8, preds, maxvals, qscale);
-    for (int i = 0; i < num_joints; i++) {
-      int row = static_cast<int>(std::floor(preds[2 * i] + 0.5));
-      int col = static_cast<int>(std::floor(preds[2 * i + 1] + 0.5));
-      if (1 < col && col < width - 1 && 1 < row && row < height - 1) {
-        float diff_x = ptr_int8[i * height * width + row * width + col + 1] * qscale -
-                       ptr_int8[i * height * width + row * width + col - 1] * qscale;
-        float diff_y = ptr_int8[i * height * width + (row + 1) * width + col] * qscale -
-                       ptr_int8[i * height * width + (row - 1) * width + col] * qscale;
-        diff_x = getSignedValue(diff_x);
-        diff_y = getSignedValue(diff_y);
-        std::cout << "before" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        preds[2 * i] += diff_x * 0.25;
-        preds[2 * i + 1] += diff_y * 0.25;
-        std::cout << "after" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << "int ptr: diff_x=" << diff_x * 0.25 << ", diff_y=" << diff_y << std::endl;
-      }
-      obj->info[index].pedestrian_properity->pose_17.x[i] = preds[2 * i + 1] * 4;
-      obj->info[index].pedestrian_properity->pose_17.y[i] = preds[2 * i] * 4;
-      obj->info[index].pedestrian_properity->pose_17.score[i] = maxvals[i];
-    }
+    decode_heatmaps(static_cast<float *>(oinfo.raw_pointer), 1, num_joints, height, width,
+                    KeypointRefine::DARK, keypoints_.data());
+  }
+
+  obj->info[index].pedestrian_properity =
+      (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
+  memset(obj->info[index].pedestrian_properity, 0, sizeof(cvtdl_pedestrian_meta));
+  cvtdl_pose17_meta_t &pose = obj->info[index].pedestrian_properity->pose_17;
+  float stride_x = nn_width / width;
+  float stride_y = nn_height / height;
+  for (int i = 0; i < std::min(num_joints, NUM_KEYPOINTS); i++) {
+    pose.x[i] = keypoints_[i].x * stride_x;
+    pose.y[i] = keypoints_[i].y * stride_y;
+    pose.score[i] = keypoints_[i].score;
   }
 
   float scale_ratio, pad_w, pad_h;
@@ -187,34 +140,4 @@ void Hrnet::outputParser(const float nn_width, const float nn_height, const int
   }
 }
 
-template <typename T>
-void Hrnet::getMaxPreds(int batch_size, int num_joints, int height, int width, T *ptr_data,
-                        std::vector<float> &preds, std::vector<float> &maxvals, float qscale) {
-  preds.clear();
-  maxvals.clear();
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < num_joints; j++) {
-      float maxval = 0.0;
-      float maxrow = 0;
-      float maxcol = 0;
-      for (int h = 0; h < height; h++) {
-        for (int w = 0; w < width; w++) {
-          float val =
-              ptr_data[i * num_joints * height * width + j * height * width + h * width + w] *
-              qscale;
-          if (val > maxval) {
-            maxval = val;
-            maxrow = h * 1.0;
-            maxcol = w * 1.0;
-          }
-        }
-      }
-      maxvals.push_back(maxval);
-      preds.push_back(maxrow);
-      preds.push_back(maxcol);
-      // std::cout<<"row: "<<maxrow<<", col: "<<maxcol<<std::endl;
-    }
-  }
-}
-
 }  // namespace cvitdl
\ No newline at end of file
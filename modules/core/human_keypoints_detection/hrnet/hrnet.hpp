@@ -1,5 +1,6 @@
 #pragma once
 #include "core/face/cvtdl_face_types.h"
+#include "keypoint_decode.hpp"
 #include "pose_detection.hpp"
 
 namespace cvitdl {
@@ -14,11 +15,7 @@ class Hrnet final : public PoseDetectionBase {
   void outputParser(const float nn_width, const float nn_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj, std::vector<float> &box,
                     int index);
-  template <typename T>
-  void getMaxPreds(int batch_size, int num_joints, int height, int width, T *ptr_data,
-                   std::vector<float> &preds, std::vector<float> &maxvals, float qscale);
 
-  std::vector<float> preds;
-  std::vector<float> maxvals;
+  std::vector<Keypoint> keypoints_;
 };
 }  // namespace cvitdl
\ No newline at end of file
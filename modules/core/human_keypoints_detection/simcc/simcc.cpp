@@ -3,13 +3,13 @@
 #include <cmath>
 #include <iterator>
 
-#include <iostream>
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/cvi_tdl_types_mem_internal.h"
 #include "core_utils.hpp"
 #include "cvi_sys.h"
+#include "keypoint_decode.hpp"
 #include "object_utils.hpp"
 #include "simcc.hpp"
 
@@ -87,31 +87,31 @@ int Simcc::inference(VIDEO_FRAME_INFO_S *stOutFrame, cvtdl_object_t *obj_meta) {
 void Simcc::outputParser(const float nn_width, const float nn_height, const int frame_width,
                          const int frame_height, cvtdl_object_t *obj, std::vector<float> &box,
                          int index) {
-  float *data_x = getOutputRawPtr<float>(0);
-  float *data_y = getOutputRawPtr<float>(1);
-
-  CVI_SHAPE output0_shape = getOutputShape(0);
-  CVI_SHAPE output1_shape = getOutputShape(1);
+  TensorInfo oinfo_x = getOutputTensorInfo(0);
+  TensorInfo oinfo_y = getOutputTensorInfo(1);
+  int num_joints = std::min((int)oinfo_x.shape.dim[1], NUM_KEYPOINTS);
+  int len_x = oinfo_x.shape.dim[2];
+  int len_y = oinfo_y.shape.dim[2];
+
+  Keypoint keypoints[NUM_KEYPOINTS];
+  if (oinfo_x.tensor_size == oinfo_x.tensor_elem) {
+    decode_simcc(static_cast<int8_t *>(oinfo_x.raw_pointer), oinfo_x.qscale, len_x,
+                 static_cast<int8_t *>(oinfo_y.raw_pointer), oinfo_y.qscale, len_y, num_joints,
+                 EXPAND_RATIO, keypoints);
+  } else {
+    decode_simcc(static_cast<float *>(oinfo_x.raw_pointer), 1, len_x,
+                 static_cast<float *>(oinfo_y.raw_pointer), 1, len_y, num_joints, EXPAND_RATIO,
+                 keypoints);
+  }
 
   obj->info[index].pedestrian_properity =
       (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
-
-  for (int i = 0; i < NUM_KEYPOINTS; i++) {
-    float *score_start_x = data_x + i * output0_shape.dim[2];
-    float *score_end_x = data_x + (i + 1) * output0_shape.dim[2];
-    auto iter_x = std::max_element(score_start_x, score_end_x);
-    uint32_t pos_x = iter_x - score_start_x;
-    float score_x = *iter_x;
-
-    float *score_start_y = data_y + i * output1_shape.dim[2];
-    float *score_end_y = data_y + (i + 1) * output1_shape.dim[2];
-    auto iter_y = std::max_element(score_start_y, score_end_y);
-    uint32_t pos_y = iter_y - score_start_y;
-    float score_y = *iter_y;
-
-    obj->info[index].pedestrian_properity->pose_17.x[i] = (float)pos_x / EXPAND_RATIO;
-    obj->info[index].pedestrian_properity->pose_17.y[i] = (float)pos_y / EXPAND_RATIO;
-    obj->info[index].pedestrian_properity->pose_17.score[i] = std::min(score_x, score_y);
+  memset(obj->info[index].pedestrian_properity, 0, sizeof(cvtdl_pedestrian_meta));
+  cvtdl_pose17_meta_t &pose = obj->info[index].pedestrian_properity->pose_17;
+  for (int i = 0; i < num_joints; i++) {
+    pose.x[i] = keypoints[i].x;
+    pose.y[i] = keypoints[i].y;
+    pose.score[i] = keypoints[i].score;
   }
 
   float scale_ratio, pad_w, pad_h;
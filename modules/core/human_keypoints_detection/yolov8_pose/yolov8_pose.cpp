@@ -12,20 +12,9 @@
 
 namespace cvitdl {
 
-template <typename T>
-inline void parse_cls_info(T *p_cls_ptr, int num_anchor, int num_cls, int anchor_idx, float qscale,
-                           float *p_max_logit, int *p_max_cls) {
-  int max_logit_c = -1;
-  float max_logit = -1000;
-  for (int c = 0; c < num_cls; c++) {
-    float logit = p_cls_ptr[c * num_anchor + anchor_idx];
-    if (logit > max_logit) {
-      max_logit = logit;
-      max_logit_c = c;
-    }
-  }
-  *p_max_logit = max_logit * qscale;
-  *p_max_cls = max_logit_c;
+static AnchorFreeBranch get_branch(const TensorInfo &oinfo) {
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  return {oinfo.raw_pointer, is_int8 ? oinfo.qscale : 1, (int)oinfo.shape.dim[1], 0};
 }
 
 YoloV8Pose::YoloV8Pose() : YoloV8Pose(std::make_tuple(64, 17, 1)) {}
@@ -78,6 +67,31 @@ int YoloV8Pose::onModelOpened() {
       return CVI_FAILURE;
     }
   }
+  if (strides.empty()) {
+    LOGE("no box branch found\n");
+    return CVI_FAILURE;
+  }
+  for (int stride : strides) {
+    if (class_out_names.count(stride) == 0 || keypoints_out_names.count(stride) == 0) {
+      LOGE("incomplete branches for stride %d\n", stride);
+      return CVI_FAILURE;
+    }
+  }
+
+  const TensorInfo &cls_info = getOutputTensorInfo(class_out_names[strides[0]]);
+  const TensorInfo &box_info = getOutputTensorInfo(bbox_out_names[strides[0]]);
+  decoder_.setup(AnchorFreeBoxCoding::DFL, AnchorFreeLayout::CHW,
+                 cls_info.tensor_size == cls_info.tensor_elem,
+                 box_info.tensor_size == box_info.tensor_elem, m_cls_channel_, m_box_channel_ / 4,
+                 input_w, input_h);
+  kpts_infos_.clear();
+  for (int stride : strides) {
+    const TensorInfo &level_cls = getOutputTensorInfo(class_out_names[stride]);
+    const TensorInfo &level_box = getOutputTensorInfo(bbox_out_names[stride]);
+    decoder_.addLevel(stride, level_cls.shape.dim[3], level_cls.shape.dim[2],
+                      get_branch(level_cls), get_branch(level_box));
+    kpts_infos_.push_back(&getOutputTensorInfo(keypoints_out_names[stride]));
+  }
 
   return CVI_TDL_SUCCESS;
 }
@@ -99,71 +113,11 @@ int YoloV8Pose::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta
   return CVI_TDL_SUCCESS;
 }
 
-// the bbox featuremap shape is b x 4*regmax x h x w
-void YoloV8Pose::decode_bbox_feature_map(int stride, int anchor_idx,
-                                         std::vector<float> &decode_box) {
-  std::string box_name;
-
-  box_name = bbox_out_names[stride];
-  TensorInfo boxinfo = getOutputTensorInfo(box_name);
-
-  int num_per_pixel = boxinfo.tensor_size / boxinfo.tensor_elem;
-  int8_t *p_box_int8 = static_cast<int8_t *>(boxinfo.raw_pointer);
-  float *p_box_float = static_cast<float *>(boxinfo.raw_pointer);
-  int num_channel = boxinfo.shape.dim[1];
-  int num_anchor = boxinfo.shape.dim[2] * boxinfo.shape.dim[3];
-  int box_val_num = 4;
-  int reg_max = 16;
-  if (m_box_channel_ != box_val_num * reg_max) {
-    LOGE("box channel size not ok,got:%d\n", num_channel);
-  }
-
-  int32_t feat_w = boxinfo.shape.dim[3];
-
-  int anchor_y = anchor_idx / feat_w;
-  int anchor_x = anchor_idx % feat_w;
-
-  // LOGI("box numchannel:%d,numperpixel:%d,featw:%d,feath:%d,anchory:%d,anchorx:%d,numanchor:%d\n",
-  //      num_channel, num_per_pixel, feat_w, feat_h, anchor_y, anchor_x, num_anchor);
-
-  float grid_y = anchor_y + 0.5;
-  float grid_x = anchor_x + 0.5;
-
-  std::vector<float> grid_logits;  // 4x16
-  if (num_per_pixel == 1) {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_int8[c * num_anchor + anchor_idx] * boxinfo.qscale);
-    }
-  } else {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_float[c * num_anchor + anchor_idx]);
-    }
-  }
-
-  // compute softmax and accumulate val per 16
-  std::vector<float> box_vals;
-  for (int i = 0; i < box_val_num; i++) {
-    float sum_softmax = 0;
-    float sum_val = 0;
-    for (int j = 0; j < reg_max; j++) {
-      float expv = exp(grid_logits[i * reg_max + j]);
-      sum_softmax += expv;
-      sum_val += expv * j;
-    }
-    sum_softmax = sum_val / sum_softmax;
-    box_vals.push_back(sum_softmax);
-  }
-
-  std::vector<float> box = {(grid_x - box_vals[0]) * stride, (grid_y - box_vals[1]) * stride,
-                            (grid_x + box_vals[2]) * stride, (grid_y + box_vals[3]) * stride};
-  decode_box = box;
-}
-
-void YoloV8Pose::decode_keypoints_feature_map(int stride, int anchor_idx,
+void YoloV8Pose::decode_keypoints_feature_map(int level, int anchor_idx,
                                               std::vector<float> &decode_kpts) {
   decode_kpts.clear();
-  std::string kpts_name = keypoints_out_names[stride];
-  TensorInfo kpts_info = getOutputTensorInfo(kpts_name);
+  int stride = strides[level];
+  const TensorInfo &kpts_info = *kpts_infos_[level];
 
   int num_per_pixel = kpts_info.tensor_size / kpts_info.tensor_elem;
   int8_t *p_kpts_int8 = static_cast<int8_t *>(kpts_info.raw_pointer);
@@ -209,58 +163,13 @@ void YoloV8Pose::decode_keypoints_feature_map(int stride, int anchor_idx,
 void YoloV8Pose::outputParser(const int image_width, const int image_height, const int frame_width,
                               const int frame_height, cvtdl_object_t *obj_meta) {
   Detections vec_obj;
-  CVI_SHAPE shape = getInputShape(0);
-  int nn_width = shape.dim[3];
-  int nn_height = shape.dim[2];
-  float inverse_th = std::log(m_model_threshold / (1 - m_model_threshold));
-
   std::vector<std::pair<int, int>> valild_pairs;
-  for (size_t i = 0; i < strides.size(); i++) {
-    int stride = strides[i];
-    std::string cls_name = class_out_names[stride];
-
-    TensorInfo classinfo = getOutputTensorInfo(cls_name);
-
-    int num_per_pixel = classinfo.tensor_size / classinfo.tensor_elem;
-    int8_t *p_cls_int8 = static_cast<int8_t *>(classinfo.raw_pointer);
-    float *p_cls_float = static_cast<float *>(classinfo.raw_pointer);
-
-    int num_cls = m_cls_channel_;
-    int num_anchor = classinfo.shape.dim[2] * classinfo.shape.dim[3];
-    // LOGI("stride:%d,featw:%d,feath:%d,numperpixel:%d,numcls:%d\n", stride,
-    // classinfo.shape.dim[3],
-    //     classinfo.shape.dim[2], num_per_pixel, num_cls);
-    float cls_qscale = num_per_pixel == 1 ? classinfo.qscale : 1;
-    for (int j = 0; j < num_anchor; j++) {
-      int max_logit_c = -1;
-      float max_logit = -1000;
-      if (num_per_pixel == 1) {
-        parse_cls_info<int8_t>(p_cls_int8, num_anchor, num_cls, j, cls_qscale, &max_logit,
-                               &max_logit_c);
-      } else {
-        parse_cls_info<float>(p_cls_float, num_anchor, num_cls, j, cls_qscale, &max_logit,
-                              &max_logit_c);
-      }
-      if (max_logit < inverse_th) {
-        continue;
-      }
-      float score = 1 / (1 + exp(-max_logit));
-      std::vector<float> box;
-      decode_bbox_feature_map(stride, j, box);
-      PtrDectRect det = std::make_shared<object_detect_rect_t>();
-      det->score = score;
-      det->x1 = box[0];
-      det->y1 = box[1];
-      det->x2 = box[2];
-      det->y2 = box[3];
-      det->label = max_logit_c;
-      clip_bbox(nn_width, nn_height, det);
-      float box_width = det->x2 - det->x1;
-      float box_height = det->y2 - det->y1;
-      if (box_width > 1 && box_height > 1) {
-        vec_obj.push_back(det);
-        valild_pairs.push_back(std::make_pair(stride, j));
-      }
+  std::vector<int> anchor_ids;
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    anchor_ids.clear();
+    decoder_.decode(i, m_model_threshold, &vec_obj, &anchor_ids);
+    for (int anchor : anchor_ids) {
+      valild_pairs.push_back(std::make_pair((int)i, anchor));
     }
   }
   postProcess(vec_obj, frame_width, frame_height, obj_meta, valild_pairs);
@@ -1,5 +1,6 @@
 #pragma once
 #include <bitset>
+#include "anchor_free_decode.hpp"
 #include "core/object/cvtdl_object_types.h"
 #include "object_utils.hpp"
 #include "pose_detection.hpp"
@@ -23,8 +24,7 @@ class YoloV8Pose final : public PoseDetectionBase {
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
 
-  void decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box);
-  void decode_keypoints_feature_map(int stride, int anchor_idx, std::vector<float> &decode_kpts);
+  void decode_keypoints_feature_map(int level, int anchor_idx, std::vector<float> &decode_kpts);
 
   void postProcess(Detections &dets, int frame_width, int frame_height, cvtdl_object_t *obj,
                    std::vector<std::pair<int, int>> &valild_pairs);
@@ -36,5 +36,8 @@ class YoloV8Pose final : public PoseDetectionBase {
   int m_box_channel_ = 0;
   int m_kpts_channel_ = 0;
   int m_cls_channel_ = 0;
+  AnchorFreeDecoder decoder_;
+  // keypoint branch of each decoder level
+  std::vector<const TensorInfo *> kpts_infos_;
 };
 }  // namespace cvitdl
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
 #include <cmath>
 #include <iterator>
@@ -8,7 +9,6 @@
 #include <error_msg.hpp>
 #include <fstream>
 #include <iostream>
-#include "Eigen/Core"
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
@@ -16,6 +16,7 @@
 #include "core/utils/vpss_helper.h"
 #include "core_utils.hpp"
 #include "cvi_sys.h"
+#include "mask_rle.hpp"
 #include "object_utils.hpp"
 #include "opencv2/opencv.hpp"
 #include "yolov8_seg.hpp"
@@ -39,20 +40,47 @@ static void convert_det_struct(const Detections &dets, cvtdl_object_t *obj, int
   }
 }
 
+static AnchorFreeBranch get_branch(const TensorInfo &oinfo, int channel_offset) {
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  return {oinfo.raw_pointer, is_int8 ? oinfo.qscale : 1, (int)oinfo.shape.dim[1], channel_offset};
+}
+
+// Evaluate coeffs . proto only inside the box [x1, x2) x [y1, y2) of the prototype plane and
+// emit foreground runs. The pixel is foreground when the mask logit is >= 0, which is
+// sigmoid(logit) >= 0.5. A positive dequantization scale does not change the sign, so int8
+// prototypes are used as they are.
 template <typename T>
-inline void parse_cls_info(T *p_cls_ptr, int num_anchor, int num_cls, int anchor_idx,
-                           int cls_offset, float qscale, float *p_max_logit, int *p_max_cls) {
-  int max_logit_c = -1;
-  float max_logit = -1000;
-  for (int c = 0; c < num_cls; c++) {
-    float logit = p_cls_ptr[(c + cls_offset) * num_anchor + anchor_idx];
-    if (logit > max_logit) {
-      max_logit = logit;
-      max_logit_c = c;
+static void assemble_instance_mask(const T *p_proto, int proto_c, int proto_h, int proto_w,
+                                   const float *coeffs, int x1, int y1, int x2, int y2,
+                                   std::vector<float> &acc, MaskRleEncoder *encoder) {
+  int box_w = x2 - x1;
+  if (box_w <= 0 || y2 <= y1) {
+    return;
+  }
+  int proto_hw = proto_h * proto_w;
+  acc.resize(box_w);
+  float *p_acc = acc.data();
+  for (int y = y1; y < y2; ++y) {
+    std::fill(acc.begin(), acc.end(), 0.f);
+    for (int c = 0; c < proto_c; ++c) {
+      const T *p_row = p_proto + c * proto_hw + y * proto_w + x1;
+      const float coeff = coeffs[c];
+      for (int x = 0; x < box_w; ++x) {
+        p_acc[x] += coeff * p_row[x];
+      }
+    }
+    int x = 0;
+    while (x < box_w) {
+      while (x < box_w && p_acc[x] < 0) {
+        ++x;
+      }
+      int run_start = x;
+      while (x < box_w && p_acc[x] >= 0) {
+        ++x;
+      }
+      encoder->addSpan(y, x1 + run_start, x1 + x);
     }
   }
-  *p_max_logit = max_logit * qscale;
-  *p_max_cls = max_logit_c;
 }
 YoloV8Seg::YoloV8Seg() {
   // Default value
@@ -144,71 +172,63 @@ int YoloV8Seg::onModelOpened() {
     // remove the entry with the smallest key from mask_out_name
     mask_out_names.erase(min_it);
   }
+  if (strides.empty()) {
+    LOGE("no box branch found\n");
+    return CVI_FAILURE;
+  }
+  for (int stride : strides) {
+    if (mask_out_names.count(stride) == 0) {
+      LOGE("no mask branch found for stride %d\n", stride);
+      return CVI_FAILURE;
+    }
+  }
+  if (proto_out_names.empty()) {
+    LOGE("no proto branch found\n");
+    return CVI_FAILURE;
+  }
+  setupDecoder();
 
   return CVI_TDL_SUCCESS;
 }
 
-// the bbox featuremap shape is b x 4*regmax x h x w
-void YoloV8Seg::decode_bbox_feature_map(int stride, int anchor_idx,
-                                        std::vector<float> &decode_box) {
-  std::string box_name;
-  if (bbox_out_names.count(stride)) {
-    box_name = bbox_out_names[stride];
-  } else if (bbox_class_out_names.count(stride)) {
-    box_name = bbox_class_out_names[stride];
-  }
-  TensorInfo boxinfo = getOutputTensorInfo(box_name);
-
-  int num_per_pixel = boxinfo.tensor_size / boxinfo.tensor_elem;
-  int8_t *p_box_int8 = static_cast<int8_t *>(boxinfo.raw_pointer);
-  float *p_box_float = static_cast<float *>(boxinfo.raw_pointer);
-  int num_channel = boxinfo.shape.dim[1];
-  int num_anchor = boxinfo.shape.dim[2] * boxinfo.shape.dim[3];
-  int box_val_num = 4;
-  int reg_max = 16;
-  if (m_box_channel_ != box_val_num * reg_max) {
-    LOGE("box channel size not ok,got:%d\n", num_channel);
+void YoloV8Seg::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  DetectionBase::set_algparam(alg_param);
+  if (!strides.empty()) {
+    setupDecoder();
   }
+}
 
-  int32_t feat_w = boxinfo.shape.dim[3];
-
-  int anchor_y = anchor_idx / feat_w;
-  int anchor_x = anchor_idx % feat_w;
-
-  // LOGI("box numchannel:%d,numperpixel:%d,featw:%d,feath:%d,anchory:%d,anchorx:%d,numanchor:%d\n",
-  //      num_channel, num_per_pixel, feat_w, feat_h, anchor_y, anchor_x, num_anchor);
-
-  float grid_y = anchor_y + 0.5;
-  float grid_x = anchor_x + 0.5;
-
-  std::vector<float> grid_logits;  // 4x16
-  if (num_per_pixel == 1) {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_int8[c * num_anchor + anchor_idx] * boxinfo.qscale);
-    }
+// Class and box branches of stride. A fused box+class tensor is read at two channel offsets.
+void YoloV8Seg::getBranches(int stride, const TensorInfo **cls_info, const TensorInfo **box_info,
+                            int *cls_offset) {
+  if (bbox_class_out_names.count(stride)) {
+    *cls_info = &getOutputTensorInfo(bbox_class_out_names[stride]);
+    *box_info = *cls_info;
+    *cls_offset = m_box_channel_;
   } else {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_float[c * num_anchor + anchor_idx]);
-    }
+    *cls_info = &getOutputTensorInfo(class_out_names[stride]);
+    *box_info = &getOutputTensorInfo(bbox_out_names[stride]);
+    *cls_offset = 0;
   }
+}
 
-  // compute softmax and accumulate val per 16
-  std::vector<float> box_vals;
-  for (int i = 0; i < box_val_num; i++) {
-    float sum_softmax = 0;
-    float sum_val = 0;
-    for (int j = 0; j < reg_max; j++) {
-      float expv = exp(grid_logits[i * reg_max + j]);
-      sum_softmax += expv;
-      sum_val += expv * j;
-    }
-    sum_softmax = sum_val / sum_softmax;
-    box_vals.push_back(sum_softmax);
+void YoloV8Seg::setupDecoder() {
+  CVI_SHAPE input_shape = getInputShape(0);
+  const TensorInfo *cls_info, *box_info;
+  int cls_offset;
+  getBranches(strides[0], &cls_info, &box_info, &cls_offset);
+  decoder_.setup(AnchorFreeBoxCoding::DFL, AnchorFreeLayout::CHW,
+                 cls_info->tensor_size == cls_info->tensor_elem,
+                 box_info->tensor_size == box_info->tensor_elem, alg_param_.cls,
+                 m_box_channel_ / 4, input_shape.dim[3], input_shape.dim[2]);
+  mask_infos_.clear();
+  for (int stride : strides) {
+    getBranches(stride, &cls_info, &box_info, &cls_offset);
+    decoder_.addLevel(stride, cls_info->shape.dim[3], cls_info->shape.dim[2],
+                      get_branch(*cls_info, cls_offset), get_branch(*box_info, 0));
+    mask_infos_.push_back(&getOutputTensorInfo(mask_out_names[stride]));
   }
-
-  std::vector<float> box = {(grid_x - box_vals[0]) * stride, (grid_y - box_vals[1]) * stride,
-                            (grid_x + box_vals[2]) * stride, (grid_y + box_vals[3]) * stride};
-  decode_box = box;
+  proto_info_ = &getOutputTensorInfo(proto_out_names.begin()->second);
 }
 
 int YoloV8Seg::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
@@ -241,26 +261,26 @@ void YoloV8Seg::outputParser(const int image_width, const int image_height, cons
 
   int num_dets_to_crop = final_dets_id.size();
 
-  Eigen::MatrixXf mask_map(num_dets_to_crop, m_mask_channel_);
+  // mask coefficients of each final detection, num_dets x mask_channel
+  std::vector<float> mask_map(num_dets_to_crop * m_mask_channel_);
 
   int row = 0;
 
   // extract the corresponding mask_map based on the ID of the final detection box
   for (const auto &pair : final_dets_id) {
-    std::string mask_name;
-    mask_name = mask_out_names[pair.first];
-    TensorInfo maskinfo = getOutputTensorInfo(mask_name);
+    const TensorInfo &maskinfo = *mask_infos_[pair.first];
     int num_map = maskinfo.shape.dim[2] * maskinfo.shape.dim[3];
     int num_per_pixel = maskinfo.tensor_size / maskinfo.tensor_elem;
     int8_t *p_mask_int8 = static_cast<int8_t *>(maskinfo.raw_pointer);
     float *p_mask_float = static_cast<float *>(maskinfo.raw_pointer);
+    float *p_coeff = mask_map.data() + row * m_mask_channel_;
     if (num_per_pixel == 1) {
       for (int c = 0; c < m_mask_channel_; c++) {
-        mask_map(row, c) = p_mask_int8[c * num_map + pair.second] * maskinfo.qscale;
+        p_coeff[c] = p_mask_int8[c * num_map + pair.second] * maskinfo.qscale;
       }
     } else {
       for (int c = 0; c < m_mask_channel_; c++) {
-        mask_map(row, c) = p_mask_float[c * num_map + pair.second];
+        p_coeff[c] = p_mask_float[c * num_map + pair.second];
       }
     }
     row++;
@@ -269,56 +289,53 @@ void YoloV8Seg::outputParser(const int image_width, const int image_height, cons
   // obtain prototype branch data
   auto firstElement = proto_out_names.begin();
   int proto_stride = firstElement->first;
-  std::string proto_output_name = firstElement->second;
-
-  TensorInfo protoinfo = getOutputTensorInfo(proto_output_name);
+  const TensorInfo &protoinfo = *proto_info_;
 
   int proto_c = protoinfo.shape.dim[1];
   int proto_h = protoinfo.shape.dim[2];
   int proto_w = protoinfo.shape.dim[3];
-  int proto_hw = proto_h * proto_w;
-
-  Eigen::MatrixXf proto_output(proto_c, proto_hw);  // (32,96*160)
-
   int num_per_pixel = protoinfo.tensor_size / protoinfo.tensor_elem;
-  int8_t *p_proto_int8 = static_cast<int8_t *>(protoinfo.raw_pointer);
-  float *p_proto_float = static_cast<float *>(protoinfo.raw_pointer);
-  if (num_per_pixel == 1) {
-    for (int i = 0; i < proto_c; i++) {
-      for (int j = 0; j < proto_hw; j++) {
-        proto_output(i, j) = p_proto_int8[i * proto_hw + j] * protoinfo.qscale;
-      }
-    }
-  } else {
-    for (int i = 0; i < proto_c; i++) {
-      for (int j = 0; j < proto_hw; j++) {
-        proto_output(i, j) = p_proto_float[i * proto_hw + j];
-      }
-    }
+  if (proto_c != m_mask_channel_) {
+    LOGE("proto channel %d not equal to mask channel %d\n", proto_c, m_mask_channel_);
+    return;
   }
 
-  Eigen::MatrixXf masks_output = mask_map * proto_output;
-
   obj_meta->mask_height = proto_h;
   obj_meta->mask_width = proto_w;
+  std::vector<float> acc;
+  std::vector<uint32_t> rle;
+  MaskRleEncoder encoder;
   // 96*160
   for (uint32_t i = 0; i < obj_meta->size; i++) {
-    int x1 = static_cast<int>(round(obj_meta->info[i].bbox.x1 / proto_stride));
-    int x2 = static_cast<int>(round(obj_meta->info[i].bbox.x2 / proto_stride));
-    int y1 = static_cast<int>(round(obj_meta->info[i].bbox.y1 / proto_stride));
-    int y2 = static_cast<int>(round(obj_meta->info[i].bbox.y2 / proto_stride));
+    int x1 = std::max(static_cast<int>(round(obj_meta->info[i].bbox.x1 / proto_stride)), 0);
+    int x2 = std::min(static_cast<int>(round(obj_meta->info[i].bbox.x2 / proto_stride)), proto_w);
+    int y1 = std::max(static_cast<int>(round(obj_meta->info[i].bbox.y1 / proto_stride)), 0);
+    int y2 = std::min(static_cast<int>(round(obj_meta->info[i].bbox.y2 / proto_stride)), proto_h);
     if (obj_meta->info[i].mask_properity == NULL) {
-      obj_meta->info[i].mask_properity = (cvtdl_mask_meta *)malloc(sizeof(cvtdl_mask_meta));
-      if (obj_meta->info[i].mask_properity == NULL) {
-        LOGE("Failed to allocate memory for mask_properity\n");
-      }
+      obj_meta->info[i].mask_properity = (cvtdl_mask_meta *)calloc(1, sizeof(cvtdl_mask_meta));
     }
-    obj_meta->info[i].mask_properity->mask = (uint8_t *)calloc(proto_hw, sizeof(uint8_t));
-    for (int j = y1; j < y2; ++j) {
-      for (int k = x1; k < x2; ++k) {
-        if (1 / (1 + exp(-masks_output(i, j * proto_w + k))) >= 0.5) {
-          obj_meta->info[i].mask_properity->mask[j * proto_w + k] = 255;
-        }
+    cvtdl_mask_meta *mask_meta = obj_meta->info[i].mask_properity;
+    if (mask_meta == NULL) {
+      LOGE("Failed to allocate memory for mask_properity\n");
+    } else {
+      encoder.reset(proto_w, proto_h);
+      const float *p_coeff = mask_map.data() + i * m_mask_channel_;
+      if (num_per_pixel == 1) {
+        assemble_instance_mask(static_cast<int8_t *>(protoinfo.raw_pointer), proto_c, proto_h,
+                               proto_w, p_coeff, x1, y1, x2, y2, acc, &encoder);
+      } else {
+        assemble_instance_mask(static_cast<float *>(protoinfo.raw_pointer), proto_c, proto_h,
+                               proto_w, p_coeff, x1, y1, x2, y2, acc, &encoder);
+      }
+      encoder.finish(&rle);
+      free(mask_meta->mask_rle);
+      mask_meta->mask_rle_size = 0;
+      mask_meta->mask_rle = (uint32_t *)malloc(rle.size() * sizeof(uint32_t));
+      if (mask_meta->mask_rle == NULL) {
+        LOGE("Failed to allocate memory for mask_rle\n");
+      } else {
+        memcpy(mask_meta->mask_rle, rle.data(), rle.size() * sizeof(uint32_t));
+        mask_meta->mask_rle_size = rle.size();
       }
     }
     if (!hasSkippedVpssPreprocess()) {
@@ -332,64 +349,15 @@ void YoloV8Seg::detPostProcess(Detections &dets, cvtdl_object_t *obj_meta,
                                std::vector<std::pair<int, int>> &final_dets_id) {
   CVI_SHAPE shape = getInputShape(0);
 
-  // used to record the features and index of the detection box at which stride after NMS
-  // post-processing
+  // used to record the level and anchor index of each detection box after NMS post-processing
   std::vector<std::pair<int, int>> temp;
 
-  int nn_width = shape.dim[3];
-  int nn_height = shape.dim[2];
-  float inverse_th = std::log(m_model_threshold / (1 - m_model_threshold));
-
-  for (size_t i = 0; i < strides.size(); i++) {
-    int stride = strides[i];
-    std::string cls_name;
-    int cls_offset = 0;
-    if (class_out_names.count(stride)) {
-      cls_name = class_out_names[stride];
-    } else if (bbox_class_out_names.count(stride)) {
-      cls_name = bbox_class_out_names[stride];
-      cls_offset = m_box_channel_;
-    }
-    TensorInfo classinfo = getOutputTensorInfo(cls_name);
-
-    int num_per_pixel = classinfo.tensor_size / classinfo.tensor_elem;
-    int8_t *p_cls_int8 = static_cast<int8_t *>(classinfo.raw_pointer);
-    float *p_cls_float = static_cast<float *>(classinfo.raw_pointer);
-
-    int num_cls = alg_param_.cls;
-    int num_anchor = classinfo.shape.dim[2] * classinfo.shape.dim[3];
-    float cls_qscale = num_per_pixel == 1 ? classinfo.qscale : 1;
-
-    for (int j = 0; j < num_anchor; j++) {
-      int max_logit_c = -1;
-      float max_logit = -1000;
-      if (num_per_pixel == 1) {
-        parse_cls_info<int8_t>(p_cls_int8, num_anchor, num_cls, j, cls_offset, cls_qscale,
-                               &max_logit, &max_logit_c);
-      } else {
-        parse_cls_info<float>(p_cls_float, num_anchor, num_cls, j, cls_offset, cls_qscale,
-                              &max_logit, &max_logit_c);
-      }
-      if (max_logit < inverse_th) {
-        continue;
-      }
-      float score = 1 / (1 + exp(-max_logit));
-      std::vector<float> box;
-      decode_bbox_feature_map(stride, j, box);
-      PtrDectRect det = std::make_shared<object_detect_rect_t>();
-      det->score = score;
-      det->x1 = box[0];
-      det->y1 = box[1];
-      det->x2 = box[2];
-      det->y2 = box[3];
-      det->label = max_logit_c;
-      clip_bbox(nn_width, nn_height, det);
-      float box_width = det->x2 - det->x1;
-      float box_height = det->y2 - det->y1;
-      if (box_width > 1 && box_height > 1) {
-        dets.push_back(det);
-        temp.push_back(std::make_pair(stride, j));
-      }
+  std::vector<int> anchor_ids;
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    anchor_ids.clear();
+    decoder_.decode(i, m_model_threshold, &dets, &anchor_ids);
+    for (int anchor : anchor_ids) {
+      temp.push_back(std::make_pair((int)i, anchor));
     }
   }
 
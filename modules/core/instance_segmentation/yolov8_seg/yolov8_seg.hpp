@@ -2,6 +2,7 @@
 
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
+#include "anchor_free_decode.hpp"
 #include "obj_detection.hpp"
 namespace cvitdl {
 
@@ -13,12 +14,15 @@ class YoloV8Seg final : public DetectionBase {
   YoloV8Seg(PAIR_INT yolov8_pair);
   ~YoloV8Seg();
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta);
+  void set_algparam(const cvtdl_det_algo_param_t &alg_param) override;
 
  private:
   int onModelOpened() override;
+  void getBranches(int stride, const TensorInfo **cls_info, const TensorInfo **box_info,
+                   int *cls_offset);
+  void setupDecoder();
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
-  void decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box);
   void detPostProcess(Detections &dets, cvtdl_object_t *obj_meta,
                       std::vector<std::pair<int, int>> &final_dets_id);
 
@@ -30,5 +34,9 @@ class YoloV8Seg final : public DetectionBase {
   std::map<int, std::string> bbox_class_out_names;
   int m_box_channel_ = 64;
   int m_mask_channel_ = 32;
+  AnchorFreeDecoder decoder_;
+  // mask coefficient branch of each decoder level and the prototype branch
+  std::vector<const TensorInfo *> mask_infos_;
+  const TensorInfo *proto_info_ = nullptr;
 };
 }  // namespace cvitdl
\ No newline at end of file
@@ -9,6 +9,7 @@ class Polylanenet final : public Core {
   Polylanenet();
   virtual ~Polylanenet();
   void set_lower(float th);
+  float get_lower() const { return LOWERE; }
   int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_lane_t *lane_meta);
   virtual bool allowExportChannelAttribute() const override { return true; }
 
@@ -1,7 +1,7 @@
 #include "decode_tool.hpp"
 
-#include <iostream>
 #include <vector>
+#include "ctc_decode.hpp"
 
 #define CODE_LENGTH_TW 18
 #define CODE_LENGTH_CN 24
@@ -29,82 +29,126 @@ char const *CHAR_LIST_CN[CHARS_NUM_CN] = {
 
 namespace LPR {
 
-bool greedy_decode(float *y, std::string &id_number, LP_FORMAT format) {
+namespace {
+
+struct FormatInfo {
+  int code_length;
   int chars_num;
-  switch (format) {
-    case TAIWAN:
-      chars_num = CHARS_NUM_TW;
-      break;
-    case CHINA:
-      chars_num = CHARS_NUM_CN;
-      break;
-    default:
-      return false;
-  }
-  int code_length = (format == TAIWAN) ? CODE_LENGTH_TW : CODE_LENGTH_CN;
-  int *code = new int[code_length];
-  for (int i = 0; i < code_length; i++) {
-    float max_value = y[i];
-    code[i] = 0;
-    for (int j = 1; j < chars_num; j++) {
-      if (y[j * code_length + i] > max_value) {
-        max_value = y[j * code_length + i];
-        code[i] = j;
-      }
-    }
-  }
+  int blank;
+};
 
+bool format_info(LP_FORMAT format, FormatInfo *info) {
   switch (format) {
     case TAIWAN:
-      id_number = decode_tw(code);
-      break;
+      *info = {CODE_LENGTH_TW, CHARS_NUM_TW, CHARS_NUM_TW - 1};
+      return true;
     case CHINA:
-      id_number = decode_cn(code);
-      break;
+      *info = {CODE_LENGTH_CN, CHARS_NUM_CN, 0};
+      return true;
     default:
       return false;
   }
-
-  delete[] code;
-  return true;
 }
 
-std::string decode_tw(int *code) {
-  std::vector<int> de_code;
-  int previous = -1;
-  for (int i = 0; i < CODE_LENGTH_TW; i++) {
-    if (code[i] != previous) {
-      de_code.push_back(code[i]);
-      previous = code[i];
+// Labels a plate format symbol stands for: D digit, L letter, A digit or letter, P province,
+// S special suffix, anything else the literal character.
+std::vector<int> symbol_labels(LP_FORMAT format, char symbol) {
+  std::vector<int> labels;
+  auto range = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      labels.push_back(i);
     }
+  };
+  if (format == TAIWAN) {
+    if (symbol == 'D' || symbol == 'A') range(0, 10);
+    if (symbol == 'L' || symbol == 'A') range(10, 34);
+    if (symbol == '-') labels.push_back(34);
+  } else {
+    if (symbol == 'P') range(1, 32);
+    if (symbol == 'S') range(32, 38);
+    if (symbol == 'D' || symbol == 'A') range(38, 48);
+    if (symbol == 'L' || symbol == 'A') range(48, CHARS_NUM_CN);
   }
-  std::string id_number("");
-  for (size_t i = 0; i < de_code.size(); i++) {
-    if (de_code[i] != CHARS_NUM_TW - 1) {
-      id_number.append(1, CHAR_LIST_TW[de_code[i]]);
+  return labels;
+}
+
+cvitdl::PatternGrammar make_grammar(LP_FORMAT format, const std::vector<std::string> &specs) {
+  FormatInfo info;
+  format_info(format, &info);
+  cvitdl::PatternGrammar grammar(info.chars_num);
+  for (const std::string &spec : specs) {
+    std::vector<std::vector<int>> positions;
+    for (char symbol : spec) {
+      positions.push_back(symbol_labels(format, symbol));
     }
+    grammar.addPattern(positions);
   }
+  return grammar;
+}
 
-  return id_number;
+const cvitdl::PatternGrammar &plate_grammar(LP_FORMAT format) {
+  static const cvitdl::PatternGrammar tw =
+      make_grammar(TAIWAN, {"AAA-AAAA", "AA-AAAA", "AAAA-AA", "AAA-AAA", "AA-AAA", "AAA-AA"});
+  static const cvitdl::PatternGrammar cn = make_grammar(CHINA, {"PLAAAAA", "PLAAAAAA", "PLAAAAS"});
+  return format == TAIWAN ? tw : cn;
 }
 
-std::string decode_cn(int *code) {
-  std::vector<int> de_code;
-  int previous = -1;
-  for (int i = 0; i < CODE_LENGTH_CN; i++) {
-    if (code[i] != previous) {
-      de_code.push_back(code[i]);
-      previous = code[i];
+std::string to_string(const std::vector<int> &labels, LP_FORMAT format) {
+  std::string id_number;
+  for (int label : labels) {
+    if (format == TAIWAN) {
+      id_number += CHAR_LIST_TW[label];
+    } else {
+      id_number += CHAR_LIST_CN[label];
     }
   }
-  std::string id_number("");
-  for (size_t i = 0; i < de_code.size(); i++) {
-    if (de_code[i] != 0) {
-      id_number += CHAR_LIST_CN[de_code[i]];
-    }
+  return id_number;
+}
+
+cvitdl::CtcInput ctc_input(const int8_t *y_int8, const float *y, float qscale,
+                           const FormatInfo &info) {
+  cvitdl::CtcInput input;
+  input.data_int8 = y_int8;
+  input.data_float = y_int8 != nullptr ? nullptr : y;
+  input.qscale = y_int8 != nullptr ? qscale : 1;
+  input.is_prob = false;
+  input.steps = info.code_length;
+  input.classes = info.chars_num;
+  input.step_stride = 1;
+  input.class_stride = info.code_length;
+  input.seq_stride = info.code_length * info.chars_num;
+  return input;
+}
+
+}  // namespace
+
+bool greedy_decode(const int8_t *y_int8, const float *y, float qscale, std::string &id_number,
+                   LP_FORMAT format) {
+  FormatInfo info;
+  if (!format_info(format, &info)) {
+    return false;
   }
+  std::vector<int> labels;
+  cvitdl::CtcInput input = ctc_input(y_int8, y, qscale, info);
+  cvitdl::CtcDecoder(info.blank).greedy(input, 0, &labels, nullptr);
+  id_number = to_string(labels, format);
+  return true;
+}
 
-  return id_number;
+bool beam_decode(const int8_t *y_int8, const float *y, float qscale, int beam_width,
+                 std::string &id_number, LP_FORMAT format) {
+  FormatInfo info;
+  if (!format_info(format, &info)) {
+    return false;
+  }
+  std::vector<int> labels;
+  cvitdl::CtcDecoder decoder(info.blank);
+  cvitdl::CtcInput input = ctc_input(y_int8, y, qscale, info);
+  if (!decoder.beamSearch(input, 0, beam_width, &plate_grammar(format), &labels, nullptr)) {
+    decoder.greedy(input, 0, &labels, nullptr);
+  }
+  id_number = to_string(labels, format);
+  return true;
 }
 
-}  // namespace LPR
\ No newline at end of file
+}  // namespace LPR
@@ -1,11 +1,17 @@
 #pragma once
+#include <stdint.h>
 #include <string>
 
 enum LP_FORMAT { TAIWAN = 0, CHINA };
 
 namespace LPR {
-bool greedy_decode(float *y, std::string &id_number, LP_FORMAT format = TAIWAN);
+// Greedy CTC decoding of the class-major LPRNet output, y_int8 with its dequantization scale for
+// int8 outputs, y otherwise.
+bool greedy_decode(const int8_t *y_int8, const float *y, float qscale, std::string &id_number,
+                   LP_FORMAT format = TAIWAN);
 
-std::string decode_tw(int *code);
-std::string decode_cn(int *code);
+// Prefix beam search over the output restricted to the plate formats of format. Falls back to
+// greedy decoding when no hypothesis is a valid plate.
+bool beam_decode(const int8_t *y_int8, const float *y, float qscale, int beam_width,
+                 std::string &id_number, LP_FORMAT format = TAIWAN);
 }  // namespace LPR
@@ -86,10 +86,16 @@ int LicensePlateRecognition::inference(VIDEO_FRAME_INFO_S *frame,
       return ret;
     }
 
-    float *out_code = getOutputRawPtr<float>(OUTPUT_NAME);
+    TensorView out = getOutputTensorView(OUTPUT_NAME);
+    const int8_t *out_int8 = out.is_int8 ? out.get<int8_t>() : nullptr;
+    const float *out_float = out.is_int8 ? nullptr : out.get<float>();
 
     std::string id_number;
-    if (!LPR::greedy_decode(out_code, id_number, format)) {
+    bool decoded = m_beam_width > 1 ? LPR::beam_decode(out_int8, out_float, out.qscale,
+                                                       m_beam_width, id_number, format)
+                                    : LPR::greedy_decode(out_int8, out_float, out.qscale,
+                                                         id_number, format);
+    if (!decoded) {
       LOGE("LPR::decode error!!\n");
       return CVI_TDL_ERR_INFERENCE;
     }
@@ -4,6 +4,7 @@
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/face/cvtdl_face_types.h"
+#include "ctc_decode.hpp"
 #include "rescale_utils.hpp"
 
 #define SCALE (1 / 128.)
@@ -33,49 +34,35 @@ LicensePlateRecognitionV2::LicensePlateRecognitionV2()
   m_preprocess_param[0].keep_aspect_ratio = false;
 }
 
-void LicensePlateRecognitionV2::greedy_decode(float *prebs) {
+void LicensePlateRecognitionV2::greedy_decode(const TensorView &prebs) {
   CVI_SHAPE shape = getOutputShape(0);
   // 80，18
   int rows = shape.dim[1];
   int cols = shape.dim[2];
 
-  int index[cols];
-  // argmax index
-  for (int i = 0; i < cols; i++) {
-    float max = prebs[cols];
-    int maxIndex = 0;
-    for (int j = 1; j < rows; j++) {
-      if (prebs[i + j * cols] > max) {
-        max = prebs[i + j * cols];
-        maxIndex = j;
-      }
-    }
-    index[i] = maxIndex;
-  }
-
-  std::vector<int> no_repeat_blank_label;
-  uint32_t pre_c = index[0];
-  if (pre_c != CHARS.size() - 1) {
-    no_repeat_blank_label.push_back(pre_c);
-  }
-  for (int i = 0; i < cols; i++) {
-    uint32_t c = index[i];
-    if ((pre_c == c) || (c == CHARS.size() - 1)) {
-      if (c == CHARS.size() - 1) {
-        pre_c = c;
-      }
-      continue;
-    }
-    no_repeat_blank_label.push_back(c);
-    pre_c = c;
+  CtcInput input;
+  input.data_int8 = prebs.is_int8 ? prebs.get<int8_t>() : nullptr;
+  input.data_float = prebs.is_int8 ? nullptr : prebs.get<float>();
+  input.qscale = prebs.qscale;
+  input.is_prob = false;
+  input.steps = cols;
+  input.classes = rows;
+  input.step_stride = 1;
+  input.class_stride = cols;
+  input.seq_stride = rows * cols;
+
+  CtcDecoder decoder(CHARS.size() - 1);
+  std::vector<int> labels;
+  if (m_beam_width <= 1 || !decoder.beamSearch(input, 0, m_beam_width, nullptr, &labels, nullptr)) {
+    decoder.greedy(input, 0, &labels, nullptr);
   }
 
   std::string lb = "";
-  for (int k : no_repeat_blank_label) {
+  for (int k : labels) {
     lb += CHARS[k];
     lb += " ";
   }
-  std::cout << "Prediction: " << lb << std::endl;
+  LOGD("prediction: %s\n", lb.c_str());
 }
 
 int LicensePlateRecognitionV2::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *vehicle_meta) {
@@ -104,8 +91,7 @@ int LicensePlateRecognitionV2::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object
       return ret;
     }
 
-    float *out = getOutputRawPtr<float>(OUTPUT_NAME_PROBABILITY);
-    greedy_decode(out);
+    greedy_decode(getOutputTensorView(OUTPUT_NAME_PROBABILITY));
     mp_vpss_inst->releaseFrame(f, 0);
     delete f;
 
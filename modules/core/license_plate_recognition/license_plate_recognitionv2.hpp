@@ -12,7 +12,7 @@ class LicensePlateRecognitionV2 final : public LicensePlateRecognitionBase {
 
   ~LicensePlateRecognitionV2(){};
   int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *vehicle_meta) override;
-  void greedy_decode(float *prebs);
+  void greedy_decode(const TensorView &prebs);
   bool allowExportChannelAttribute() const override { return true; }
 };
 }  // namespace cvitdl
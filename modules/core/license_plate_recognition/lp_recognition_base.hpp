@@ -14,6 +14,12 @@ class LicensePlateRecognitionBase : public Core {
   virtual int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *object_meta) = 0;
   virtual bool allowExportChannelAttribute() const override { return false; }
   int after_inference() { return 0; }
+  // Beam width of the CTC decoding, 1 decodes greedily.
+  void setBeamWidth(uint32_t beam_width) { m_beam_width = beam_width; }
+  uint32_t getBeamWidth() const { return m_beam_width; }
+
+ protected:
+  uint32_t m_beam_width = 1;
 };
 
 }  // namespace cvitdl
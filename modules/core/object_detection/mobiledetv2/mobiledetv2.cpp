@@ -338,7 +338,8 @@ int MobileDetV2::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *meta) {
   Detections dets;
   generate_dets_for_each_stride(&dets);
 
-  Detections final_dets = nms_multi_class(dets, m_iou_threshold);
+  Detections final_dets = nms_multi_class(dets, m_iou_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
 
   if (!m_filter.all()) {  // filter if not all bit are set
     auto condition = [this](const PtrDectRect &det) {
@@ -35,91 +35,37 @@ static void convert_det_struct(const Detections &dets, cvtdl_object_t *out, int
   }
 }
 
-float yoloe_sigmoid(float x) { return 1.0 / (1.0 + exp(-x)); }
-
-template <typename T>
-void decode_yoloe_bbox(T *ptr, float qscale, int basic_pos, int grid0, int grid1, int stride,
-                       int label, float box_prob, PtrDectRect &det) {
-  float x1 = (-ptr[basic_pos + 0] * qscale + grid0 + 0.5) * stride;
-  float y1 = (-ptr[basic_pos + 1] * qscale + grid1 + 0.5) * stride;
-  float x2 = (ptr[basic_pos + 2] * qscale + grid0 + 0.5) * stride;
-  float y2 = (ptr[basic_pos + 3] * qscale + grid1 + 0.5) * stride;
-  det->label = label;
-  det->score = box_prob;
-  det->x1 = x1;
-  det->y1 = y1;
-  det->x2 = x2;
-  det->y2 = y2;
+// Outputs are laid out as [1, grid_h, grid_w, channels].
+static AnchorFreeBranch get_branch(const TensorInfo &oinfo) {
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  return {oinfo.raw_pointer, is_int8 ? oinfo.qscale : 1, (int)oinfo.shape.dim[3], 0};
 }
 
-template <typename T>
-int yoloe_argmax(T *ptr, int basic_pos, int cls_len) {
-  int max_idx = 0;
-  for (int i = 0; i < cls_len; i++) {
-    if (ptr[i + basic_pos] > ptr[max_idx + basic_pos]) {
-      max_idx = i;
-    }
+void PPYoloE::generate_ppyoloe_proposals(Detections &detections) {
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    decoder_.decode(i, m_model_threshold, &detections, nullptr);
   }
-  return max_idx;
 }
 
-void PPYoloE::generate_ppyoloe_proposals(Detections &detections, int frame_width,
-                                         int frame_height) {
-  CVI_SHAPE shape = getInputShape(0);
-  int target_w = shape.dim[3];
-  int target_h = shape.dim[2];
+void PPYoloE::setupDecoder() {
+  CVI_SHAPE input_shape = getInputShape(0);
+  const TensorInfo &cls_info = getOutputTensorInfo(class_out_names_[strides_[0]]);
+  const TensorInfo &box_info = getOutputTensorInfo(box_out_names_[strides_[0]]);
+  decoder_.setup(AnchorFreeBoxCoding::LTRB, AnchorFreeLayout::HWC,
+                 cls_info.tensor_size == cls_info.tensor_elem,
+                 box_info.tensor_size == box_info.tensor_elem, alg_param_.cls, 1,
+                 input_shape.dim[3], input_shape.dim[2]);
+  for (int stride : strides_) {
+    decoder_.addLevel(stride, input_shape.dim[3] / stride, input_shape.dim[2] / stride,
+                      get_branch(getOutputTensorInfo(class_out_names_[stride])),
+                      get_branch(getOutputTensorInfo(box_out_names_[stride])));
+  }
+}
 
-  for (auto stride : strides_) {
-    TensorInfo oinfo_box = getOutputTensorInfo(box_out_names_[stride]);
-    int num_per_pixel_box = oinfo_box.tensor_size / oinfo_box.tensor_elem;
-    float qscale_box = num_per_pixel_box == 1 ? oinfo_box.qscale : 1;
-    int8_t *ptr_int8_box = static_cast<int8_t *>(oinfo_box.raw_pointer);
-    float *ptr_float_box = static_cast<float *>(oinfo_box.raw_pointer);
-
-    TensorInfo oinfo_cls = getOutputTensorInfo(class_out_names_[stride]);
-    int num_per_pixel_cls = oinfo_cls.tensor_size / oinfo_cls.tensor_elem;
-    float qscale_cls = num_per_pixel_cls == 1 ? oinfo_cls.qscale : 1;
-    int8_t *ptr_int8_cls = static_cast<int8_t *>(oinfo_cls.raw_pointer);
-    float *ptr_float_cls = static_cast<float *>(oinfo_cls.raw_pointer);
-
-    int num_grid_w = target_w / stride;
-    int num_grid_h = target_h / stride;
-
-    int basic_pos_cls = 0;
-    int basic_pos_box = 0;
-    for (int g1 = 0; g1 < num_grid_h; g1++) {
-      for (int g0 = 0; g0 < num_grid_w; g0++) {
-        float class_score = 0.0f;
-        int label = 0;
-        if (num_per_pixel_cls == 1) {
-          label = yoloe_argmax<int8_t>(ptr_int8_cls, basic_pos_cls, alg_param_.cls);
-          class_score = ptr_int8_cls[label + basic_pos_cls] * qscale_cls;
-        } else {
-          label = yoloe_argmax<float>(ptr_float_cls, basic_pos_cls, alg_param_.cls);
-          class_score = ptr_float_cls[label + basic_pos_cls];
-        }
-
-        class_score = yoloe_sigmoid(class_score);
-        if (class_score < m_model_threshold) {
-          basic_pos_cls += alg_param_.cls;
-          basic_pos_box += 4;
-          continue;
-        }
-
-        PtrDectRect det = std::make_shared<object_detect_rect_t>();
-        if (num_per_pixel_box == 1) {
-          decode_yoloe_bbox<int8_t>(ptr_int8_box, qscale_box, basic_pos_box, g0, g1, stride, label,
-                                    class_score, det);
-        } else {
-          decode_yoloe_bbox<float>(ptr_float_box, qscale_box, basic_pos_box, g0, g1, stride, label,
-                                   class_score, det);
-        }
-        basic_pos_cls += alg_param_.cls;
-        basic_pos_box += 4;
-        clip_bbox(frame_width, frame_height, det);
-        detections.push_back(det);
-      }
-    }
+void PPYoloE::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  DetectionBase::set_algparam(alg_param);
+  if (!strides_.empty()) {
+    setupDecoder();
   }
 }
 
@@ -180,6 +126,10 @@ int PPYoloE::onModelOpened() {
       return CVI_TDL_FAILURE;
     }
   }
+  if (strides_.empty()) {
+    return CVI_TDL_FAILURE;
+  }
+  setupDecoder();
 
   return CVI_TDL_SUCCESS;
 }
@@ -203,10 +153,11 @@ int PPYoloE::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
 void PPYoloE::outputParser(const int image_width, const int image_height, const int frame_width,
                            const int frame_height, cvtdl_object_t *obj_meta) {
   Detections vec_obj;
-  generate_ppyoloe_proposals(vec_obj, image_width, image_height);
+  generate_ppyoloe_proposals(vec_obj);
 
   // Do nms on output result
-  Detections final_dets = nms_multi_class(vec_obj, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(vec_obj, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
 
   CVI_SHAPE shape = getInputShape(0);
 
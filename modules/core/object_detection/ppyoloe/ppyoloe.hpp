@@ -1,6 +1,7 @@
 #pragma once
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
+#include "anchor_free_decode.hpp"
 #include "obj_detection.hpp"
 
 namespace cvitdl {
@@ -12,15 +13,18 @@ class PPYoloE final : public DetectionBase {
 
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) override;
   bool allowExportChannelAttribute() const override { return true; }
+  void set_algparam(const cvtdl_det_algo_param_t &alg_param) override;
 
  private:
   int onModelOpened() override;
+  void setupDecoder();
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
-  void generate_ppyoloe_proposals(Detections &detections, int frame_width, int frame_height);
+  void generate_ppyoloe_proposals(Detections &detections);
 
   std::vector<int> strides_;
   std::map<int, std::string> box_out_names_;
   std::map<int, std::string> class_out_names_;
+  AnchorFreeDecoder decoder_;
 };
 }  // namespace cvitdl
\ No newline at end of file
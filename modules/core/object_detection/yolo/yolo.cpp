@@ -224,7 +224,8 @@ cvtdl_bbox_t Yolo::Yolo_box_rescale(int frame_width, int frame_height, int width
 
 void Yolo::YoloPostProcess(Detections &dets, int frame_width, int frame_height,
                            cvtdl_object_t *obj_meta) {
-  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
   CVI_SHAPE shape = getInputShape(0);
   convert_det_struct(final_dets, obj_meta, shape.dim[2], shape.dim[3]);
   // rescale bounding box to original image
@@ -1,6 +1,7 @@
 #pragma once
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
+#include "anchor_free_decode.hpp"
 #include "obj_detection.hpp"
 
 namespace cvitdl {
@@ -18,14 +19,13 @@ class YoloV10Detection final : public DetectionBase {
 
  private:
   int onModelOpened() override;
+  void getBranches(int stride, const TensorInfo **cls_info, const TensorInfo **box_info,
+                   int *cls_offset);
+  void setupDecoder();
 
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
 
-  void parseDecodeBranch(const int image_width, const int image_height, const int frame_width,
-                         const int frame_height, cvtdl_object_t *obj_meta);
-
-  void decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box);
   void postProcess(Detections &dets, int frame_width, int frame_height, cvtdl_object_t *obj_meta);
   std::map<std::string, std::string> out_names_;
 
@@ -36,5 +36,6 @@ class YoloV10Detection final : public DetectionBase {
   std::map<int, std::string> bbox_class_out_names;
   int m_box_channel_ = 0;
   int m_cls_channel_ = 0;
+  AnchorFreeDecoder decoder_;
 };
 }  // namespace cvitdl
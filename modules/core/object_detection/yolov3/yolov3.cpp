@@ -2,6 +2,7 @@
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core_utils.hpp"
+#include "yolo_decode.hpp"
 
 #define YOLOV3_CLASSES 80
 #define YOLOV3_NMS_THRESHOLD 0.45
@@ -139,12 +140,18 @@ void Yolov3::doYolo(YOLOLayer &l) {
   int w = l.width;
   int h = l.height;
   int output_size = l.norm * l.channels * w * h;
+  // Cells whose objectness logit is below this can not pass the threshold, skip their sigmoids.
+  const float obj_logit_thresh = sigmoid_inverse(m_model_threshold);
 
   for (int b = 0; b < m_yolov3_param.m_batch; ++b) {
     for (int p = 0; p < w * h; ++p) {
       for (int n = 0; n < m_yolov3_param.m_anchor_nums; ++n) {
         int obj_index = EntryIndex(w, h, m_yolov3_param.m_classes, b, n * w * h + p,
                                    m_yolov3_param.m_coords, output_size);
+        if (data[obj_index] < obj_logit_thresh) {
+          data[obj_index] = 0;
+          continue;
+        }
         ActivateArray(data + obj_index, 1, true);
         float objectness = data[obj_index];
 
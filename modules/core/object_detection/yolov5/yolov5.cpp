@@ -19,24 +19,6 @@
 #include "object_utils.hpp"
 #include "yolov5.hpp"
 
-template <typename T>
-int yolov5_argmax(T *ptr, int start_idx, int arr_len) {
-  int max_idx = start_idx;
-  for (int i = start_idx + 1; i < start_idx + arr_len; i++) {
-    if (ptr[i] > ptr[max_idx]) {
-      max_idx = i;
-    }
-  }
-  return max_idx - start_idx;
-}
-
-int max_val(int x, int y) {
-  if (x > y) return x;
-  return y;
-}
-
-float sigmoid(float x) { return 1.0 / (1 + exp(-x)); }
-
 namespace cvitdl {
 
 static void convert_det_struct(const Detections &dets, cvtdl_object_t *obj, int im_height,
@@ -64,20 +46,62 @@ Yolov5::Yolov5() {
   }
   m_preprocess_param[0].format = PIXEL_FORMAT_RGB_888_PLANAR;
 
-  uint32_t *anchors = new uint32_t[18];
-  uint32_t p_anchors[18] = {10, 13, 16,  30,  33, 23,  30,  61,  62,
-                            45, 59, 119, 116, 90, 156, 198, 373, 326};
-  memcpy(anchors, p_anchors, sizeof(p_anchors));
-  alg_param_.anchors = anchors;
-  alg_param_.anchor_len = 18;
-  uint32_t *strides = new uint32_t[3];
-  uint32_t p_strides[3] = {8, 16, 32};
-  memcpy(strides, p_strides, sizeof(p_strides));
-  alg_param_.strides = strides;
-  alg_param_.stride_len = 3;
+  anchor_storage_ = {10, 13, 16, 30, 33, 23, 30, 61, 62, 45, 59, 119, 116, 90, 156, 198, 373, 326};
+  alg_param_.anchors = anchor_storage_.data();
+  alg_param_.anchor_len = anchor_storage_.size();
+  stride_storage_ = {8, 16, 32};
+  alg_param_.strides = stride_storage_.data();
+  alg_param_.stride_len = stride_storage_.size();
   alg_param_.cls = 80;
 }
 
+static YoloBranch get_branch(const TensorInfo &oinfo) {
+  YoloBranch branch;
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  branch.data_int8 = is_int8 ? static_cast<int8_t *>(oinfo.raw_pointer) : nullptr;
+  branch.data_float = is_int8 ? nullptr : static_cast<float *>(oinfo.raw_pointer);
+  branch.qscale = is_int8 ? oinfo.qscale : 1;
+  return branch;
+}
+
+void Yolov5::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  DetectionBase::set_algparam(alg_param);
+  if (!strides_.empty()) {
+    setupDecoder();
+  }
+}
+
+// Levels follow alg_param_.strides rather than the output order, the anchors are given in that
+// order.
+int Yolov5::setupDecoder() {
+  if (alg_param_.stride_len != (int)strides_.size()) {
+    LOGE("yolov5 has %zu output levels but %d strides are set\n", strides_.size(),
+         alg_param_.stride_len);
+    return CVI_TDL_FAILURE;
+  }
+  std::vector<int> strides(alg_param_.strides, alg_param_.strides + alg_param_.stride_len);
+  for (int stride : strides) {
+    if (std::find(strides_.begin(), strides_.end(), stride) == strides_.end()) {
+      LOGE("yolov5 has no output of stride %d\n", stride);
+      return CVI_TDL_FAILURE;
+    }
+  }
+  CVI_SHAPE input_shape = getInputShape(0);
+  std::vector<int> num_anchors;
+  for (int stride : strides) {
+    num_anchors.push_back(getOutputTensorInfo(class_out_names_[stride]).shape.dim[0]);
+  }
+  decoder_.setup(YoloBoxCoding::YOLOV5, input_shape.dim[3], input_shape.dim[2], strides,
+                 num_anchors, alg_param_.anchors, alg_param_.anchor_len, alg_param_.cls);
+  for (size_t i = 0; i < strides.size(); i++) {
+    int stride = strides[i];
+    decoder_.bindLevel(i, get_branch(getOutputTensorInfo(conf_out_names_[stride])),
+                       get_branch(getOutputTensorInfo(class_out_names_[stride])),
+                       get_branch(getOutputTensorInfo(box_out_names_[stride])));
+  }
+  return CVI_TDL_SUCCESS;
+}
+
 int Yolov5::onModelOpened() {
   CVI_SHAPE input_shape = getInputShape(0);
   int input_h = input_shape.dim[2];
@@ -124,8 +148,7 @@ int Yolov5::onModelOpened() {
       return CVI_TDL_FAILURE;
     }
   }
-
-  return CVI_TDL_SUCCESS;
+  return setupDecoder();
 }
 
 Yolov5::~Yolov5() {}
@@ -139,6 +162,14 @@ uint32_t Yolov5::set_roi(Point_t &roi) {
   return 0;
 }
 
+bool Yolov5::get_roi(Point_t *roi) const {
+  roi->x1 = (int)yolo_box.x1;
+  roi->x2 = (int)yolo_box.x2;
+  roi->y1 = (int)yolo_box.y1;
+  roi->y2 = (int)yolo_box.y2;
+  return roi_flag;
+}
+
 int Yolov5::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
   if (roi_flag == true) {
     VIDEO_FRAME_INFO_S *f = new VIDEO_FRAME_INFO_S;
@@ -181,135 +212,16 @@ int Yolov5::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
   return CVI_TDL_SUCCESS;
 }
 
-void xywh2xxyy(float x, float y, float w, float h, PtrDectRect &det) {
-  det->x1 = x - w / 2;
-  det->y1 = y - h / 2;
-  det->x2 = x + w / 2;
-  det->y2 = y + h / 2;
-}
-
-template <typename T>
-void parseDet(T *ptr, int start_idx, float qscale, int cls, float box_prob, int grid_x, int grid_y,
-              int stride_x, int stride_y, float pw, float ph, int im_height, int im_width,
-              Detections &vec_obj) {
-  float sigmoid_x = sigmoid(ptr[start_idx] * qscale);
-  float sigmoid_y = sigmoid(ptr[start_idx + 1] * qscale);
-  float sigmoid_w = sigmoid(ptr[start_idx + 2] * qscale);
-  float sigmoid_h = sigmoid(ptr[start_idx + 3] * qscale);
-  float object_score = box_prob;
-
-  PtrDectRect det = std::make_shared<object_detect_rect_t>();
-  det->score = object_score;
-  det->label = cls;
-  // decode predicted bounding box of each grid to whole image
-  float x = (2 * sigmoid_x - 0.5 + (float)grid_x) * (float)stride_x;
-  float y = (2 * sigmoid_y - 0.5 + (float)grid_y) * (float)stride_y;
-  float w = pow((sigmoid_w * 2), 2) * pw;
-  float h = pow((sigmoid_h * 2), 2) * ph;
-  xywh2xxyy(x, y, w, h, det);
-
-  clip_bbox(im_height, im_width, det);
-  float box_width = det->x2 - det->x1;
-  float box_height = det->y2 - det->y1;
-  if (box_width > 1 && box_height > 1) {
-    vec_obj.push_back(det);
-  }
-}
-
 void Yolov5::generate_yolov5_proposals(Detections &vec_obj) {
-  CVI_SHAPE shape = getInputShape(0);
-  int target_w = shape.dim[3];
-  int target_h = shape.dim[2];
-  int anchor_pos = 0;
-  for (uint32_t i = 0; i < strides_.size(); i++) {
-    int stride = alg_param_.strides[i];
-    int num_grid_w = target_w / stride;
-    int num_grid_h = target_h / stride;
-
-    int basic_pos_class = 0;
-    int basic_pos_object = 0;
-    int basic_pos_box = 0;
-
-    TensorInfo oinfo_class = getOutputTensorInfo(class_out_names_[stride]);
-    int num_per_pixel_class = oinfo_class.tensor_size / oinfo_class.tensor_elem;
-    float qscale_class = num_per_pixel_class == 1 ? oinfo_class.qscale : 1;
-    int8_t *ptr_int8_class = static_cast<int8_t *>(oinfo_class.raw_pointer);
-    float *ptr_float_class = static_cast<float *>(oinfo_class.raw_pointer);
-
-    TensorInfo oinfo_object = getOutputTensorInfo(conf_out_names_[stride]);
-    int num_per_pixel_object = oinfo_object.tensor_size / oinfo_object.tensor_elem;
-    float qscale_object = num_per_pixel_object == 1 ? oinfo_object.qscale : 1;
-    int8_t *ptr_int8_object = static_cast<int8_t *>(oinfo_object.raw_pointer);
-    float *ptr_float_object = static_cast<float *>(oinfo_object.raw_pointer);
-
-    TensorInfo oinfo_box = getOutputTensorInfo(box_out_names_[stride]);
-    int num_per_pixel_box = oinfo_box.tensor_size / oinfo_box.tensor_elem;
-    float qscale_box = num_per_pixel_box == 1 ? oinfo_box.qscale : 1;
-    int8_t *ptr_int8_box = static_cast<int8_t *>(oinfo_box.raw_pointer);
-    float *ptr_float_box = static_cast<float *>(oinfo_box.raw_pointer);
-
-    CVI_SHAPE output_shape = oinfo_class.shape;
-    uint32_t anchor_len = output_shape.dim[0];
-    for (uint32_t anchor_idx = 0; anchor_idx < anchor_len; anchor_idx++) {
-      uint32_t *anchors = alg_param_.anchors + anchor_pos;
-
-      float pw = anchors[0];
-      float ph = anchors[1];
-
-      for (int grid_y = 0; grid_y < num_grid_h; grid_y++) {
-        for (int grid_x = 0; grid_x < num_grid_w; grid_x++) {
-          float class_score = 0.0f;
-          float box_objectness = 0.0f;
-          int label = 0;
-
-          // parse object conf
-          if (num_per_pixel_class == 1) {
-            box_objectness = ptr_int8_object[basic_pos_object] * qscale_object;
-          } else {
-            box_objectness = ptr_float_object[basic_pos_object];
-          }
-
-          // parse class score
-          if (num_per_pixel_object == 1) {
-            label = yolov5_argmax<int8_t>(ptr_int8_class, basic_pos_class, alg_param_.cls);
-            class_score = ptr_int8_class[basic_pos_class + label] * qscale_class;
-          } else {
-            label = yolov5_argmax<float>(ptr_float_class, basic_pos_class, alg_param_.cls);
-            class_score = ptr_float_class[basic_pos_class + label];
-          }
-
-          box_objectness = sigmoid(box_objectness);
-          class_score = sigmoid(class_score);
-          float box_prob = box_objectness * class_score;
-
-          if (box_prob < m_model_threshold) {
-            basic_pos_class += alg_param_.cls;
-            basic_pos_box += 4;
-            basic_pos_object += 1;
-            continue;
-          }
-
-          if (num_per_pixel_box == 1) {
-            parseDet<int8_t>(ptr_int8_box, basic_pos_box, qscale_box, label, box_prob, grid_x,
-                             grid_y, stride, stride, pw, ph, target_w, target_h, vec_obj);
-          } else {
-            parseDet<float>(ptr_float_box, basic_pos_box, qscale_box, label, box_prob, grid_x,
-                            grid_y, stride, stride, pw, ph, target_w, target_h, vec_obj);
-          }
-
-          basic_pos_class += alg_param_.cls;
-          basic_pos_box += 4;
-          basic_pos_object += 1;
-        }
-      }
-      anchor_pos += 2;
-    }
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    decoder_.decode(i, m_model_threshold, &vec_obj);
   }
 }
 
 void Yolov5::Yolov5PostProcess(Detections &dets, int frame_width, int frame_height,
                                cvtdl_object_t *obj_meta) {
-  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
   CVI_SHAPE shape = getInputShape(0);
   convert_det_struct(final_dets, obj_meta, shape.dim[2], shape.dim[3]);
   // rescale bounding box to original image
@@ -3,6 +3,7 @@
 #include "core/core/cvtdl_core_types.h"
 #include "core/object/cvtdl_object_types.h"
 #include "obj_detection.hpp"
+#include "yolo_decode.hpp"
 
 namespace cvitdl {
 
@@ -13,9 +14,13 @@ class Yolov5 final : public DetectionBase {
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) override;
 
   uint32_t set_roi(Point_t &roi);
+  // Return false if no roi is set.
+  bool get_roi(Point_t *roi) const;
+  void set_algparam(const cvtdl_det_algo_param_t &alg_param) override;
 
  private:
   int onModelOpened() override;
+  int setupDecoder();
 
   void generate_yolov5_proposals(Detections &vec_obj);
   void outputParser(const int image_width, const int image_height, const int frame_width,
@@ -27,6 +32,7 @@ class Yolov5 final : public DetectionBase {
   std::map<int, std::string> conf_out_names_;
   std::map<int, std::string> box_out_names_;
   std::vector<int> strides_;
+  YoloDecoder decoder_;
   cvtdl_bbox_t yolo_box;
   bool roi_flag = false;
 };
@@ -133,10 +133,14 @@ int Yolov6::onModelOpened() {
     }
   }
 
+  cls_infos_.clear();
+  box_infos_.clear();
   for (size_t i = 0; i < strides_.size(); i++) {
     if (!class_out_names_.count(strides_[i]) || !box_out_names_.count(strides_[i])) {
       return CVI_TDL_FAILURE;
     }
+    cls_infos_.push_back(&getOutputTensorInfo(class_out_names_[strides_[i]]));
+    box_infos_.push_back(&getOutputTensorInfo(box_out_names_[strides_[i]]));
   }
 
   return CVI_TDL_SUCCESS;
@@ -160,10 +164,9 @@ int Yolov6::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
   return CVI_TDL_SUCCESS;
 }
 
-void Yolov6::decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box) {
-  std::string box_name = box_out_names_[stride];
-  TensorInfo boxinfo = getOutputTensorInfo(box_name);
-  CVI_SHAPE input_shape = getInputShape(0);
+void Yolov6::decode_bbox_feature_map(const TensorInfo &boxinfo, int anchor_idx,
+                                     float *decode_box) {
+  const CVI_SHAPE &input_shape = getInputTensorInfo(0).shape;
   int box_val_num = 4;
 
   int num_per_pixel = boxinfo.tensor_size / boxinfo.tensor_elem;
@@ -182,19 +185,19 @@ void Yolov6::decode_bbox_feature_map(int stride, int anchor_idx, std::vector<flo
   float grid_y = anchor_y + 0.5;
   float grid_x = anchor_x + 0.5;
 
-  std::vector<float> box_vals;
+  float box_vals[4];
   for (int i = 0; i < box_val_num; i++) {
     if (num_per_pixel == 1) {
-      box_vals.push_back(p_box_int8[anchor_idx * 4 + i] * boxinfo.qscale);
+      box_vals[i] = p_box_int8[anchor_idx * 4 + i] * boxinfo.qscale;
     } else {
-      box_vals.push_back(p_box_float[anchor_idx * 4 + i]);
+      box_vals[i] = p_box_float[anchor_idx * 4 + i];
     }
   }
 
-  std::vector<float> box = {(grid_x - box_vals[0]) * stride_x, (grid_y - box_vals[1]) * stride_y,
-                            (grid_x + box_vals[2]) * stride_x, (grid_y + box_vals[3]) * stride_y};
-
-  decode_box = box;
+  decode_box[0] = (grid_x - box_vals[0]) * stride_x;
+  decode_box[1] = (grid_y - box_vals[1]) * stride_y;
+  decode_box[2] = (grid_x + box_vals[2]) * stride_x;
+  decode_box[3] = (grid_y + box_vals[3]) * stride_y;
 }
 
 void Yolov6::clip_bbox(int frame_width, int frame_height, cvtdl_bbox_t *bbox) {
@@ -238,7 +241,8 @@ cvtdl_bbox_t Yolov6::boxRescale(int frame_width, int frame_height, int width, in
 
 void Yolov6::postProcess(Detections &dets, int frame_width, int frame_height,
                          cvtdl_object_t *obj_meta) {
-  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
   CVI_SHAPE shape = getInputShape(0);
   convert_det_struct(final_dets, obj_meta, shape.dim[2], shape.dim[3]);
   // rescale bounding box to original image
@@ -258,11 +262,8 @@ void Yolov6::outputParser(const int iamge_width, const int image_height, const i
 
   float inverse_th = std::log(m_model_threshold / (1 - m_model_threshold));
 
-  for (size_t i = 0; i < strides_.size(); i++) {
-    int stride = strides_[i];
-    std::string cls_name = class_out_names_[stride];
-
-    TensorInfo classinfo = getOutputTensorInfo(cls_name);
+  for (size_t i = 0; i < cls_infos_.size(); i++) {
+    const TensorInfo &classinfo = *cls_infos_[i];
     int num_per_pixel = classinfo.tensor_size / classinfo.tensor_elem;
     int8_t *p_cls_int8 = static_cast<int8_t *>(classinfo.raw_pointer);
     float *p_cls_float = static_cast<float *>(classinfo.raw_pointer);
@@ -284,8 +285,8 @@ void Yolov6::outputParser(const int iamge_width, const int image_height, const i
       }
 
       float score = sigmoid(max_logit);
-      std::vector<float> box;
-      decode_bbox_feature_map(stride, j, box);
+      float box[4];
+      decode_bbox_feature_map(*box_infos_[i], j, box);
 
       PtrDectRect det = std::make_shared<object_detect_rect_t>();
       det->score = score;
@@ -15,7 +15,7 @@ class Yolov6 final : public DetectionBase {
  private:
   int onModelOpened() override;
 
-  void decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box);
+  void decode_bbox_feature_map(const TensorInfo &boxinfo, int anchor_idx, float *decode_box);
   void clip_bbox(int frame_width, int frame_height, cvtdl_bbox_t *bbox);
   cvtdl_bbox_t boxRescale(int frame_width, int frame_height, int width, int height,
                           cvtdl_bbox_t bbox);
@@ -28,5 +28,8 @@ class Yolov6 final : public DetectionBase {
   std::map<int, std::string> class_out_names_;
   std::map<int, std::string> box_out_names_;
   std::vector<int> strides_;
+  // class and box branches of each stride, resolved at model open
+  std::vector<const TensorInfo *> cls_infos_;
+  std::vector<const TensorInfo *> box_infos_;
 };
 }  // namespace cvitdl
\ No newline at end of file
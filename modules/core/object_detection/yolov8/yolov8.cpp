@@ -34,20 +34,9 @@ static void convert_det_struct(const Detections &dets, cvtdl_object_t *obj, int
     obj->info[i].classes = dets[i]->label;
   }
 }
-template <typename T>
-inline void parse_cls_info(T *p_cls_ptr, int num_anchor, int num_cls, int anchor_idx,
-                           int cls_offset, float qscale, float *p_max_logit, int *p_max_cls) {
-  int max_logit_c = -1;
-  float max_logit = -1000;
-  for (int c = 0; c < num_cls; c++) {
-    float logit = p_cls_ptr[(c + cls_offset) * num_anchor + anchor_idx];
-    if (logit > max_logit) {
-      max_logit = logit;
-      max_logit_c = c;
-    }
-  }
-  *p_max_logit = max_logit * qscale;
-  *p_max_cls = max_logit_c;
+static AnchorFreeBranch get_branch(const TensorInfo &oinfo, int channel_offset) {
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  return {oinfo.raw_pointer, is_int8 ? oinfo.qscale : 1, (int)oinfo.shape.dim[1], channel_offset};
 }
 
 YoloV8Detection::YoloV8Detection() : YoloV8Detection(std::make_pair(64, 80)) {}
@@ -118,10 +107,59 @@ int YoloV8Detection::onModelOpened() {
       return CVI_FAILURE;
     }
   }
+  if (strides.empty()) {
+    LOGE("no box branch found\n");
+    return CVI_FAILURE;
+  }
+  setupDecoder();
 
   return CVI_TDL_SUCCESS;
 }
 
+void YoloV8Detection::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  DetectionBase::set_algparam(alg_param);
+  if (!strides.empty()) {
+    setupDecoder();
+  }
+}
+
+// Class and box branches of stride. A fused box+class tensor is read at two channel offsets.
+void YoloV8Detection::getBranches(int stride, const TensorInfo **cls_info,
+                                  const TensorInfo **box_info, int *cls_offset) {
+  if (bbox_class_out_names.count(stride)) {
+    *cls_info = &getOutputTensorInfo(bbox_class_out_names[stride]);
+    *box_info = *cls_info;
+    *cls_offset = m_box_channel_;
+  } else {
+    *cls_info = &getOutputTensorInfo(class_out_names[stride]);
+    *box_info = &getOutputTensorInfo(bbox_out_names[stride]);
+    *cls_offset = 0;
+  }
+}
+
+void YoloV8Detection::setupDecoder() {
+  CVI_SHAPE input_shape = getInputShape(0);
+  const TensorInfo *cls_info, *box_info;
+  int cls_offset;
+  getBranches(strides[0], &cls_info, &box_info, &cls_offset);
+  // stride 0 is a single branch pair already decoded to boxes of the input
+  bool decoded = strides[0] == 0;
+  decoder_.setup(decoded ? AnchorFreeBoxCoding::XYWH : AnchorFreeBoxCoding::DFL,
+                 AnchorFreeLayout::CHW, cls_info->tensor_size == cls_info->tensor_elem,
+                 box_info->tensor_size == box_info->tensor_elem, alg_param_.cls,
+                 m_box_channel_ / 4, input_shape.dim[3], input_shape.dim[2]);
+  for (int stride : strides) {
+    getBranches(stride, &cls_info, &box_info, &cls_offset);
+    AnchorFreeBranch cls = get_branch(*cls_info, cls_offset);
+    AnchorFreeBranch box = get_branch(*box_info, 0);
+    if (decoded) {
+      decoder_.addLevel(0, cls_info->shape.dim[2], 1, cls, box);
+    } else {
+      decoder_.addLevel(stride, cls_info->shape.dim[3], cls_info->shape.dim[2], cls, box);
+    }
+  }
+}
+
 YoloV8Detection::~YoloV8Detection() {}
 
 int YoloV8Detection::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) {
@@ -132,228 +170,27 @@ int YoloV8Detection::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj
     return ret;
   }
   CVI_SHAPE shape = getInputShape(0);
-  if (strides.size() == 3) {
-    outputParser(shape.dim[3], shape.dim[2], srcFrame->stVFrame.u32Width,
-                 srcFrame->stVFrame.u32Height, obj_meta);
-  } else {
-    parseDecodeBranch(shape.dim[3], shape.dim[2], srcFrame->stVFrame.u32Width,
-                      srcFrame->stVFrame.u32Height, obj_meta);
-  }
+  outputParser(shape.dim[3], shape.dim[2], srcFrame->stVFrame.u32Width,
+               srcFrame->stVFrame.u32Height, obj_meta);
 
   model_timer_.TicToc("post");
   return CVI_TDL_SUCCESS;
 }
 
-// the bbox featuremap shape is b x 4*regmax x h x w
-void YoloV8Detection::decode_bbox_feature_map(int stride, int anchor_idx,
-                                              std::vector<float> &decode_box) {
-  std::string box_name;
-  if (bbox_out_names.count(stride)) {
-    box_name = bbox_out_names[stride];
-  } else if (bbox_class_out_names.count(stride)) {
-    box_name = bbox_class_out_names[stride];
-  }
-  TensorInfo boxinfo = getOutputTensorInfo(box_name);
-
-  int num_per_pixel = boxinfo.tensor_size / boxinfo.tensor_elem;
-  int8_t *p_box_int8 = static_cast<int8_t *>(boxinfo.raw_pointer);
-  float *p_box_float = static_cast<float *>(boxinfo.raw_pointer);
-  int num_channel = boxinfo.shape.dim[1];
-  int num_anchor = boxinfo.shape.dim[2] * boxinfo.shape.dim[3];
-  int box_val_num = 4;
-  int reg_max = 16;
-  if (m_box_channel_ != box_val_num * reg_max) {
-    LOGE("box channel size not ok,got:%d\n", num_channel);
-  }
-
-  int32_t feat_w = boxinfo.shape.dim[3];
-
-  int anchor_y = anchor_idx / feat_w;
-  int anchor_x = anchor_idx % feat_w;
-
-  // LOGI("box numchannel:%d,numperpixel:%d,featw:%d,feath:%d,anchory:%d,anchorx:%d,numanchor:%d\n",
-  //      num_channel, num_per_pixel, feat_w, feat_h, anchor_y, anchor_x, num_anchor);
-
-  float grid_y = anchor_y + 0.5;
-  float grid_x = anchor_x + 0.5;
-
-  std::vector<float> grid_logits;  // 4x16
-  if (num_per_pixel == 1) {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_int8[c * num_anchor + anchor_idx] * boxinfo.qscale);
-    }
-  } else {
-    for (int c = 0; c < m_box_channel_; c++) {
-      grid_logits.push_back(p_box_float[c * num_anchor + anchor_idx]);
-    }
-  }
-
-  // compute softmax and accumulate val per 16
-  std::vector<float> box_vals;
-  for (int i = 0; i < box_val_num; i++) {
-    float sum_softmax = 0;
-    float sum_val = 0;
-    for (int j = 0; j < reg_max; j++) {
-      float expv = exp(grid_logits[i * reg_max + j]);
-      sum_softmax += expv;
-      sum_val += expv * j;
-    }
-    sum_softmax = sum_val / sum_softmax;
-    box_vals.push_back(sum_softmax);
-  }
-
-  std::vector<float> box = {(grid_x - box_vals[0]) * stride, (grid_y - box_vals[1]) * stride,
-                            (grid_x + box_vals[2]) * stride, (grid_y + box_vals[3]) * stride};
-  decode_box = box;
-}
-
 void YoloV8Detection::outputParser(const int image_width, const int image_height,
                                    const int frame_width, const int frame_height,
                                    cvtdl_object_t *obj_meta) {
   Detections vec_obj;
-  CVI_SHAPE shape = getInputShape(0);
-  int nn_width = shape.dim[3];
-  int nn_height = shape.dim[2];
-  float inverse_th = std::log(m_model_threshold / (1 - m_model_threshold));
-
-  for (size_t i = 0; i < strides.size(); i++) {
-    int stride = strides[i];
-    std::string cls_name;
-    int cls_offset = 0;
-    if (class_out_names.count(stride)) {
-      cls_name = class_out_names[stride];
-    } else if (bbox_class_out_names.count(stride)) {
-      cls_name = bbox_class_out_names[stride];
-      cls_offset = m_box_channel_;
-    }
-    TensorInfo classinfo = getOutputTensorInfo(cls_name);
-
-    int num_per_pixel = classinfo.tensor_size / classinfo.tensor_elem;
-    int8_t *p_cls_int8 = static_cast<int8_t *>(classinfo.raw_pointer);
-    float *p_cls_float = static_cast<float *>(classinfo.raw_pointer);
-
-    int num_cls = alg_param_.cls;
-    int num_anchor = classinfo.shape.dim[2] * classinfo.shape.dim[3];
-    // LOGI("stride:%d,featw:%d,feath:%d,numperpixel:%d,numcls:%d\n", stride,
-    // classinfo.shape.dim[3],
-    //     classinfo.shape.dim[2], num_per_pixel, num_cls);
-    float cls_qscale = num_per_pixel == 1 ? classinfo.qscale : 1;
-    for (int j = 0; j < num_anchor; j++) {
-      int max_logit_c = -1;
-      float max_logit = -1000;
-      if (num_per_pixel == 1) {
-        parse_cls_info<int8_t>(p_cls_int8, num_anchor, num_cls, j, cls_offset, cls_qscale,
-                               &max_logit, &max_logit_c);
-      } else {
-        parse_cls_info<float>(p_cls_float, num_anchor, num_cls, j, cls_offset, cls_qscale,
-                              &max_logit, &max_logit_c);
-      }
-      if (max_logit < inverse_th) {
-        continue;
-      }
-      float score = 1 / (1 + exp(-max_logit));
-      std::vector<float> box;
-      decode_bbox_feature_map(stride, j, box);
-      PtrDectRect det = std::make_shared<object_detect_rect_t>();
-      det->score = score;
-      det->x1 = box[0];
-      det->y1 = box[1];
-      det->x2 = box[2];
-      det->y2 = box[3];
-      det->label = max_logit_c;
-      clip_bbox(nn_width, nn_height, det);
-      float box_width = det->x2 - det->x1;
-      float box_height = det->y2 - det->y1;
-      if (box_width > 1 && box_height > 1) {
-        vec_obj.push_back(det);
-      }
-    }
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    decoder_.decode(i, m_model_threshold, &vec_obj, nullptr);
   }
   postProcess(vec_obj, frame_width, frame_height, obj_meta);
 }
 
-void YoloV8Detection::parseDecodeBranch(const int image_width, const int image_height,
-                                        const int frame_width, const int frame_height,
-                                        cvtdl_object_t *obj_meta) {
-  int stride = strides[0];
-  TensorInfo oinfo_box = getOutputTensorInfo(bbox_out_names[stride]);
-  TensorInfo oinfo_cls = getOutputTensorInfo(class_out_names[stride]);
-
-  int num_per_pixel_cls = oinfo_cls.tensor_size / oinfo_cls.tensor_elem;
-  int8_t *p_cls_int8 = static_cast<int8_t *>(oinfo_cls.raw_pointer);
-  float *p_cls_float = static_cast<float *>(oinfo_cls.raw_pointer);
-
-  int num_per_pixel_box = oinfo_box.tensor_size / oinfo_box.tensor_elem;
-  int8_t *p_box_int8 = static_cast<int8_t *>(oinfo_box.raw_pointer);
-  float *p_box_float = static_cast<float *>(oinfo_box.raw_pointer);
-
-  int num_cls = alg_param_.cls;
-  float cls_qscale = num_per_pixel_cls == 1 ? oinfo_cls.qscale : 1;
-  float box_qscale = num_per_pixel_box == 1 ? oinfo_box.qscale : 1;
-  int cls_offset = 0;
-
-  Detections vec_obj;
-
-  CVI_SHAPE shape = getInputShape(0);
-  // y = 1/(1+exp(-x)) ==>
-  float inverse_th = std::log(m_model_threshold / (1 - m_model_threshold));
-  int num_anchor = oinfo_cls.shape.dim[2];
-
-  LOGI("parseDecodeBranch box_pixel:%d,cls_pixel:%d,numanchor:%d\n", num_per_pixel_cls,
-       num_per_pixel_box, num_anchor);
-
-  float x, y, w, h;
-  for (int i = 0; i < num_anchor; i++) {
-    int max_logit_c = -1;
-    float max_logit = -1000;
-    if (num_per_pixel_cls == 1) {
-      parse_cls_info<int8_t>(p_cls_int8, num_anchor, num_cls, i, cls_offset, cls_qscale, &max_logit,
-                             &max_logit_c);
-    } else {
-      parse_cls_info<float>(p_cls_float, num_anchor, num_cls, i, cls_offset, cls_qscale, &max_logit,
-                            &max_logit_c);
-    }
-    if (max_logit < inverse_th) {
-      continue;
-    }
-    float score = 1 / (1 + exp(-max_logit));
-    if (num_per_pixel_box == 1) {
-      x = p_box_int8[0 * num_anchor + i] * box_qscale;
-      y = p_box_int8[1 * num_anchor + i] * box_qscale;
-      w = p_box_int8[2 * num_anchor + i] * box_qscale;
-      h = p_box_int8[3 * num_anchor + i] * box_qscale;
-    } else {
-      x = p_box_float[0 * num_anchor + i];
-      y = p_box_float[1 * num_anchor + i];
-      w = p_box_float[2 * num_anchor + i];
-      h = p_box_float[3 * num_anchor + i];
-    }
-
-    int x1 = int((x - 0.5 * w));
-    int y1 = int((y - 0.5 * h));
-
-    int x2 = int((x + 0.5 * w));
-    int y2 = int((y + 0.5 * h));
-
-    PtrDectRect det = std::make_shared<object_detect_rect_t>();
-    det->score = score;
-    det->x1 = x1;
-    det->y1 = y1;
-    det->x2 = x2;
-    det->y2 = y2;
-    det->label = 0;
-    clip_bbox(shape.dim[3], shape.dim[2], det);
-    float box_width = det->x2 - det->x1;
-    float box_height = det->y2 - det->y1;
-    if (box_width > 1 && box_height > 1) {
-      vec_obj.push_back(det);
-    }
-  }
-  postProcess(vec_obj, frame_width, frame_height, obj_meta);
-}
 void YoloV8Detection::postProcess(Detections &dets, int frame_width, int frame_height,
                                   cvtdl_object_t *obj_meta) {
-  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(dets, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
   CVI_SHAPE shape = getInputShape(0);
   convert_det_struct(final_dets, obj_meta, shape.dim[2], shape.dim[3]);
 
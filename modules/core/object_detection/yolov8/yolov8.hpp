@@ -1,6 +1,7 @@
 #pragma once
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
+#include "anchor_free_decode.hpp"
 #include "obj_detection.hpp"
 
 namespace cvitdl {
@@ -14,17 +15,17 @@ class YoloV8Detection final : public DetectionBase {
   ~YoloV8Detection();
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) override;
   bool allowExportChannelAttribute() const override { return true; }
+  void set_algparam(const cvtdl_det_algo_param_t &alg_param) override;
 
  private:
   int onModelOpened() override;
+  void getBranches(int stride, const TensorInfo **cls_info, const TensorInfo **box_info,
+                   int *cls_offset);
+  void setupDecoder();
 
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
 
-  void parseDecodeBranch(const int image_width, const int image_height, const int frame_width,
-                         const int frame_height, cvtdl_object_t *obj_meta);
-
-  void decode_bbox_feature_map(int stride, int anchor_idx, std::vector<float> &decode_box);
   void postProcess(Detections &dets, int frame_width, int frame_height, cvtdl_object_t *obj_meta);
   std::map<std::string, std::string> out_names_;
 
@@ -34,5 +35,6 @@ class YoloV8Detection final : public DetectionBase {
   std::map<int, std::string> bbox_out_names;
   std::map<int, std::string> bbox_class_out_names;
   int m_box_channel_ = 64;
+  AnchorFreeDecoder decoder_;
 };
 }  // namespace cvitdl
@@ -34,121 +34,18 @@ static void convert_det_struct(const Detections &dets, cvtdl_object_t *out, int
   }
 }
 
-float yolox_sigmoid(float x) { return 1.0 / (1.0 + exp(-x)); }
-
-template <typename T>
-void decode_yolox_bbox(T *ptr, float qscale, int basic_pos, int grid0, int grid1, int stride,
-                       int label, float box_prob, PtrDectRect &det) {
-  float x_center = (ptr[basic_pos + 0] * qscale + grid0) * stride;
-  float y_center = (ptr[basic_pos + 1] * qscale + grid1) * stride;
-  float w = std::exp(ptr[basic_pos + 2] * qscale) * stride;
-  float h = std::exp(ptr[basic_pos + 3] * qscale) * stride;
-  float x0 = x_center - w * 0.5f;
-  float y0 = y_center - h * 0.5f;
-  det->label = label;
-  det->score = box_prob;
-  det->x1 = x0;
-  det->y1 = y0;
-  det->x2 = x0 + w;
-  det->y2 = y0 + h;
-}
-
-template <typename T>
-int yolox_argmax(T *ptr, int basic_pos, int cls_len) {
-  int max_idx = 0;
-  for (int i = 0; i < cls_len; i++) {
-    if (ptr[i + basic_pos] > ptr[max_idx + basic_pos]) {
-      max_idx = i;
-    }
-  }
-  return max_idx;
+static YoloBranch get_branch(const TensorInfo &oinfo) {
+  YoloBranch branch;
+  bool is_int8 = oinfo.tensor_size == oinfo.tensor_elem;
+  branch.data_int8 = is_int8 ? static_cast<int8_t *>(oinfo.raw_pointer) : nullptr;
+  branch.data_float = is_int8 ? nullptr : static_cast<float *>(oinfo.raw_pointer);
+  branch.qscale = is_int8 ? oinfo.qscale : 1;
+  return branch;
 }
 
 void YoloX::generate_yolox_proposals(Detections &detections) {
-  CVI_SHAPE shape = getInputShape(0);
-  int target_w = shape.dim[3];
-  int target_h = shape.dim[2];
-
-  for (auto stride : strides_) {
-    TensorInfo oinfo_class = getOutputTensorInfo(class_out_names_[stride]);
-    int num_per_pixel_class = oinfo_class.tensor_size / oinfo_class.tensor_elem;
-    float qscale_class = num_per_pixel_class == 1 ? oinfo_class.qscale : 1;
-    int8_t *ptr_int8_class = static_cast<int8_t *>(oinfo_class.raw_pointer);
-    float *ptr_float_class = static_cast<float *>(oinfo_class.raw_pointer);
-
-    TensorInfo oinfo_object = getOutputTensorInfo(object_out_names_[stride]);
-    int num_per_pixel_object = oinfo_object.tensor_size / oinfo_object.tensor_elem;
-    float qscale_object = num_per_pixel_object == 1 ? oinfo_object.qscale : 1;
-    int8_t *ptr_int8_object = static_cast<int8_t *>(oinfo_object.raw_pointer);
-    float *ptr_float_object = static_cast<float *>(oinfo_object.raw_pointer);
-
-    TensorInfo oinfo_box = getOutputTensorInfo(box_out_names_[stride]);
-    int num_per_pixel_box = oinfo_box.tensor_size / oinfo_box.tensor_elem;
-    float qscale_box = num_per_pixel_box == 1 ? oinfo_box.qscale : 1;
-    int8_t *ptr_int8_box = static_cast<int8_t *>(oinfo_box.raw_pointer);
-    float *ptr_float_box = static_cast<float *>(oinfo_box.raw_pointer);
-
-    int num_grid_w = target_w / stride;
-    int num_grid_h = target_h / stride;
-
-    int basic_pos_class = 0;
-    int basic_pos_object = 0;
-    int basic_pos_box = 0;
-
-    for (int g1 = 0; g1 < num_grid_h; g1++) {
-      for (int g0 = 0; g0 < num_grid_w; g0++) {
-        float class_score = 0.0f;
-        float box_objectness = 0.0f;
-        int label = 0;
-
-        // parse object conf
-        if (num_per_pixel_class == 1) {
-          box_objectness = ptr_int8_object[basic_pos_object] * qscale_object;
-        } else {
-          box_objectness = ptr_float_object[basic_pos_object];
-        }
-
-        // parse class score
-        if (num_per_pixel_object == 1) {
-          label = yolox_argmax<int8_t>(ptr_int8_class, basic_pos_class, alg_param_.cls);
-          class_score = ptr_int8_class[basic_pos_class + label] * qscale_class;
-        } else {
-          label = yolox_argmax<float>(ptr_float_class, basic_pos_class, alg_param_.cls);
-          class_score = ptr_float_class[basic_pos_class + label];
-        }
-
-        box_objectness = yolox_sigmoid(box_objectness);
-        class_score = yolox_sigmoid(class_score);
-        float box_prob = box_objectness * class_score;
-
-        if (box_prob < m_model_threshold) {
-          basic_pos_class += alg_param_.cls;
-          basic_pos_box += 4;
-          basic_pos_object += 1;
-          continue;
-        }
-
-        // parse box point
-        PtrDectRect det = std::make_shared<object_detect_rect_t>();
-        if (num_per_pixel_box == 1) {
-          decode_yolox_bbox<int8_t>(ptr_int8_box, qscale_box, basic_pos_box, g0, g1, stride, label,
-                                    box_prob, det);
-        } else {
-          decode_yolox_bbox<float>(ptr_float_box, qscale_box, basic_pos_box, g0, g1, stride, label,
-                                   box_prob, det);
-        }
-
-        clip_bbox(target_w, target_h, det);
-        float box_width = det->x2 - det->x1;
-        float box_height = det->y2 - det->y1;
-        if (box_width > 1 && box_height > 1) {
-          detections.push_back(det);
-        }
-        basic_pos_class += alg_param_.cls;
-        basic_pos_box += 4;
-        basic_pos_object += 1;
-      }
-    }
+  for (size_t i = 0; i < decoder_.numLevels(); i++) {
+    decoder_.decode(i, m_model_threshold, &detections);
   }
 }
 
@@ -162,6 +59,25 @@ YoloX::YoloX() {
   alg_param_.cls = 80;
 }
 
+void YoloX::set_algparam(const cvtdl_det_algo_param_t &alg_param) {
+  DetectionBase::set_algparam(alg_param);
+  if (!strides_.empty()) {
+    setupDecoder();
+  }
+}
+
+void YoloX::setupDecoder() {
+  CVI_SHAPE input_shape = getInputShape(0);
+  decoder_.setup(YoloBoxCoding::YOLOX, input_shape.dim[3], input_shape.dim[2], strides_, {},
+                 nullptr, 0, alg_param_.cls);
+  for (size_t i = 0; i < strides_.size(); i++) {
+    int stride = strides_[i];
+    decoder_.bindLevel(i, get_branch(getOutputTensorInfo(object_out_names_[stride])),
+                       get_branch(getOutputTensorInfo(class_out_names_[stride])),
+                       get_branch(getOutputTensorInfo(box_out_names_[stride])));
+  }
+}
+
 int YoloX::onModelOpened() {
   CVI_SHAPE input_shape = getInputShape(0);
 
@@ -210,6 +126,7 @@ int YoloX::onModelOpened() {
       return CVI_TDL_FAILURE;
     }
   }
+  setupDecoder();
 
   return CVI_TDL_SUCCESS;
 }
@@ -237,7 +154,8 @@ void YoloX::outputParser(const int image_width, const int image_height, const in
   generate_yolox_proposals(vec_obj);
 
   // Do nms on output result
-  Detections final_dets = nms_multi_class(vec_obj, m_model_nms_threshold);
+  Detections final_dets = nms_multi_class(vec_obj, m_model_nms_threshold, alg_param_.max_candidates,
+                                          alg_param_.max_det);
 
   CVI_SHAPE shape = getInputShape(0);
 
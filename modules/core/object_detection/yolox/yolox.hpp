@@ -2,6 +2,7 @@
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
 #include "obj_detection.hpp"
+#include "yolo_decode.hpp"
 
 namespace cvitdl {
 
@@ -12,9 +13,11 @@ class YoloX final : public DetectionBase {
 
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta) override;
   bool allowExportChannelAttribute() const override { return true; }
+  void set_algparam(const cvtdl_det_algo_param_t &alg_param) override;
 
  private:
   int onModelOpened() override;
+  void setupDecoder();
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj_meta);
   void generate_yolox_proposals(Detections &detections);
@@ -23,5 +26,6 @@ class YoloX final : public DetectionBase {
   std::map<int, std::string> class_out_names_;
   std::map<int, std::string> object_out_names_;
   std::map<int, std::string> box_out_names_;
+  YoloDecoder decoder_;
 };
 }  // namespace cvitdl
\ No newline at end of file
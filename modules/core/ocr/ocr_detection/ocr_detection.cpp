@@ -6,11 +6,7 @@
 #include "cvi_sys.h"
 
 #include "core/utils/vpss_helper.h"
-
-#include <iostream>
-#include <opencv2/opencv.hpp>
-#include <sstream>
-#include "opencv2/imgproc.hpp"
+#include "text_region.hpp"
 
 #define R_SCALE (0.003922)
 #define G_SCALE (0.003922)
@@ -19,6 +15,9 @@
 #define G_MEAN (0)
 #define B_MEAN (0)
 
+#define OCR_MIN_AREA 10
+#define OCR_UNCLIP_RATIO 1.5f
+
 namespace cvitdl {
 
 OCRDetection::OCRDetection() : Core(CVI_MEM_DEVICE) {
@@ -101,37 +100,43 @@ void NMS(std::vector<cvtdl_object_info_t> &bboxes, std::vector<cvtdl_object_info
 }
 
 void OCRDetection::outputParser(float thresh, float boxThresh, cvtdl_object_t *obj_meta) {
-  float *out = getOutputRawPtr<float>(0);
-  CVI_SHAPE output_shape = getOutputShape(0);
-  int outHeight = output_shape.dim[2];
-  int outWidth = output_shape.dim[3];
-  cv::Mat probMap(outHeight, outWidth, CV_32FC1, out);
-  cv::Mat binaryMap;
-  probMap.convertTo(binaryMap, CV_8UC1, 255.0);
-  cv::threshold(binaryMap, binaryMap, thresh * 255, 255, cv::THRESH_BINARY);
-
-  std::vector<std::vector<cv::Point>> contours;
-  cv::findContours(binaryMap, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+  TensorInfo oinfo = getOutputTensorInfo(0);
+  int outHeight = oinfo.shape.dim[2];
+  int outWidth = oinfo.shape.dim[3];
+
+  TextRegionParam param = {thresh, OCR_MIN_AREA, OCR_UNCLIP_RATIO};
+  std::vector<TextRegion> regions;
+  if (oinfo.tensor_size == oinfo.tensor_elem) {
+    extract_text_regions(static_cast<int8_t *>(oinfo.raw_pointer), oinfo.qscale, outWidth,
+                         outHeight, outWidth, param, &regions);
+  } else {
+    extract_text_regions(static_cast<float *>(oinfo.raw_pointer), outWidth, outHeight, outWidth,
+                         param, &regions);
+  }
 
   std::vector<cvtdl_object_info_t> bboxes;
   CVI_SHAPE shape = getInputShape(0);
-  for (auto &contour : contours) {
-    double area = cv::contourArea(contour);
-    if (area < 10) continue;
-
-    cv::Rect boundingBox = cv::boundingRect(contour);
-
-    cvtdl_bbox_t bbox = {boundingBox.x, boundingBox.y, boundingBox.x + boundingBox.width,
-                         boundingBox.y + boundingBox.height};
+  for (const TextRegion &region : regions) {
+    cvtdl_bbox_t bbox;
+    bbox.x1 = std::max(region.x1, 0.f);
+    bbox.y1 = std::max(region.y1, 0.f);
+    bbox.x2 = std::min(region.x2, (float)outWidth);
+    bbox.y2 = std::min(region.y2, (float)outHeight);
+    bbox.score = region.score;
     cvtdl_bbox_t rescaled_bbox =
         box_rescale(obj_meta->width, obj_meta->height, shape.dim[3], shape.dim[2], bbox,
                     meta_rescale_type_e::RESCALE_CENTER);
 
     cvtdl_object_info_t objInfo;
+    memset(&objInfo, 0, sizeof(objInfo));
     objInfo.bbox = rescaled_bbox;
     bboxes.push_back(objInfo);
   }
 
+  std::stable_sort(bboxes.begin(), bboxes.end(),
+                   [](const cvtdl_object_info_t &a, const cvtdl_object_info_t &b) {
+                     return a.bbox.score > b.bbox.score;
+                   });
   std::vector<cvtdl_object_info_t> bboxes_nms;
   NMS(bboxes, bboxes_nms, boxThresh, 'u');
 
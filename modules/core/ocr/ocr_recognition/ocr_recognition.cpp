@@ -3,6 +3,7 @@
 #include "core/cvi_tdl_types_mem.h"
 #include "core/cvi_tdl_types_mem_internal.h"
 #include "core_utils.hpp"
+#include "ctc_decode.hpp"
 #include "cvi_sys.h"
 
 #include "core/utils/vpss_helper.h"
@@ -65,20 +66,6 @@ OCRRecognition::OCRRecognition() : Core(CVI_MEM_DEVICE) {
 }
 OCRRecognition::~OCRRecognition() {}
 
-int argmax(float* start, float* end) {
-  float* max_iter = std::max_element(start, end);
-  int max_idx = max_iter - start;
-  return max_idx;
-}
-
-template <typename InputIt, typename T>
-T my_accumulate(InputIt first, InputIt last, T init) {
-  for (; first != last; ++first) {
-    init = init + *first;
-  }
-  return init;
-}
-
 std::vector<std::string> ReadDict(const std::string& path) {
   std::ifstream in(path);
   std::string line;
@@ -94,47 +81,35 @@ std::vector<std::string> ReadDict(const std::string& path) {
   return m_vec;
 }
 
-std::pair<std::string, float> OCRRecognition::decode(const std::vector<int>& text_index,
-                                                     const std::vector<float>& text_prob,
-                                                     std::vector<std::string>& chars,
-                                                     bool is_remove_duplicate) {
-  std::string text;
-  std::vector<float> conf_list;
-
-  for (size_t idx = 0; idx < text_index.size(); ++idx) {
-    if (is_remove_duplicate && idx > 0 && text_index[idx - 1] == text_index[idx]) {
-      continue;
-    }
-    text += chars[text_index[idx]];
-    conf_list.push_back(text_prob[idx]);
-  }
-
-  float average_conf = conf_list.empty() ? 0.0f
-                                         : my_accumulate(conf_list.begin(), conf_list.end(), 0.0f) /
-                                               conf_list.size();
-  return {text, average_conf};
-}
-
-void OCRRecognition::greedy_decode(float* prebs, std::vector<std::string>& chars) {
+void OCRRecognition::greedy_decode(const TensorView& prebs, std::vector<std::string>& chars) {
   CVI_SHAPE output_shape = getOutputShape(0);
   int outShapeC = output_shape.dim[1];
   int outHeight = output_shape.dim[2];
   int outWidth = output_shape.dim[3];
 
-  std::vector<int> argmax_results(outShapeC, 0);
-  std::vector<float> confidences(outShapeC, 0.0f);
+  // time-major softmax output, class 0 is the CTC blank and class i is chars[i - 1]
+  CtcInput input;
+  input.data_int8 = prebs.is_int8 ? prebs.get<int8_t>() : nullptr;
+  input.data_float = prebs.is_int8 ? nullptr : prebs.get<float>();
+  input.qscale = prebs.qscale;
+  input.is_prob = true;
+  input.steps = outShapeC;
+  input.classes = outHeight * outWidth;
+  input.step_stride = outHeight * outWidth;
+  input.class_stride = 1;
+  input.seq_stride = outShapeC * outHeight * outWidth;
+
+  std::vector<int> labels;
+  float average_conf = 0;
+  CtcDecoder(0).greedy(input, 0, &labels, &average_conf);
 
-  for (int t = 0; t < outShapeC; ++t) {
-    float* start = prebs + t * outWidth * outHeight;
-    float* end = prebs + (t + 1) * outWidth * outHeight;
-    int argmax_idx = argmax(start, end);
-
-    argmax_results[t] = argmax_idx - 1;
-    confidences[t] = *(start + argmax_idx);
+  std::string text;
+  for (int label : labels) {
+    if (label <= (int)chars.size()) {
+      text += chars[label - 1];
+    }
   }
-  auto result = decode(argmax_results, confidences, chars, true);
-  std::cout << "Decoded Text: " << result.first << ", Average Confidence: " << result.second
-            << std::endl;
+  LOGD("decoded text: %s, average confidence: %f\n", text.c_str(), average_conf);
 }
 
 // 可以不通过det，打开下方接口
@@ -219,8 +194,7 @@ int OCRRecognition::inference(VIDEO_FRAME_INFO_S* frame, cvtdl_object_t* obj_met
       return ret;
     }
 
-    float* out = getOutputRawPtr<float>(0);
-    greedy_decode(out, myCharacters);
+    greedy_decode(getOutputTensorView(0), myCharacters);
     mp_vpss_inst->releaseFrame(cropped_frame, 0);
     delete cropped_frame;
   }
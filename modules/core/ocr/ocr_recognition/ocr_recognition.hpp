@@ -12,9 +12,6 @@ class OCRRecognition final : public Core {
   int inference(VIDEO_FRAME_INFO_S* frame, cvtdl_object_t* obj_meta);
 
  private:
-  void greedy_decode(float* prebs, std::vector<std::string>& chars);
-  std::pair<std::string, float> decode(const std::vector<int>& text_index,
-                                       const std::vector<float>& text_prob,
-                                       std::vector<std::string>& chars, bool is_remove_duplicate);
+  void greedy_decode(const TensorView& prebs, std::vector<std::string>& chars);
 };
 }  // namespace cvitdl
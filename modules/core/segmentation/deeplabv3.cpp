@@ -1,5 +1,7 @@
 #include "deeplabv3.hpp"
 
+#include <string.h>
+
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/utils/vpss_helper.h"
@@ -23,7 +25,11 @@ Deeplabv3::Deeplabv3() : Core(CVI_MEM_DEVICE) {
 
 Deeplabv3::~Deeplabv3() {}
 
-int Deeplabv3::onModelOpened() { return allocateION(); }
+int Deeplabv3::onModelOpened() {
+  // single-output models may be exported without the dequant node
+  m_score_name = getNumOutputTensor() == 1 ? getOutputTensorInfo(0).tensor_name : NAME_SCORE;
+  return allocateION();
+}
 
 int Deeplabv3::onModelClosed() {
   releaseION();
@@ -31,7 +37,7 @@ int Deeplabv3::onModelClosed() {
 }
 
 CVI_S32 Deeplabv3::allocateION() {
-  CVI_SHAPE shape = getOutputShape(NAME_SCORE);
+  CVI_SHAPE shape = getOutputShape(m_score_name);
   if (CREATE_ION_HELPER(&m_label_frame, shape.dim[3], shape.dim[2], PIXEL_FORMAT_YUV_400, "tpu") !=
       CVI_SUCCESS) {
     LOGE("Cannot allocate ion for preprocess\n");
@@ -65,7 +71,13 @@ int Deeplabv3::inference(VIDEO_FRAME_INFO_S *frame, VIDEO_FRAME_INFO_S *out_fram
     return ret;
   }
 
-  outputParser(filter);
+  ret = outputParser(filter, 1, m_label_frame.stVFrame.pu8VirAddr[0],
+                     m_label_frame.stVFrame.u32Stride[0]);
+  if (ret != CVI_TDL_SUCCESS) {
+    return ret;
+  }
+  CVI_SYS_IonFlushCache(m_label_frame.stVFrame.u64PhyAddr[0], m_label_frame.stVFrame.pu8VirAddr[0],
+                        m_label_frame.stVFrame.u32Length[0]);
 
   VPSS_CHN_ATTR_S vpssChnAttr;
   vpssChnAttr.u32Width = frame->stVFrame.u32Width;
@@ -96,58 +108,77 @@ int Deeplabv3::inference(VIDEO_FRAME_INFO_S *frame, VIDEO_FRAME_INFO_S *out_fram
   return CVI_TDL_SUCCESS;
 }
 
-inline bool is_preserved_class(cvtdl_class_filter_t *filter, int32_t c) {
-  if (c == 0) return true;  // "unlabled class" should be preserved
-
-  if (filter->num_preserved_classes > 0) {
-    for (uint32_t j = 0; j < filter->num_preserved_classes; j++) {
-      if (filter->preserved_class_ids[j] == (uint32_t)c) {
-        return true;
-      }
-    }
+int Deeplabv3::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_seg_label_t *seg_label,
+                         cvtdl_class_filter_t *filter) {
+  if (frame->stVFrame.enPixelFormat != PIXEL_FORMAT_RGB_888) {
+    LOGE("Error: pixel format not match PIXEL_FORMAT_RGB_888.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
   }
 
-  return false;
-}
-
-int Deeplabv3::outputParser(cvtdl_class_filter_t *filter) {
-  float *out = getOutputRawPtr<float>(NAME_SCORE);
-
-  CVI_SHAPE output_shape = getOutputShape(NAME_SCORE);
-
-  int size = output_shape.dim[2] * output_shape.dim[3];
-  std::vector<float> max_prob(size, 0);
-
-  for (int32_t c = 0; c < output_shape.dim[1]; ++c) {
-    int size_offset = c * size;
-    for (int32_t h = 0; h < output_shape.dim[2]; ++h) {
-      int width_offset = h * output_shape.dim[3];
-      int frame_offset = h * m_label_frame.stVFrame.u32Stride[0];
-
-      for (int32_t w = 0; w < output_shape.dim[3]; ++w) {
-        if (out[size_offset + width_offset + w] > max_prob[width_offset + w]) {
-          m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w] = (int8_t)c;
-          max_prob[width_offset + w] = out[size_offset + width_offset + w];
-        }
-      }
-    }
+  std::vector<VIDEO_FRAME_INFO_S *> frames = {frame};
+  int ret = run(frames);
+  if (ret != CVI_TDL_SUCCESS) {
+    return ret;
   }
 
-  if (filter) {
-    for (int32_t h = 0; h < output_shape.dim[2]; ++h) {
-      int frame_offset = h * m_label_frame.stVFrame.u32Stride[0];
-
-      for (int32_t w = 0; w < output_shape.dim[3]; ++w) {
-        if (!is_preserved_class(filter, m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w])) {
-          m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w] = 0;
-        }
-      }
+  CVI_SHAPE output_shape = getOutputShape(m_score_name);
+  int downscale = seg_label->downscale > 1 ? seg_label->downscale : 1;
+  uint32_t width = (output_shape.dim[3] + downscale - 1) / downscale;
+  uint32_t height = (output_shape.dim[2] + downscale - 1) / downscale;
+
+  CVI_TDL_FreeCpp(seg_label);
+  if (seg_label->use_rle) {
+    m_labels.resize(width * height);
+    ret = outputParser(filter, downscale, m_labels.data(), width);
+    if (ret != CVI_TDL_SUCCESS) {
+      return ret;
+    }
+    encode_label_rle(m_labels.data(), width, height, width, &m_rle);
+    seg_label->rle = (uint32_t *)malloc(m_rle.size() * sizeof(uint32_t));
+    if (seg_label->rle == NULL) {
+      LOGE("Failed to allocate memory for seg label rle\n");
+      return CVI_TDL_FAILURE;
+    }
+    memcpy(seg_label->rle, m_rle.data(), m_rle.size() * sizeof(uint32_t));
+    seg_label->rle_size = m_rle.size() / 2;
+  } else {
+    seg_label->labels = (uint8_t *)malloc(width * height);
+    if (seg_label->labels == NULL) {
+      LOGE("Failed to allocate memory for seg labels\n");
+      return CVI_TDL_FAILURE;
+    }
+    ret = outputParser(filter, downscale, seg_label->labels, width);
+    if (ret != CVI_TDL_SUCCESS) {
+      return ret;
     }
   }
+  seg_label->width = width;
+  seg_label->height = height;
+  return CVI_TDL_SUCCESS;
+}
 
-  CVI_SYS_IonFlushCache(m_label_frame.stVFrame.u64PhyAddr[0], m_label_frame.stVFrame.pu8VirAddr[0],
-                        m_label_frame.stVFrame.u32Length[0]);
+int Deeplabv3::outputParser(cvtdl_class_filter_t *filter, int downscale, uint8_t *dst,
+                            int dst_stride) {
+  const TensorInfo &oinfo = getOutputTensorInfo(m_score_name);
+  int num_cls = oinfo.shape.dim[1];
+  int height = oinfo.shape.dim[2];
+  int width = oinfo.shape.dim[3];
+  if (num_cls > 256) {
+    LOGE("Deeplabv3 supports up to 256 classes, got %d\n", num_cls);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
 
+  if (filter != nullptr) {
+    m_argmax.setFilter(filter->preserved_class_ids, filter->num_preserved_classes);
+  } else {
+    m_argmax.clearFilter();
+  }
+  int num_per_pixel = oinfo.tensor_size / oinfo.tensor_elem;
+  if (num_per_pixel == 1) {
+    m_argmax.run(oinfo.get<int8_t>(), num_cls, height, width, downscale, dst, dst_stride);
+  } else {
+    m_argmax.run(oinfo.get<float>(), num_cls, height, width, downscale, dst, dst_stride);
+  }
   return CVI_TDL_SUCCESS;
 }
 
@@ -2,6 +2,7 @@
 #include "core/object/cvtdl_object_types.h"
 #include "core_internel.hpp"
 #include "cvi_comm.h"
+#include "seg_argmax.hpp"
 
 namespace cvitdl {
 
@@ -11,6 +12,8 @@ class Deeplabv3 final : public Core {
   virtual ~Deeplabv3();
   int inference(VIDEO_FRAME_INFO_S *frame, VIDEO_FRAME_INFO_S *out_frame,
                 cvtdl_class_filter_t *filter);
+  int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_seg_label_t *seg_label,
+                cvtdl_class_filter_t *filter);
   virtual bool allowExportChannelAttribute() const override { return true; }
 
  private:
@@ -18,7 +21,11 @@ class Deeplabv3 final : public Core {
   virtual int onModelClosed() override;
   CVI_S32 allocateION();
   void releaseION();
-  int outputParser(cvtdl_class_filter_t *filter);
+  int outputParser(cvtdl_class_filter_t *filter, int downscale, uint8_t *dst, int dst_stride);
   VIDEO_FRAME_INFO_S m_label_frame;
+  std::string m_score_name;
+  SegArgmax m_argmax;
+  std::vector<uint8_t> m_labels;
+  std::vector<uint32_t> m_rle;
 };
 }  // namespace cvitdl
@@ -0,0 +1,163 @@
+#include "seg_argmax.hpp"
+
+#include <string.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+namespace {
+
+const int kBlock = 16;
+
+// Argmax of num pixels (num <= kBlock) starting at p, step pixels apart. The first class wins
+// ties.
+template <typename T>
+inline void argmax_block(const T *p, int num_cls, int plane, int step, int num, uint8_t *labels) {
+  T best[kBlock];
+  uint8_t label[kBlock];
+  for (int i = 0; i < num; i++) {
+    best[i] = p[i * step];
+    label[i] = 0;
+  }
+  for (int c = 1; c < num_cls; c++) {
+    const T *pc = p + c * plane;
+    for (int i = 0; i < num; i++) {
+      T v = pc[i * step];
+      bool greater = v > best[i];
+      best[i] = greater ? v : best[i];
+      label[i] = greater ? static_cast<uint8_t>(c) : label[i];
+    }
+  }
+  for (int i = 0; i < num; i++) {
+    labels[i] = label[i];
+  }
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+inline void argmax_block16(const float *p, int num_cls, int plane, uint8_t *labels) {
+  float32x4_t best[4];
+  uint32x4_t label[4];
+  for (int k = 0; k < 4; k++) {
+    best[k] = vld1q_f32(p + 4 * k);
+    label[k] = vdupq_n_u32(0);
+  }
+  for (int c = 1; c < num_cls; c++) {
+    const float *pc = p + c * plane;
+    const uint32x4_t cls = vdupq_n_u32(c);
+    for (int k = 0; k < 4; k++) {
+      float32x4_t v = vld1q_f32(pc + 4 * k);
+      uint32x4_t greater = vcgtq_f32(v, best[k]);
+      best[k] = vbslq_f32(greater, v, best[k]);
+      label[k] = vbslq_u32(greater, cls, label[k]);
+    }
+  }
+  uint16x8_t lo = vcombine_u16(vmovn_u32(label[0]), vmovn_u32(label[1]));
+  uint16x8_t hi = vcombine_u16(vmovn_u32(label[2]), vmovn_u32(label[3]));
+  vst1q_u8(labels, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+}
+
+inline void argmax_block16(const int8_t *p, int num_cls, int plane, uint8_t *labels) {
+  int8x16_t best = vld1q_s8(p);
+  uint8x16_t label = vdupq_n_u8(0);
+  for (int c = 1; c < num_cls; c++) {
+    int8x16_t v = vld1q_s8(p + c * plane);
+    uint8x16_t greater = vcgtq_s8(v, best);
+    best = vmaxq_s8(best, v);
+    label = vbslq_u8(greater, vdupq_n_u8(c), label);
+  }
+  vst1q_u8(labels, label);
+}
+#else
+template <typename T>
+inline void argmax_block16(const T *p, int num_cls, int plane, uint8_t *labels) {
+  argmax_block(p, num_cls, plane, 1, kBlock, labels);
+}
+#endif
+
+template <typename T>
+void argmax_labels(const T *scores, int num_cls, int height, int width, int downscale,
+                   const uint8_t *lut, uint8_t *dst, int dst_stride) {
+  const int plane = height * width;
+  const int out_w = (width + downscale - 1) / downscale;
+  for (int y = 0, oy = 0; y < height; y += downscale, oy++) {
+    const T *p_row = scores + y * width;
+    uint8_t *p_dst = dst + oy * dst_stride;
+    int ox = 0;
+    if (downscale == 1) {
+      for (; ox + kBlock <= out_w; ox += kBlock) {
+        argmax_block16(p_row + ox, num_cls, plane, p_dst + ox);
+      }
+    }
+    for (; ox < out_w; ox += kBlock) {
+      int num = std::min(kBlock, out_w - ox);
+      argmax_block(p_row + ox * downscale, num_cls, plane, downscale, num, p_dst + ox);
+    }
+    if (lut != nullptr) {
+      for (int x = 0; x < out_w; x++) {
+        p_dst[x] = lut[p_dst[x]];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void SegArgmax::setFilter(const uint32_t *preserved, uint32_t num_preserved) {
+  m_identity = false;
+  memset(m_lut, 0, sizeof(m_lut));
+  for (uint32_t j = 0; j < num_preserved; j++) {
+    if (preserved[j] < 256) {
+      m_lut[preserved[j]] = preserved[j];
+    }
+  }
+}
+
+void SegArgmax::clearFilter() {
+  m_identity = true;
+  for (int c = 0; c < 256; c++) {
+    m_lut[c] = c;
+  }
+}
+
+void SegArgmax::run(const float *scores, int num_cls, int height, int width, int downscale,
+                    uint8_t *dst, int dst_stride) const {
+  argmax_labels(scores, num_cls, height, width, downscale, m_identity ? nullptr : m_lut, dst,
+                dst_stride);
+}
+
+void SegArgmax::run(const int8_t *scores, int num_cls, int height, int width, int downscale,
+                    uint8_t *dst, int dst_stride) const {
+  argmax_labels(scores, num_cls, height, width, downscale, m_identity ? nullptr : m_lut, dst,
+                dst_stride);
+}
+
+void encode_label_rle(const uint8_t *labels, int width, int height, int stride,
+                      std::vector<uint32_t> *rle) {
+  rle->clear();
+  uint32_t cur = 0, count = 0;
+  for (int y = 0; y < height; y++) {
+    const uint8_t *p_row = labels + y * stride;
+    for (int x = 0; x < width; x++) {
+      if (p_row[x] == cur) {
+        count++;
+        continue;
+      }
+      if (count > 0) {
+        rle->push_back(cur);
+        rle->push_back(count);
+      }
+      cur = p_row[x];
+      count = 1;
+    }
+  }
+  if (count > 0) {
+    rle->push_back(cur);
+    rle->push_back(count);
+  }
+}
+
+}  // namespace cvitdl
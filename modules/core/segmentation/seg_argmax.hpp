@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace cvitdl {
+
+/**
+ * @brief Fused argmax over the class axis of an NCHW score map.
+ *
+ * Pixels are processed in blocks across all classes, so every label is written once. The class
+ * filter is applied through a lookup table in the same pass. Int8 scores are compared as they
+ * are, since a positive quantization scale keeps their order.
+ */
+class SegArgmax {
+ public:
+  // Classes other than the num_preserved ids in preserved map to 0.
+  void setFilter(const uint32_t *preserved, uint32_t num_preserved);
+  // Keep every class.
+  void clearFilter();
+
+  // Evaluate every downscale-th row and column of a num_cls x height x width score map and write
+  // ceil(height / downscale) rows of ceil(width / downscale) labels, dst_stride bytes apart.
+  void run(const float *scores, int num_cls, int height, int width, int downscale, uint8_t *dst,
+           int dst_stride) const;
+  void run(const int8_t *scores, int num_cls, int height, int width, int downscale, uint8_t *dst,
+           int dst_stride) const;
+
+ private:
+  bool m_identity = true;
+  uint8_t m_lut[256];
+};
+
+// Encode a label map as (label, run length) pairs in row-major order.
+void encode_label_rle(const uint8_t *labels, int width, int height, int stride,
+                      std::vector<uint32_t> *rle);
+
+}  // namespace cvitdl
@@ -18,6 +18,7 @@ class SoundClassification final : public Core {
     threshold_ = th;
     return CVI_SUCCESS;
   };
+  float getThreshold() const { return threshold_; }
   int getClassesNum();
   int get_top_k(float *result, size_t count);
   void normal_sound(short *temp_buffer, int n);
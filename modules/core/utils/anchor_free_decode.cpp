@@ -0,0 +1,244 @@
+#include "anchor_free_decode.hpp"
+
+#include <math.h>
+#include <algorithm>
+#include "keypoint_decode.hpp"
+#include "yolo_decode.hpp"
+
+namespace cvitdl {
+
+namespace {
+
+typedef AnchorFreeDecoder::Level Level;
+typedef AnchorFreeDecoder::Context Context;
+
+// Anchors whose class maxima are kept on the stack at a time by the channel-major sweep.
+constexpr int kAnchorBlock = 256;
+
+inline float dequant(float v, float) { return v; }
+inline float dequant(int8_t v, float qscale) { return v * qscale; }
+
+// Smallest value in the tensor's domain whose dequantized logit reaches logit_thresh.
+inline float logit_gate(const float *, float logit_thresh, float) { return logit_thresh; }
+inline int logit_gate(const int8_t *, float logit_thresh, float qscale) {
+  if (!(qscale > 0)) {
+    return 128;
+  }
+  float q = ceilf(logit_thresh / qscale);
+  return (int)std::min(128.f, std::max(-128.f, q));
+}
+
+template <typename T, AnchorFreeLayout L>
+inline const T *channel_ptr(const T *p, const AnchorFreeBranch &b, int num_anchor, int anchor,
+                            int c, int *step) {
+  if (L == AnchorFreeLayout::CHW) {
+    *step = num_anchor;
+    return p + (size_t)(b.channel_offset + c) * num_anchor + anchor;
+  }
+  *step = 1;
+  return p + (size_t)anchor * b.channels + b.channel_offset + c;
+}
+
+// Expectation of the softmax over reg_max bins spaced step apart.
+inline float dfl_distance(const float *p, int step, int reg_max, const float *) {
+  float max_val = p[0];
+  for (int j = 1; j < reg_max; j++) {
+    max_val = std::max(max_val, p[j * step]);
+  }
+  float sum = 0, sum_j = 0;
+  for (int j = 0; j < reg_max; j++) {
+    float e = expf(p[j * step] - max_val);
+    sum += e;
+    sum_j += e * j;
+  }
+  return sum_j / sum;
+}
+
+inline float dfl_distance(const int8_t *p, int step, int reg_max, const float *exp_lut) {
+  int max_val = p[0];
+  for (int j = 1; j < reg_max; j++) {
+    max_val = std::max(max_val, (int)p[j * step]);
+  }
+  float sum = 0, sum_j = 0;
+  for (int j = 0; j < reg_max; j++) {
+    float e = exp_lut[max_val - p[j * step]];
+    sum += e;
+    sum_j += e * j;
+  }
+  return sum_j / sum;
+}
+
+template <typename TB, AnchorFreeBoxCoding C, AnchorFreeLayout L>
+inline void decode_box(const TB *pb, const AnchorFreeBranch &box, const Level &level,
+                       const Context &ctx, int anchor, float *out) {
+  const int num_anchor = level.grid_w * level.grid_h;
+  int step;
+  if (C == AnchorFreeBoxCoding::XYWH) {
+    const TB *p = channel_ptr<TB, L>(pb, box, num_anchor, anchor, 0, &step);
+    float x = dequant(p[0], box.qscale), y = dequant(p[step], box.qscale);
+    float w = dequant(p[2 * step], box.qscale), h = dequant(p[3 * step], box.qscale);
+    out[0] = x - 0.5f * w;
+    out[1] = y - 0.5f * h;
+    out[2] = x + 0.5f * w;
+    out[3] = y + 0.5f * h;
+    return;
+  }
+
+  float d[4];
+  if (C == AnchorFreeBoxCoding::DFL) {
+    for (int k = 0; k < 4; k++) {
+      const TB *p = channel_ptr<TB, L>(pb, box, num_anchor, anchor, k * ctx.reg_max, &step);
+      d[k] = dfl_distance(p, step, ctx.reg_max, ctx.exp_lut);
+    }
+  } else {
+    const TB *p = channel_ptr<TB, L>(pb, box, num_anchor, anchor, 0, &step);
+    for (int k = 0; k < 4; k++) {
+      d[k] = dequant(p[k * step], box.qscale);
+    }
+  }
+  const float gx = anchor % level.grid_w + 0.5f;
+  const float gy = anchor / level.grid_w + 0.5f;
+  out[0] = (gx - d[0]) * level.stride;
+  out[1] = (gy - d[1]) * level.stride;
+  out[2] = (gx + d[2]) * level.stride;
+  out[3] = (gy + d[3]) * level.stride;
+}
+
+template <typename TC, typename TB, AnchorFreeBoxCoding C, AnchorFreeLayout L>
+void decode_impl(const Level &level, const Context &ctx, const AnchorFreeBranch &cls,
+                 const AnchorFreeBranch &box, float logit_thresh, Detections *dets,
+                 std::vector<int> *anchor_ids) {
+  const TC *pc = static_cast<const TC *>(cls.data);
+  const TB *pb = static_cast<const TB *>(box.data);
+  const int num_anchor = level.grid_w * level.grid_h;
+  const auto gate = logit_gate(pc, logit_thresh, cls.qscale);
+
+  auto emit = [&](int anchor, int label, TC best) {
+    float b[4];
+    decode_box<TB, C, L>(pb, box, level, ctx, anchor, b);
+    PtrDectRect det = std::make_shared<object_detect_rect_t>();
+    det->x1 = b[0];
+    det->y1 = b[1];
+    det->x2 = b[2];
+    det->y2 = b[3];
+    det->score = 1.f / (1.f + expf(-dequant(best, cls.qscale)));
+    det->label = label;
+    clip_bbox(ctx.input_w, ctx.input_h, det);
+    if (det->x2 - det->x1 > 1 && det->y2 - det->y1 > 1) {
+      dets->push_back(det);
+      if (anchor_ids != nullptr) {
+        anchor_ids->push_back(anchor);
+      }
+    }
+  };
+
+  if (L == AnchorFreeLayout::CHW) {
+    // Sweep class planes over a block of anchors so every read is contiguous.
+    const TC *planes = pc + (size_t)cls.channel_offset * num_anchor;
+    TC best_val[kAnchorBlock];
+    int best_cls[kAnchorBlock];
+    for (int a0 = 0; a0 < num_anchor; a0 += kAnchorBlock) {
+      const int len = std::min(kAnchorBlock, num_anchor - a0);
+      std::copy(planes + a0, planes + a0 + len, best_val);
+      std::fill(best_cls, best_cls + len, 0);
+      for (int c = 1; c < ctx.num_cls; c++) {
+        const TC *row = planes + (size_t)c * num_anchor + a0;
+        for (int i = 0; i < len; i++) {
+          if (row[i] > best_val[i]) {
+            best_val[i] = row[i];
+            best_cls[i] = c;
+          }
+        }
+      }
+      for (int i = 0; i < len; i++) {
+        if (best_val[i] >= gate) {
+          emit(a0 + i, best_cls[i], best_val[i]);
+        }
+      }
+    }
+  } else {
+    for (int a = 0; a < num_anchor; a++) {
+      TC best;
+      int label = argmax(pc + (size_t)a * cls.channels + cls.channel_offset, ctx.num_cls, &best);
+      if (best >= gate) {
+        emit(a, label, best);
+      }
+    }
+  }
+}
+
+template <typename TC, typename TB, AnchorFreeBoxCoding C>
+AnchorFreeDecoder::DecodeFn select_layout(AnchorFreeLayout layout) {
+  if (layout == AnchorFreeLayout::CHW) {
+    return decode_impl<TC, TB, C, AnchorFreeLayout::CHW>;
+  }
+  return decode_impl<TC, TB, C, AnchorFreeLayout::HWC>;
+}
+
+template <typename TC, typename TB>
+AnchorFreeDecoder::DecodeFn select_fn(AnchorFreeBoxCoding coding, AnchorFreeLayout layout) {
+  switch (coding) {
+    case AnchorFreeBoxCoding::DFL:
+      return select_layout<TC, TB, AnchorFreeBoxCoding::DFL>(layout);
+    case AnchorFreeBoxCoding::LTRB:
+      return select_layout<TC, TB, AnchorFreeBoxCoding::LTRB>(layout);
+    case AnchorFreeBoxCoding::XYWH:
+      return select_layout<TC, TB, AnchorFreeBoxCoding::XYWH>(layout);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+void AnchorFreeDecoder::setup(AnchorFreeBoxCoding coding, AnchorFreeLayout layout, bool cls_int8,
+                              bool box_int8, int num_cls, int reg_max, int input_w, int input_h) {
+  if (cls_int8) {
+    m_fn = box_int8 ? select_fn<int8_t, int8_t>(coding, layout)
+                    : select_fn<int8_t, float>(coding, layout);
+  } else {
+    m_fn = box_int8 ? select_fn<float, int8_t>(coding, layout)
+                    : select_fn<float, float>(coding, layout);
+  }
+  m_box_int8 = box_int8 && coding == AnchorFreeBoxCoding::DFL;
+  m_ctx = {num_cls, reg_max, input_w, input_h, nullptr};
+  m_levels.clear();
+  m_lut_qscale = 0;
+  m_exp_lut.clear();
+}
+
+void AnchorFreeDecoder::addLevel(int stride, int grid_w, int grid_h) {
+  m_levels.push_back({stride, grid_w, grid_h, {nullptr, 0, 0, 0}, {nullptr, 0, 0, 0}});
+}
+
+void AnchorFreeDecoder::addLevel(int stride, int grid_w, int grid_h, const AnchorFreeBranch &cls,
+                                 const AnchorFreeBranch &box) {
+  m_levels.push_back({stride, grid_w, grid_h, cls, box});
+}
+
+void AnchorFreeDecoder::decode(size_t level, const AnchorFreeBranch &cls,
+                               const AnchorFreeBranch &box, float threshold, Detections *dets,
+                               std::vector<int> *anchor_ids) {
+  if (m_fn == nullptr || level >= m_levels.size() || m_ctx.num_cls <= 0) {
+    return;
+  }
+  if (m_box_int8 && (m_exp_lut.empty() || box.qscale != m_lut_qscale)) {
+    // Softmax is shift invariant, so int8 bins only need exp of their distance to the maximum.
+    m_exp_lut.resize(256);
+    for (int d = 0; d < 256; d++) {
+      m_exp_lut[d] = expf(-d * box.qscale);
+    }
+    m_lut_qscale = box.qscale;
+    m_ctx.exp_lut = m_exp_lut.data();
+  }
+  m_fn(m_levels[level], m_ctx, cls, box, sigmoid_inverse(threshold), dets, anchor_ids);
+}
+
+void AnchorFreeDecoder::decode(size_t level, float threshold, Detections *dets,
+                               std::vector<int> *anchor_ids) {
+  if (level >= m_levels.size() || m_levels[level].cls.data == nullptr) {
+    return;
+  }
+  decode(level, m_levels[level].cls, m_levels[level].box, threshold, dets, anchor_ids);
+}
+
+}  // namespace cvitdl
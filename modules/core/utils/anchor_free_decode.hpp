@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "object_utils.hpp"
+
+namespace cvitdl {
+
+enum class AnchorFreeBoxCoding {
+  DFL,   // 4 x reg_max distance bins per anchor, softmax expectation in grid units
+  LTRB,  // 4 distances to the cell center in grid units
+  XYWH,  // center and size already decoded to input pixels
+};
+
+enum class AnchorFreeLayout {
+  CHW,  // value (c, anchor) at c * num_anchor + anchor
+  HWC,  // value (c, anchor) at anchor * channels + c
+};
+
+// One output tensor of an anchor-free head. A tensor holding box and class channels together is
+// read twice with different channel offsets.
+struct AnchorFreeBranch {
+  const void *data;
+  float qscale;
+  int channels;        // channels of the whole tensor
+  int channel_offset;  // first channel of this branch
+};
+
+/**
+ * @brief Decoder shared by anchor-free heads with a class branch and a box branch per stride.
+ *
+ * setup() picks the decode loop instantiated for the heads' dtypes, box coding and layout, so
+ * decode() runs without per-anchor dispatch. Anchors are rejected on their best class logit in
+ * the tensor's own domain, and boxes are only decoded for the anchors that pass.
+ */
+class AnchorFreeDecoder {
+ public:
+  void setup(AnchorFreeBoxCoding coding, AnchorFreeLayout layout, bool cls_int8, bool box_int8,
+             int num_cls, int reg_max, int input_w, int input_h);
+  // Levels are decoded by index in the order they are added. stride is unused by XYWH.
+  void addLevel(int stride, int grid_w, int grid_h);
+  // Add a level bound to its output tensors, which stay in place across frames.
+  void addLevel(int stride, int grid_w, int grid_h, const AnchorFreeBranch &cls,
+                const AnchorFreeBranch &box);
+  size_t numLevels() const { return m_levels.size(); }
+
+  // Appends the detections of level with a sigmoid class score of at least threshold, clipped to
+  // the input and dropped when not larger than one pixel. anchor_ids, if not null, receives the
+  // anchor index of every appended detection.
+  void decode(size_t level, const AnchorFreeBranch &cls, const AnchorFreeBranch &box,
+              float threshold, Detections *dets, std::vector<int> *anchor_ids);
+  // Decode a level with the branches bound by addLevel.
+  void decode(size_t level, float threshold, Detections *dets, std::vector<int> *anchor_ids);
+
+  struct Level {
+    int stride;
+    int grid_w;
+    int grid_h;
+    AnchorFreeBranch cls;
+    AnchorFreeBranch box;
+  };
+  struct Context {
+    int num_cls;
+    int reg_max;
+    int input_w;
+    int input_h;
+    const float *exp_lut;  // exp(-d * qscale) of the int8 box branch at index d
+  };
+  typedef void (*DecodeFn)(const Level &level, const Context &ctx, const AnchorFreeBranch &cls,
+                           const AnchorFreeBranch &box, float threshold, Detections *dets,
+                           std::vector<int> *anchor_ids);
+
+ private:
+  DecodeFn m_fn = nullptr;
+  bool m_box_int8 = false;
+  Context m_ctx = {0, 0, 0, 0, nullptr};
+  std::vector<Level> m_levels;
+  float m_lut_qscale = 0;
+  std::vector<float> m_exp_lut;
+};
+
+}  // namespace cvitdl
@@ -4,6 +4,11 @@
 #include <iostream>
 #include <numeric>
 #include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+#define CLIP_LOGIT_SCALE 100.f
+#define CLIP_IMAGE_BLOCK 32
 
 namespace cvitdl {
 void normalize_matrix(Eigen::MatrixXf& matrix) {
@@ -25,4 +30,70 @@ int clip_postprocess(Eigen::MatrixXf& text_features, Eigen::MatrixXf& image_feat
 
   return 0;
 }
-}  // namespace cvitdl
\ No newline at end of file
+
+int ClipScorer::setTextFeatures(const float* const* features, int num, int dim) {
+  if (features == nullptr || num <= 0 || dim <= 0) {
+    LOGE("invalid text features, num: %d, dim: %d\n", num, dim);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  m_text.resize(num, dim);
+  for (int i = 0; i < num; ++i) {
+    m_text.row(i) = Eigen::Map<const Eigen::RowVectorXf>(features[i], dim);
+    float norm = m_text.row(i).norm();
+    if (norm != 0.0f) {
+      m_text.row(i) /= norm;
+    }
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int ClipScorer::topk(const float* const* image_features, int num_images, int k, int* labels,
+                     float* scores) {
+  const int num_texts = m_text.rows();
+  const int dim = m_text.cols();
+  if (num_texts == 0) {
+    LOGE("text features are not set\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  if (image_features == nullptr || num_images < 0 || k <= 0) {
+    LOGE("invalid arguments, num_images: %d, k: %d\n", num_images, k);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  const int valid_k = std::min(k, num_texts);
+  m_order.resize(num_texts);
+
+  for (int begin = 0; begin < num_images; begin += CLIP_IMAGE_BLOCK) {
+    const int block = std::min(CLIP_IMAGE_BLOCK, num_images - begin);
+    m_images.resize(block, dim);
+    for (int i = 0; i < block; ++i) {
+      m_images.row(i) = Eigen::Map<const Eigen::RowVectorXf>(image_features[begin + i], dim);
+      float norm = m_images.row(i).norm();
+      if (norm != 0.0f) {
+        m_images.row(i) *= CLIP_LOGIT_SCALE / norm;
+      }
+    }
+    m_logits.noalias() = m_images * m_text.transpose();
+
+    for (int i = 0; i < block; ++i) {
+      const float* row = m_logits.row(i).data();
+      std::iota(m_order.begin(), m_order.end(), 0);
+      auto by_logit = [row](int a, int b) { return row[a] > row[b]; };
+      std::partial_sort(m_order.begin(), m_order.begin() + valid_k, m_order.end(), by_logit);
+
+      const float max_logit = row[m_order[0]];
+      const float denom = (m_logits.row(i).array() - max_logit).exp().sum();
+      int* out_labels = labels + static_cast<size_t>(begin + i) * k;
+      float* out_scores = scores + static_cast<size_t>(begin + i) * k;
+      for (int j = 0; j < valid_k; ++j) {
+        out_labels[j] = m_order[j];
+        out_scores[j] = std::exp(row[m_order[j]] - max_logit) / denom;
+      }
+      for (int j = valid_k; j < k; ++j) {
+        out_labels[j] = -1;
+        out_scores[j] = 0;
+      }
+    }
+  }
+  return CVI_TDL_SUCCESS;
+}
+}  // namespace cvitdl
@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "Eigen/Core"
 #include "unsupported/Eigen/FFT"
 
@@ -7,4 +8,31 @@ void normalize_matrix(Eigen::MatrixXf& matrix);
 Eigen::MatrixXf softmax(const Eigen::MatrixXf& input);
 int clip_postprocess(Eigen::MatrixXf& text_features, Eigen::MatrixXf& image_features,
                      Eigen::MatrixXf& prods);
-}  // namespace cvitdl
\ No newline at end of file
+
+/**
+ * @brief Scores image embeddings against a resident set of text embeddings.
+ *
+ * Text embeddings are L2-normalized once in setTextFeatures() and kept. topk() normalizes image
+ * embeddings in blocks, computes the scaled cosine logits with an Eigen GEMM and returns the k
+ * best labels per image with their softmax probabilities. The full probability matrix is never
+ * stored: each row only needs its max and its sum of exponentials.
+ */
+class ClipScorer {
+ public:
+  int setTextFeatures(const float* const* features, int num, int dim);
+  int numTexts() const { return m_text.rows(); }
+  int dim() const { return m_text.cols(); }
+
+  // labels and scores hold num_images * k entries, row-major. If k exceeds the number of texts
+  // the remaining entries are set to -1 and 0.
+  int topk(const float* const* image_features, int num_images, int k, int* labels,
+           float* scores);
+
+ private:
+  typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+  RowMatrix m_text;
+  RowMatrix m_images;
+  RowMatrix m_logits;
+  std::vector<int> m_order;
+};
+}  // namespace cvitdl
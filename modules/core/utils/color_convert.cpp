@@ -0,0 +1,187 @@
+#include "color_convert.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// ITU-R BT.601 video range in Q20, identical to the OpenCV YUV420 -> RGB conversion.
+#define YUV_SHIFT 20
+#define YUV_CY 1220542
+#define YUV_CUB 2116026
+#define YUV_CUG (-409993)
+#define YUV_CVG (-852492)
+#define YUV_CVR 1673527
+
+namespace cvitdl {
+
+namespace {
+
+inline uint8_t clamp_u8(int v) { return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+inline void yuv_pixel(uint8_t y, int ruv, int guv, int buv, uint8_t *dst) {
+  int yy = std::max(0, int(y) - 16) * YUV_CY;
+  dst[0] = clamp_u8((yy + ruv) >> YUV_SHIFT);
+  dst[1] = clamp_u8((yy + guv) >> YUV_SHIFT);
+  dst[2] = clamp_u8((yy + buv) >> YUV_SHIFT);
+}
+
+inline void uv_terms(uint8_t u, uint8_t v, int *ruv, int *guv, int *buv) {
+  int uu = int(u) - 128, vv = int(v) - 128;
+  const int half = 1 << (YUV_SHIFT - 1);
+  *ruv = half + YUV_CVR * vv;
+  *guv = half + YUV_CVG * vv + YUV_CUG * uu;
+  *buv = half + YUV_CUB * uu;
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+// (y' + c) >> 20 for 16 pixels sharing 8 chroma terms, saturated to u8.
+inline uint8x16_t yuv_channel16(const int32x4_t y[4], int32x4_t c_lo, int32x4_t c_hi) {
+  int32x4x2_t c0 = vzipq_s32(c_lo, c_lo);
+  int32x4x2_t c1 = vzipq_s32(c_hi, c_hi);
+  int16x4_t r0 = vqmovn_s32(vshrq_n_s32(vaddq_s32(y[0], c0.val[0]), YUV_SHIFT));
+  int16x4_t r1 = vqmovn_s32(vshrq_n_s32(vaddq_s32(y[1], c0.val[1]), YUV_SHIFT));
+  int16x4_t r2 = vqmovn_s32(vshrq_n_s32(vaddq_s32(y[2], c1.val[0]), YUV_SHIFT));
+  int16x4_t r3 = vqmovn_s32(vshrq_n_s32(vaddq_s32(y[3], c1.val[1]), YUV_SHIFT));
+  return vcombine_u8(vqmovun_s16(vcombine_s16(r0, r1)), vqmovun_s16(vcombine_s16(r2, r3)));
+}
+
+// 16 pixels starting on a chroma pair boundary.
+inline void yuv420_to_rgb16(const uint8_t *y, uint8x8_t u8, uint8x8_t v8, uint8_t *dst) {
+  uint8x16_t y16 = vqsubq_u8(vld1q_u8(y), vdupq_n_u8(16));
+  uint16x8_t y_lo = vmovl_u8(vget_low_u8(y16));
+  uint16x8_t y_hi = vmovl_u8(vget_high_u8(y16));
+  const int32x4_t cy = vdupq_n_s32(YUV_CY);
+  int32x4_t ys[4] = {
+      vmulq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(y_lo))), cy),
+      vmulq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(y_lo))), cy),
+      vmulq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(y_hi))), cy),
+      vmulq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(y_hi))), cy)};
+
+  int16x8_t uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), vdupq_n_s16(128));
+  int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), vdupq_n_s16(128));
+  const int32x4_t half = vdupq_n_s32(1 << (YUV_SHIFT - 1));
+  int32x4_t u_lo = vmovl_s16(vget_low_s16(uu)), u_hi = vmovl_s16(vget_high_s16(uu));
+  int32x4_t v_lo = vmovl_s16(vget_low_s16(vv)), v_hi = vmovl_s16(vget_high_s16(vv));
+
+  uint8x16x3_t rgb;
+  rgb.val[0] =
+      yuv_channel16(ys, vmlaq_n_s32(half, v_lo, YUV_CVR), vmlaq_n_s32(half, v_hi, YUV_CVR));
+  rgb.val[1] = yuv_channel16(ys, vmlaq_n_s32(vmlaq_n_s32(half, v_lo, YUV_CVG), u_lo, YUV_CUG),
+                             vmlaq_n_s32(vmlaq_n_s32(half, v_hi, YUV_CVG), u_hi, YUV_CUG));
+  rgb.val[2] =
+      yuv_channel16(ys, vmlaq_n_s32(half, u_lo, YUV_CUB), vmlaq_n_s32(half, u_hi, YUV_CUB));
+  vst3q_u8(dst, rgb);
+}
+#endif
+
+}  // namespace
+
+void planar_to_packed_row(const uint8_t *r, const uint8_t *g, const uint8_t *b, int width,
+                          uint8_t *dst) {
+  int x = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x3_t rgb;
+    rgb.val[0] = vld1q_u8(r + x);
+    rgb.val[1] = vld1q_u8(g + x);
+    rgb.val[2] = vld1q_u8(b + x);
+    vst3q_u8(dst + 3 * x, rgb);
+  }
+#endif
+  for (; x < width; x++) {
+    dst[3 * x] = r[x];
+    dst[3 * x + 1] = g[x];
+    dst[3 * x + 2] = b[x];
+  }
+}
+
+void yuv420_to_rgb_row(const uint8_t *y, const uint8_t *u, const uint8_t *v, int uv_step,
+                       bool odd_start, int width, uint8_t *dst) {
+  int ruv, guv, buv;
+  if (odd_start && width > 0) {
+    uv_terms(*u, *v, &ruv, &guv, &buv);
+    yuv_pixel(*y, ruv, guv, buv, dst);
+    y++;
+    u += uv_step;
+    v += uv_step;
+    dst += 3;
+    width--;
+  }
+  int x = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; x + 16 <= width; x += 16) {
+    uint8x8_t u8, v8;
+    if (uv_step == 2) {
+      // u and v point into one interleaved plane
+      if (u < v) {
+        uint8x8x2_t uv = vld2_u8(u + x);
+        u8 = uv.val[0];
+        v8 = uv.val[1];
+      } else {
+        uint8x8x2_t vu = vld2_u8(v + x);
+        v8 = vu.val[0];
+        u8 = vu.val[1];
+      }
+    } else {
+      u8 = vld1_u8(u + x / 2);
+      v8 = vld1_u8(v + x / 2);
+    }
+    yuv420_to_rgb16(y + x, u8, v8, dst + 3 * x);
+  }
+#endif
+  for (; x < width; x += 2) {
+    int c = (x / 2) * uv_step;
+    uv_terms(u[c], v[c], &ruv, &guv, &buv);
+    yuv_pixel(y[x], ruv, guv, buv, dst + 3 * x);
+    if (x + 1 < width) {
+      yuv_pixel(y[x + 1], ruv, guv, buv, dst + 3 * x + 3);
+    }
+  }
+}
+
+int crop_to_rgb888(const VIDEO_FRAME_INFO_S *frame, int x, int y, int width, int height,
+                   uint8_t *dst, uint32_t dst_stride) {
+  const VIDEO_FRAME_S &vf = frame->stVFrame;
+  int x0 = std::max(x, 0), y0 = std::max(y, 0);
+  int x1 = std::min(x + width, (int)vf.u32Width), y1 = std::min(y + height, (int)vf.u32Height);
+  if (x1 <= x0 || y1 <= y0) {
+    return CVI_TDL_SUCCESS;
+  }
+  const int valid_w = x1 - x0;
+  uint8_t *p_dst = dst + (y0 - y) * dst_stride + (x0 - x) * 3;
+  for (int row = y0; row < y1; row++, p_dst += dst_stride) {
+    switch (vf.enPixelFormat) {
+      case PIXEL_FORMAT_RGB_888: {
+        memcpy(p_dst, vf.pu8VirAddr[0] + row * vf.u32Stride[0] + x0 * 3, valid_w * 3);
+      } break;
+      case PIXEL_FORMAT_RGB_888_PLANAR: {
+        planar_to_packed_row(vf.pu8VirAddr[0] + row * vf.u32Stride[0] + x0,
+                             vf.pu8VirAddr[1] + row * vf.u32Stride[1] + x0,
+                             vf.pu8VirAddr[2] + row * vf.u32Stride[2] + x0, valid_w, p_dst);
+      } break;
+      case PIXEL_FORMAT_NV21: {
+        const uint8_t *p_vu = vf.pu8VirAddr[1] + (row >> 1) * vf.u32Stride[1] + (x0 >> 1) * 2;
+        yuv420_to_rgb_row(vf.pu8VirAddr[0] + row * vf.u32Stride[0] + x0, p_vu + 1, p_vu, 2,
+                          x0 & 1, valid_w, p_dst);
+      } break;
+      case PIXEL_FORMAT_YUV_PLANAR_420: {
+        int c_offset = (x0 >> 1);
+        yuv420_to_rgb_row(vf.pu8VirAddr[0] + row * vf.u32Stride[0] + x0,
+                          vf.pu8VirAddr[1] + (row >> 1) * vf.u32Stride[1] + c_offset,
+                          vf.pu8VirAddr[2] + (row >> 1) * vf.u32Stride[2] + c_offset, 1, x0 & 1,
+                          valid_w, p_dst);
+      } break;
+      default:
+        LOGE("Pixel format [%d] is not supported.\n", vf.enPixelFormat);
+        return CVI_TDL_ERR_INVALID_ARGS;
+    }
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include "cvi_comm.h"
+
+namespace cvitdl {
+
+// Interleave width pixels of three planes into packed RGB.
+void planar_to_packed_row(const uint8_t *r, const uint8_t *g, const uint8_t *b, int width,
+                          uint8_t *dst);
+
+// Convert width pixels of a 4:2:0 row to packed RGB with the BT.601 video-range coefficients used
+// by cv::cvtColor. u and v point at the chroma sample of the first pixel and advance by uv_step
+// per two pixels (1 for I420, 2 for NV21). odd_start means the first pixel is the right one of a
+// chroma pair.
+void yuv420_to_rgb_row(const uint8_t *y, const uint8_t *u, const uint8_t *v, int uv_step,
+                       bool odd_start, int width, uint8_t *dst);
+
+// Crop the width x height box at (x, y) of frame straight into packed RGB888. Pixels of the box
+// outside the frame are left untouched. Supports RGB888, RGB888 planar, NV21 and I420 frames, which
+// must be mapped.
+int crop_to_rgb888(const VIDEO_FRAME_INFO_S *frame, int x, int y, int width, int height,
+                   uint8_t *dst, uint32_t dst_stride);
+
+}  // namespace cvitdl
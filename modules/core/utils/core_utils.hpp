@@ -9,6 +9,10 @@
 #include <vector>
 #include "cvi_comm.h"
 
+// Row stride of cvtdl_image_t planes allocated by the SDK. Rows are padded, so image data can't be
+// copied from a cv::Mat in one block.
+#define GET_TDL_IMAGE_STRIDE(x) (ALIGN((x), DEFAULT_ALIGN))
+
 namespace cvitdl {
 
 void SoftMaxForBuffer(const float *src, float *dst, size_t size);
@@ -0,0 +1,393 @@
+#include "crop_batch.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "color_convert.hpp"
+#include "core/core/cvtdl_errno.h"
+#include "core_utils.hpp"
+#include "cvi_tdl_log.hpp"
+#include "frame_map_cache.hpp"
+
+// Frame rows handled together before moving to the next band.
+#define CROP_BAND_ROWS 16
+#define CROP_MAX_WORKERS 8
+
+namespace cvitdl {
+
+namespace {
+
+struct CropJob {
+  int x, y, w, h;
+  cvtdl_image_t *image;
+};
+
+// Threads kept across calls, so splitting a frame costs a wake-up rather than thread creation.
+// One call uses the pool at a time, concurrent calls run on their own thread instead of waiting.
+class BandWorkers {
+ public:
+  // Never destroyed, the workers stay blocked until the process exits.
+  static BandWorkers &instance() {
+    static BandWorkers *workers = new BandWorkers();
+    return *workers;
+  }
+
+  // Run task(0) .. task(num_tasks - 1) on the calling thread and num_tasks - 1 workers.
+  void run(int num_tasks, const std::function<void(int)> &task) {
+    std::unique_lock<std::mutex> run_lock(m_run_mutex, std::try_to_lock);
+    if (!run_lock.owns_lock()) {
+      for (int t = 0; t < num_tasks; t++) {
+        task(t);
+      }
+      return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while ((int)m_threads.size() < num_tasks - 1) {
+      m_threads.emplace_back(&BandWorkers::workerLoop, this);
+    }
+    m_task = &task;
+    m_num_tasks = num_tasks;
+    m_next_task = 0;
+    m_pending = num_tasks;
+    m_start.notify_all();
+    while (m_next_task < m_num_tasks) {
+      runNext(lock);
+    }
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_task = nullptr;
+  }
+
+ private:
+  BandWorkers() = default;
+
+  // Called and returns with the lock held.
+  void runNext(std::unique_lock<std::mutex> &lock) {
+    int t = m_next_task++;
+    const std::function<void(int)> *task = m_task;
+    lock.unlock();
+    (*task)(t);
+    lock.lock();
+    if (--m_pending == 0) {
+      m_done.notify_one();
+    }
+  }
+
+  void workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_start.wait(lock, [this] { return m_task != nullptr && m_next_task < m_num_tasks; });
+      runNext(lock);
+    }
+  }
+
+  std::mutex m_run_mutex;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  std::vector<std::thread> m_threads;
+  const std::function<void(int)> *m_task = nullptr;
+  int m_num_tasks = 0;
+  int m_next_task = 0;
+  int m_pending = 0;
+};
+
+bool is_supported_format(PIXEL_FORMAT_E fmt) {
+  return fmt == PIXEL_FORMAT_RGB_888 || fmt == PIXEL_FORMAT_RGB_888_PLANAR ||
+         fmt == PIXEL_FORMAT_NV21 || fmt == PIXEL_FORMAT_YUV_PLANAR_420;
+}
+
+// Same box adjustment as crop_image and crop_image_exten: even width and height, optionally
+// extended to a square.
+void box_region(const cvtdl_bbox_t &bbox, int frame_w, int frame_h, float exten_ratio,
+                CropJob *job) {
+  int x1 = (int)floorf(bbox.x1), y1 = (int)floorf(bbox.y1);
+  int x2 = (int)floorf(bbox.x2), y2 = (int)floorf(bbox.y2);
+  if (x2 < x1 || y2 < y1) {
+    job->x = x1;
+    job->y = y1;
+    job->w = job->h = 0;
+    return;
+  }
+  int width = x2 - x1 + 1, height = y2 - y1 + 1;
+  if (height % 2 != 0) {
+    y1 -= (y2 + 1 >= frame_h) ? 1 : 0;
+    height++;
+  }
+  if (width % 2 != 0) {
+    x1 -= (x2 + 1 >= frame_w) ? 1 : 0;
+    width++;
+  }
+  if (exten_ratio <= 0) {
+    job->x = x1;
+    job->y = y1;
+    job->w = width;
+    job->h = height;
+    return;
+  }
+  int edge = std::max(width, height);
+  int edge_exten = (int)(edge * exten_ratio);
+  job->x = x1 - (edge - width) / 2 - edge_exten;
+  job->y = y1 - (edge - height) / 2 - edge_exten;
+  job->w = job->h = edge + 2 * edge_exten;
+}
+
+// Copy samples [x, x + w) of a row with limit samples into dst, skipping the ones outside the row.
+inline void copy_span(const uint8_t *src, int limit, int x, int w, int bits, uint8_t *dst) {
+  int x0 = std::max(x, 0), x1 = std::min(x + w, limit);
+  if (x1 > x0) {
+    memcpy(dst + (x0 - x) * bits, src + x0 * bits, (x1 - x0) * bits);
+  }
+}
+
+// Copy frame rows [r0, r1), which lie inside both the frame and the job, into the job image.
+void copy_rows(const VIDEO_FRAME_INFO_S *frame, const CropJob &job, int r0, int r1,
+               bool cvtRGB888) {
+  const VIDEO_FRAME_S &vf = frame->stVFrame;
+  cvtdl_image_t *img = job.image;
+  const int fw = vf.u32Width, fh = vf.u32Height;
+  for (int r = r0; r < r1; r++) {
+    const int t = r - job.y;
+    uint8_t *p_dst = img->pix[0] + t * img->stride[0];
+    if (cvtRGB888) {
+      crop_to_rgb888(frame, job.x, r, job.w, 1, p_dst, img->stride[0]);
+      continue;
+    }
+    switch (vf.enPixelFormat) {
+      case PIXEL_FORMAT_RGB_888: {
+        copy_span(vf.pu8VirAddr[0] + r * vf.u32Stride[0], fw, job.x, job.w, 3, p_dst);
+      } break;
+      case PIXEL_FORMAT_RGB_888_PLANAR: {
+        for (int p = 0; p < 3; p++) {
+          copy_span(vf.pu8VirAddr[p] + r * vf.u32Stride[p], fw, job.x, job.w, 1,
+                    img->pix[p] + t * img->stride[p]);
+        }
+      } break;
+      case PIXEL_FORMAT_NV21:
+      case PIXEL_FORMAT_YUV_PLANAR_420: {
+        copy_span(vf.pu8VirAddr[0] + r * vf.u32Stride[0], fw, job.x, job.w, 1, p_dst);
+        // A chroma row goes with the even row of its pair, or with the first frame row when the
+        // even one lies above the frame.
+        if (t % 2 != 0 && r != 0) {
+          break;
+        }
+        const int ct = t / 2, cy = job.y / 2 + ct;
+        if (cy < 0 || cy >= fh / 2 || ct >= (int)img->height / 2) {
+          break;
+        }
+        if (vf.enPixelFormat == PIXEL_FORMAT_NV21) {
+          copy_span(vf.pu8VirAddr[1] + cy * vf.u32Stride[1], fw / 2, job.x / 2, job.w / 2, 2,
+                    img->pix[1] + ct * img->stride[1]);
+        } else {
+          for (int p = 1; p < 3; p++) {
+            copy_span(vf.pu8VirAddr[p] + cy * vf.u32Stride[p], fw / 2, job.x / 2, job.w / 2, 1,
+                      img->pix[p] + ct * img->stride[p]);
+          }
+        }
+      } break;
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+uint32_t image_layout(cvtdl_image_t *image, uint32_t height, uint32_t width, PIXEL_FORMAT_E fmt) {
+  image->pix_format = fmt;
+  image->height = height;
+  image->width = width;
+
+  /* NOTE: Refer to vpss_helper.h*/
+  switch (fmt) {
+    case PIXEL_FORMAT_RGB_888: {
+      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width * 3);
+      image->stride[1] = 0;
+      image->stride[2] = 0;
+      image->length[0] = image->stride[0] * image->height;
+      image->length[1] = 0;
+      image->length[2] = 0;
+    } break;
+    case PIXEL_FORMAT_RGB_888_PLANAR: {
+      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->stride[2] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->length[0] = image->stride[0] * image->height;
+      image->length[1] = image->stride[1] * image->height;
+      image->length[2] = image->stride[2] * image->height;
+    } break;
+    case PIXEL_FORMAT_NV21: {
+      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->stride[2] = 0;
+      image->length[0] = image->stride[0] * image->height;
+      image->length[1] = image->stride[0] * (image->height >> 1);
+      image->length[2] = 0;
+    } break;
+    case PIXEL_FORMAT_YUV_PLANAR_420: {
+      image->stride[0] = GET_TDL_IMAGE_STRIDE(image->width);
+      image->stride[1] = GET_TDL_IMAGE_STRIDE(image->width >> 1);
+      image->stride[2] = GET_TDL_IMAGE_STRIDE(image->width >> 1);
+      image->length[0] = image->stride[0] * image->height;
+      image->length[1] = image->stride[1] * (image->height >> 1);
+      image->length[2] = image->stride[2] * (image->height >> 1);
+    } break;
+    default:
+      LOGE("Currently unsupported format %u\n", fmt);
+      return 0;
+  }
+  return image->length[0] + image->length[1] + image->length[2];
+}
+
+void image_attach(cvtdl_image_t *image, uint8_t *data) {
+  image->pix[0] = data;
+  switch (image->pix_format) {
+    case PIXEL_FORMAT_RGB_888_PLANAR:
+    case PIXEL_FORMAT_YUV_PLANAR_420: {
+      image->pix[1] = image->pix[0] + image->length[0];
+      image->pix[2] = image->pix[1] + image->length[1];
+    } break;
+    case PIXEL_FORMAT_NV21: {
+      image->pix[1] = image->pix[0] + image->length[0];
+      image->pix[2] = NULL;
+    } break;
+    default: {
+      image->pix[1] = NULL;
+      image->pix[2] = NULL;
+    } break;
+  }
+}
+
+int crop_images(VIDEO_FRAME_INFO_S *frame, const cvtdl_bbox_t *bboxes, uint32_t num,
+                cvtdl_image_batch_t *dst, bool cvtRGB888, float exten_ratio, uint32_t num_threads) {
+  const VIDEO_FRAME_S &vf = frame->stVFrame;
+  if (!is_supported_format(vf.enPixelFormat)) {
+    LOGE("Pixel format [%d] is not supported.\n", vf.enPixelFormat);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  const PIXEL_FORMAT_E dst_fmt = cvtRGB888 ? PIXEL_FORMAT_RGB_888 : vf.enPixelFormat;
+  const int fw = vf.u32Width, fh = vf.u32Height;
+
+  if (dst->size != num) {
+    free(dst->images);
+    free(dst->crop_boxes);
+    dst->images = NULL;
+    dst->crop_boxes = NULL;
+    dst->size = 0;
+    if (num > 0) {
+      dst->images = (cvtdl_image_t *)calloc(num, sizeof(cvtdl_image_t));
+      dst->crop_boxes = (cvtdl_bbox_t *)calloc(num, sizeof(cvtdl_bbox_t));
+      if (dst->images == NULL || dst->crop_boxes == NULL) {
+        LOGE("alloc image batch failed, num: %u\n", num);
+        free(dst->images);
+        free(dst->crop_boxes);
+        dst->images = NULL;
+        dst->crop_boxes = NULL;
+        return CVI_TDL_FAILURE;
+      }
+    }
+    dst->size = num;
+  }
+  if (num == 0) {
+    return CVI_TDL_SUCCESS;
+  }
+
+  std::vector<CropJob> jobs(num);
+  std::vector<uint32_t> offsets(num);
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < num; i++) {
+    CropJob &job = jobs[i];
+    box_region(bboxes[i], fw, fh, exten_ratio, &job);
+    job.image = &dst->images[i];
+    memset(job.image, 0, sizeof(cvtdl_image_t));
+    offsets[i] = total;
+    total += image_layout(job.image, job.h, job.w, dst_fmt);
+    cvtdl_bbox_t &crop_box = dst->crop_boxes[i];
+    crop_box.x1 = job.x;
+    crop_box.y1 = job.y;
+    crop_box.x2 = job.x + job.w - 1;
+    crop_box.y2 = job.y + job.h - 1;
+    crop_box.score = bboxes[i].score;
+  }
+  if (total > dst->capacity) {
+    free(dst->buffer);
+    dst->buffer = (uint8_t *)malloc(total);
+    dst->capacity = dst->buffer == NULL ? 0 : total;
+    if (dst->buffer == NULL) {
+      LOGE("alloc image batch buffer failed, size: %u\n", total);
+      return CVI_TDL_FAILURE;
+    }
+  }
+
+  int row_begin = fh, row_end = 0;
+  for (uint32_t i = 0; i < num; i++) {
+    CropJob &job = jobs[i];
+    cvtdl_image_t *img = job.image;
+    image_attach(img, dst->buffer + offsets[i]);
+    if (job.w == 0 || job.h == 0) {
+      continue;
+    }
+    // only crops reaching outside the frame have pixels left unwritten
+    if (job.x < 0 || job.y < 0 || job.x + job.w > fw || job.y + job.h > fh) {
+      memset(img->pix[0], 0, img->length[0] + img->length[1] + img->length[2]);
+    }
+    row_begin = std::min(row_begin, std::max(job.y, 0));
+    row_end = std::max(row_end, std::min(job.y + job.h, fh));
+  }
+  if (row_end <= row_begin) {
+    return CVI_TDL_SUCCESS;
+  }
+
+  std::vector<uint32_t> order(num);
+  for (uint32_t i = 0; i < num; i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&jobs](uint32_t a, uint32_t b) { return jobs[a].y < jobs[b].y; });
+
+  bool do_unmap = FrameMapCache::instance().map(frame);
+  if (vf.pu8VirAddr[0] == NULL) {
+    return CVI_TDL_FAILURE;
+  }
+
+  // Bands are disjoint in frame rows and therefore in destination rows, so workers never write
+  // the same bytes.
+  auto run_bands = [&](int band_begin, int band_end) {
+    for (int b = band_begin; b < band_end; b++) {
+      const int rb0 = row_begin + b * CROP_BAND_ROWS;
+      const int rb1 = std::min(rb0 + CROP_BAND_ROWS, row_end);
+      for (uint32_t idx : order) {
+        const CropJob &job = jobs[idx];
+        if (job.y >= rb1) {
+          break;
+        }
+        int r0 = std::max(rb0, job.y), r1 = std::min(rb1, job.y + job.h);
+        if (r0 < r1 && job.w > 0) {
+          copy_rows(frame, job, r0, r1, cvtRGB888);
+        }
+      }
+    }
+  };
+  const int num_bands = (row_end - row_begin + CROP_BAND_ROWS - 1) / CROP_BAND_ROWS;
+  const int workers = std::max(1, std::min({(int)num_threads, num_bands, CROP_MAX_WORKERS}));
+  if (workers == 1) {
+    run_bands(0, num_bands);
+  } else {
+    const int per_worker = (num_bands + workers - 1) / workers;
+    BandWorkers::instance().run(workers, [&](int w) {
+      run_bands(w * per_worker, std::min((w + 1) * per_worker, num_bands));
+    });
+  }
+
+  if (do_unmap) {
+    FrameMapCache::instance().unmap(frame);
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+#include "core/core/cvtdl_core_types.h"
+#include "cvi_comm.h"
+
+namespace cvitdl {
+
+// Fill format, size, strides and plane lengths of image for a height x width fmt image. Return the
+// number of bytes its pixels need, or 0 if fmt is not supported. pix is left untouched.
+uint32_t image_layout(cvtdl_image_t *image, uint32_t height, uint32_t width, PIXEL_FORMAT_E fmt);
+
+// Point the planes of a laid out image at data.
+void image_attach(cvtdl_image_t *image, uint8_t *data);
+
+/**
+ * @brief Crop num boxes of frame into dst. All crops share one buffer which is reused by later
+ * calls while it is large enough.
+ *
+ * With exten_ratio > 0 every crop is the square extension used by crop_image_exten, otherwise the
+ * box is cropped as by crop_image. Frame rows are walked top to bottom in bands shared by all
+ * boxes, and bands are split across num_threads threads when num_threads > 1. The threads
+ * come from a pool kept across calls, at most 8 are used.
+ */
+int crop_images(VIDEO_FRAME_INFO_S *frame, const cvtdl_bbox_t *bboxes, uint32_t num,
+                cvtdl_image_batch_t *dst, bool cvtRGB888, float exten_ratio, uint32_t num_threads);
+
+}  // namespace cvitdl
@@ -0,0 +1,362 @@
+#include "ctc_decode.hpp"
+
+#include <math.h>
+#include <algorithm>
+#include "keypoint_decode.hpp"
+
+namespace cvitdl {
+
+namespace {
+
+inline float log_add(float a, float b) {
+  if (a < b) {
+    std::swap(a, b);
+  }
+  if (b == -INFINITY) {
+    return a;
+  }
+  return a + log1pf(expf(b - a));
+}
+
+// Log probabilities of one time step. Logits are normalized with a softmax. int8 logits look
+// their exponentials up in exp_lut, which holds exp((q - 127) * qscale) at index q + 128.
+class StepScorer {
+ public:
+  StepScorer(const CtcInput &input) : m_in(input) {
+    if (m_in.data_int8 != nullptr && !m_in.is_prob) {
+      m_exp_lut.resize(256);
+      for (int q = -128; q < 128; q++) {
+        m_exp_lut[q + 128] = expf((q - 127) * m_in.qscale);
+      }
+    }
+  }
+
+  template <typename T>
+  void logProbs(const T *p, float *logp) const;
+
+ private:
+  float value(const int8_t *p, int c) const { return p[c * m_in.class_stride] * m_in.qscale; }
+  float value(const float *p, int c) const { return p[c * m_in.class_stride]; }
+
+  const CtcInput &m_in;
+  std::vector<float> m_exp_lut;
+};
+
+template <>
+void StepScorer::logProbs<int8_t>(const int8_t *p, float *logp) const {
+  if (m_in.is_prob) {
+    for (int c = 0; c < m_in.classes; c++) {
+      logp[c] = logf(std::max(value(p, c), 1e-30f));
+    }
+    return;
+  }
+  float sum = 0;
+  for (int c = 0; c < m_in.classes; c++) {
+    sum += m_exp_lut[p[c * m_in.class_stride] + 128];
+  }
+  float log_sum = logf(sum);
+  for (int c = 0; c < m_in.classes; c++) {
+    logp[c] = (p[c * m_in.class_stride] - 127) * m_in.qscale - log_sum;
+  }
+}
+
+template <>
+void StepScorer::logProbs<float>(const float *p, float *logp) const {
+  if (m_in.is_prob) {
+    for (int c = 0; c < m_in.classes; c++) {
+      logp[c] = logf(std::max(value(p, c), 1e-30f));
+    }
+    return;
+  }
+  float max_val = value(p, 0);
+  for (int c = 1; c < m_in.classes; c++) {
+    max_val = std::max(max_val, value(p, c));
+  }
+  float sum = 0;
+  for (int c = 0; c < m_in.classes; c++) {
+    logp[c] = value(p, c) - max_val;
+    sum += expf(logp[c]);
+  }
+  float log_sum = logf(sum);
+  for (int c = 0; c < m_in.classes; c++) {
+    logp[c] -= log_sum;
+  }
+}
+
+// Best class of every step of a sequence starting at base.
+template <typename T>
+void best_classes(const CtcInput &in, const T *base, std::vector<int> *best) {
+  best->resize(in.steps);
+  if (in.class_stride == 1) {
+    T max_val;
+    for (int t = 0; t < in.steps; t++) {
+      (*best)[t] = argmax(base + t * in.step_stride, in.classes, &max_val);
+    }
+    return;
+  }
+  // Class-major: sweep class rows so every step keeps its running maximum while memory is read
+  // row by row.
+  std::vector<T> best_val(in.steps);
+  for (int t = 0; t < in.steps; t++) {
+    best_val[t] = base[t * in.step_stride];
+    (*best)[t] = 0;
+  }
+  for (int c = 1; c < in.classes; c++) {
+    const T *row = base + c * in.class_stride;
+    for (int t = 0; t < in.steps; t++) {
+      T v = row[t * in.step_stride];
+      if (v > best_val[t]) {
+        best_val[t] = v;
+        (*best)[t] = c;
+      }
+    }
+  }
+}
+
+template <typename T>
+void greedy_impl(const CtcInput &in, const T *base, int blank, std::vector<int> *labels,
+                 float *score) {
+  std::vector<int> best;
+  best_classes(in, base, &best);
+
+  labels->clear();
+  std::vector<float> logp(score != nullptr ? in.classes : 0);
+  StepScorer scorer(in);
+  float prob_sum = 0;
+  int prev = -1;
+  for (int t = 0; t < in.steps; t++) {
+    int c = best[t];
+    if (c != prev && c != blank) {
+      labels->push_back(c);
+      if (score != nullptr) {
+        scorer.logProbs(base + t * in.step_stride, logp.data());
+        prob_sum += expf(logp[c]);
+      }
+    }
+    prev = c;
+  }
+  if (score != nullptr) {
+    *score = labels->empty() ? 0 : prob_sum / labels->size();
+  }
+}
+
+struct PrefixNode {
+  int parent;
+  int label;
+  uint32_t state;
+};
+
+struct Beam {
+  int node;
+  float pb;   // log probability of alignments ending in blank
+  float pnb;  // log probability of alignments ending in the last label
+  float total() const { return log_add(pb, pnb); }
+};
+
+template <typename T>
+bool beam_impl(const CtcInput &in, const T *base, int blank, int beam_width,
+               const CtcGrammar *grammar, std::vector<int> *labels, float *score) {
+  std::vector<PrefixNode> nodes = {{-1, -1, grammar != nullptr ? grammar->start() : 0}};
+  std::unordered_map<uint64_t, int> children;
+  auto child_of = [&](int node, int label) {
+    uint64_t key = (uint64_t)node << 32 | (uint32_t)label;
+    auto it = children.find(key);
+    if (it != children.end()) {
+      return it->second;
+    }
+    uint32_t state = 0;
+    if (grammar != nullptr && !grammar->next(nodes[node].state, label, &state)) {
+      children[key] = -1;
+      return -1;
+    }
+    nodes.push_back({node, label, state});
+    children[key] = nodes.size() - 1;
+    return (int)nodes.size() - 1;
+  };
+
+  StepScorer scorer(in);
+  std::vector<float> logp(in.classes);
+  std::vector<int> candidates(in.classes);
+  std::vector<Beam> beams = {{0, 0.f, -INFINITY}};
+  std::vector<Beam> next_beams;
+  std::unordered_map<int, int> next_index;
+  const int num_candidates = std::min(beam_width, in.classes);
+
+  for (int t = 0; t < in.steps; t++) {
+    scorer.logProbs(base + t * in.step_stride, logp.data());
+    for (int c = 0; c < in.classes; c++) {
+      candidates[c] = c;
+    }
+    std::partial_sort(candidates.begin(), candidates.begin() + num_candidates, candidates.end(),
+                      [&](int a, int b) { return logp[a] > logp[b]; });
+    const float prune = logp[candidates[0]] - 10.f;
+
+    next_beams.clear();
+    next_index.clear();
+    auto beam_of = [&](int node) -> Beam & {
+      auto it = next_index.find(node);
+      if (it != next_index.end()) {
+        return next_beams[it->second];
+      }
+      next_index[node] = next_beams.size();
+      next_beams.push_back({node, -INFINITY, -INFINITY});
+      return next_beams.back();
+    };
+
+    for (const Beam &b : beams) {
+      const int last = nodes[b.node].label;
+      Beam &same = beam_of(b.node);
+      same.pb = log_add(same.pb, b.total() + logp[blank]);
+      if (last >= 0) {
+        same.pnb = log_add(same.pnb, b.pnb + logp[last]);
+      }
+      for (int k = 0; k < num_candidates; k++) {
+        int c = candidates[k];
+        if (logp[c] < prune) {
+          break;
+        }
+        if (c == blank) {
+          continue;
+        }
+        int child = child_of(b.node, c);
+        if (child < 0) {
+          continue;
+        }
+        Beam &ext = beam_of(child);
+        // A repeated label needs a blank in between to extend the prefix.
+        float prev = c == last ? b.pb : b.total();
+        ext.pnb = log_add(ext.pnb, prev + logp[c]);
+      }
+    }
+
+    if ((int)next_beams.size() > beam_width) {
+      std::partial_sort(next_beams.begin(), next_beams.begin() + beam_width, next_beams.end(),
+                        [](const Beam &a, const Beam &b) { return a.total() > b.total(); });
+      next_beams.resize(beam_width);
+    }
+    beams.swap(next_beams);
+  }
+
+  const Beam *best = nullptr;
+  for (const Beam &b : beams) {
+    if (grammar != nullptr && !grammar->accept(nodes[b.node].state)) {
+      continue;
+    }
+    if (best == nullptr || b.total() > best->total()) {
+      best = &b;
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+  labels->clear();
+  for (int node = best->node; node > 0; node = nodes[node].parent) {
+    labels->push_back(nodes[node].label);
+  }
+  std::reverse(labels->begin(), labels->end());
+  if (score != nullptr) {
+    *score = expf(best->total());
+  }
+  return true;
+}
+
+}  // namespace
+
+void PatternGrammar::addPattern(const std::vector<std::vector<int>> &positions) {
+  if (m_lengths.size() >= 24 || positions.size() > 255) {
+    return;
+  }
+  std::vector<uint8_t> allowed(positions.size() * m_num_classes, 0);
+  for (size_t pos = 0; pos < positions.size(); pos++) {
+    for (int label : positions[pos]) {
+      if (label >= 0 && label < m_num_classes) {
+        allowed[pos * m_num_classes + label] = 1;
+      }
+    }
+  }
+  m_lengths.push_back(positions.size());
+  m_allowed.push_back(std::move(allowed));
+}
+
+// A state holds the prefix length in its low 8 bits and the patterns still matching above them.
+uint32_t PatternGrammar::start() const {
+  return (uint32_t)((1u << m_lengths.size()) - 1) << 8;
+}
+
+bool PatternGrammar::next(uint32_t state, int label, uint32_t *next_state) const {
+  if (label < 0 || label >= m_num_classes) {
+    return false;
+  }
+  uint32_t pos = state & 0xff;
+  uint32_t alive = 0;
+  for (size_t p = 0; p < m_lengths.size(); p++) {
+    if ((state >> (8 + p) & 1) && (int)pos < m_lengths[p] &&
+        m_allowed[p][pos * m_num_classes + label]) {
+      alive |= 1u << p;
+    }
+  }
+  *next_state = alive << 8 | (pos + 1);
+  return alive != 0;
+}
+
+bool PatternGrammar::accept(uint32_t state) const {
+  uint32_t pos = state & 0xff;
+  for (size_t p = 0; p < m_lengths.size(); p++) {
+    if ((state >> (8 + p) & 1) && m_lengths[p] == (int)pos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+LexiconGrammar::LexiconGrammar() { m_nodes.push_back({{}, false}); }
+
+void LexiconGrammar::addWord(const std::vector<int> &labels) {
+  uint32_t node = 0;
+  for (int label : labels) {
+    auto it = m_nodes[node].children.find(label);
+    if (it == m_nodes[node].children.end()) {
+      m_nodes.push_back({{}, false});
+      uint32_t child = m_nodes.size() - 1;
+      m_nodes[node].children[label] = child;
+      node = child;
+    } else {
+      node = it->second;
+    }
+  }
+  m_nodes[node].terminal = true;
+}
+
+bool LexiconGrammar::next(uint32_t state, int label, uint32_t *next_state) const {
+  auto it = m_nodes[state].children.find(label);
+  if (it == m_nodes[state].children.end()) {
+    return false;
+  }
+  *next_state = it->second;
+  return true;
+}
+
+void CtcDecoder::greedy(const CtcInput &input, int n, std::vector<int> *labels,
+                        float *score) const {
+  if (input.data_int8 != nullptr) {
+    greedy_impl(input, input.data_int8 + n * input.seq_stride, m_blank, labels, score);
+  } else {
+    greedy_impl(input, input.data_float + n * input.seq_stride, m_blank, labels, score);
+  }
+}
+
+bool CtcDecoder::beamSearch(const CtcInput &input, int n, int beam_width,
+                            const CtcGrammar *grammar, std::vector<int> *labels,
+                            float *score) const {
+  if (beam_width < 1) {
+    beam_width = 1;
+  }
+  if (input.data_int8 != nullptr) {
+    return beam_impl(input, input.data_int8 + n * input.seq_stride, m_blank, beam_width, grammar,
+                     labels, score);
+  }
+  return beam_impl(input, input.data_float + n * input.seq_stride, m_blank, beam_width, grammar,
+                   labels, score);
+}
+
+}  // namespace cvitdl
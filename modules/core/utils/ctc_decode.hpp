@@ -0,0 +1,92 @@
+#pragma once
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace cvitdl {
+
+/**
+ * @brief Scores of one or more CTC sequences, int8 with a dequantization scale or float.
+ *
+ * Score (n, t, c) of sequence n, time step t and class c is at
+ * n * seq_stride + t * step_stride + c * class_stride, so time-major and class-major outputs are
+ * both read in place.
+ */
+struct CtcInput {
+  const int8_t *data_int8;
+  const float *data_float;
+  float qscale;
+  bool is_prob;  // scores are softmax probabilities rather than logits
+  int steps;
+  int classes;
+  int step_stride;
+  int class_stride;
+  int seq_stride;
+};
+
+// Restricts the label sequences a beam search may produce. States are opaque to the decoder.
+class CtcGrammar {
+ public:
+  virtual ~CtcGrammar() {}
+  virtual uint32_t start() const = 0;
+  // State after appending label to a prefix in state, false if label may not follow.
+  virtual bool next(uint32_t state, int label, uint32_t *next_state) const = 0;
+  // Whether a prefix in state is a complete sequence.
+  virtual bool accept(uint32_t state) const = 0;
+};
+
+// Fixed length formats, each a list of allowed labels per position. At most 24 patterns.
+class PatternGrammar : public CtcGrammar {
+ public:
+  explicit PatternGrammar(int num_classes) : m_num_classes(num_classes) {}
+  void addPattern(const std::vector<std::vector<int>> &positions);
+
+  uint32_t start() const override;
+  bool next(uint32_t state, int label, uint32_t *next_state) const override;
+  bool accept(uint32_t state) const override;
+
+ private:
+  int m_num_classes;
+  std::vector<int> m_lengths;
+  std::vector<std::vector<uint8_t>> m_allowed;  // [pattern][position * m_num_classes + label]
+};
+
+// A set of words, only whole words are accepted.
+class LexiconGrammar : public CtcGrammar {
+ public:
+  LexiconGrammar();
+  void addWord(const std::vector<int> &labels);
+
+  uint32_t start() const override { return 0; }
+  bool next(uint32_t state, int label, uint32_t *next_state) const override;
+  bool accept(uint32_t state) const override { return m_nodes[state].terminal; }
+
+ private:
+  struct Node {
+    std::unordered_map<int, uint32_t> children;
+    bool terminal;
+  };
+  std::vector<Node> m_nodes;
+};
+
+class CtcDecoder {
+ public:
+  explicit CtcDecoder(int blank) : m_blank(blank) {}
+
+  // Best class of every step with repeats merged and blanks removed. score, if not null, is the
+  // mean probability of the kept steps.
+  void greedy(const CtcInput &input, int n, std::vector<int> *labels, float *score) const;
+
+  /**
+   * @brief Prefix beam search over sequence n, optionally constrained by grammar. score, if not
+   * null, is the probability of labels summed over all alignments. Return false when no
+   * hypothesis is accepted by the grammar, labels are left untouched then.
+   */
+  bool beamSearch(const CtcInput &input, int n, int beam_width, const CtcGrammar *grammar,
+                  std::vector<int> *labels, float *score) const;
+
+ private:
+  int m_blank;
+};
+
+}  // namespace cvitdl
@@ -0,0 +1,111 @@
+#include "frame_map_cache.hpp"
+
+#include "core/core/cvtdl_errno.h"
+#include "cvi_sys.h"
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+
+FrameMapCache &FrameMapCache::instance() {
+  static FrameMapCache cache;
+  return cache;
+}
+
+FrameMapCache::Key FrameMapCache::keyOf(const VIDEO_FRAME_INFO_S *frame) {
+  uint32_t length =
+      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
+  return Key(frame->stVFrame.u64PhyAddr[0], length);
+}
+
+FrameMapCache::Entry *FrameMapCache::acquire(const Key &key) {
+  auto iter = m_entries.find(key);
+  if (iter != m_entries.end()) {
+    return &iter->second;
+  }
+  uint8_t *vir_addr = (uint8_t *)CVI_SYS_Mmap(key.first, key.second);
+  if (vir_addr == NULL) {
+    LOGE("mmap frame failed, phy addr: 0x%llx, length: %u\n", (unsigned long long)key.first,
+         key.second);
+    return nullptr;
+  }
+  Entry &entry = m_entries[key];
+  entry.vir_addr = vir_addr;
+  entry.scope_refs = 0;
+  entry.use_refs = 0;
+  return &entry;
+}
+
+void FrameMapCache::releaseIfUnused(const Key &key) {
+  auto iter = m_entries.find(key);
+  if (iter == m_entries.end() || iter->second.scope_refs > 0 || iter->second.use_refs > 0) {
+    return;
+  }
+  CVI_SYS_Munmap(iter->second.vir_addr, key.second);
+  m_entries.erase(iter);
+}
+
+int FrameMapCache::beginFrame(VIDEO_FRAME_INFO_S *frame) {
+  if (frame->stVFrame.u64PhyAddr[0] == 0) {
+    return CVI_TDL_SUCCESS;  // system memory, nothing to map
+  }
+  if (frame->stVFrame.pu8VirAddr[0] != NULL) {
+    return CVI_TDL_SUCCESS;  // mapped by the caller, map() won't touch it either
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Entry *entry = acquire(keyOf(frame));
+  if (entry == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
+  entry->scope_refs++;
+  return CVI_TDL_SUCCESS;
+}
+
+int FrameMapCache::endFrame(VIDEO_FRAME_INFO_S *frame) {
+  if (frame->stVFrame.u64PhyAddr[0] == 0) {
+    return CVI_TDL_SUCCESS;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Key key = keyOf(frame);
+  auto iter = m_entries.find(key);
+  if (iter == m_entries.end() || iter->second.scope_refs == 0) {
+    if (frame->stVFrame.pu8VirAddr[0] != NULL) {
+      return CVI_TDL_SUCCESS;  // beginFrame skipped the caller's mapping
+    }
+    LOGW("end frame mapping without begin, phy addr: 0x%llx\n", (unsigned long long)key.first);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  iter->second.scope_refs--;
+  releaseIfUnused(key);
+  return CVI_TDL_SUCCESS;
+}
+
+bool FrameMapCache::map(VIDEO_FRAME_INFO_S *frame) {
+  if (frame->stVFrame.pu8VirAddr[0] != NULL) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Entry *entry = acquire(keyOf(frame));
+  if (entry == nullptr) {
+    return false;
+  }
+  entry->use_refs++;
+  frame->stVFrame.pu8VirAddr[0] = entry->vir_addr;
+  frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
+  frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
+  return true;
+}
+
+void FrameMapCache::unmap(VIDEO_FRAME_INFO_S *frame) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Key key = keyOf(frame);
+  auto iter = m_entries.find(key);
+  if (iter != m_entries.end() && iter->second.use_refs > 0) {
+    iter->second.use_refs--;
+    releaseIfUnused(key);
+  }
+  frame->stVFrame.pu8VirAddr[0] = NULL;
+  frame->stVFrame.pu8VirAddr[1] = NULL;
+  frame->stVFrame.pu8VirAddr[2] = NULL;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <utility>
+#include "cvi_comm.h"
+
+namespace cvitdl {
+
+/**
+ * @brief Shares one CPU mapping of a frame between helpers that read it.
+ *
+ * Mappings are keyed by physical address and length and reference counted. Outside a frame
+ * scope, map()/unmap() behave like a plain mmap/munmap pair. Between beginFrame() and endFrame()
+ * the mapping stays alive, so cropping many boxes from one frame maps it once. Frames the caller
+ * already mapped are left alone by both. Scopes should not outlive the frame: the physical
+ * buffer is recycled by the VB pool once the frame is released.
+ */
+class FrameMapCache {
+ public:
+  static FrameMapCache &instance();
+
+  int beginFrame(VIDEO_FRAME_INFO_S *frame);
+  int endFrame(VIDEO_FRAME_INFO_S *frame);
+
+  // Fill pu8VirAddr of an unmapped frame. Return false if the frame was already mapped by the
+  // caller, in which case unmap() must not be called.
+  bool map(VIDEO_FRAME_INFO_S *frame);
+  void unmap(VIDEO_FRAME_INFO_S *frame);
+
+ private:
+  struct Entry {
+    uint8_t *vir_addr;
+    int scope_refs;
+    int use_refs;
+  };
+  typedef std::pair<uint64_t, uint32_t> Key;
+
+  static Key keyOf(const VIDEO_FRAME_INFO_S *frame);
+  Entry *acquire(const Key &key);
+  void releaseIfUnused(const Key &key);
+
+  std::mutex m_mutex;
+  std::map<Key, Entry> m_entries;
+};
+
+}  // namespace cvitdl
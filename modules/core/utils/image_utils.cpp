@@ -2,8 +2,10 @@
 
 #include "core/cvi_tdl_utils.h"
 
+#include "color_convert.hpp"
 #include "core_utils.hpp"
 #include "cvi_tdl_log.hpp"
+#include "frame_map_cache.hpp"
 #include "rescale_utils.hpp"
 
 #include "opencv2/core.hpp"
@@ -26,27 +28,14 @@ static bool IS_SUPPORTED_FORMAT(VIDEO_FRAME_INFO_S *frame) {
   return true;
 }
 
+// Mappings go through FrameMapCache, so crops inside a CVI_TDL_BeginFrameMapping scope share one.
 static void DO_MAP_IF_NEEDED(VIDEO_FRAME_INFO_S *frame, bool *do_unmap) {
-  *do_unmap = false;
-  CVI_U32 frame_size =
-      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
-  if (frame->stVFrame.pu8VirAddr[0] == NULL) {
-    frame->stVFrame.pu8VirAddr[0] =
-        (CVI_U8 *)CVI_SYS_Mmap(frame->stVFrame.u64PhyAddr[0], frame_size);
-    frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
-    frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
-    *do_unmap = true;
-  }
+  *do_unmap = cvitdl::FrameMapCache::instance().map(frame);
 }
 
 static void DO_UNMAP_IF_NEEDED(VIDEO_FRAME_INFO_S *frame, bool do_unmap) {
-  CVI_U32 frame_size =
-      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
   if (do_unmap) {
-    CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], frame_size);
-    frame->stVFrame.pu8VirAddr[0] = NULL;
-    frame->stVFrame.pu8VirAddr[1] = NULL;
-    frame->stVFrame.pu8VirAddr[2] = NULL;
+    cvitdl::FrameMapCache::instance().unmap(frame);
   }
 }
 
@@ -132,21 +121,21 @@ CVI_S32 crop_image(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *dst_image, cvtdl
   GET_BBOX_COORD(bbox, x1, y1, x2, y2, height, width, srcFrame->stVFrame.enPixelFormat,
                  srcFrame->stVFrame.u32Height, srcFrame->stVFrame.u32Width);
 
-  cvtdl_image_t tmp_image;
-  memset(&tmp_image, 0, sizeof(cvtdl_image_t));
   if (cvtRGB888 && srcFrame->stVFrame.enPixelFormat != PIXEL_FORMAT_RGB_888) {
-    if (CVI_TDL_SUCCESS !=
-        CVI_TDL_CreateImage(&tmp_image, height, width, srcFrame->stVFrame.enPixelFormat)) {
-      return CVI_TDL_FAILURE;
-    }
+    // crop and convert in one pass, no intermediate image
     if (CVI_TDL_SUCCESS != CVI_TDL_CreateImage(dst_image, height, width, PIXEL_FORMAT_RGB_888)) {
       return CVI_TDL_FAILURE;
     }
-  } else {
-    if (CVI_TDL_SUCCESS !=
-        CVI_TDL_CreateImage(dst_image, height, width, srcFrame->stVFrame.enPixelFormat)) {
-      return CVI_TDL_FAILURE;
-    }
+    bool do_unmap = false;
+    DO_MAP_IF_NEEDED(srcFrame, &do_unmap);
+    CVI_S32 ret = crop_to_rgb888(srcFrame, x1, y1, width, height, dst_image->pix[0],
+                                 dst_image->stride[0]);
+    DO_UNMAP_IF_NEEDED(srcFrame, do_unmap);
+    return ret;
+  }
+  if (CVI_TDL_SUCCESS !=
+      CVI_TDL_CreateImage(dst_image, height, width, srcFrame->stVFrame.enPixelFormat)) {
+    return CVI_TDL_FAILURE;
   }
 
   bool do_unmap = false;
@@ -159,65 +148,39 @@ CVI_S32 crop_image(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *dst_image, cvtdl
                       3);
     } break;
     case PIXEL_FORMAT_RGB_888_PLANAR: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
-                      srcFrame->stVFrame.u32Stride[0], p_image->stride[0], x1, y1, width, height,
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
+                      srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], x1, y1, width, height,
                       1);
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
-                      srcFrame->stVFrame.u32Stride[1], p_image->stride[1], x1, y1, width, height,
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
+                      srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], x1, y1, width, height,
                       1);
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[2], p_image->pix[2],
-                      srcFrame->stVFrame.u32Stride[2], p_image->stride[2], x1, y1, width, height,
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[2], dst_image->pix[2],
+                      srcFrame->stVFrame.u32Stride[2], dst_image->stride[2], x1, y1, width, height,
                       1);
-      if (cvtRGB888) {
-        for (uint32_t i = 0; i < dst_image->height; i++) {
-          for (uint32_t j = 0; j < dst_image->width * 3; j++) {
-            dst_image->pix[0][i * dst_image->stride[0] + j] =
-                tmp_image.pix[j % 3][i * tmp_image.stride[0] + j / 3];
-          }
-        }
-      }
     } break;
     case PIXEL_FORMAT_NV21: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
-                      srcFrame->stVFrame.u32Stride[0], p_image->stride[0], x1, y1, width, height,
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
+                      srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], x1, y1, width, height,
                       1);
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
-                      srcFrame->stVFrame.u32Stride[1], p_image->stride[1], (x1 >> 1), (y1 >> 1),
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
+                      srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], (x1 >> 1), (y1 >> 1),
                       (width >> 1), (height >> 1), 2);
-      if (cvtRGB888) {
-        cv::Mat cvImage_NV21(tmp_image.height * 3 / 2, tmp_image.width, CV_8UC1, tmp_image.pix[0],
-                             tmp_image.stride[0]);
-        cv::Mat cvImage_RGB888(dst_image->height, dst_image->width, CV_8UC3, dst_image->pix[0],
-                               dst_image->stride[0]);
-        cv::cvtColor(cvImage_NV21, cvImage_RGB888, CV_YUV2RGB_NV21);
-      }
     } break;
     case PIXEL_FORMAT_YUV_PLANAR_420: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
-                      srcFrame->stVFrame.u32Stride[0], p_image->stride[0], x1, y1, width, height,
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
+                      srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], x1, y1, width, height,
                       1);
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
-                      srcFrame->stVFrame.u32Stride[1], p_image->stride[1], (x1 >> 1), (y1 >> 1),
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
+                      srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], (x1 >> 1), (y1 >> 1),
                       (width >> 1), (height >> 1), 1);
-      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[2], p_image->pix[2],
-                      srcFrame->stVFrame.u32Stride[2], p_image->stride[2], (x1 >> 1), (y1 >> 1),
+      BBOX_PIXEL_COPY(srcFrame->stVFrame.pu8VirAddr[2], dst_image->pix[2],
+                      srcFrame->stVFrame.u32Stride[2], dst_image->stride[2], (x1 >> 1), (y1 >> 1),
                       (width >> 1), (height >> 1), 1);
-      if (cvtRGB888) {
-        cv::Mat cvImage_YUV420(tmp_image.height * 3 / 2, tmp_image.width, CV_8UC1, tmp_image.pix[0],
-                               tmp_image.stride[0]);
-        cv::Mat cvImage_RGB888(dst_image->height, dst_image->width, CV_8UC3, dst_image->pix[0],
-                               dst_image->stride[0]);
-        cv::cvtColor(cvImage_YUV420, cvImage_RGB888, CV_YUV2RGB_I420);
-      }
-    }
+    } break;
     default:
       break;
   }
 
-  CVI_TDL_Free(&tmp_image);
   DO_UNMAP_IF_NEEDED(srcFrame, do_unmap);
 
   return CVI_SUCCESS;
@@ -245,24 +208,23 @@ CVI_S32 crop_image_exten(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *dst_image,
   *offset_x = edge_exten + (edge - width) / 2;
   *offset_y = edge_exten + (edge - height) / 2;
 
-  cvtdl_image_t tmp_image;
-  memset(&tmp_image, 0, sizeof(cvtdl_image_t));
+  uint32_t exten_edge = edge + 2 * edge_exten;
   if (cvtRGB888 && srcFrame->stVFrame.enPixelFormat != PIXEL_FORMAT_RGB_888) {
-    if (CVI_TDL_SUCCESS != CVI_TDL_CreateImage(&tmp_image, edge + 2 * edge_exten,
-                                               edge + 2 * edge_exten,
-                                               srcFrame->stVFrame.enPixelFormat)) {
-      return CVI_TDL_FAILURE;
-    }
-    if (CVI_TDL_SUCCESS != CVI_TDL_CreateImage(dst_image, edge + 2 * edge_exten,
-                                               edge + 2 * edge_exten, PIXEL_FORMAT_RGB_888)) {
-      return CVI_TDL_FAILURE;
-    }
-  } else {
-    if (CVI_TDL_SUCCESS != CVI_TDL_CreateImage(dst_image, edge + 2 * edge_exten,
-                                               edge + 2 * edge_exten,
-                                               srcFrame->stVFrame.enPixelFormat)) {
+    // crop and convert in one pass, no intermediate image
+    if (CVI_TDL_SUCCESS !=
+        CVI_TDL_CreateImage(dst_image, exten_edge, exten_edge, PIXEL_FORMAT_RGB_888)) {
       return CVI_TDL_FAILURE;
     }
+    bool do_unmap = false;
+    DO_MAP_IF_NEEDED(srcFrame, &do_unmap);
+    CVI_S32 ret = crop_to_rgb888(srcFrame, ext_x1, ext_y1, exten_edge, exten_edge,
+                                 dst_image->pix[0], dst_image->stride[0]);
+    DO_UNMAP_IF_NEEDED(srcFrame, do_unmap);
+    return ret;
+  }
+  if (CVI_TDL_SUCCESS != CVI_TDL_CreateImage(dst_image, exten_edge, exten_edge,
+                                             srcFrame->stVFrame.enPixelFormat)) {
+    return CVI_TDL_FAILURE;
   }
 
   bool do_unmap = false;
@@ -276,74 +238,47 @@ CVI_S32 crop_image_exten(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_image_t *dst_image,
                         dst_image->width, dst_image->height, 3);
     } break;
     case PIXEL_FORMAT_RGB_888_PLANAR: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
                         (int)srcFrame->stVFrame.u32Width, (int)srcFrame->stVFrame.u32Height,
-                        srcFrame->stVFrame.u32Stride[0], p_image->stride[0], ext_x1, ext_y1,
-                        p_image->width, p_image->height, 1);
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
+                        srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], ext_x1, ext_y1,
+                        dst_image->width, dst_image->height, 1);
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
                         (int)srcFrame->stVFrame.u32Width, (int)srcFrame->stVFrame.u32Height,
-                        srcFrame->stVFrame.u32Stride[1], p_image->stride[1], ext_x1, ext_y1,
-                        p_image->width, p_image->height, 1);
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[2], p_image->pix[2],
+                        srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], ext_x1, ext_y1,
+                        dst_image->width, dst_image->height, 1);
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[2], dst_image->pix[2],
                         (int)srcFrame->stVFrame.u32Width, (int)srcFrame->stVFrame.u32Height,
-                        srcFrame->stVFrame.u32Stride[2], p_image->stride[2], ext_x1, ext_y1,
-                        p_image->width, p_image->height, 1);
-      if (cvtRGB888) {
-        for (uint32_t i = 0; i < dst_image->height; i++) {
-          for (uint32_t j = 0; j < dst_image->width * 3; j++) {
-            dst_image->pix[0][i * dst_image->stride[0] + j] =
-                tmp_image.pix[j % 3][i * tmp_image.stride[0] + j / 3];
-          }
-        }
-      }
+                        srcFrame->stVFrame.u32Stride[2], dst_image->stride[2], ext_x1, ext_y1,
+                        dst_image->width, dst_image->height, 1);
     } break;
     case PIXEL_FORMAT_NV21: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
                         (int)srcFrame->stVFrame.u32Width, (int)srcFrame->stVFrame.u32Height,
-                        srcFrame->stVFrame.u32Stride[0], p_image->stride[0], ext_x1, ext_y1,
-                        p_image->width, p_image->height, 1);
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
+                        srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], ext_x1, ext_y1,
+                        dst_image->width, dst_image->height, 1);
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
                         (int)srcFrame->stVFrame.u32Width / 2, (int)srcFrame->stVFrame.u32Height / 2,
-                        srcFrame->stVFrame.u32Stride[1], p_image->stride[1], (ext_x1 / 2),
-                        (ext_y1 / 2), (p_image->width / 2), (p_image->height / 2), 2);
-      if (cvtRGB888) {
-        cv::Mat cvImage_NV21(tmp_image.height * 3 / 2, tmp_image.width, CV_8UC1, tmp_image.pix[0],
-                             tmp_image.stride[0]);
-        cv::Mat cvImage_RGB888(dst_image->height, dst_image->width, CV_8UC3, dst_image->pix[0],
-                               dst_image->stride[0]);
-        cv::cvtColor(cvImage_NV21, cvImage_RGB888, CV_YUV2RGB_NV21);
-      }
+                        srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], (ext_x1 / 2),
+                        (ext_y1 / 2), (dst_image->width / 2), (dst_image->height / 2), 2);
     } break;
     case PIXEL_FORMAT_YUV_PLANAR_420: {
-      cvtdl_image_t *p_image = (cvtRGB888) ? &tmp_image : dst_image;
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], p_image->pix[0],
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[0], dst_image->pix[0],
                         (int)srcFrame->stVFrame.u32Width, (int)srcFrame->stVFrame.u32Height,
-                        srcFrame->stVFrame.u32Stride[0], p_image->stride[0], ext_x1, ext_y1,
-                        p_image->width, p_image->height, 1);
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], p_image->pix[1],
+                        srcFrame->stVFrame.u32Stride[0], dst_image->stride[0], ext_x1, ext_y1,
+                        dst_image->width, dst_image->height, 1);
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[1], dst_image->pix[1],
                         (int)srcFrame->stVFrame.u32Width / 2, (int)srcFrame->stVFrame.u32Height / 2,
-                        srcFrame->stVFrame.u32Stride[1], p_image->stride[1], (ext_x1 / 2),
-                        (ext_y1 / 2), (p_image->width / 2), (p_image->height / 2), 1);
-      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[2], p_image->pix[2],
+                        srcFrame->stVFrame.u32Stride[1], dst_image->stride[1], (ext_x1 / 2),
+                        (ext_y1 / 2), (dst_image->width / 2), (dst_image->height / 2), 1);
+      BBOX_PIXEL_COPY_2(srcFrame->stVFrame.pu8VirAddr[2], dst_image->pix[2],
                         (int)srcFrame->stVFrame.u32Width / 2, (int)srcFrame->stVFrame.u32Height / 2,
-                        srcFrame->stVFrame.u32Stride[2], p_image->stride[2], (ext_x1 / 2),
-                        (ext_y1 / 2), (p_image->width / 2), (p_image->height / 2), 1);
-      if (cvtRGB888) {
-        cv::Mat cvImage_YUV420(tmp_image.height * 3 / 2, tmp_image.width, CV_8UC1, tmp_image.pix[0],
-                               tmp_image.stride[0]);
-        cv::Mat cvImage_RGB888(dst_image->height, dst_image->width, CV_8UC3, dst_image->pix[0],
-                               dst_image->stride[0]);
-
-        cv::cvtColor(cvImage_YUV420, cvImage_RGB888, CV_YUV2RGB_I420);
-      }
+                        srcFrame->stVFrame.u32Stride[2], dst_image->stride[2], (ext_x1 / 2),
+                        (ext_y1 / 2), (dst_image->width / 2), (dst_image->height / 2), 1);
     } break;
     default:
       break;
   }
 
-  CVI_TDL_Free(&tmp_image);
   DO_UNMAP_IF_NEEDED(srcFrame, do_unmap);
 
   return CVI_TDL_SUCCESS;
@@ -0,0 +1,204 @@
+#include "keypoint_decode.hpp"
+
+#include <math.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+namespace {
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+inline int8_t hmax_s8(int8x16_t v) {
+  int8x8_t m = vpmax_s8(vget_low_s8(v), vget_high_s8(v));
+  m = vpmax_s8(m, m);
+  m = vpmax_s8(m, m);
+  m = vpmax_s8(m, m);
+  return vget_lane_s8(m, 0);
+}
+
+inline float hmax_f32(float32x4_t v) {
+  float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  m = vpmax_f32(m, m);
+  return vget_lane_f32(m, 0);
+}
+
+inline bool any_u8(uint8x16_t v) {
+  uint64x2_t w = vreinterpretq_u64_u8(v);
+  return (vgetq_lane_u64(w, 0) | vgetq_lane_u64(w, 1)) != 0;
+}
+
+inline bool any_u32(uint32x4_t v) {
+  uint64x2_t w = vreinterpretq_u64_u32(v);
+  return (vgetq_lane_u64(w, 0) | vgetq_lane_u64(w, 1)) != 0;
+}
+#endif
+
+inline float value_at(const float *p, int idx, float) { return p[idx]; }
+inline float value_at(const int8_t *p, int idx, float qscale) { return p[idx] * qscale; }
+
+// Sub-pixel offset of the peak at (x, y) of a height x width heatmap.
+template <typename T>
+void refine_peak(const T *hm, float qscale, int height, int width, int x, int y,
+                 KeypointRefine refine, float *dx, float *dy) {
+  *dx = 0;
+  *dy = 0;
+  if (refine == KeypointRefine::NONE) {
+    return;
+  }
+  if (refine == KeypointRefine::DARK && 0 < x && x < width - 1 && 0 < y && y < height - 1) {
+    // log of the 3x3 neighbourhood, l[1][1] is the peak
+    float l[3][3];
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) {
+        l[r][c] = logf(fmaxf(value_at(hm, (y + r - 1) * width + x + c - 1, qscale), 1e-10f));
+      }
+    }
+    float gx = 0.5f * (l[1][2] - l[1][0]);
+    float gy = 0.5f * (l[2][1] - l[0][1]);
+    float hxx = l[1][2] - 2 * l[1][1] + l[1][0];
+    float hyy = l[2][1] - 2 * l[1][1] + l[0][1];
+    float hxy = 0.25f * (l[2][2] - l[0][2] - l[2][0] + l[0][0]);
+    float det = hxx * hyy - hxy * hxy;
+    // Only a proper maximum has a negative definite Hessian.
+    if (hxx < 0 && det > 1e-6f) {
+      float ox = -(hyy * gx - hxy * gy) / det;
+      float oy = -(hxx * gy - hxy * gx) / det;
+      if (fabsf(ox) <= 1 && fabsf(oy) <= 1) {
+        *dx = ox;
+        *dy = oy;
+        return;
+      }
+    }
+  }
+  if (1 < x && x < width - 1 && 1 < y && y < height - 1) {
+    int idx = y * width + x;
+    float diff_x = value_at(hm, idx + 1, qscale) - value_at(hm, idx - 1, qscale);
+    float diff_y = value_at(hm, idx + width, qscale) - value_at(hm, idx - width, qscale);
+    *dx = diff_x > 0 ? 0.25f : (diff_x < 0 ? -0.25f : 0.f);
+    *dy = diff_y > 0 ? 0.25f : (diff_y < 0 ? -0.25f : 0.f);
+  }
+}
+
+template <typename T>
+void decode_heatmaps_impl(const T *data, float qscale, int num, int height, int width,
+                          KeypointRefine refine, Keypoint *out) {
+  const int plane = height * width;
+  for (int i = 0; i < num; i++) {
+    const T *p = data + i * plane;
+    T max_val;
+    int idx = argmax(p, plane, &max_val);
+    float score = value_at(&max_val, 0, qscale);
+    out[i] = {0, 0, 0};
+    if (score <= 0) {
+      continue;
+    }
+    int x = idx % width, y = idx / width;
+    float dx, dy;
+    refine_peak(p, qscale, height, width, x, y, refine, &dx, &dy);
+    out[i] = {x + dx, y + dy, score};
+  }
+}
+
+template <typename T>
+void decode_simcc_impl(const T *data_x, float qscale_x, int len_x, const T *data_y,
+                       float qscale_y, int len_y, int num, float split_ratio, Keypoint *out) {
+  for (int i = 0; i < num; i++) {
+    T max_x, max_y;
+    int pos_x = argmax(data_x + i * len_x, len_x, &max_x);
+    int pos_y = argmax(data_y + i * len_y, len_y, &max_y);
+    float score_x = value_at(&max_x, 0, qscale_x);
+    float score_y = value_at(&max_y, 0, qscale_y);
+    out[i] = {pos_x / split_ratio, pos_y / split_ratio, fminf(score_x, score_y)};
+  }
+}
+
+}  // namespace
+
+int argmax(const float *p, int n, float *max_val) {
+  int i = 0;
+  float best = p[0];
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  if (n >= 4) {
+    float32x4_t m = vld1q_f32(p);
+    for (i = 4; i + 4 <= n; i += 4) {
+      m = vmaxq_f32(m, vld1q_f32(p + i));
+    }
+    best = hmax_f32(m);
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] > best) {
+      best = p[i];
+    }
+  }
+  *max_val = best;
+
+  int j = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const float32x4_t b = vdupq_n_f32(best);
+  while (j + 4 <= n && !any_u32(vceqq_f32(vld1q_f32(p + j), b))) {
+    j += 4;
+  }
+#endif
+  while (j < n && p[j] != best) {
+    j++;
+  }
+  return j < n ? j : 0;
+}
+
+int argmax(const int8_t *p, int n, int8_t *max_val) {
+  int i = 0;
+  int8_t best = p[0];
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  if (n >= 16) {
+    int8x16_t m = vld1q_s8(p);
+    for (i = 16; i + 16 <= n; i += 16) {
+      m = vmaxq_s8(m, vld1q_s8(p + i));
+    }
+    best = hmax_s8(m);
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] > best) {
+      best = p[i];
+    }
+  }
+  *max_val = best;
+
+  int j = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const int8x16_t b = vdupq_n_s8(best);
+  while (j + 16 <= n && !any_u8(vceqq_s8(vld1q_s8(p + j), b))) {
+    j += 16;
+  }
+#endif
+  while (j < n && p[j] != best) {
+    j++;
+  }
+  return j;
+}
+
+void decode_heatmaps(const float *data, float qscale, int num, int height, int width,
+                     KeypointRefine refine, Keypoint *out) {
+  decode_heatmaps_impl(data, qscale, num, height, width, refine, out);
+}
+
+void decode_heatmaps(const int8_t *data, float qscale, int num, int height, int width,
+                     KeypointRefine refine, Keypoint *out) {
+  decode_heatmaps_impl(data, qscale, num, height, width, refine, out);
+}
+
+void decode_simcc(const float *data_x, float qscale_x, int len_x, const float *data_y,
+                  float qscale_y, int len_y, int num, float split_ratio, Keypoint *out) {
+  decode_simcc_impl(data_x, qscale_x, len_x, data_y, qscale_y, len_y, num, split_ratio, out);
+}
+
+void decode_simcc(const int8_t *data_x, float qscale_x, int len_x, const int8_t *data_y,
+                  float qscale_y, int len_y, int num, float split_ratio, Keypoint *out) {
+  decode_simcc_impl(data_x, qscale_x, len_x, data_y, qscale_y, len_y, num, split_ratio, out);
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+namespace cvitdl {
+
+struct Keypoint {
+  float x;
+  float y;
+  float score;
+};
+
+enum class KeypointRefine {
+  NONE,
+  QUARTER_OFFSET,  // shift a quarter pixel towards the higher neighbour
+  DARK,            // second order Taylor expansion of the log heatmap around the peak
+};
+
+// Index of the first maximum of p[0, n) and the maximum itself. n must be positive.
+int argmax(const float *p, int n, float *max_val);
+int argmax(const int8_t *p, int n, int8_t *max_val);
+
+/**
+ * @brief Find the peak of num consecutive height x width heatmaps, dequantized by qscale for int8.
+ *
+ * out[i] is in heatmap pixels. A heatmap without a positive value gives (0, 0) with score 0.
+ * Several instances stacked in one tensor are decoded with one call by passing num as
+ * instances * joints.
+ */
+void decode_heatmaps(const float *data, float qscale, int num, int height, int width,
+                     KeypointRefine refine, Keypoint *out);
+void decode_heatmaps(const int8_t *data, float qscale, int num, int height, int width,
+                     KeypointRefine refine, Keypoint *out);
+
+/**
+ * @brief Decode num SimCC keypoints from their x and y classification vectors of len_x and len_y
+ * bins. Coordinates are the argmax bins divided by split_ratio, the score is the lower of the two
+ * maxima.
+ */
+void decode_simcc(const float *data_x, float qscale_x, int len_x, const float *data_y,
+                  float qscale_y, int len_y, int num, float split_ratio, Keypoint *out);
+void decode_simcc(const int8_t *data_x, float qscale_x, int len_x, const int8_t *data_y,
+                  float qscale_y, int len_y, int num, float split_ratio, Keypoint *out);
+
+}  // namespace cvitdl
@@ -0,0 +1,97 @@
+#include "latency_histogram.hpp"
+
+#include <time.h>
+
+namespace cvitdl {
+
+uint64_t monotonic_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Values below kSubBuckets get a bucket each. Above, bucket (m - kSubBits + 1, s) holds the
+// values whose highest bit is m and whose next kSubBits bits are s.
+int LatencyHistogram::bucketOf(uint64_t ns) {
+  if (ns < (uint64_t)kSubBuckets) {
+    return (int)ns;
+  }
+  int magnitude = 63 - __builtin_clzll(ns);
+  if (magnitude > kMaxMagnitude) {
+    return kNumBuckets - 1;
+  }
+  int sub = (int)(ns >> (magnitude - kSubBits)) & (kSubBuckets - 1);
+  return (magnitude - kSubBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::valueOf(int bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  int magnitude = bucket / kSubBuckets + kSubBits - 1;
+  int sub = bucket % kSubBuckets;
+  uint64_t width = 1ull << (magnitude - kSubBits);
+  return ((uint64_t)(kSubBuckets + sub) << (magnitude - kSubBits)) + width / 2;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+  m_buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t prev = m_max.load(std::memory_order_relaxed);
+  while (ns > prev && !m_max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::reset() {
+  for (auto &b : m_buckets) {
+    b.store(0, std::memory_order_relaxed);
+  }
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (int i = 0; i < kNumBuckets; i++) {
+    m_buckets[i].fetch_add(other.m_buckets[i].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+  }
+  m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  uint64_t max = other.m_max.load(std::memory_order_relaxed);
+  uint64_t prev = m_max.load(std::memory_order_relaxed);
+  while (max > prev && !m_max.compare_exchange_weak(prev, max, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::stats(LatencyStats *out) const {
+  uint32_t counts[kNumBuckets];
+  uint64_t total = 0;
+  for (int i = 0; i < kNumBuckets; i++) {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  *out = LatencyStats();
+  out->count = total;
+  if (total == 0) {
+    return;
+  }
+  out->mean_us = m_sum.load(std::memory_order_relaxed) / 1000.f / total;
+  out->max_us = m_max.load(std::memory_order_relaxed) / 1000.f;
+
+  const float quantiles[3] = {0.5f, 0.95f, 0.99f};
+  float *results[3] = {&out->p50_us, &out->p95_us, &out->p99_us};
+  uint64_t seen = 0;
+  int q = 0;
+  for (int i = 0; i < kNumBuckets && q < 3; i++) {
+    seen += counts[i];
+    while (q < 3 && seen >= quantiles[q] * total) {
+      *results[q++] = valueOf(i) / 1000.f;
+    }
+  }
+  for (int i = 0; i < 3; i++) {
+    if (*results[i] > out->max_us) {
+      *results[i] = out->max_us;
+    }
+  }
+}
+
+}  // namespace cvitdl
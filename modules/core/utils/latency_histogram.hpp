@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+namespace cvitdl {
+
+uint64_t monotonic_ns();
+
+struct LatencyStats {
+  uint64_t count;
+  float mean_us;
+  float p50_us;
+  float p95_us;
+  float p99_us;
+  float max_us;
+};
+
+/**
+ * @brief Log-linear histogram of nanosecond latencies, HDR style with 16 sub-buckets per power of
+ * two, so percentiles are within 1/16 of the recorded values.
+ *
+ * record() only does relaxed atomic increments and never blocks, so stats can be read from any
+ * thread while the inference thread records. Values beyond about 68 s land in the last bucket.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() { reset(); }
+
+  void record(uint64_t ns);
+  void reset();
+  // Add the values recorded by other, e.g. to report several instances of a model as one.
+  void merge(const LatencyHistogram &other);
+  void stats(LatencyStats *out) const;
+
+ private:
+  static constexpr int kSubBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBits;
+  static constexpr int kMaxMagnitude = 36;
+  static constexpr int kNumBuckets = (kMaxMagnitude - kSubBits + 2) * kSubBuckets;
+
+  static int bucketOf(uint64_t ns);
+  // Middle of the value range counted by bucket.
+  static uint64_t valueOf(int bucket);
+
+  std::atomic<uint32_t> m_buckets[kNumBuckets];
+  std::atomic<uint64_t> m_sum;
+  std::atomic<uint64_t> m_max;
+};
+
+}  // namespace cvitdl
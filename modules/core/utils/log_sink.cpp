@@ -0,0 +1,217 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cvi_tdl_log.hpp"
+
+int cvi_tdl_log_level = LOG_INFO;
+
+namespace {
+
+constexpr uint32_t kRingSlots = 64;
+constexpr size_t kMessageSize = 256;
+// the drainer also polls, a wake-up may be missed while it is between two passes
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+struct Message {
+  int level;
+  char text[kMessageSize];
+};
+
+// Written by its thread only and read by the drainer only, so head and tail need no lock.
+struct Ring {
+  Message slots[kRingSlots];
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+  std::atomic<uint32_t> dropped{0};
+  // the thread exited, the drainer frees the ring once empty
+  std::atomic<bool> orphaned{false};
+};
+
+void writeOut(int level, const char *text) {
+#ifdef CONFIG_ALIOS
+  ulog(level, MODULE_NAME, ULOG_TAG, "%s", text);
+#else
+  syslog(CVI_TDL_LOG_CHN | level, "%s", text);
+#endif
+}
+
+// Formats and writes a message on the calling thread, whatever its length.
+void writeDirect(int level, const char *fmt, va_list args) {
+  char text[kMessageSize];
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(text, sizeof(text), fmt, copy);
+  va_end(copy);
+  if (len >= (int)sizeof(text)) {
+    std::unique_ptr<char[]> long_text(new char[len + 1]);
+    vsnprintf(long_text.get(), len + 1, fmt, args);
+    writeOut(level, long_text.get());
+    return;
+  }
+  writeOut(level, text);
+}
+
+class LogSink {
+ public:
+  // Never destroyed, static destructors running after the exit flush may still log.
+  static LogSink &instance() {
+    static LogSink *sink = new LogSink();
+    return *sink;
+  }
+
+  Ring *registerRing() {
+    Ring *ring = new Ring();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rings.push_back(ring);
+    if (!m_thread.joinable()) {
+      m_thread = std::thread(&LogSink::drainLoop, this);
+      atexit([] { LogSink::instance().stop(); });
+    }
+    return ring;
+  }
+
+  bool stopped() const { return m_stopped.load(std::memory_order_acquire); }
+
+  void wake() { m_wake.notify_one(); }
+
+ private:
+  LogSink() = default;
+
+  void stop() {
+    m_stopped.store(true, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+  }
+
+  bool drainRing(Ring *ring) {
+    uint32_t begin = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    for (uint32_t tail = begin; tail != head; tail++) {
+      const Message &msg = ring->slots[tail % kRingSlots];
+      writeOut(msg.level, msg.text);
+      ring->tail.store(tail + 1, std::memory_order_release);
+    }
+    uint32_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0) {
+      char text[64];
+      snprintf(text, sizeof(text), "[" MODULE_NAME "] [W] %u log messages dropped\n", dropped);
+      writeOut(LOG_WARNING, text);
+    }
+    return head != begin;
+  }
+
+  void releaseOrphans() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto end = std::remove_if(m_rings.begin(), m_rings.end(), [](Ring *ring) {
+      if (!ring->orphaned.load(std::memory_order_acquire) ||
+          ring->tail.load(std::memory_order_relaxed) !=
+              ring->head.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      delete ring;
+      return true;
+    });
+    m_rings.erase(end, m_rings.end());
+  }
+
+  void drainLoop() {
+    std::vector<Ring *> rings;
+    while (true) {
+      bool stopping;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        rings = m_rings;
+        stopping = m_stopping;
+      }
+      bool busy = false;
+      for (Ring *ring : rings) {
+        busy |= drainRing(ring);
+      }
+      releaseOrphans();
+      if (stopping) {
+        return;
+      }
+      if (!busy) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait_for(lock, kIdleWait, [this] { return m_stopping; });
+      }
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::vector<Ring *> m_rings;
+  std::thread m_thread;
+  bool m_stopping = false;
+  std::atomic<bool> m_stopped{false};
+};
+
+struct ThreadRing {
+  Ring *ring = nullptr;
+  ~ThreadRing() {
+    if (ring != nullptr) {
+      ring->orphaned.store(true, std::memory_order_release);
+      ring = nullptr;
+    }
+  }
+};
+
+Ring *threadRing() {
+  thread_local ThreadRing t_ring;
+  if (t_ring.ring == nullptr) {
+    t_ring.ring = LogSink::instance().registerRing();
+  }
+  return t_ring.ring;
+}
+
+}  // namespace
+
+void cvi_tdl_log_write(int level, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  LogSink &sink = LogSink::instance();
+  // Errors are written out directly, so they are never dropped nor held in a ring at a crash.
+  Ring *ring = sink.stopped() || level <= LOG_ERR ? nullptr : threadRing();
+  if (ring == nullptr) {
+    writeDirect(level, fmt, args);
+    va_end(args);
+    return;
+  }
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  if (head - tail == kRingSlots) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    va_end(args);
+    return;
+  }
+  Message &msg = ring->slots[head % kRingSlots];
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(msg.text, sizeof(msg.text), fmt, copy);
+  va_end(copy);
+  if (len >= (int)sizeof(msg.text)) {
+    // Too long for a slot, written out whole instead of truncated.
+    writeDirect(level, fmt, args);
+    va_end(args);
+    return;
+  }
+  va_end(args);
+  msg.level = level;
+  ring->head.store(head + 1, std::memory_order_release);
+  if (head == tail) {
+    sink.wake();
+  }
+}
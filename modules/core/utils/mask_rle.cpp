@@ -0,0 +1,318 @@
+#include "mask_rle.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cvitdl {
+
+namespace {
+
+struct RowSpan {
+  int32_t x0;
+  int32_t x1;  // exclusive
+};
+
+// Foreground runs split at row boundaries. Spans of row y are
+// spans[row_start[y], row_start[y + 1]).
+struct RowSpans {
+  int width = 0;
+  int height = 0;
+  std::vector<RowSpan> spans;
+  std::vector<int32_t> span_row;
+  std::vector<uint32_t> row_start;
+
+  void build(const uint32_t *counts, uint32_t size, int w, int h) {
+    width = w;
+    height = h;
+    spans.clear();
+    span_row.clear();
+    row_start.assign(h + 1, 0);
+    const uint32_t total = static_cast<uint32_t>(w) * h;
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < size && pos < total; i++) {
+      uint32_t end = std::min(pos + counts[i], total);
+      if (i % 2 == 1) {
+        while (pos < end) {
+          int y = pos / w;
+          int x0 = pos % w;
+          int x1 = std::min<uint32_t>(end - static_cast<uint32_t>(y) * w, w);
+          spans.push_back({x0, x1});
+          span_row.push_back(y);
+          row_start[y + 1]++;
+          pos = static_cast<uint32_t>(y) * w + x1;
+        }
+      }
+      pos = end;
+    }
+    for (int y = 0; y < h; y++) {
+      row_start[y + 1] += row_start[y];
+    }
+  }
+
+  bool isForeground(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+      return false;
+    }
+    const RowSpan *first = spans.data() + row_start[y];
+    const RowSpan *last = spans.data() + row_start[y + 1];
+    const RowSpan *it = std::upper_bound(
+        first, last, x, [](int v, const RowSpan &span) { return v < span.x0; });
+    return it != first && x < (it - 1)->x1;
+  }
+};
+
+int find_root(std::vector<int> &parent, int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+// Clockwise in image coordinates: E, SE, S, SW, W, NW, N, NE.
+const int kDirX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int kDirY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+// Direction index of the offset (dx, dy), indexed by (dy + 1) * 3 + (dx + 1).
+const int kOffsetDir[9] = {5, 6, 7, 4, -1, 0, 3, 2, 1};
+
+// Moore-neighbour tracing starting from the top-left pixel of a component, whose west, north-west,
+// north and north-east neighbours are background.
+void trace_outer(const RowSpans &rows, int sx, int sy, size_t max_steps, std::vector<int> *chain) {
+  chain->clear();
+  chain->push_back(sx);
+  chain->push_back(sy);
+  int px = sx, py = sy;
+  int backtrack = 4;
+  int first_dir = -1;
+  for (size_t step = 0; step < max_steps; step++) {
+    int dir = -1;
+    for (int k = 1; k <= 8; k++) {
+      int d = (backtrack + k) % 8;
+      if (rows.isForeground(px + kDirX[d], py + kDirY[d])) {
+        dir = d;
+        break;
+      }
+    }
+    if (dir < 0) {
+      return;  // isolated pixel
+    }
+    if (first_dir < 0) {
+      first_dir = dir;
+    } else if (px == sx && py == sy && dir == first_dir) {
+      chain->resize(chain->size() - 2);  // drop the repeated start point
+      return;
+    }
+    int prev = (dir + 7) % 8;
+    int cx = px + kDirX[prev], cy = py + kDirY[prev];
+    px += kDirX[dir];
+    py += kDirY[dir];
+    backtrack = kOffsetDir[(cy - py + 1) * 3 + (cx - px + 1)];
+    chain->push_back(px);
+    chain->push_back(py);
+  }
+}
+
+// Keep only the points where the chain changes direction.
+void compress_chain(const std::vector<int> &chain, std::vector<int> *points) {
+  points->clear();
+  size_t n = chain.size() / 2;
+  if (n <= 2) {
+    *points = chain;
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    size_t prev = (i + n - 1) % n, next = (i + 1) % n;
+    int in_x = chain[2 * i] - chain[2 * prev], in_y = chain[2 * i + 1] - chain[2 * prev + 1];
+    int out_x = chain[2 * next] - chain[2 * i], out_y = chain[2 * next + 1] - chain[2 * i + 1];
+    if (in_x != out_x || in_y != out_y) {
+      points->push_back(chain[2 * i]);
+      points->push_back(chain[2 * i + 1]);
+    }
+  }
+}
+
+}  // namespace
+
+void MaskRleEncoder::reset(int width, int height) {
+  m_width = width;
+  m_total = static_cast<uint32_t>(width) * height;
+  m_pos = 0;
+  m_counts.clear();
+}
+
+void MaskRleEncoder::addSpan(int y, int x0, int x1) {
+  if (x1 <= x0) {
+    return;
+  }
+  uint32_t start = static_cast<uint32_t>(y) * m_width + x0;
+  uint32_t end = static_cast<uint32_t>(y) * m_width + x1;
+  if (!m_counts.empty() && start == m_pos) {
+    m_counts.back() += end - start;
+  } else {
+    m_counts.push_back(start - m_pos);
+    m_counts.push_back(end - start);
+  }
+  m_pos = end;
+}
+
+void MaskRleEncoder::addRow(int y, const uint8_t *row) {
+  int x = 0;
+  const int width = m_width;
+  while (x < width) {
+    while (x < width && row[x] == 0) {
+      x++;
+    }
+    int x0 = x;
+    while (x < width && row[x] != 0) {
+      x++;
+    }
+    addSpan(y, x0, x);
+  }
+}
+
+void MaskRleEncoder::finish(std::vector<uint32_t> *counts) {
+  if (m_pos < m_total || m_counts.empty()) {
+    m_counts.push_back(m_total - m_pos);
+  }
+  counts->swap(m_counts);
+  m_counts.clear();
+}
+
+void rle_encode(const uint8_t *mask, int width, int height, std::vector<uint32_t> *counts) {
+  MaskRleEncoder encoder;
+  encoder.reset(width, height);
+  for (int y = 0; y < height; y++) {
+    encoder.addRow(y, mask + y * width);
+  }
+  encoder.finish(counts);
+}
+
+void rle_decode(const uint32_t *counts, uint32_t size, int width, int height, uint8_t *mask) {
+  const uint32_t total = static_cast<uint32_t>(width) * height;
+  memset(mask, 0, total);
+  uint32_t pos = 0;
+  for (uint32_t i = 0; i < size && pos < total; i++) {
+    uint32_t end = std::min(pos + counts[i], total);
+    if (i % 2 == 1) {
+      memset(mask + pos, 255, end - pos);
+    }
+    pos = end;
+  }
+}
+
+uint32_t rle_area(const uint32_t *counts, uint32_t size) {
+  uint32_t area = 0;
+  for (uint32_t i = 1; i < size; i += 2) {
+    area += counts[i];
+  }
+  return area;
+}
+
+bool rle_bbox(const uint32_t *counts, uint32_t size, int width, int *x1, int *y1, int *x2,
+              int *y2) {
+  int min_x = width, min_y = -1, max_x = -1, max_y = -1;
+  uint32_t pos = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    if (i % 2 == 1 && counts[i] > 0) {
+      uint32_t last = pos + counts[i] - 1;
+      int ys = pos / width, ye = last / width;
+      if (min_y < 0) {
+        min_y = ys;
+      }
+      max_y = ye;
+      if (ys == ye) {
+        min_x = std::min<int>(min_x, pos % width);
+        max_x = std::max<int>(max_x, last % width);
+      } else {
+        min_x = 0;
+        max_x = width - 1;
+      }
+    }
+    pos += counts[i];
+  }
+  if (max_y < 0) {
+    return false;
+  }
+  *x1 = min_x;
+  *y1 = min_y;
+  *x2 = max_x;
+  *y2 = max_y;
+  return true;
+}
+
+float rle_iou(const uint32_t *counts_a, uint32_t size_a, const uint32_t *counts_b,
+              uint32_t size_b) {
+  uint64_t area_a = rle_area(counts_a, size_a);
+  uint64_t area_b = rle_area(counts_b, size_b);
+  uint64_t inter = 0;
+  uint32_t ia = 0, ib = 0;
+  uint32_t ca = size_a > 0 ? counts_a[0] : 0;
+  uint32_t cb = size_b > 0 ? counts_b[0] : 0;
+  while (ia < size_a && ib < size_b) {
+    uint32_t c = std::min(ca, cb);
+    if ((ia & 1) && (ib & 1)) {
+      inter += c;
+    }
+    ca -= c;
+    cb -= c;
+    if (ca == 0 && ++ia < size_a) {
+      ca = counts_a[ia];
+    }
+    if (cb == 0 && ++ib < size_b) {
+      cb = counts_b[ib];
+    }
+  }
+  uint64_t uni = area_a + area_b - inter;
+  return uni == 0 ? 0.f : static_cast<float>(inter) / uni;
+}
+
+void rle_outer_contour(const uint32_t *counts, uint32_t size, int width, int height,
+                       std::vector<int> *points) {
+  points->clear();
+  RowSpans rows;
+  rows.build(counts, size, width, height);
+  const int num_spans = rows.spans.size();
+  if (num_spans == 0) {
+    return;
+  }
+
+  // Label 8-connected components on spans of adjacent rows.
+  std::vector<int> parent(num_spans);
+  std::iota(parent.begin(), parent.end(), 0);
+  for (int y = 1; y < height; y++) {
+    uint32_t a = rows.row_start[y - 1], a_end = rows.row_start[y];
+    uint32_t b = rows.row_start[y], b_end = rows.row_start[y + 1];
+    while (a < a_end && b < b_end) {
+      const RowSpan &sa = rows.spans[a];
+      const RowSpan &sb = rows.spans[b];
+      if (sa.x0 <= sb.x1 && sb.x0 <= sa.x1) {
+        int ra = find_root(parent, a), rb = find_root(parent, b);
+        if (ra != rb) {
+          parent[std::max(ra, rb)] = std::min(ra, rb);
+        }
+      }
+      if (sa.x1 < sb.x1) {
+        a++;
+      } else {
+        b++;
+      }
+    }
+  }
+
+  // The root is the lowest span index, i.e. the top-left pixel of the component.
+  const size_t max_steps = 4 * static_cast<size_t>(rle_area(counts, size)) + 8;
+  std::vector<int> chain, compressed;
+  for (int i = 0; i < num_spans; i++) {
+    if (find_root(parent, i) != i) {
+      continue;
+    }
+    trace_outer(rows, rows.spans[i].x0, rows.span_row[i], max_steps, &chain);
+    compress_chain(chain, &compressed);
+    if (compressed.size() > points->size()) {
+      points->swap(compressed);
+    }
+  }
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace cvitdl {
+
+// Row-major run-length encoding of a width x height binary mask. Run lengths alternate between
+// background and foreground and start with background, so counts[0] may be 0. Runs are allowed to
+// cross row boundaries.
+class MaskRleEncoder {
+ public:
+  void reset(int width, int height);
+  // Foreground span [x0, x1) on row y. Spans must be added in raster order without overlap.
+  void addSpan(int y, int x0, int x1);
+  // Append the foreground runs of row y, where row[x] != 0 is foreground.
+  void addRow(int y, const uint8_t *row);
+  void finish(std::vector<uint32_t> *counts);
+
+ private:
+  uint32_t m_width = 0;
+  uint32_t m_total = 0;
+  uint32_t m_pos = 0;  // end of the last foreground run
+  std::vector<uint32_t> m_counts;
+};
+
+void rle_encode(const uint8_t *mask, int width, int height, std::vector<uint32_t> *counts);
+// Write 255 for foreground and 0 for background.
+void rle_decode(const uint32_t *counts, uint32_t size, int width, int height, uint8_t *mask);
+
+uint32_t rle_area(const uint32_t *counts, uint32_t size);
+// Tight box of the foreground, x2 and y2 inclusive. Return false when the mask is empty.
+bool rle_bbox(const uint32_t *counts, uint32_t size, int width, int *x1, int *y1, int *x2,
+              int *y2);
+float rle_iou(const uint32_t *counts_a, uint32_t size_a, const uint32_t *counts_b,
+              uint32_t size_b);
+
+// Trace the outer boundary of every 8-connected component and return the one with the most
+// points as (x, y) pairs. Straight segments are compressed to their end points.
+void rle_outer_contour(const uint32_t *counts, uint32_t size, int width, int height,
+                       std::vector<int> *points);
+
+}  // namespace cvitdl
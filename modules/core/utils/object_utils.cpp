@@ -1,12 +1,12 @@
 
 #include "object_utils.hpp"
-#include "core/object/cvtdl_object_types.h"
 
 #include <math.h>
 #include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 using namespace std;
 
 namespace cvitdl {
@@ -34,16 +34,54 @@ static vector<size_t> calculate_area(const Detections &dets) {
 }
 
 Detections topk_dets(const Detections &dets, uint32_t max_det) {
-  vector<size_t> order = sort_indexes(dets);
+  size_t num_to_keep = std::min<size_t>(dets.size(), max_det);
+  vector<size_t> order(dets.size());
+  iota(order.begin(), order.end(), 0);
+  // ties keep their input order, as sort_indexes does
+  partial_sort(order.begin(), order.begin() + num_to_keep, order.end(),
+               [&dets](size_t i1, size_t i2) {
+                 return dets[i1]->score > dets[i2]->score ||
+                        (dets[i1]->score == dets[i2]->score && i1 < i2);
+               });
 
-  uint32_t num_to_keep = dets.size() > max_det ? max_det : dets.size();
   Detections final_dets(num_to_keep);
   for (size_t k = 0; k < num_to_keep; k++) {
-    final_dets[k] = dets[k];
+    final_dets[k] = dets[order[k]];
   }
   return final_dets;
 }
 
+Detections topk_per_class(const Detections &dets, uint32_t max_per_class) {
+  unordered_map<int, vector<size_t>> by_label;
+  for (size_t i = 0; i < dets.size(); i++) {
+    by_label[dets[i]->label].push_back(i);
+  }
+
+  vector<uint8_t> selected(dets.size(), 0);
+  for (auto &it : by_label) {
+    vector<size_t> &idx = it.second;
+    if (idx.size() > max_per_class) {
+      nth_element(idx.begin(), idx.begin() + max_per_class, idx.end(),
+                  [&dets](size_t i1, size_t i2) {
+                    return dets[i1]->score > dets[i2]->score ||
+                           (dets[i1]->score == dets[i2]->score && i1 < i2);
+                  });
+      idx.resize(max_per_class);
+    }
+    for (size_t i : idx) {
+      selected[i] = 1;
+    }
+  }
+
+  Detections kept;
+  for (size_t i = 0; i < dets.size(); i++) {
+    if (selected[i]) {
+      kept.push_back(dets[i]);
+    }
+  }
+  return kept;
+}
+
 Detections nms_multi_class(const Detections &dets, float iou_threshold) {
   vector<int> keep(dets.size(), 0);
   vector<int> suppressed(dets.size(), 0);
@@ -87,6 +125,21 @@ Detections nms_multi_class(const Detections &dets, float iou_threshold) {
   return final_dets;
 }
 
+Detections nms_multi_class(const Detections &dets, float iou_threshold, uint32_t max_candidates,
+                           uint32_t max_det) {
+  Detections final_dets;
+  if (max_candidates > 0 && dets.size() > max_candidates) {
+    final_dets = nms_multi_class(topk_per_class(dets, max_candidates), iou_threshold);
+  } else {
+    final_dets = nms_multi_class(dets, iou_threshold);
+  }
+  // nms output is sorted by score
+  if (max_det > 0 && final_dets.size() > max_det) {
+    final_dets.resize(max_det);
+  }
+  return final_dets;
+}
+
 Detections nms_multi_class_with_ids(const Detections &dets, float iou_threshold,
                                     vector<int> &keep) {
   vector<int> suppressed(dets.size(), 0);
@@ -17,7 +17,13 @@ typedef std::shared_ptr<object_detect_rect_t> PtrDectRect;
 typedef std::vector<PtrDectRect> Detections;
 
 Detections topk_dets(const Detections &dets, uint32_t max_det);
+// The max_per_class highest scoring detections of every label, in their input order.
+Detections topk_per_class(const Detections &dets, uint32_t max_per_class);
 Detections nms_multi_class(const Detections &dets, float iou_threshold);
+// NMS over at most max_candidates detections per label, keeping at most max_det results. 0
+// disables either limit.
+Detections nms_multi_class(const Detections &dets, float iou_threshold, uint32_t max_candidates,
+                           uint32_t max_det);
 Detections nms_multi_class_with_ids(const Detections &dets, float iou_threshold,
                                     std::vector<int> &keep);
 
@@ -1,12 +1,19 @@
 #include "profiler.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <sstream>
-double cal_time_elapsed(struct timeval &start, struct timeval &end) {
-  double sec = end.tv_sec - start.tv_sec + (end.tv_usec - start.tv_usec) / 1000000.;
-  return sec;
-}
 Timer::Timer(const std::string &name, int summary_cond_times)
-    : name_(name), summary_cond_times_(summary_cond_times) {}
+    : name_(name), summary_cond_times_(summary_cond_times) {
+#ifdef PERF_EVAL
+  bool enabled = true;
+#else
+  const char *env = getenv("TDL_LATENCY_STATS");
+  bool enabled = env != nullptr && atoi(env) != 0;
+#endif
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
 
 Timer::~Timer() {}
 
@@ -20,56 +27,90 @@ void Timer::Toc(int times) {
     Summary();
   }
 }
-void Timer::TicToc(const std::string &str_step) {
-#ifdef PERF_EVAL
-  if (step_name_vec_.size() > 0 && step_name_vec_[0] == str_step) {
-    for (auto &kv : step_time_) {
-      int step = kv.first;
-      int prev_step = step - 1;
-      if (step_time_.count(prev_step)) {
-        double ts = cal_time_elapsed(step_time_[prev_step], step_time_[step]);
-        if (step_time_elpased_.count(step) == 0) {
-          step_time_elpased_[step] = ts;
-        } else {
-          step_time_elpased_[step] += ts;
-        }
-      }
+
+int Timer::FindStage(const char *str_step, bool literal, int num_stages) const {
+  // Stages are marked in the same order every round, so the stage after the previous mark is
+  // usually the one.
+  for (int k = 0; literal && k < num_stages; k++) {
+    int i = (cursor_ + k) % num_stages;
+    if (stages_[i]->key == str_step) {
+      return i;
     }
-    times_ += 1;
-    if (times_ == summary_cond_times_) {
-      double total_ts = 0;
-      std::stringstream ss;
-      ss.precision(3);
-      ss << "[Timer] " << name_ << " ";
-      for (size_t i = 1; i < step_name_vec_.size(); i++) {
-        if (step_time_elpased_.count(i)) {
-          ss << step_name_vec_[i] << ":" << step_time_elpased_[i] * 1000 / times_ << ",";
-          total_ts += step_time_elpased_[i] * 1000 / times_;
-        }
-      }
-      ss << "total:" << total_ts;
-      std::cout << ss.str() << std::endl;
-      times_ = 0;
-      step_time_elpased_.clear();
+  }
+  for (int k = 0; k < num_stages; k++) {
+    int i = (cursor_ + k) % num_stages;
+    if (strcmp(stages_[i]->name, str_step) == 0) {
+      return i;
     }
-    step_time_.clear();
-    step_name_vec_.clear();
   }
-  for (size_t i = 1; i < step_name_vec_.size(); i++) {
-    if (step_name_vec_[i] == str_step) {
-      std::cout << "find duplicate name:" << str_step << std::endl;
+  return -1;
+}
+
+void Timer::TicToc(const char *str_step, bool literal) {
+  if (!enabled_.load(std::memory_order_relaxed)) {
+    round_start_ = 0;
+    return;
+  }
+  uint64_t now = cvitdl::monotonic_ns();
+  int num_stages = num_stages_.load(std::memory_order_relaxed);
+  int idx = FindStage(str_step, literal, num_stages);
+  if (idx < 0) {
+    // a truncated name would never match again and take a new stage on every mark
+    if (num_stages == kMaxStages || strlen(str_step) > kMaxStageName) {
       return;
     }
+    Stage *stage = new Stage();
+    stage->key = literal ? str_step : nullptr;
+    snprintf(stage->name, sizeof(stage->name), "%s", str_step);
+    stages_[num_stages].reset(stage);
+    idx = num_stages;
+    num_stages_.store(num_stages + 1, std::memory_order_release);
+  }
+  cursor_ = idx + 1;
+
+  if (idx == 0) {
+    if (round_start_ != 0 && last_mark_ > round_start_) {
+      total_.record(last_mark_ - round_start_);
+      if (summary_cond_times_ > 0 && ++rounds_ >= summary_cond_times_) {
+        Summary();
+      }
+    }
+    round_start_ = last_mark_ = now;
+    return;
   }
+  if (round_start_ == 0) {
+    // enabled in the middle of a round
+    return;
+  }
+  stages_[idx]->hist.record(now - last_mark_);
+  last_mark_ = now;
+}
 
-  struct timeval t;
-  gettimeofday(&t, NULL);
-  step_name_vec_.push_back(str_step);
-  int idx = int(step_name_vec_.size()) - 1;
-  step_time_[idx] = t;
+void Timer::EnableStats(bool enable) { enabled_.store(enable, std::memory_order_relaxed); }
 
-#endif
+bool Timer::MergeStats(const char *stage, cvitdl::LatencyHistogram *hist) const {
+  if (strcmp(stage, "total") == 0) {
+    hist->merge(total_);
+    return true;
+  }
+  int num_stages = num_stages_.load(std::memory_order_acquire);
+  for (int i = 0; i < num_stages; i++) {
+    if (strcmp(stages_[i]->name, stage) == 0) {
+      hist->merge(stages_[i]->hist);
+      return true;
+    }
+  }
+  return false;
+}
+
+void Timer::ResetStats() {
+  int num_stages = num_stages_.load(std::memory_order_acquire);
+  for (int i = 0; i < num_stages; i++) {
+    stages_[i]->hist.reset();
+  }
+  total_.reset();
 }
+
 void Timer::Config(const std::string &name, int summary_cond_times) {
   name_ = name;
   summary_cond_times_ = summary_cond_times;
@@ -77,10 +118,26 @@ void Timer::Config(const std::string &name, int summary_cond_times) {
 
 void Timer::Summary() {
 #ifdef PERF_EVAL
-  std::cout << "[Timer] " << name_ << " " << 1000 * total_time_ / times_ << "ms" << std::endl;
+  if (rounds_ > 0) {
+    std::stringstream ss;
+    ss.precision(3);
+    ss << "[Timer] " << name_ << " p50/p99 ms ";
+    int num_stages = num_stages_.load(std::memory_order_acquire);
+    cvitdl::LatencyStats stats;
+    for (int i = 1; i < num_stages; i++) {
+      stages_[i]->hist.stats(&stats);
+      ss << stages_[i]->name << ":" << stats.p50_us / 1000 << "/" << stats.p99_us / 1000 << ",";
+    }
+    total_.stats(&stats);
+    ss << "total:" << stats.p50_us / 1000 << "/" << stats.p99_us / 1000;
+    std::cout << ss.str() << std::endl;
+  } else {
+    std::cout << "[Timer] " << name_ << " " << 1000 * total_time_ / times_ << "ms" << std::endl;
+  }
 #endif
   total_time_ = 0.;
   times_ = 0;
+  rounds_ = 0;
 }
 
 /* =========================================== */
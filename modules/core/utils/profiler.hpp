@@ -1,8 +1,12 @@
 #pragma once
+#include <pthread.h>
 #include <sys/time.h>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
+#include "latency_histogram.hpp"
 double get_cur_time_usecs();
 double get_cur_time_millisecs();
 class Timer {
@@ -13,10 +17,34 @@ class Timer {
   void Tic();
   void Toc(int times = 1);
   void Config(const std::string &name, int summary_cond_times = 100);
-  void TicToc(const std::string &str_step);
+
+  static constexpr size_t kMaxStageName = 31;
+
+  // Mark the end of stage str_step. The first name ever marked opens every round, each later mark
+  // records the span since the previous one into the histogram of its stage, and "total" gets the
+  // span of the whole round when the next round opens. Does nothing while disabled. Stages are
+  // matched by pointer first when str_step is a literal, pass false for names in caller buffers.
+  // Names longer than kMaxStageName are ignored.
+  void TicToc(const char *str_step, bool literal = true);
+
+  // Recording is enabled by PERF_EVAL builds or the TDL_LATENCY_STATS=1 environment variable.
+  void EnableStats(bool enable);
+  bool StatsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+  int SummaryInterval() const { return summary_cond_times_; }
+  // Add the histogram of stage to hist. Return false if stage has never been marked.
+  bool MergeStats(const char *stage, cvitdl::LatencyHistogram *hist) const;
+  void ResetStats();
 
  private:
+  static constexpr int kMaxStages = 16;
+  struct Stage {
+    const char *key;  // literal passed by the caller, compared before the name
+    char name[kMaxStageName + 1];
+    cvitdl::LatencyHistogram hist;
+  };
+
   void Summary();
+  int FindStage(const char *str_step, bool literal, int num_stages) const;
 
  private:
   std::string name_;
@@ -26,9 +54,18 @@ class Timer {
   int times_ = 0;
   int summary_cond_times_;
 
-  std::map<int, struct timeval> step_time_;
-  std::vector<std::string> step_name_vec_;
-  std::map<int, double> step_time_elpased_;
+  // Stages are only appended, and readers see those published by num_stages_.
+  std::atomic<bool> enabled_;
+  std::atomic<int> num_stages_{0};
+  std::unique_ptr<Stage> stages_[kMaxStages];
+  cvitdl::LatencyHistogram total_;
+  // Round state is only touched by the marking thread, which is safe because models mark from
+  // inference calls holding their instance exclusively (see ModelLease) and apps mark from the
+  // thread running them.
+  uint64_t round_start_ = 0;
+  uint64_t last_mark_ = 0;
+  int cursor_ = 0;
+  int rounds_ = 0;
 };
 
 class FpsProfiler {
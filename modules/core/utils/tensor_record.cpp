@@ -0,0 +1,158 @@
+#include "tensor_record.hpp"
+
+#include <string.h>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+
+namespace {
+
+const char kMagic[4] = {'C', 'V', 'T', 'R'};
+const uint32_t kVersion = 1;
+const uint32_t kMaxDims = 8;
+const uint32_t kMaxNameLen = 4096;
+// larger buffers are taken as a corrupt record, inputs hold a layout only and allocate mem_size
+const uint64_t kMaxTensorBytes = 256ULL << 20;
+// name_len, fmt, dim_size, qscale, count, mem_size and data_size of a tensor without name or data
+const uint64_t kMinTensorBytes = 4 + 4 + 4 + 4 + 8 + 8 + 8;
+
+uint64_t bytes_left(FILE *fp, uint64_t file_size) {
+  long pos = ftell(fp);
+  return pos < 0 || (uint64_t)pos > file_size ? 0 : file_size - pos;
+}
+
+template <typename T>
+bool put(FILE *fp, const T &v) {
+  return fwrite(&v, sizeof(T), 1, fp) == 1;
+}
+
+template <typename T>
+bool get(FILE *fp, T *v) {
+  return fread(v, sizeof(T), 1, fp) == 1;
+}
+
+bool put_tensor(FILE *fp, const TensorRecord &t) {
+  uint32_t name_len = t.name.size();
+  uint32_t dim_size = t.dims.size();
+  uint64_t data_size = t.data.size();
+  bool ok = put(fp, name_len) && fwrite(t.name.data(), 1, name_len, fp) == name_len &&
+            put(fp, t.fmt) && put(fp, dim_size);
+  for (uint32_t i = 0; ok && i < dim_size; i++) {
+    ok = put(fp, t.dims[i]);
+  }
+  ok = ok && put(fp, t.qscale) && put(fp, t.count) && put(fp, t.mem_size) && put(fp, data_size);
+  return ok && (data_size == 0 || fwrite(t.data.data(), 1, data_size, fp) == data_size);
+}
+
+// Sizes are checked against the rest of the file before anything is allocated, so a corrupt
+// record fails to parse instead of running out of memory.
+bool get_tensor(FILE *fp, uint64_t file_size, TensorRecord *t) {
+  uint32_t name_len, dim_size;
+  uint64_t data_size;
+  if (!get(fp, &name_len) || name_len > kMaxNameLen || name_len > bytes_left(fp, file_size)) {
+    return false;
+  }
+  t->name.resize(name_len);
+  if (fread(&t->name[0], 1, name_len, fp) != name_len || !get(fp, &t->fmt) ||
+      !get(fp, &dim_size) || dim_size > kMaxDims) {
+    return false;
+  }
+  t->dims.resize(dim_size);
+  for (uint32_t i = 0; i < dim_size; i++) {
+    if (!get(fp, &t->dims[i])) {
+      return false;
+    }
+  }
+  if (!get(fp, &t->qscale) || !get(fp, &t->count) || !get(fp, &t->mem_size) ||
+      !get(fp, &data_size) || t->mem_size > kMaxTensorBytes || data_size > t->mem_size ||
+      data_size > bytes_left(fp, file_size)) {
+    return false;
+  }
+  t->data.resize(data_size);
+  return data_size == 0 || fread(t->data.data(), 1, data_size, fp) == data_size;
+}
+
+bool same_layout(const std::vector<TensorRecord> &a, const std::vector<TensorRecord> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].name != b[i].name || a[i].fmt != b[i].fmt || a[i].dims != b[i].dims ||
+        a[i].mem_size != b[i].mem_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int write_tensor_record(FILE *fp, const TensorRecordFrame &frame) {
+  uint32_t num_inputs = frame.inputs.size();
+  uint32_t num_outputs = frame.outputs.size();
+  bool ok = fwrite(kMagic, 1, 4, fp) == 4 && put(fp, kVersion) && put(fp, num_inputs) &&
+            put(fp, num_outputs);
+  for (size_t i = 0; ok && i < frame.inputs.size(); i++) {
+    ok = put_tensor(fp, frame.inputs[i]);
+  }
+  for (size_t i = 0; ok && i < frame.outputs.size(); i++) {
+    ok = put_tensor(fp, frame.outputs[i]);
+  }
+  if (!ok) {
+    LOGE("failed to write tensor record\n");
+    return CVI_TDL_FAILURE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int read_tensor_records(const char *path, std::vector<TensorRecordFrame> *frames) {
+  FILE *fp = fopen(path, "rb");
+  if (fp == nullptr) {
+    LOGE("cannot open tensor record: %s\n", path);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  frames->clear();
+  uint64_t file_size = 0;
+  if (fseek(fp, 0, SEEK_END) == 0) {
+    long end = ftell(fp);
+    file_size = end > 0 ? end : 0;
+  }
+  rewind(fp);
+  int ret = CVI_TDL_SUCCESS;
+  char magic[4];
+  while (fread(magic, 1, 4, fp) == 4) {
+    uint32_t version, num_inputs, num_outputs;
+    if (memcmp(magic, kMagic, 4) != 0 || !get(fp, &version) || version != kVersion ||
+        !get(fp, &num_inputs) || !get(fp, &num_outputs) ||
+        ((uint64_t)num_inputs + num_outputs) * kMinTensorBytes > bytes_left(fp, file_size)) {
+      ret = CVI_TDL_FAILURE;
+      break;
+    }
+    TensorRecordFrame frame;
+    frame.inputs.resize(num_inputs);
+    frame.outputs.resize(num_outputs);
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < num_inputs; i++) {
+      ok = get_tensor(fp, file_size, &frame.inputs[i]);
+    }
+    for (uint32_t i = 0; ok && i < num_outputs; i++) {
+      ok = get_tensor(fp, file_size, &frame.outputs[i]);
+    }
+    if (!ok || (!frames->empty() && (!same_layout(frames->front().inputs, frame.inputs) ||
+                                     !same_layout(frames->front().outputs, frame.outputs)))) {
+      ret = CVI_TDL_FAILURE;
+      break;
+    }
+    frames->push_back(std::move(frame));
+  }
+  fclose(fp);
+  if (ret != CVI_TDL_SUCCESS || frames->empty()) {
+    LOGE("invalid tensor record: %s, frame %zu\n", path, frames->size());
+    frames->clear();
+    return CVI_TDL_FAILURE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace cvitdl {
+
+// One tensor as seen by post-processing. fmt holds the runtime's CVI_FMT value.
+struct TensorRecord {
+  std::string name;
+  int32_t fmt;
+  std::vector<int32_t> dims;
+  float qscale;
+  uint64_t count;             // number of elements
+  uint64_t mem_size;          // bytes of the tensor buffer
+  std::vector<uint8_t> data;  // empty when only the layout was recorded
+};
+
+// Tensors of one inference. Inputs carry their layout only, outputs their data as well.
+struct TensorRecordFrame {
+  std::vector<TensorRecord> inputs;
+  std::vector<TensorRecord> outputs;
+};
+
+/**
+ * @brief Append frame to a tensor record file opened for binary writing.
+ *
+ * A record file is a sequence of frames, each starting with the magic "CVTR" and a version, so
+ * one file collects a whole recording session.
+ */
+int write_tensor_record(FILE *fp, const TensorRecordFrame &frame);
+
+// Read every frame of a tensor record file, all frames must share their tensor layout.
+int read_tensor_records(const char *path, std::vector<TensorRecordFrame> *frames);
+
+}  // namespace cvitdl
@@ -0,0 +1,209 @@
+#include "text_region.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+namespace cvitdl {
+
+namespace {
+
+struct Run {
+  int y;
+  int x0;
+  int x1;  // exclusive
+  float sum;
+};
+
+struct Point {
+  int64_t x;
+  int64_t y;
+};
+
+int find_root(std::vector<int> &parent, int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+int64_t cross(const Point &o, const Point &a, const Point &b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Andrew's monotone chain, counter-clockwise without collinear points.
+void convex_hull(std::vector<Point> *points, std::vector<Point> *hull) {
+  std::vector<Point> &p = *points;
+  std::sort(p.begin(), p.end(),
+            [](const Point &a, const Point &b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+  p.erase(std::unique(p.begin(), p.end(),
+                      [](const Point &a, const Point &b) { return a.x == b.x && a.y == b.y; }),
+          p.end());
+  hull->assign(2 * p.size(), Point());
+  size_t k = 0;
+  for (size_t i = 0; i < p.size(); i++) {
+    while (k >= 2 && cross((*hull)[k - 2], (*hull)[k - 1], p[i]) <= 0) k--;
+    (*hull)[k++] = p[i];
+  }
+  for (size_t i = p.size() - 1, t = k + 1; i > 0; i--) {
+    while (k >= t && cross((*hull)[k - 2], (*hull)[k - 1], p[i - 1]) <= 0) k--;
+    (*hull)[k++] = p[i - 1];
+  }
+  hull->resize(k > 1 ? k - 1 : k);
+}
+
+// Rotating the frame to every hull edge finds the minimum area rectangle, which has a side on one
+// of them.
+void min_area_rect(const std::vector<Point> &hull, float unclip_ratio, TextRegion *region) {
+  float best_area = INFINITY;
+  float ux = 1, uy = 0, min_u = 0, max_u = 0, min_v = 0, max_v = 0;
+  for (size_t i = 0; i < hull.size(); i++) {
+    const Point &a = hull[i];
+    const Point &b = hull[(i + 1) % hull.size()];
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len == 0) {
+      continue;
+    }
+    dx /= len;
+    dy /= len;
+    float u0 = INFINITY, u1 = -INFINITY, v0 = INFINITY, v1 = -INFINITY;
+    for (const Point &p : hull) {
+      float u = p.x * dx + p.y * dy;
+      float v = -p.x * dy + p.y * dx;
+      u0 = std::min(u0, u);
+      u1 = std::max(u1, u);
+      v0 = std::min(v0, v);
+      v1 = std::max(v1, v);
+    }
+    float area = (u1 - u0) * (v1 - v0);
+    if (area < best_area) {
+      best_area = area;
+      ux = dx;
+      uy = dy;
+      min_u = u0;
+      max_u = u1;
+      min_v = v0;
+      max_v = v1;
+    }
+  }
+
+  float w = max_u - min_u, h = max_v - min_v;
+  if (unclip_ratio > 0 && w + h > 0) {
+    float d = w * h * unclip_ratio / (2 * (w + h));
+    min_u -= d;
+    max_u += d;
+    min_v -= d;
+    max_v += d;
+  }
+  const float us[4] = {min_u, max_u, max_u, min_u};
+  const float vs[4] = {min_v, min_v, max_v, max_v};
+  for (int i = 0; i < 4; i++) {
+    region->pts_x[i] = us[i] * ux - vs[i] * uy;
+    region->pts_y[i] = us[i] * uy + vs[i] * ux;
+  }
+  region->x1 = *std::min_element(region->pts_x, region->pts_x + 4);
+  region->x2 = *std::max_element(region->pts_x, region->pts_x + 4);
+  region->y1 = *std::min_element(region->pts_y, region->pts_y + 4);
+  region->y2 = *std::max_element(region->pts_y, region->pts_y + 4);
+}
+
+inline float dequant(float v, float) { return v; }
+inline float dequant(int8_t v, float qscale) { return v * qscale; }
+
+template <typename T, typename G>
+void extract_impl(const T *prob, float qscale, G gate, int width, int height, int stride,
+                  const TextRegionParam &param, std::vector<TextRegion> *regions) {
+  regions->clear();
+  std::vector<Run> runs;
+  std::vector<int> parent;
+  size_t prev_begin = 0, prev_end = 0;
+  for (int y = 0; y < height; y++) {
+    const T *row = prob + (size_t)y * stride;
+    size_t cur_begin = runs.size();
+    for (int x = 0; x < width;) {
+      if (!(row[x] > gate)) {
+        x++;
+        continue;
+      }
+      Run r = {y, x, x, 0.f};
+      for (; x < width && row[x] > gate; x++) {
+        r.sum += dequant(row[x], qscale);
+      }
+      r.x1 = x;
+      runs.push_back(r);
+      parent.push_back(runs.size() - 1);
+    }
+    size_t cur_end = runs.size();
+
+    // Runs of consecutive rows touch, diagonals included, when [x0, x1] ranges overlap.
+    size_t i = prev_begin, j = cur_begin;
+    while (i < prev_end && j < cur_end) {
+      if (runs[i].x0 <= runs[j].x1 && runs[j].x0 <= runs[i].x1) {
+        int a = find_root(parent, i), b = find_root(parent, j);
+        if (a != b) {
+          parent[std::max(a, b)] = std::min(a, b);
+        }
+      }
+      if (runs[i].x1 < runs[j].x1) {
+        i++;
+      } else {
+        j++;
+      }
+    }
+    prev_begin = cur_begin;
+    prev_end = cur_end;
+  }
+
+  std::vector<int> region_of(runs.size(), -1);
+  std::vector<std::vector<Point>> corners;
+  std::vector<float> sums;
+  std::vector<int> areas;
+  for (size_t r = 0; r < runs.size(); r++) {
+    int root = find_root(parent, r);
+    if (region_of[root] < 0) {
+      region_of[root] = corners.size();
+      corners.emplace_back();
+      sums.push_back(0);
+      areas.push_back(0);
+    }
+    int k = region_of[root];
+    const Run &run = runs[r];
+    corners[k].push_back({run.x0, run.y});
+    corners[k].push_back({run.x1, run.y});
+    corners[k].push_back({run.x0, run.y + 1});
+    corners[k].push_back({run.x1, run.y + 1});
+    sums[k] += run.sum;
+    areas[k] += run.x1 - run.x0;
+  }
+
+  std::vector<Point> hull;
+  for (size_t k = 0; k < corners.size(); k++) {
+    if (areas[k] < param.min_area) {
+      continue;
+    }
+    TextRegion region;
+    convex_hull(&corners[k], &hull);
+    min_area_rect(hull, param.unclip_ratio, &region);
+    region.score = sums[k] / areas[k];
+    region.area = areas[k];
+    regions->push_back(region);
+  }
+}
+
+}  // namespace
+
+void extract_text_regions(const float *prob, int width, int height, int stride,
+                          const TextRegionParam &param, std::vector<TextRegion> *regions) {
+  extract_impl(prob, 1.f, param.thresh, width, height, stride, param, regions);
+}
+
+void extract_text_regions(const int8_t *prob, float qscale, int width, int height, int stride,
+                          const TextRegionParam &param, std::vector<TextRegion> *regions) {
+  // q * qscale > thresh holds exactly for q > floor(thresh / qscale)
+  float q = qscale > 0 ? floorf(param.thresh / qscale) : 127.f;
+  int gate = (int)std::min(127.f, std::max(-129.f, q));
+  extract_impl(prob, qscale, gate, width, height, stride, param, regions);
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace cvitdl {
+
+struct TextRegionParam {
+  float thresh;        // binarization threshold of the probability map
+  int min_area;        // regions with fewer pixels are dropped
+  float unclip_ratio;  // DBNet unclip ratio, 0 keeps the shrunk region
+};
+
+struct TextRegion {
+  // Minimum area rotated rectangle after unclipping, corners in order around the rectangle.
+  float pts_x[4];
+  float pts_y[4];
+  // Axis aligned bounds of the corners.
+  float x1, y1, x2, y2;
+  float score;  // mean probability of the region
+  int area;     // number of pixels
+};
+
+/**
+ * @brief Extract the text regions of a height x width DBNet probability map with row stride
+ * stride, in map coordinates.
+ *
+ * Pixels are thresholded in the map's own domain, grouped into 8-connected regions from their row
+ * runs, and every region's minimum area rectangle is enlarged by area * unclip_ratio / perimeter
+ * on each side, the closed form of DBNet's polygon offset for a rectangle.
+ */
+void extract_text_regions(const float *prob, int width, int height, int stride,
+                          const TextRegionParam &param, std::vector<TextRegion> *regions);
+void extract_text_regions(const int8_t *prob, float qscale, int width, int height, int stride,
+                          const TextRegionParam &param, std::vector<TextRegion> *regions);
+
+}  // namespace cvitdl
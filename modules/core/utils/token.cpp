@@ -1,248 +1,382 @@
 #include "token.hpp"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
 #include <algorithm>
-#include <cassert>
+#include <climits>
 #include <fstream>
-#include <iostream>
-#include <regex>
-#include <set>
+#include <map>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+#define BPE_BINARY_MAGIC "CVIBPE01"
+#define BPE_NUM_MERGES 48894
+#define BPE_MAX_CACHE_WORDS 16384
+
 namespace cvitdl {
-std::set<std::pair<std::string, std::string>> get_pairs(const std::vector<std::string>& word) {
-  std::set<std::pair<std::string, std::string>> pairs;
-  std::string prev_char = word[0];
-  for (size_t i = 1; i < word.size(); ++i) {
-    pairs.insert(std::make_pair(prev_char, word[i]));
-    prev_char = word[i];
-  }
-  return pairs;
+
+static const char *kSpecialChars = "@#$%^&*!";
+static const char *kContractions[] = {"'s", "'t", "'re", "'ve", "'m", "'ll", "'d"};
+
+int32_t BpeTokenizer::intern(const std::string &str) {
+  auto it = m_symbol_ids.find(str);
+  if (it != m_symbol_ids.end()) {
+    return it->second;
+  }
+  int32_t id = m_symbols.size();
+  m_symbols.push_back(str);
+  m_symbol_token.push_back(0);
+  m_symbol_ids.emplace(str, id);
+  return id;
+}
+
+int32_t BpeTokenizer::findSymbol(const std::string &str) const {
+  auto it = m_symbol_ids.find(str);
+  return it == m_symbol_ids.end() ? -1 : it->second;
 }
 
-struct pair_hash {
-  template <class T1, class T2>
-  std::size_t operator()(const std::pair<T1, T2>& pair) const {
-    return std::hash<T1>()(pair.first) ^ std::hash<T2>()(pair.second);
+void BpeTokenizer::finalize() {
+  m_merge_table.clear();
+  m_merge_table.reserve(m_merges.size());
+  for (size_t rank = 0; rank < m_merges.size(); rank++) {
+    int32_t left = m_merges[rank].first;
+    int32_t right = m_merges[rank].second;
+    int32_t merged = intern(m_symbols[left] + m_symbols[right]);
+    m_merge_table.emplace(pairKey(left, right), MergeEntry{static_cast<int32_t>(rank), merged});
+  }
+  for (int c = 0; c < 256; c++) {
+    std::string ch(1, static_cast<char>(c));
+    m_char_symbol[c] = intern(ch);
+    m_char_end_symbol[c] = intern(ch + "</w>");
   }
-};
+  int32_t start = findSymbol("<start_of_text>");
+  int32_t end = findSymbol("<end_of_text>");
+  m_start_token = start < 0 ? 0 : m_symbol_token[start];
+  m_end_token = end < 0 ? 0 : m_symbol_token[end];
 
-std::unordered_map<std::pair<std::string, std::string>, int, pair_hash> create_pairs_map(
-    const std::string& filename, int start_line, int end_line) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    std::cerr << "Error opening file." << std::endl;
-    return {};
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  m_cache.clear();
+}
+
+int BpeTokenizer::load(const std::string &encoder_file, const std::string &bpe_file) {
+  if (bpe_file.empty()) {
+    return loadBinary(encoder_file);
+  }
+  std::ifstream encoder(encoder_file);
+  if (!encoder.is_open()) {
+    LOGE("Cannot open vocabulary file %s\n", encoder_file.c_str());
+    return CVI_TDL_FAILURE;
   }
+  m_symbols.clear();
+  m_symbol_token.clear();
+  m_symbol_ids.clear();
+  m_merges.clear();
 
   std::string line;
-  std::vector<std::pair<std::string, std::string>> pairs;
-  int line_count = 0;
-
-  while (std::getline(file, line) && line_count < end_line) {
-    ++line_count;
-    if (line_count >= start_line) {
-      std::istringstream iss(line);
-      std::string word1, word2;
-      iss >> word1 >> word2;
-      pairs.emplace_back(word1, word2);
+  while (std::getline(encoder, line)) {
+    size_t pos = line.find(": ");
+    if (pos == std::string::npos) {
+      LOGW("Invalid vocabulary line: %s\n", line.c_str());
+      continue;
     }
+    int32_t sym = intern(line.substr(0, pos));
+    m_symbol_token[sym] = atoi(line.c_str() + pos + 2);
   }
 
-  file.close();
-
-  std::unordered_map<std::pair<std::string, std::string>, int, pair_hash> pairs_map;
-  int value = 0;
-  for (const auto& pair : pairs) {
-    pairs_map[pair] = value;
-    ++value;
+  std::ifstream merges(bpe_file);
+  if (!merges.is_open()) {
+    LOGE("Cannot open bpe file %s\n", bpe_file.c_str());
+    m_symbols.clear();
+    return CVI_TDL_FAILURE;
+  }
+  // The first line is a version header.
+  std::getline(merges, line);
+  m_merges.reserve(BPE_NUM_MERGES);
+  while (m_merges.size() < BPE_NUM_MERGES && std::getline(merges, line)) {
+    std::istringstream iss(line);
+    std::string left, right;
+    iss >> left >> right;
+    m_merges.emplace_back(intern(left), intern(right));
   }
+  finalize();
+  LOGI("Loaded bpe tokenizer: %zu symbols, %zu merges\n", m_symbols.size(), m_merges.size());
+  return CVI_TDL_SUCCESS;
+}
 
-  return pairs_map;
+int BpeTokenizer::saveBinary(const std::string &file) const {
+  FILE *fp = fopen(file.c_str(), "wb");
+  if (fp == nullptr) {
+    LOGE("Cannot open %s for writing\n", file.c_str());
+    return CVI_TDL_FAILURE;
+  }
+  uint32_t num_symbols = m_symbols.size();
+  uint32_t num_merges = m_merges.size();
+  fwrite(BPE_BINARY_MAGIC, 1, strlen(BPE_BINARY_MAGIC), fp);
+  fwrite(&num_symbols, sizeof(num_symbols), 1, fp);
+  fwrite(&num_merges, sizeof(num_merges), 1, fp);
+  for (uint32_t i = 0; i < num_symbols; i++) {
+    uint16_t len = m_symbols[i].size();
+    fwrite(&len, sizeof(len), 1, fp);
+    fwrite(m_symbols[i].data(), 1, len, fp);
+    fwrite(&m_symbol_token[i], sizeof(int32_t), 1, fp);
+  }
+  for (const auto &merge : m_merges) {
+    fwrite(&merge.first, sizeof(int32_t), 1, fp);
+    fwrite(&merge.second, sizeof(int32_t), 1, fp);
+  }
+  bool ok = ferror(fp) == 0;
+  fclose(fp);
+  return ok ? CVI_TDL_SUCCESS : CVI_TDL_FAILURE;
 }
 
-void mergePairs(
-    std::vector<std::string>& word, std::set<std::pair<std::string, std::string>>& pairs,
-    const std::unordered_map<std::pair<std::string, std::string>, int, pair_hash>& bpe_ranks) {
-  while (true) {
-    std::pair<std::string, std::string> bigram;
-
-    if (pairs.size() > 1) {
-      bigram = *std::min_element(pairs.begin(), pairs.end(),
-                                 [&bpe_ranks](const std::pair<std::string, std::string>& pair1,
-                                              const std::pair<std::string, std::string>& pair2) {
-                                   int pair1Value = bpe_ranks.find(pair1) != bpe_ranks.end()
-                                                        ? bpe_ranks.at(pair1)
-                                                        : std::numeric_limits<int>::max();
-                                   int pair2Value = bpe_ranks.find(pair2) != bpe_ranks.end()
-                                                        ? bpe_ranks.at(pair2)
-                                                        : std::numeric_limits<int>::max();
-                                   return pair1Value < pair2Value;
-                                 });
-    } else {
-      bigram = *pairs.begin();
+int BpeTokenizer::loadBinary(const std::string &file) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in.is_open()) {
+    LOGE("Cannot open tokenizer file %s\n", file.c_str());
+    return CVI_TDL_FAILURE;
+  }
+  std::vector<char> buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  size_t pos = 0;
+  auto read = [&](void *dst, size_t size) {
+    if (pos + size > buf.size()) {
+      return false;
     }
+    memcpy(dst, buf.data() + pos, size);
+    pos += size;
+    return true;
+  };
 
-    if (bpe_ranks.find(bigram) == bpe_ranks.end()) {
+  char magic[sizeof(BPE_BINARY_MAGIC) - 1];
+  uint32_t num_symbols = 0, num_merges = 0;
+  if (!read(magic, sizeof(magic)) || memcmp(magic, BPE_BINARY_MAGIC, sizeof(magic)) != 0 ||
+      !read(&num_symbols, sizeof(num_symbols)) || !read(&num_merges, sizeof(num_merges))) {
+    LOGE("%s is not a bpe tokenizer file\n", file.c_str());
+    return CVI_TDL_FAILURE;
+  }
+
+  m_symbols.clear();
+  m_symbol_token.clear();
+  m_symbol_ids.clear();
+  m_merges.clear();
+  m_symbols.reserve(num_symbols);
+  m_symbol_token.reserve(num_symbols);
+  m_symbol_ids.reserve(num_symbols);
+  for (uint32_t i = 0; i < num_symbols; i++) {
+    uint16_t len = 0;
+    int32_t token = 0;
+    if (!read(&len, sizeof(len)) || pos + len > buf.size()) {
       break;
     }
+    std::string str(buf.data() + pos, len);
+    pos += len;
+    if (!read(&token, sizeof(token))) {
+      break;
+    }
+    m_symbol_token[intern(str)] = token;
+  }
+  m_merges.reserve(num_merges);
+  for (uint32_t i = 0; i < num_merges; i++) {
+    int32_t left = 0, right = 0;
+    if (!read(&left, sizeof(left)) || !read(&right, sizeof(right))) {
+      break;
+    }
+    m_merges.emplace_back(left, right);
+  }
+  if (m_symbols.size() != num_symbols || m_merges.size() != num_merges) {
+    LOGE("Truncated tokenizer file %s\n", file.c_str());
+    m_symbols.clear();
+    return CVI_TDL_FAILURE;
+  }
+  finalize();
+  return CVI_TDL_SUCCESS;
+}
 
-    std::string first = bigram.first;
-    std::string second = bigram.second;
-    std::vector<std::string> new_word;
-    size_t i = 0;
-
-    while (i < word.size()) {
-      try {
-        auto it = std::find(word.begin() + i, word.end(), first);
-        if (it == word.end()) {
-          new_word.insert(new_word.end(), word.begin() + i, word.end());
+// Same split as the CLIP pattern
+// [@#$%^&*!]|'s|'t|'re|'ve|'m|'ll|'d|[[:alpha:]]+|[[:digit:]]|[^[:space:][:alpha:][:digit:]]+
+void BpeTokenizer::splitWords(const std::string &text, std::vector<std::string> *words) const {
+  size_t n = text.size();
+  size_t i = 0;
+  while (i < n) {
+    unsigned char c = text[i];
+    if (isspace(c)) {
+      i++;
+      continue;
+    }
+    if (c != '\0' && strchr(kSpecialChars, c) != nullptr) {
+      words->emplace_back(1, static_cast<char>(c));
+      i++;
+      continue;
+    }
+    if (c == '\'') {
+      bool matched = false;
+      for (const char *contraction : kContractions) {
+        size_t len = strlen(contraction);
+        if (text.compare(i, len, contraction) == 0) {
+          words->emplace_back(text, i, len);
+          i += len;
+          matched = true;
           break;
         }
-        size_t j = std::distance(word.begin(), it);
-        new_word.insert(new_word.end(), word.begin() + i, word.begin() + j);
-        i = j;
-      } catch (...) {
-        new_word.insert(new_word.end(), word.begin() + i, word.end());
-        break;
       }
-
-      if (word[i] == first && i < word.size() - 1 && word[i + 1] == second) {
-        new_word.push_back(first + second);
-        i += 2;
-      } else {
-        new_word.push_back(word[i]);
-        i += 1;
+      if (matched) {
+        continue;
       }
     }
-    word = new_word;
-    if (word.size() == 1) {
-      break;
-    } else {
-      pairs.clear();
-      auto new_pairs = get_pairs(word);
-      pairs.insert(new_pairs.begin(), new_pairs.end());
+    size_t j = i + 1;
+    if (isalpha(c)) {
+      while (j < n && isalpha(static_cast<unsigned char>(text[j]))) j++;
+    } else if (!isdigit(c)) {
+      while (j < n) {
+        unsigned char cj = text[j];
+        if (isspace(cj) || isalpha(cj) || isdigit(cj)) break;
+        j++;
+      }
     }
+    words->emplace_back(text, i, j - i);
+    i = j;
   }
 }
 
-void readVocab(const char* fp, std::unordered_map<std::string, uint32_t>& vocab) {
-  std::ifstream file(fp);
-  if (!file) {
-    std::cerr << "Cannot open vocabulary file " << fp << std::endl;
-    exit(EXIT_FAILURE);
+const std::vector<int32_t> &BpeTokenizer::bpe(const std::string &word) {
+  auto cached = m_cache.find(word);
+  if (cached != m_cache.end()) {
+    return cached->second;
   }
-  std::cerr << "Loading vocabulary from " << fp << " ..." << std::endl;
-  std::string line;
-  while (std::getline(file, line)) {
-    // Split the line by ": "
-    size_t pos = line.find(": ");
-    if (pos == std::string::npos) {
-      std::cerr << "Invalid line format: " << line << std::endl;
-      continue;
-    }
-    std::string word = line.substr(0, pos);
-    int count = stoi(line.substr(pos + 2));
 
-    vocab[word] = count;
+  std::vector<int32_t> symbols(word.size());
+  for (size_t i = 0; i < word.size(); i++) {
+    unsigned char c = word[i];
+    symbols[i] = (i + 1 == word.size()) ? m_char_end_symbol[c] : m_char_symbol[c];
   }
-  std::cerr << "Read " << vocab.size() << " words from vocabulary file." << std::endl;
-}
 
-std::vector<std::string> split_word(const std::string& token) {
-  std::vector<std::string> word;
-  for (size_t i = 0; i < token.size() - 1; ++i) {
-    word.push_back(token.substr(i, 1));
+  while (symbols.size() > 1) {
+    int32_t best_rank = INT_MAX;
+    int32_t left = -1, right = -1, merged = -1;
+    for (size_t i = 0; i + 1 < symbols.size(); i++) {
+      auto it = m_merge_table.find(pairKey(symbols[i], symbols[i + 1]));
+      if (it != m_merge_table.end() && it->second.rank < best_rank) {
+        best_rank = it->second.rank;
+        left = symbols[i];
+        right = symbols[i + 1];
+        merged = it->second.merged;
+      }
+    }
+    if (best_rank == INT_MAX) {
+      break;
+    }
+    size_t out = 0;
+    for (size_t i = 0; i < symbols.size();) {
+      if (i + 1 < symbols.size() && symbols[i] == left && symbols[i + 1] == right) {
+        symbols[out++] = merged;
+        i += 2;
+      } else {
+        symbols[out++] = symbols[i++];
+      }
+    }
+    symbols.resize(out);
   }
-  word.push_back(token.substr(token.size() - 1) + "</w>");
-  return word;
-}
 
-int token_bpe(const std::string& encoderFile, const std::string& bpeFile,
-              const std::string& textFile, std::vector<std::vector<int32_t>>& tokens) {
-  // build vocabulary list
-  std::unordered_map<std::string, uint32_t> vocab;
-  readVocab(encoderFile.c_str(), vocab);
-
-  // build bpe_ranks
-  const int start_line = 2;
-  const int end_line = 48895;
-  std::unordered_map<std::pair<std::string, std::string>, int, pair_hash> pairs_map =
-      create_pairs_map(bpeFile, start_line, end_line);
-
-  // split sentence
-  std::string special = "[@#$%^&*!]";
-  std::regex pattern(
-      special +
-          R"(|'s|'t|'re|'ve|'m|'ll|'d|[[:alpha:]]+|[[:digit:]]|[^[:space:][:alpha:][:digit:]]+)",
-      std::regex_constants::icase);
+  for (int32_t &sym : symbols) {
+    sym = m_symbol_token[sym];
+  }
+  if (m_cache.size() >= BPE_MAX_CACHE_WORDS) {
+    m_cache.clear();
+  }
+  return m_cache.emplace(word, std::move(symbols)).first->second;
+}
 
-  std::vector<std::string> text;
-  std::ifstream file(textFile);
+int BpeTokenizer::encode(const std::string &text, std::vector<int32_t> *tokens) {
+  if (!isLoaded()) {
+    LOGE("bpe tokenizer is not loaded\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  std::string lower(text);
+  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+  std::vector<std::string> words;
+  splitWords(lower, &words);
 
-  if (file.is_open()) {
-    std::string line;
-    while (std::getline(file, line)) {
-      text.push_back(line);
-    }
-    file.close();
-  } else {
-    std::cerr << "Unable to open file." << std::endl;
-    return 1;
-  }
-
-  // tokens.resize(text.size());
-  // process each sentence
-  for (int j = 0; j < text.size(); j++) {
-    std::transform(text[j].begin(), text[j].end(), text[j].begin(),
-                   ::tolower);  // convert all to lowercase
-    std::vector<std::string> words;
-
-    // std::sregex_iterator is an iterator class in C++ used for matching regular expressions in
-    // strings
-    std::sregex_iterator it(text[j].begin(), text[j].end(), pattern);
-    std::sregex_iterator end;
-
-    while (it != end) {
-      std::smatch match = *it;
-      words.push_back(match.str());
-      ++it;
+  tokens->clear();
+  tokens->reserve(CLIP_CONTEXT_LENGTH);
+  tokens->push_back(m_start_token);
+  {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    for (const std::string &word : words) {
+      const std::vector<int32_t> &ids = bpe(word);
+      tokens->insert(tokens->end(), ids.begin(), ids.end());
     }
+  }
+  tokens->push_back(m_end_token);
 
-    tokens[j].push_back(vocab["<start_of_text>"]);
+  if (tokens->size() > CLIP_CONTEXT_LENGTH) {
+    LOGE("statement is too long (%zu tokens): %s\n", tokens->size(), text.c_str());
+    return CVI_TDL_FAILURE;
+  }
+  tokens->resize(CLIP_CONTEXT_LENGTH, 0);
+  return CVI_TDL_SUCCESS;
+}
 
-    // process each word
-    for (int i = 0; i < words.size(); i++) {
-      std::vector<std::string> word =
-          split_word(words[i]);  // split the word and add </w> after the last character
-      std::set<std::pair<std::string, std::string>> pairs =
-          get_pairs(word);  // return the set of all possible character pairs in a word
+int BpeTokenizer::encodeBatch(const std::vector<std::string> &texts,
+                              std::vector<std::vector<int32_t>> *tokens) {
+  tokens->resize(texts.size());
+  for (size_t i = 0; i < texts.size(); i++) {
+    int ret = encode(texts[i], &(*tokens)[i]);
+    if (ret != CVI_TDL_SUCCESS) {
+      LOGE("tokenize line %zu failed\n", i);
+      return ret;
+    }
+  }
+  return CVI_TDL_SUCCESS;
+}
 
-      if (pairs.empty()) {
-        std::string token = words[i] + "</w>";
-        tokens[j].push_back(vocab[token]);
-        continue;
-      }
+std::shared_ptr<BpeTokenizer> get_bpe_tokenizer(const std::string &encoderFile,
+                                                const std::string &bpeFile) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::shared_ptr<BpeTokenizer>> registry;
 
-      mergePairs(word, pairs, pairs_map);
-      for (const auto& word_split : word) {
-        tokens[j].push_back(vocab[word_split]);
-      }
-    }
+  std::string key = encoderFile + '\n' + bpeFile;
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto it = registry.find(key);
+  if (it != registry.end()) {
+    return it->second;
+  }
+  auto tokenizer = std::make_shared<BpeTokenizer>();
+  if (tokenizer->load(encoderFile, bpeFile) != CVI_TDL_SUCCESS) {
+    return nullptr;
+  }
+  registry[key] = tokenizer;
+  return tokenizer;
+}
 
-    tokens[j].push_back(vocab["<end_of_text>"]);
+int token_bpe(const std::string &encoderFile, const std::string &bpeFile,
+              const std::string &textFile, std::vector<std::vector<int32_t>> &tokens) {
+  std::shared_ptr<BpeTokenizer> tokenizer = get_bpe_tokenizer(encoderFile, bpeFile);
+  if (tokenizer == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
 
-    // check if the length of tokens [j] is less than 77, and add zeros if it is less than 77
-    if (tokens[j].size() < 77) {
-      int zerosToAdd = 77 - tokens[j].size();
-      for (int k = 0; k < zerosToAdd; ++k) {
-        tokens[j].push_back(0);
-      }
-    } else {
-      printf("line %d statement is too long, shortened.\n", j);
-      return 1;
-    }
+  std::ifstream file(textFile);
+  if (!file.is_open()) {
+    LOGE("Unable to open file %s\n", textFile.c_str());
+    return CVI_TDL_FAILURE;
+  }
+  std::vector<std::string> text;
+  std::string line;
+  while (std::getline(file, line)) {
+    text.push_back(line);
   }
 
-  return 0;
+  std::vector<std::vector<int32_t>> encoded;
+  int ret = tokenizer->encodeBatch(text, &encoded);
+  if (tokens.size() < encoded.size()) {
+    tokens.resize(encoded.size());
+  }
+  for (size_t i = 0; i < encoded.size(); i++) {
+    tokens[i] = std::move(encoded[i]);
+  }
+  return ret;
 }
-}  // namespace cvitdl
\ No newline at end of file
+}  // namespace cvitdl
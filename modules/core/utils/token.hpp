@@ -1,8 +1,72 @@
 #pragma once
+#include <stdint.h>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace cvitdl {
-int token_bpe(const std::string& encoderFile, const std::string& bpeFile,
-              const std::string& textFile, std::vector<std::vector<int32_t>>& tokens);
-}  // namespace cvitdl
\ No newline at end of file
+
+#define CLIP_CONTEXT_LENGTH 77
+
+/**
+ * @brief CLIP byte-pair-encoding tokenizer.
+ *
+ * Vocabulary and merge ranks are loaded once. Every string that appears in the vocabulary or the
+ * merge list is interned to an integer symbol, and the merge table is keyed on (left, right)
+ * symbol pairs, so BPE runs on integer arrays. Results are cached per word. The tokenizer can be
+ * exported to a compact binary file, which loads without parsing the text files.
+ */
+class BpeTokenizer {
+ public:
+  // Load from encoder ("word: id" per line) and merges files. If bpe_file is empty, encoder_file
+  // is read as a binary file written by saveBinary().
+  int load(const std::string &encoder_file, const std::string &bpe_file);
+  int loadBinary(const std::string &file);
+  int saveBinary(const std::string &file) const;
+  bool isLoaded() const { return !m_symbols.empty(); }
+
+  // Tokenize one prompt into CLIP_CONTEXT_LENGTH ids: <start_of_text>, words, <end_of_text>,
+  // zero padding.
+  int encode(const std::string &text, std::vector<int32_t> *tokens);
+  int encodeBatch(const std::vector<std::string> &texts, std::vector<std::vector<int32_t>> *tokens);
+
+ private:
+  struct MergeEntry {
+    int32_t rank;
+    int32_t merged;
+  };
+
+  int32_t intern(const std::string &str);
+  int32_t findSymbol(const std::string &str) const;
+  void finalize();
+  void splitWords(const std::string &text, std::vector<std::string> *words) const;
+  const std::vector<int32_t> &bpe(const std::string &word);
+
+  static inline uint64_t pairKey(int32_t left, int32_t right) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(left)) << 32) |
+           static_cast<uint32_t>(right);
+  }
+
+  std::vector<std::string> m_symbols;
+  std::vector<int32_t> m_symbol_token;  // symbol -> vocabulary id, 0 if not in vocabulary
+  std::unordered_map<std::string, int32_t> m_symbol_ids;
+  std::vector<std::pair<int32_t, int32_t>> m_merges;  // (left, right) ordered by rank
+  std::unordered_map<uint64_t, MergeEntry> m_merge_table;
+  int32_t m_char_symbol[256];
+  int32_t m_char_end_symbol[256];
+  int32_t m_start_token = 0;
+  int32_t m_end_token = 0;
+
+  std::mutex m_cache_mutex;
+  std::unordered_map<std::string, std::vector<int32_t>> m_cache;
+};
+
+// Tokenizers are shared per (encoder, bpe) file pair for the lifetime of the process.
+std::shared_ptr<BpeTokenizer> get_bpe_tokenizer(const std::string &encoderFile,
+                                                const std::string &bpeFile);
+
+int token_bpe(const std::string &encoderFile, const std::string &bpeFile,
+              const std::string &textFile, std::vector<std::vector<int32_t>> &tokens);
+}  // namespace cvitdl
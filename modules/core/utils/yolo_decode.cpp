@@ -0,0 +1,261 @@
+#include "yolo_decode.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+namespace {
+
+inline float sigmoid(float x) { return 1.f / (1.f + expf(-x)); }
+
+// Objectness gate in the domain of the tensor: the smallest int8 value whose logit reaches
+// logit, or the logit itself for float tensors.
+inline int objectness_gate(const int8_t *, float logit, float qscale) {
+  if (qscale <= 0) {
+    return -128;
+  }
+  float q = ceilf(logit / qscale);
+  return static_cast<int>(std::min(128.f, std::max(-128.f, q)));
+}
+
+inline float objectness_gate(const float *, float logit, float) { return logit; }
+
+template <typename T>
+inline int argmax(const T *p, int num) {
+  int best = 0;
+  for (int i = 1; i < num; i++) {
+    if (p[i] > p[best]) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+inline float branch_value(const YoloBranch &b, int idx) {
+  return b.data_int8 != nullptr ? b.data_int8[idx] * b.qscale : b.data_float[idx];
+}
+
+template <typename T>
+inline const T *branch_data(const YoloBranch &b);
+
+template <>
+inline const int8_t *branch_data<int8_t>(const YoloBranch &b) {
+  return b.data_int8;
+}
+
+template <>
+inline const float *branch_data<float>(const YoloBranch &b) {
+  return b.data_float;
+}
+
+}  // namespace
+
+float sigmoid_inverse(float prob) {
+  if (prob <= 0) {
+    return -INFINITY;
+  }
+  if (prob >= 1) {
+    return INFINITY;
+  }
+  return logf(prob / (1.f - prob));
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+static inline float32x4_t exp_f32x4(float32x4_t x) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f)), vdupq_n_f32(88.3762626647950f));
+  // x = n * ln2 + r, |r| <= ln2 / 2
+  float32x4_t fx = vmlaq_n_f32(vdupq_n_f32(0.5f), x, 1.44269504088896341f);
+  float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+  uint32x4_t gt = vcgtq_f32(t, fx);
+  uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.f));
+  float32x4_t n = vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(gt, one)));
+  float32x4_t r = vmlsq_n_f32(x, n, 0.693359375f);
+  r = vmlsq_n_f32(r, n, -2.12194440e-4f);
+
+  float32x4_t y = vdupq_n_f32(1.9875691500e-4f);
+  y = vmlaq_f32(vdupq_n_f32(1.3981999507e-3f), y, r);
+  y = vmlaq_f32(vdupq_n_f32(8.3334519073e-3f), y, r);
+  y = vmlaq_f32(vdupq_n_f32(4.1665795894e-2f), y, r);
+  y = vmlaq_f32(vdupq_n_f32(1.6666665459e-1f), y, r);
+  y = vmlaq_f32(vdupq_n_f32(5.0000001201e-1f), y, r);
+  y = vmlaq_f32(vaddq_f32(r, vdupq_n_f32(1.f)), y, vmulq_f32(r, r));
+
+  int32x4_t pow2n = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(pow2n));
+}
+#endif
+
+void exp4(const float *x, float *y) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  vst1q_f32(y, exp_f32x4(vld1q_f32(x)));
+#else
+  for (int i = 0; i < 4; i++) {
+    y[i] = expf(x[i]);
+  }
+#endif
+}
+
+void sigmoid4(const float *x, float *y) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  float32x4_t d = vaddq_f32(vdupq_n_f32(1.f), exp_f32x4(vnegq_f32(vld1q_f32(x))));
+  float32x4_t r = vrecpeq_f32(d);
+  r = vmulq_f32(r, vrecpsq_f32(d, r));
+  r = vmulq_f32(r, vrecpsq_f32(d, r));
+  vst1q_f32(y, r);
+#else
+  for (int i = 0; i < 4; i++) {
+    y[i] = sigmoid(x[i]);
+  }
+#endif
+}
+
+void YoloDecoder::setup(YoloBoxCoding coding, int input_w, int input_h,
+                        const std::vector<int> &strides, const std::vector<int> &num_anchors,
+                        const uint32_t *anchors, int anchor_len, int num_cls) {
+  m_coding = coding;
+  m_input_w = input_w;
+  m_input_h = input_h;
+  m_num_cls = num_cls;
+  m_levels.clear();
+
+  int anchor_pos = 0;
+  for (size_t i = 0; i < strides.size(); i++) {
+    Level l;
+    l.bound = false;
+    l.stride = strides[i];
+    l.grid_w = input_w / l.stride;
+    l.grid_h = input_h / l.stride;
+    const float offset = coding == YoloBoxCoding::YOLOV5 ? -0.5f : 0.f;
+    l.xy_scale = coding == YoloBoxCoding::YOLOV5 ? 2.f * l.stride : (float)l.stride;
+    l.cell_x.resize(l.grid_w);
+    l.cell_y.resize(l.grid_h);
+    for (int g = 0; g < l.grid_w; g++) {
+      l.cell_x[g] = (g + offset) * l.stride;
+    }
+    for (int g = 0; g < l.grid_h; g++) {
+      l.cell_y[g] = (g + offset) * l.stride;
+    }
+
+    int n = i < num_anchors.size() ? num_anchors[i] : 1;
+    for (int a = 0; a < n; a++) {
+      if (coding == YoloBoxCoding::YOLOX) {
+        l.anchor_w.push_back(l.stride);
+        l.anchor_h.push_back(l.stride);
+        continue;
+      }
+      float pw = 0, ph = 0;
+      if (anchors != nullptr && anchor_pos + 1 < anchor_len) {
+        pw = anchors[anchor_pos];
+        ph = anchors[anchor_pos + 1];
+      }
+      anchor_pos += 2;
+      // (2 * s)^2 * anchor = s^2 * (4 * anchor)
+      l.anchor_w.push_back(4.f * pw);
+      l.anchor_h.push_back(4.f * ph);
+    }
+    m_levels.push_back(l);
+  }
+}
+
+void YoloDecoder::bindLevel(size_t level, const YoloBranch &obj, const YoloBranch &cls,
+                            const YoloBranch &box) {
+  if (level >= m_levels.size()) {
+    return;
+  }
+  Level &l = m_levels[level];
+  l.bound = true;
+  l.obj = obj;
+  l.cls = cls;
+  l.box = box;
+}
+
+void YoloDecoder::decode(size_t level, float threshold, Detections *dets) const {
+  if (level >= m_levels.size() || !m_levels[level].bound) {
+    return;
+  }
+  const Level &l = m_levels[level];
+  decode(level, l.obj, l.cls, l.box, threshold, dets);
+}
+
+void YoloDecoder::decode(size_t level, const YoloBranch &obj, const YoloBranch &cls,
+                         const YoloBranch &box, float threshold, Detections *dets) const {
+  if (level >= m_levels.size()) {
+    return;
+  }
+  const Level &l = m_levels[level];
+  const float logit = sigmoid_inverse(threshold);
+  const int num_anchors = l.anchor_w.size();
+
+  auto run = [&](auto obj_data, auto cls_data) {
+    const auto gate = objectness_gate(obj_data, logit, obj.qscale);
+    const float obj_q = obj.data_int8 != nullptr ? obj.qscale : 1.f;
+    const float cls_q = cls.data_int8 != nullptr ? cls.qscale : 1.f;
+    int pos = 0;
+    for (int a = 0; a < num_anchors; a++) {
+      for (int gy = 0; gy < l.grid_h; gy++) {
+        for (int gx = 0; gx < l.grid_w; gx++, pos++) {
+          if (obj_data[pos] < gate) {
+            continue;
+          }
+          const auto *p_cls = cls_data + pos * m_num_cls;
+          int label = argmax(p_cls, m_num_cls);
+          float score = sigmoid(obj_data[pos] * obj_q) * sigmoid(p_cls[label] * cls_q);
+          if (score < threshold) {
+            continue;
+          }
+
+          float v[4];
+          for (int k = 0; k < 4; k++) {
+            v[k] = branch_value(box, pos * 4 + k);
+          }
+          float w, h;
+          if (m_coding == YoloBoxCoding::YOLOV5) {
+            sigmoid4(v, v);
+            w = v[2] * v[2] * l.anchor_w[a];
+            h = v[3] * v[3] * l.anchor_h[a];
+          } else {
+            float e[4] = {v[2], v[3], 0, 0};
+            exp4(e, e);
+            w = e[0] * l.anchor_w[a];
+            h = e[1] * l.anchor_h[a];
+          }
+          float x = l.cell_x[gx] + v[0] * l.xy_scale;
+          float y = l.cell_y[gy] + v[1] * l.xy_scale;
+
+          PtrDectRect det = std::make_shared<object_detect_rect_t>();
+          det->label = label;
+          det->score = score;
+          det->x1 = x - w * 0.5f;
+          det->y1 = y - h * 0.5f;
+          det->x2 = x + w * 0.5f;
+          det->y2 = y + h * 0.5f;
+          clip_bbox(m_input_w, m_input_h, det);
+          if (det->x2 - det->x1 > 1 && det->y2 - det->y1 > 1) {
+            dets->push_back(det);
+          }
+        }
+      }
+    }
+  };
+
+  if (obj.data_int8 != nullptr) {
+    if (cls.data_int8 != nullptr) {
+      run(branch_data<int8_t>(obj), branch_data<int8_t>(cls));
+    } else {
+      run(branch_data<int8_t>(obj), branch_data<float>(cls));
+    }
+  } else {
+    if (cls.data_int8 != nullptr) {
+      run(branch_data<float>(obj), branch_data<int8_t>(cls));
+    } else {
+      run(branch_data<float>(obj), branch_data<float>(cls));
+    }
+  }
+}
+
+}  // namespace cvitdl
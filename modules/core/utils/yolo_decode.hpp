@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "object_utils.hpp"
+
+namespace cvitdl {
+
+// One output tensor of a YOLO head, int8 with a dequantization scale or float.
+struct YoloBranch {
+  const int8_t *data_int8;
+  const float *data_float;
+  float qscale;
+};
+
+// The logit whose sigmoid is prob.
+float sigmoid_inverse(float prob);
+
+// y[i] = exp(x[i]) and y[i] = 1 / (1 + exp(-x[i])) for i < 4, in place allowed.
+void exp4(const float *x, float *y);
+void sigmoid4(const float *x, float *y);
+
+enum class YoloBoxCoding {
+  YOLOV5,  // xy = (2 * sigmoid - 0.5 + grid) * stride, wh = (2 * sigmoid)^2 * anchor
+  YOLOX,   // xy = (v + grid) * stride, wh = exp(v) * stride
+};
+
+/**
+ * @brief Decoder shared by YOLO heads with separate objectness, class and box outputs per stride,
+ * each laid out as [anchors, grid_h, grid_w, channels].
+ *
+ * Grid offsets and anchor sizes of every level are computed once in setup(). decode() rejects
+ * cells on objectness in the tensor's own domain, so int8 outputs are compared as int8, and only
+ * evaluates exp/sigmoid for the cells that pass.
+ */
+class YoloDecoder {
+ public:
+  // anchors holds anchor_len / 2 (w, h) pairs consumed level by level, num_anchors[i] at level i.
+  // Anchor-free codings ignore anchors and use one anchor per level.
+  void setup(YoloBoxCoding coding, int input_w, int input_h, const std::vector<int> &strides,
+             const std::vector<int> &num_anchors, const uint32_t *anchors, int anchor_len,
+             int num_cls);
+  size_t numLevels() const { return m_levels.size(); }
+
+  void decode(size_t level, const YoloBranch &obj, const YoloBranch &cls, const YoloBranch &box,
+              float threshold, Detections *dets) const;
+
+  // Binds the output branches of level once the model is open, so decode() needs no lookup.
+  void bindLevel(size_t level, const YoloBranch &obj, const YoloBranch &cls,
+                 const YoloBranch &box);
+  // Decodes level from the branches bound by bindLevel(), nothing if none were bound.
+  void decode(size_t level, float threshold, Detections *dets) const;
+
+ private:
+  struct Level {
+    int stride;
+    int grid_w;
+    int grid_h;
+    float xy_scale;
+    std::vector<float> cell_x;
+    std::vector<float> cell_y;
+    std::vector<float> anchor_w;
+    std::vector<float> anchor_h;
+    bool bound;
+    YoloBranch obj;
+    YoloBranch cls;
+    YoloBranch box;
+  };
+
+  YoloBoxCoding m_coding = YoloBoxCoding::YOLOV5;
+  int m_input_w = 0;
+  int m_input_h = 0;
+  int m_num_cls = 0;
+  std::vector<Level> m_levels;
+};
+
+}  // namespace cvitdl
@@ -0,0 +1,322 @@
+#include "overlay_renderer.hpp"
+
+#include <cvi_sys.h>
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include "core/core/cvtdl_errno.h"
+#ifndef NO_OPENCV
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#endif
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+namespace service {
+
+static inline uint8_t ClampColor(float value) {
+  return (value < 0) ? 0 : ((value > 255.f) ? 255 : static_cast<uint8_t>(value));
+}
+
+// Solve lo <= a * x + b <= hi and intersect the result with [*x0, *x1].
+static inline bool IntersectLinearRange(float a, float b, float lo, float hi, float *x0,
+                                        float *x1) {
+  if (a == 0) {
+    return b >= lo && b <= hi;
+  }
+  float r0 = (lo - b) / a;
+  float r1 = (hi - b) / a;
+  if (a < 0) {
+    std::swap(r0, r1);
+  }
+  *x0 = std::max(*x0, r0);
+  *x1 = std::min(*x1, r1);
+  return *x0 <= *x1;
+}
+
+static inline void ExtendDiscRange(float cx, float cy, float yc, float r2, float *x0, float *x1) {
+  float dy = yc - cy;
+  if (dy * dy > r2) {
+    return;
+  }
+  float hw = std::sqrt(r2 - dy * dy);
+  *x0 = std::min(*x0, cx - hw);
+  *x1 = std::max(*x1, cx + hw);
+}
+
+// Rect corners are aligned to 4 luma pixels so the chroma outline covers the same area.
+static inline int AlignedRectCoord(float v, int luma_size, float scale) {
+  int c = static_cast<int>(std::max(std::min(v, static_cast<float>(luma_size - 1)), 0.f));
+  return static_cast<int>(((c >> 2) << 2) * scale);
+}
+
+void OverlayRenderer::clear() {
+  m_prims.clear();
+  m_texts.clear();
+  m_colors.clear();
+}
+
+uint32_t OverlayRenderer::addColor(color_rgb color) {
+  float r = color.r * 255.f;
+  float g = color.g * 255.f;
+  float b = color.b * 255.f;
+  YuvColor yuv;
+  yuv.y = ClampColor((0.257f * r) + (0.504f * g) + (0.098f * b) + 16);
+  yuv.u = ClampColor(-(.148f * r) - (.291f * g) + (.439f * b) + 128);
+  yuv.v = ClampColor((0.439f * r) - (0.368f * g) - (0.071f * b) + 128);
+  if (!m_colors.empty()) {
+    const YuvColor &last = m_colors.back();
+    if (last.y == yuv.y && last.u == yuv.u && last.v == yuv.v) {
+      return m_colors.size() - 1;
+    }
+  }
+  m_colors.push_back(yuv);
+  return m_colors.size() - 1;
+}
+
+void OverlayRenderer::addRect(float x1, float y1, float x2, float y2, color_rgb color,
+                              int thickness) {
+  m_prims.push_back({PRIM_RECT, x1, y1, x2, y2, thickness, addColor(color)});
+}
+
+void OverlayRenderer::addLine(float x1, float y1, float x2, float y2, color_rgb color,
+                              int thickness) {
+  m_prims.push_back({PRIM_LINE, x1, y1, x2, y2, thickness, addColor(color)});
+}
+
+void OverlayRenderer::addPolyline(const float *x, const float *y, uint32_t size, bool closed,
+                                  color_rgb color, int thickness) {
+  if (size == 0) {
+    return;
+  }
+  uint32_t color_idx = addColor(color);
+  if (size == 1) {
+    m_prims.push_back({PRIM_POINT, x[0], y[0], x[0], y[0], thickness / 2, color_idx});
+    return;
+  }
+  uint32_t num_segments = closed ? size : size - 1;
+  for (uint32_t i = 0; i < num_segments; i++) {
+    uint32_t j = (i + 1) % size;
+    m_prims.push_back({PRIM_LINE, x[i], y[i], x[j], y[j], thickness, color_idx});
+  }
+}
+
+void OverlayRenderer::addPoint(float x, float y, color_rgb color, int radius) {
+  m_prims.push_back({PRIM_POINT, x, y, x, y, radius, addColor(color)});
+}
+
+void OverlayRenderer::addText(float x, float y, const char *text, color_rgb color,
+                              double font_scale, int thickness) {
+  if (text == nullptr || text[0] == '\0') {
+    return;
+  }
+  m_texts.push_back({x, y, std::string(text), font_scale, thickness, addColor(color)});
+}
+
+void OverlayRenderer::rasterizeRect(const Prim &prim, float scale, int width, int height,
+                                    std::vector<Span> *spans) {
+  int luma_width = static_cast<int>(width / scale);
+  int luma_height = static_cast<int>(height / scale);
+  int x1 = AlignedRectCoord(prim.x1, luma_width, scale);
+  int x2 = AlignedRectCoord(prim.x2, luma_width, scale);
+  int y1 = AlignedRectCoord(prim.y1, luma_height, scale);
+  int y2 = AlignedRectCoord(prim.y2, luma_height, scale);
+  if (x2 <= x1 || y2 <= y1) {
+    return;
+  }
+  int t = std::max(static_cast<int>(prim.size * scale), 1);
+  int top_end = std::min(y1 + t, y2);
+  int bottom_begin = std::max(y2 - t, top_end);
+  int left_end = std::min(x1 + t, x2);
+  int right_begin = std::max(x2 - t, left_end);
+
+  for (int y = y1; y < top_end; ++y) {
+    spans->push_back({y, x1, x2, prim.color});
+  }
+  for (int y = top_end; y < bottom_begin; ++y) {
+    spans->push_back({y, x1, left_end, prim.color});
+    if (right_begin < x2) {
+      spans->push_back({y, right_begin, x2, prim.color});
+    }
+  }
+  for (int y = bottom_begin; y < y2; ++y) {
+    spans->push_back({y, x1, x2, prim.color});
+  }
+}
+
+void OverlayRenderer::rasterizeCapsule(float ax, float ay, float bx, float by, float half_thick,
+                                       uint32_t color, int width, int height,
+                                       std::vector<Span> *spans) {
+  float dx = bx - ax;
+  float dy = by - ay;
+  float len2 = dx * dx + dy * dy;
+  float body = half_thick * std::sqrt(len2);
+  float r2 = half_thick * half_thick;
+  int row_begin = std::max(static_cast<int>(std::floor(std::min(ay, by) - half_thick)), 0);
+  int row_end = std::min(static_cast<int>(std::ceil(std::max(ay, by) + half_thick)), height - 1);
+
+  for (int row = row_begin; row <= row_end; ++row) {
+    float yc = row + 0.5f;
+    float lo = FLT_MAX;
+    float hi = -FLT_MAX;
+    ExtendDiscRange(ax, ay, yc, r2, &lo, &hi);
+    ExtendDiscRange(bx, by, yc, r2, &lo, &hi);
+    if (len2 > 0) {
+      // Segment body: 0 <= (p - a) . d <= |d|^2 and |(p - a) x d| <= half_thick * |d|.
+      float body_lo = -FLT_MAX;
+      float body_hi = FLT_MAX;
+      if (IntersectLinearRange(dx, -ax * dx + (yc - ay) * dy, 0, len2, &body_lo, &body_hi) &&
+          IntersectLinearRange(dy, -ax * dy - (yc - ay) * dx, -body, body, &body_lo, &body_hi)) {
+        lo = std::min(lo, body_lo);
+        hi = std::max(hi, body_hi);
+      }
+    }
+    if (lo > hi) {
+      continue;
+    }
+    int x0 = std::max(static_cast<int>(std::ceil(lo - 0.5f)), 0);
+    int x1 = std::min(static_cast<int>(std::floor(hi - 0.5f)), width - 1);
+    if (x0 <= x1) {
+      spans->push_back({row, x0, x1 + 1, color});
+    }
+  }
+}
+
+void OverlayRenderer::rasterize(const Prim &prim, float scale, int width, int height,
+                                std::vector<Span> *spans) {
+  switch (prim.type) {
+    case PRIM_RECT:
+      rasterizeRect(prim, scale, width, height, spans);
+      break;
+    case PRIM_LINE:
+      rasterizeCapsule(prim.x1 * scale, prim.y1 * scale, prim.x2 * scale, prim.y2 * scale,
+                       std::max(prim.size * scale, 1.f) / 2, prim.color, width, height, spans);
+      break;
+    case PRIM_POINT:
+      rasterizeCapsule(prim.x1 * scale, prim.y1 * scale, prim.x1 * scale, prim.y1 * scale,
+                       std::max(prim.size * scale, 1.f), prim.color, width, height, spans);
+      break;
+  }
+}
+
+void OverlayRenderer::fillSpans(VIDEO_FRAME_INFO_S *frame) {
+  uint8_t *y_plane = frame->stVFrame.pu8VirAddr[0];
+  uint32_t y_stride = frame->stVFrame.u32Stride[0];
+  for (const Span &span : m_luma_spans) {
+    memset(y_plane + span.y * y_stride + span.x0, m_colors[span.color].y, span.x1 - span.x0);
+  }
+
+  if (frame->stVFrame.enPixelFormat == PIXEL_FORMAT_NV21) {
+    // 1: VU-plane
+    uint8_t *vu_plane = frame->stVFrame.pu8VirAddr[1];
+    uint32_t vu_stride = frame->stVFrame.u32Stride[1];
+    for (const Span &span : m_chroma_spans) {
+      const YuvColor &c = m_colors[span.color];
+      uint16_t vu = (static_cast<uint16_t>(c.u) << 8) | c.v;
+      std::fill_n(reinterpret_cast<uint16_t *>(vu_plane + span.y * vu_stride + span.x0 * 2),
+                  span.x1 - span.x0, vu);
+    }
+  } else {
+    // 1: U-plane, 2: V-plane
+    uint8_t *u_plane = frame->stVFrame.pu8VirAddr[1];
+    uint8_t *v_plane = frame->stVFrame.pu8VirAddr[2];
+    uint32_t u_stride = frame->stVFrame.u32Stride[1];
+    uint32_t v_stride = frame->stVFrame.u32Stride[2];
+    for (const Span &span : m_chroma_spans) {
+      const YuvColor &c = m_colors[span.color];
+      memset(u_plane + span.y * u_stride + span.x0, c.u, span.x1 - span.x0);
+      memset(v_plane + span.y * v_stride + span.x0, c.v, span.x1 - span.x0);
+    }
+  }
+}
+
+void OverlayRenderer::drawTexts(VIDEO_FRAME_INFO_S *frame) {
+  if (m_texts.empty()) {
+    return;
+  }
+#ifdef NO_OPENCV
+  LOGW("no opencv support,could not draw text");
+#else
+  const VIDEO_FRAME_S &vf = frame->stVFrame;
+  cv::Size y_size(vf.u32Width, vf.u32Height);
+  cv::Size uv_size(vf.u32Width / 2, vf.u32Height / 2);
+  cv::Mat y_image(y_size, CV_8UC1, vf.pu8VirAddr[0], vf.u32Stride[0]);
+  bool nv21 = vf.enPixelFormat == PIXEL_FORMAT_NV21;
+  cv::Mat vu_image, u_image, v_image;
+  if (nv21) {
+    vu_image = cv::Mat(uv_size, CV_8UC2, vf.pu8VirAddr[1], vf.u32Stride[1]);
+  } else {
+    u_image = cv::Mat(uv_size, CV_8UC1, vf.pu8VirAddr[1], vf.u32Stride[1]);
+    v_image = cv::Mat(uv_size, CV_8UC1, vf.pu8VirAddr[2], vf.u32Stride[2]);
+  }
+
+  for (const Text &text : m_texts) {
+    const YuvColor &c = m_colors[text.color];
+    cv::Point y_point(text.x, text.y);
+    cv::Point uv_point(text.x / 2, text.y / 2);
+    int uv_thickness = std::max(text.thickness / 2, 1);
+    cv::putText(y_image, text.text, y_point, cv::FONT_HERSHEY_SIMPLEX, text.font_scale,
+                cv::Scalar(c.y), text.thickness, 8);
+    if (nv21) {
+      cv::putText(vu_image, text.text, uv_point, cv::FONT_HERSHEY_SIMPLEX, text.font_scale / 2,
+                  cv::Scalar(c.v, c.u), uv_thickness, 8);
+    } else {
+      cv::putText(u_image, text.text, uv_point, cv::FONT_HERSHEY_SIMPLEX, text.font_scale / 2,
+                  cv::Scalar(c.u), uv_thickness, 8);
+      cv::putText(v_image, text.text, uv_point, cv::FONT_HERSHEY_SIMPLEX, text.font_scale / 2,
+                  cv::Scalar(c.v), uv_thickness, 8);
+    }
+  }
+#endif
+}
+
+int OverlayRenderer::render(VIDEO_FRAME_INFO_S *frame) {
+  if (frame->stVFrame.enPixelFormat != PIXEL_FORMAT_NV21 &&
+      frame->stVFrame.enPixelFormat != PIXEL_FORMAT_YUV_PLANAR_420) {
+    LOGE("Only PIXEL_FORMAT_NV21 and PIXEL_FORMAT_YUV_PLANAR_420 are supported in overlay\n");
+    return CVI_TDL_FAILURE;
+  }
+  if (empty()) {
+    return CVI_TDL_SUCCESS;
+  }
+
+  int width = frame->stVFrame.u32Width;
+  int height = frame->stVFrame.u32Height;
+  m_luma_spans.clear();
+  m_chroma_spans.clear();
+  for (const Prim &prim : m_prims) {
+    rasterize(prim, 1.f, width, height, &m_luma_spans);
+    rasterize(prim, 0.5f, width / 2, height / 2, &m_chroma_spans);
+  }
+  // Walk the planes top to bottom; stable so later primitives still paint over earlier ones.
+  auto row_order = [](const Span &a, const Span &b) { return a.y < b.y; };
+  std::stable_sort(m_luma_spans.begin(), m_luma_spans.end(), row_order);
+  std::stable_sort(m_chroma_spans.begin(), m_chroma_spans.end(), row_order);
+
+  size_t image_size =
+      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
+  bool do_unmap = false;
+  if (frame->stVFrame.pu8VirAddr[0] == NULL) {
+    frame->stVFrame.pu8VirAddr[0] =
+        (uint8_t *)CVI_SYS_Mmap(frame->stVFrame.u64PhyAddr[0], image_size);
+    frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
+    frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
+    do_unmap = true;
+  }
+
+  fillSpans(frame);
+  drawTexts(frame);
+
+  CVI_SYS_IonFlushCache(frame->stVFrame.u64PhyAddr[0], frame->stVFrame.pu8VirAddr[0], image_size);
+  if (do_unmap) {
+    CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], image_size);
+    frame->stVFrame.pu8VirAddr[0] = NULL;
+    frame->stVFrame.pu8VirAddr[1] = NULL;
+    frame->stVFrame.pu8VirAddr[2] = NULL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace service
+}  // namespace cvitdl
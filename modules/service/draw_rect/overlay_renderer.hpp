@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "cvi_comm.h"
+#include "draw_rect.hpp"
+
+namespace cvitdl {
+namespace service {
+
+/**
+ * @brief Batched overlay renderer for NV21 and YUV420 planar frames.
+ *
+ * Rectangles, lines, polylines, keypoints and text are collected first and rendered by render()
+ * in one pass: every primitive is clipped and rasterized into horizontal spans per plane, spans
+ * are sorted in row order and filled with memset. The frame is mapped and flushed once per
+ * render() call no matter how many primitives were added. Colors use the color_rgb convention
+ * (0 ~ 1 per channel).
+ */
+class OverlayRenderer {
+ public:
+  void clear();
+  bool empty() const { return m_prims.empty() && m_texts.empty(); }
+
+  void addRect(float x1, float y1, float x2, float y2, color_rgb color, int thickness);
+  void addLine(float x1, float y1, float x2, float y2, color_rgb color, int thickness);
+  void addPolyline(const float *x, const float *y, uint32_t size, bool closed, color_rgb color,
+                   int thickness);
+  void addPoint(float x, float y, color_rgb color, int radius);
+  void addText(float x, float y, const char *text, color_rgb color, double font_scale,
+               int thickness);
+
+  int render(VIDEO_FRAME_INFO_S *frame);
+
+ private:
+  enum PrimType { PRIM_RECT = 0, PRIM_LINE, PRIM_POINT };
+
+  struct Prim {
+    PrimType type;
+    float x1, y1, x2, y2;
+    int size;
+    uint32_t color;
+  };
+
+  struct Text {
+    float x, y;
+    std::string text;
+    double font_scale;
+    int thickness;
+    uint32_t color;
+  };
+
+  struct YuvColor {
+    uint8_t y, u, v;
+  };
+
+  // [x0, x1) on row y.
+  struct Span {
+    int32_t y;
+    int32_t x0;
+    int32_t x1;
+    uint32_t color;
+  };
+
+  uint32_t addColor(color_rgb color);
+  static void rasterize(const Prim &prim, float scale, int width, int height,
+                        std::vector<Span> *spans);
+  static void rasterizeRect(const Prim &prim, float scale, int width, int height,
+                            std::vector<Span> *spans);
+  static void rasterizeCapsule(float ax, float ay, float bx, float by, float half_thick,
+                               uint32_t color, int width, int height, std::vector<Span> *spans);
+  void fillSpans(VIDEO_FRAME_INFO_S *frame);
+  void drawTexts(VIDEO_FRAME_INFO_S *frame);
+
+  std::vector<Prim> m_prims;
+  std::vector<Text> m_texts;
+  std::vector<YuvColor> m_colors;
+  // Kept across render() calls so steady-state rendering does not allocate.
+  std::vector<Span> m_luma_spans;
+  std::vector<Span> m_chroma_spans;
+};
+
+}  // namespace service
+}  // namespace cvitdl
@@ -0,0 +1,617 @@
+// Post-processing micro-benchmark on synthetic output tensors. Runs on a plain Linux host without
+// the TPU runtime or middleware, see README.md.
+#include <getopt.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "anchor_free_decode.hpp"
+#include "ctc_decode.hpp"
+#include "keypoint_decode.hpp"
+#include "mask_rle.hpp"
+#include "object_utils.hpp"
+#include "seg_argmax.hpp"
+#include "text_region.hpp"
+#include "yolo_decode.hpp"
+
+using namespace cvitdl;
+
+static std::atomic<uint64_t> g_num_allocs(0);
+
+// Kept out of line, gcc warns of a new/delete mismatch once it sees the malloc and free inside.
+__attribute__((noinline)) void *operator new(size_t size) {
+  g_num_allocs.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+__attribute__((noinline)) void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  g_num_allocs.fetch_add(1, std::memory_order_relaxed);
+  return malloc(size ? size : 1);
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, const std::nothrow_t &) noexcept {
+  free(p);
+}
+
+namespace {
+
+const float kThreshold = 0.5f;
+const float kNmsThreshold = 0.5f;
+
+struct Options {
+  int iterations = 50;
+  float density = 0.005f;
+  bool run_float = true;
+  bool run_int8 = true;
+  std::string filter;
+  const char *csv_path = nullptr;
+  const char *baseline_path = nullptr;
+  float tolerance = 10.f;
+};
+
+// A synthetic output tensor kept both as float and int8 quantized by qscale.
+struct Tensor {
+  std::vector<float> f;
+  std::vector<int8_t> q;
+  float qscale = 16.f / 127;
+
+  void resize(size_t n) { f.assign(n, 0.f); }
+  void quantize() {
+    q.resize(f.size());
+    for (size_t i = 0; i < f.size(); i++) {
+      q[i] = (int8_t)std::max(-128.f, std::min(127.f, roundf(f[i] / qscale)));
+    }
+  }
+};
+
+class Synth {
+ public:
+  explicit Synth(uint32_t seed) : m_rng(seed) {}
+  bool hit(float density) { return std::uniform_real_distribution<float>(0, 1)(m_rng) < density; }
+  float uniform(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(m_rng); }
+  float normal(float mean, float stddev) {
+    return std::normal_distribution<float>(mean, stddev)(m_rng);
+  }
+  int index(int n) { return std::uniform_int_distribution<int>(0, n - 1)(m_rng); }
+
+  // Background logits with sigmoid far below any threshold.
+  void background(Tensor *t) {
+    for (float &v : t->f) v = normal(-8.f, 1.f);
+  }
+  void noise(Tensor *t, float stddev) {
+    for (float &v : t->f) v = normal(0.f, stddev);
+  }
+
+ private:
+  std::mt19937 m_rng;
+};
+
+struct Case {
+  std::string name;
+  std::string dtype;
+  size_t anchors;  // anchors, pixels, bins or steps visited per call
+  std::function<size_t()> run;  // returns the number of candidates produced
+};
+
+struct Result {
+  double ns_per_call;
+  double ns_per_anchor;
+  double candidates_per_sec;
+  double allocs_per_call;
+};
+
+inline YoloBranch yolo_branch(const Tensor &t, bool int8) {
+  return int8 ? YoloBranch{t.q.data(), nullptr, t.qscale} : YoloBranch{nullptr, t.f.data(), 1.f};
+}
+
+inline AnchorFreeBranch af_branch(const Tensor &t, bool int8, int channels, int offset) {
+  return int8 ? AnchorFreeBranch{t.q.data(), t.qscale, channels, offset}
+              : AnchorFreeBranch{t.f.data(), 1.f, channels, offset};
+}
+
+const std::vector<int> kStrides = {8, 16, 32};
+const uint32_t kYolov5Anchors[18] = {10, 13, 16,  30,  33, 23,  30,  61,  62,
+                                     45, 59, 119, 116, 90, 156, 198, 373, 326};
+
+// YOLOv5 / YOLOX heads: objectness, class and box tensors per stride.
+void add_yolo(const Options &opt, bool int8, YoloBoxCoding coding, std::vector<Case> *cases) {
+  const int input = 640, num_cls = 80;
+  const int num_anchors = coding == YoloBoxCoding::YOLOV5 ? 3 : 1;
+  auto decoder = std::make_shared<YoloDecoder>();
+  decoder->setup(coding, input, input, kStrides, std::vector<int>(3, num_anchors), kYolov5Anchors,
+                 18, num_cls);
+  auto tensors = std::make_shared<std::vector<Tensor>>(3 * kStrides.size());
+  Synth synth(1);
+  size_t anchors = 0;
+  for (size_t l = 0; l < kStrides.size(); l++) {
+    int cells = num_anchors * (input / kStrides[l]) * (input / kStrides[l]);
+    Tensor &obj = (*tensors)[3 * l], &cls = (*tensors)[3 * l + 1], &box = (*tensors)[3 * l + 2];
+    obj.resize(cells);
+    cls.resize((size_t)cells * num_cls);
+    box.resize((size_t)cells * 4);
+    synth.background(&obj);
+    synth.background(&cls);
+    synth.noise(&box, 1.f);
+    for (int i = 0; i < cells; i++) {
+      if (synth.hit(opt.density)) {
+        obj.f[i] = synth.uniform(1.f, 4.f);
+        cls.f[(size_t)i * num_cls + synth.index(num_cls)] = synth.uniform(1.f, 4.f);
+      }
+    }
+    obj.quantize();
+    cls.quantize();
+    box.quantize();
+    anchors += cells;
+  }
+  auto dets = std::make_shared<Detections>();
+  cases->push_back({coding == YoloBoxCoding::YOLOV5 ? "yolov5" : "yolox", int8 ? "int8" : "f32",
+                    anchors, [=]() {
+                      dets->clear();
+                      for (size_t l = 0; l < decoder->numLevels(); l++) {
+                        const Tensor *t = &(*tensors)[3 * l];
+                        decoder->decode(l, yolo_branch(t[0], int8), yolo_branch(t[1], int8),
+                                        yolo_branch(t[2], int8), kThreshold, dets.get());
+                      }
+                      return dets->size();
+                    }});
+}
+
+// Anchor-free heads with a class and a box tensor per stride. DFL and LTRB boxes are in grid
+// units, CHW tensors are [channels, h, w] and HWC tensors [h * w, channels].
+void add_anchor_free(const Options &opt, bool int8, const char *name, AnchorFreeBoxCoding coding,
+                     AnchorFreeLayout layout, int num_cls, std::vector<Case> *cases) {
+  const int input = 640, reg_max = 16;
+  const int box_ch = coding == AnchorFreeBoxCoding::DFL ? 4 * reg_max : 4;
+  auto decoder = std::make_shared<AnchorFreeDecoder>();
+  decoder->setup(coding, layout, int8, int8, num_cls, reg_max, input, input);
+  auto tensors = std::make_shared<std::vector<Tensor>>(2 * kStrides.size());
+  Synth synth(2);
+  size_t anchors = 0;
+  for (size_t l = 0; l < kStrides.size(); l++) {
+    int grid = input / kStrides[l], cells = grid * grid;
+    decoder->addLevel(kStrides[l], grid, grid);
+    Tensor &cls = (*tensors)[2 * l], &box = (*tensors)[2 * l + 1];
+    cls.resize((size_t)cells * num_cls);
+    box.resize((size_t)cells * box_ch);
+    synth.background(&cls);
+    if (coding == AnchorFreeBoxCoding::DFL) {
+      synth.noise(&box, 2.f);
+    } else {
+      for (float &v : box.f) v = synth.uniform(0.5f, 6.f);
+    }
+    for (int i = 0; i < cells; i++) {
+      if (synth.hit(opt.density)) {
+        int c = synth.index(num_cls);
+        size_t idx = layout == AnchorFreeLayout::CHW ? (size_t)c * cells + i
+                                                     : (size_t)i * num_cls + c;
+        cls.f[idx] = synth.uniform(1.f, 4.f);
+      }
+    }
+    cls.quantize();
+    box.quantize();
+    anchors += cells;
+  }
+  auto dets = std::make_shared<Detections>();
+  cases->push_back({name, int8 ? "int8" : "f32", anchors, [=]() {
+                      dets->clear();
+                      for (size_t l = 0; l < decoder->numLevels(); l++) {
+                        const Tensor &cls = (*tensors)[2 * l], &box = (*tensors)[2 * l + 1];
+                        decoder->decode(l, af_branch(cls, int8, num_cls, 0),
+                                        af_branch(box, int8, box_ch, 0), kThreshold, dets.get(),
+                                        nullptr);
+                      }
+                      return dets->size();
+                    }});
+}
+
+// Class-aware NMS over overlapping candidates around a few objects per class.
+void add_nms(const Options &opt, std::vector<Case> *cases) {
+  const int num_cls = 80;
+  const int num_dets = std::max(1, (int)(8400 * opt.density * 4));
+  Synth synth(3);
+  auto dets = std::make_shared<Detections>();
+  for (int i = 0; i < num_dets; i++) {
+    PtrDectRect det = std::make_shared<object_detect_rect_t>();
+    float cx = synth.uniform(0, 640), cy = synth.uniform(0, 640);
+    float w = synth.uniform(16, 160), h = synth.uniform(16, 160);
+    if (i % 4 != 0) {
+      const object_detect_rect_t &base = *(*dets)[i - i % 4];
+      cx = (base.x1 + base.x2) / 2 + synth.normal(0, 4);
+      cy = (base.y1 + base.y2) / 2 + synth.normal(0, 4);
+      w = base.x2 - base.x1;
+      h = base.y2 - base.y1;
+    }
+    det->x1 = cx - w / 2;
+    det->y1 = cy - h / 2;
+    det->x2 = cx + w / 2;
+    det->y2 = cy + h / 2;
+    det->score = synth.uniform(kThreshold, 1.f);
+    det->label = i % 4 == 0 ? synth.index(num_cls) : (*dets)[i - i % 4]->label;
+    dets->push_back(det);
+  }
+  cases->push_back({"nms", "f32", (size_t)num_dets, [=]() {
+                      return nms_multi_class(*dets, kNmsThreshold, 0, 0).size();
+                    }});
+}
+
+// HRNet heatmaps and SimCC vectors of 17 COCO joints.
+void add_keypoints(bool int8, std::vector<Case> *cases) {
+  const int joints = 17, hm_h = 64, hm_w = 48, simcc_x = 384, simcc_y = 512;
+  Synth synth(4);
+  auto hm = std::make_shared<Tensor>();
+  hm->resize((size_t)joints * hm_h * hm_w);
+  for (int j = 0; j < joints; j++) {
+    float px = synth.uniform(4, hm_w - 4), py = synth.uniform(4, hm_h - 4);
+    for (int y = 0; y < hm_h; y++) {
+      for (int x = 0; x < hm_w; x++) {
+        float d2 = (x - px) * (x - px) + (y - py) * (y - py);
+        hm->f[((size_t)j * hm_h + y) * hm_w + x] = expf(-d2 / 8.f) + synth.normal(0, 0.01f);
+      }
+    }
+  }
+  hm->qscale = 1.f / 127;
+  hm->quantize();
+  auto kpts = std::make_shared<std::vector<Keypoint>>(joints);
+  cases->push_back({"hrnet", int8 ? "int8" : "f32", (size_t)joints * hm_h * hm_w, [=]() {
+                      if (int8) {
+                        decode_heatmaps(hm->q.data(), hm->qscale, joints, hm_h, hm_w,
+                                        KeypointRefine::DARK, kpts->data());
+                      } else {
+                        decode_heatmaps(hm->f.data(), 1.f, joints, hm_h, hm_w,
+                                        KeypointRefine::DARK, kpts->data());
+                      }
+                      return (size_t)joints;
+                    }});
+
+  auto sx = std::make_shared<Tensor>(), sy = std::make_shared<Tensor>();
+  sx->resize((size_t)joints * simcc_x);
+  sy->resize((size_t)joints * simcc_y);
+  synth.noise(sx.get(), 1.f);
+  synth.noise(sy.get(), 1.f);
+  for (int j = 0; j < joints; j++) {
+    sx->f[(size_t)j * simcc_x + synth.index(simcc_x)] = 8.f;
+    sy->f[(size_t)j * simcc_y + synth.index(simcc_y)] = 8.f;
+  }
+  sx->quantize();
+  sy->quantize();
+  cases->push_back({"simcc", int8 ? "int8" : "f32", (size_t)joints * (simcc_x + simcc_y), [=]() {
+                      if (int8) {
+                        decode_simcc(sx->q.data(), sx->qscale, simcc_x, sy->q.data(), sy->qscale,
+                                     simcc_y, joints, 2.f, kpts->data());
+                      } else {
+                        decode_simcc(sx->f.data(), 1.f, simcc_x, sy->f.data(), 1.f, simcc_y,
+                                     joints, 2.f, kpts->data());
+                      }
+                      return (size_t)joints;
+                    }});
+}
+
+// DeepLabv3 scores of 19 classes with blob shaped class regions.
+void add_deeplab(bool int8, std::vector<Case> *cases) {
+  const int num_cls = 19, h = 256, w = 512, plane = h * w;
+  Synth synth(5);
+  auto scores = std::make_shared<Tensor>();
+  scores->resize((size_t)num_cls * plane);
+  synth.noise(scores.get(), 1.f);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int c = ((y / 32) * 7 + (x / 64) * 3) % num_cls;
+      scores->f[(size_t)c * plane + y * w + x] += 4.f;
+    }
+  }
+  scores->quantize();
+  auto argmax = std::make_shared<SegArgmax>();
+  argmax->clearFilter();
+  auto labels = std::make_shared<std::vector<uint8_t>>(plane);
+  cases->push_back({"deeplabv3", int8 ? "int8" : "f32", (size_t)plane, [=]() {
+                      if (int8) {
+                        argmax->run(scores->q.data(), num_cls, h, w, 1, labels->data(), w);
+                      } else {
+                        argmax->run(scores->f.data(), num_cls, h, w, 1, labels->data(), w);
+                      }
+                      return (size_t)plane;
+                    }});
+}
+
+// YOLOv8-seg instance masks at prototype resolution, encoded to RLE row by row.
+void add_seg_rle(const Options &opt, std::vector<Case> *cases) {
+  const int size = 160;
+  const int num_masks = std::max(1, (int)(8400 * opt.density));
+  Synth synth(6);
+  auto masks = std::make_shared<std::vector<uint8_t>>((size_t)num_masks * size * size, 0);
+  for (int m = 0; m < num_masks; m++) {
+    float cx = synth.uniform(0, size), cy = synth.uniform(0, size);
+    float rx = synth.uniform(4, 40), ry = synth.uniform(4, 40);
+    uint8_t *mask = masks->data() + (size_t)m * size * size;
+    for (int y = 0; y < size; y++) {
+      for (int x = 0; x < size; x++) {
+        float dx = (x - cx) / rx, dy = (y - cy) / ry;
+        mask[y * size + x] = dx * dx + dy * dy <= 1.f;
+      }
+    }
+  }
+  auto encoder = std::make_shared<MaskRleEncoder>();
+  auto counts = std::make_shared<std::vector<uint32_t>>();
+  cases->push_back({"yolov8_seg_rle", "u8", (size_t)num_masks * size * size, [=]() {
+                      for (int m = 0; m < num_masks; m++) {
+                        const uint8_t *mask = masks->data() + (size_t)m * size * size;
+                        encoder->reset(size, size);
+                        for (int y = 0; y < size; y++) {
+                          encoder->addRow(y, mask + y * size);
+                        }
+                        encoder->finish(counts.get());
+                      }
+                      return (size_t)num_masks;
+                    }});
+}
+
+// OCR heads: DBNet probability maps and CTC recognition scores.
+void add_ocr(const Options &opt, bool int8, std::vector<Case> *cases) {
+  const int map = 640;
+  Synth synth(7);
+  auto prob = std::make_shared<Tensor>();
+  prob->resize((size_t)map * map);
+  for (float &v : prob->f) v = synth.uniform(0.f, 0.1f);
+  const int num_lines = std::max(1, (int)(map * map * opt.density / 400));
+  for (int i = 0; i < num_lines; i++) {
+    int x0 = synth.index(map - 200), y0 = synth.index(map - 24);
+    int w = 40 + synth.index(160), h = 8 + synth.index(16);
+    for (int y = y0; y < y0 + h; y++) {
+      for (int x = x0; x < x0 + w; x++) {
+        prob->f[(size_t)y * map + x] = synth.uniform(0.6f, 1.f);
+      }
+    }
+  }
+  prob->qscale = 1.f / 127;
+  prob->quantize();
+  auto regions = std::make_shared<std::vector<TextRegion>>();
+  const TextRegionParam param = {0.3f, 16, 1.5f};
+  cases->push_back({"dbnet", int8 ? "int8" : "f32", (size_t)map * map, [=]() {
+                      if (int8) {
+                        extract_text_regions(prob->q.data(), prob->qscale, map, map, map, param,
+                                             regions.get());
+                      } else {
+                        extract_text_regions(prob->f.data(), map, map, map, param,
+                                             regions.get());
+                      }
+                      return regions->size();
+                    }});
+
+  // PaddleOCR style recognition, 40 steps over 6625 characters, greedy.
+  const int steps = 40, classes = 6625;
+  auto rec = std::make_shared<Tensor>();
+  rec->resize((size_t)steps * classes);
+  synth.noise(rec.get(), 1.f);
+  for (int t = 0; t < steps; t++) {
+    rec->f[(size_t)t * classes + (t % 3 == 0 ? 0 : synth.index(classes))] = 12.f;
+  }
+  rec->quantize();
+  auto labels = std::make_shared<std::vector<int>>();
+  const CtcInput rec_input = {int8 ? rec->q.data() : nullptr, int8 ? nullptr : rec->f.data(),
+                              rec->qscale, false, steps, classes, classes, 1, steps * classes};
+  auto greedy = std::make_shared<CtcDecoder>(0);
+  cases->push_back({"ctc_greedy", int8 ? "int8" : "f32", (size_t)steps * classes, [=]() {
+                      (void)rec;  // keeps the scores rec_input points to alive
+                      float score;
+                      greedy->greedy(rec_input, 0, labels.get(), &score);
+                      return labels->size();
+                    }});
+
+  // License plate recognition, 20 steps over 70 characters, beam search under a lexicon.
+  const int lp_steps = 20, lp_classes = 70;
+  auto lp = std::make_shared<Tensor>();
+  lp->resize((size_t)lp_steps * lp_classes);
+  synth.noise(lp.get(), 1.f);
+  std::vector<int> plate;
+  for (int t = 0; t < lp_steps; t++) {
+    int label = t % 2 == 1 ? 0 : 1 + synth.index(lp_classes - 1);
+    lp->f[(size_t)t * lp_classes + label] = 6.f;
+    if (label != 0) {
+      plate.push_back(label);
+    }
+  }
+  lp->quantize();
+  auto lexicon = std::make_shared<LexiconGrammar>();
+  lexicon->addWord(plate);
+  for (int i = 0; i < 200; i++) {
+    std::vector<int> word(plate.size());
+    for (int &c : word) c = 1 + synth.index(lp_classes - 1);
+    lexicon->addWord(word);
+  }
+  const CtcInput lp_input = {int8 ? lp->q.data() : nullptr, int8 ? nullptr : lp->f.data(),
+                             lp->qscale, false, lp_steps, lp_classes, lp_classes, 1,
+                             lp_steps * lp_classes};
+  auto beam = std::make_shared<CtcDecoder>(0);
+  cases->push_back({"ctc_beam_lexicon", int8 ? "int8" : "f32", (size_t)lp_steps * lp_classes,
+                    [=]() {
+                      (void)lp;
+                      float score;
+                      beam->beamSearch(lp_input, 0, 8, lexicon.get(), labels.get(), &score);
+                      return labels->size();
+                    }});
+}
+
+std::vector<Case> build_cases(const Options &opt) {
+  std::vector<Case> cases;
+  for (int int8 = 0; int8 < 2; int8++) {
+    if ((int8 && !opt.run_int8) || (!int8 && !opt.run_float)) {
+      continue;
+    }
+    add_yolo(opt, int8, YoloBoxCoding::YOLOV5, &cases);
+    add_yolo(opt, int8, YoloBoxCoding::YOLOX, &cases);
+    add_anchor_free(opt, int8, "yolov8", AnchorFreeBoxCoding::DFL, AnchorFreeLayout::CHW, 80,
+                    &cases);
+    add_anchor_free(opt, int8, "yolov8_pose", AnchorFreeBoxCoding::DFL, AnchorFreeLayout::CHW, 1,
+                    &cases);
+    add_anchor_free(opt, int8, "ppyoloe", AnchorFreeBoxCoding::LTRB, AnchorFreeLayout::HWC, 80,
+                    &cases);
+    add_keypoints(int8, &cases);
+    add_deeplab(int8, &cases);
+    add_ocr(opt, int8, &cases);
+  }
+  add_nms(opt, &cases);
+  add_seg_rle(opt, &cases);
+  return cases;
+}
+
+Result measure(const Case &c, int iterations) {
+  for (int i = 0; i < 3; i++) {
+    c.run();
+  }
+  std::vector<double> ns(iterations);
+  size_t candidates = 0;
+  uint64_t allocs_begin = g_num_allocs.load();
+  for (int i = 0; i < iterations; i++) {
+    auto t0 = std::chrono::steady_clock::now();
+    candidates += c.run();
+    auto t1 = std::chrono::steady_clock::now();
+    ns[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  }
+  uint64_t allocs = g_num_allocs.load() - allocs_begin;
+  std::sort(ns.begin(), ns.end());
+  Result r;
+  r.ns_per_call = ns[iterations / 2];
+  r.ns_per_anchor = r.ns_per_call / std::max<size_t>(c.anchors, 1);
+  r.candidates_per_sec = candidates / (double)iterations / (r.ns_per_call * 1e-9);
+  r.allocs_per_call = (double)allocs / iterations;
+  return r;
+}
+
+// name,dtype -> (ns/anchor, allocs/call) of a previous --csv output.
+std::map<std::string, std::pair<double, double>> load_baseline(const char *path) {
+  std::map<std::string, std::pair<double, double>> baseline;
+  FILE *fp = fopen(path, "r");
+  if (fp == nullptr) {
+    fprintf(stderr, "cannot open baseline %s\n", path);
+    return baseline;
+  }
+  char line[256], name[64], dtype[16];
+  double ns_call, ns_anchor, cand, allocs;
+  unsigned long anchors;
+  while (fgets(line, sizeof(line), fp)) {
+    if (sscanf(line, "%63[^,],%15[^,],%lu,%lf,%lf,%lf,%lf", name, dtype, &anchors, &ns_call,
+               &ns_anchor, &cand, &allocs) == 7) {
+      baseline[std::string(name) + "," + dtype] = {ns_anchor, allocs};
+    }
+  }
+  fclose(fp);
+  return baseline;
+}
+
+void usage(const char *bin) {
+  printf(
+      "Usage: %s [options]\n"
+      "\n"
+      "options:\n"
+      "    -n <number>      timed calls per case (default: 50)\n"
+      "    -d <density>     fraction of anchors holding a candidate (default: 0.005)\n"
+      "    -q <f32|int8>    only run one tensor type (default: both)\n"
+      "    -m <name>        only run cases whose name contains name\n"
+      "    -o <csv>         write the results as csv\n"
+      "    -b <csv>         compare with a previous -o output, exit 1 on regression\n"
+      "    -t <percent>     ns/anchor regression tolerance against -b (default: 10)\n"
+      "    -h               help\n",
+      bin);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  Options opt;
+  int ch;
+  while ((ch = getopt(argc, argv, "n:d:q:m:o:b:t:h")) != -1) {
+    switch (ch) {
+      case 'n':
+        opt.iterations = std::max(1, atoi(optarg));
+        break;
+      case 'd':
+        opt.density = std::max(0.f, std::min(1.f, (float)atof(optarg)));
+        break;
+      case 'q':
+        opt.run_float = strcmp(optarg, "f32") == 0;
+        opt.run_int8 = strcmp(optarg, "int8") == 0;
+        break;
+      case 'm':
+        opt.filter = optarg;
+        break;
+      case 'o':
+        opt.csv_path = optarg;
+        break;
+      case 'b':
+        opt.baseline_path = optarg;
+        break;
+      case 't':
+        opt.tolerance = atof(optarg);
+        break;
+      default:
+        usage(argv[0]);
+        return ch == 'h' ? 0 : 1;
+    }
+  }
+
+  std::map<std::string, std::pair<double, double>> baseline;
+  if (opt.baseline_path != nullptr) {
+    baseline = load_baseline(opt.baseline_path);
+    if (baseline.empty()) {
+      return 1;
+    }
+  }
+  FILE *csv = nullptr;
+  if (opt.csv_path != nullptr) {
+    csv = fopen(opt.csv_path, "w");
+    if (csv == nullptr) {
+      fprintf(stderr, "cannot open %s\n", opt.csv_path);
+      return 1;
+    }
+    fprintf(csv,
+            "name,dtype,anchors,ns_per_call,ns_per_anchor,candidates_per_sec,allocs_per_call\n");
+  }
+
+  printf("%-18s %-5s %10s %12s %10s %14s %12s\n", "case", "dtype", "anchors", "ns/call",
+         "ns/anchor", "candidates/s", "allocs/call");
+  int regressions = 0;
+  for (const Case &c : build_cases(opt)) {
+    if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) {
+      continue;
+    }
+    Result r = measure(c, opt.iterations);
+    printf("%-18s %-5s %10zu %12.0f %10.3f %14.0f %12.1f", c.name.c_str(), c.dtype.c_str(),
+           c.anchors, r.ns_per_call, r.ns_per_anchor, r.candidates_per_sec, r.allocs_per_call);
+    if (csv != nullptr) {
+      fprintf(csv, "%s,%s,%zu,%.1f,%.4f,%.1f,%.2f\n", c.name.c_str(), c.dtype.c_str(), c.anchors,
+              r.ns_per_call, r.ns_per_anchor, r.candidates_per_sec, r.allocs_per_call);
+    }
+    auto it = baseline.find(c.name + "," + c.dtype);
+    if (it != baseline.end()) {
+      double change = (r.ns_per_anchor / it->second.first - 1) * 100;
+      bool slower = change > opt.tolerance;
+      bool more_allocs = r.allocs_per_call > it->second.second + 0.5;
+      printf("  %+6.1f%%%s%s", change, slower ? " SLOWER" : "", more_allocs ? " ALLOCS" : "");
+      regressions += slower || more_allocs;
+    }
+    printf("\n");
+  }
+  if (csv != nullptr) {
+    fclose(csv);
+  }
+  if (regressions > 0) {
+    printf("%d case(s) regressed against %s\n", regressions, opt.baseline_path);
+    return 1;
+  }
+  return 0;
+}